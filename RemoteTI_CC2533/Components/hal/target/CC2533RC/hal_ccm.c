@@ -41,6 +41,9 @@
  * INCLUDES
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_HAL_CCM
+
 #include "osal.h"
 #include "hal_aes.h"
 #include "hal_ccm.h"
@@ -0,0 +1,186 @@
+/**************************************************************************************************
+  Filename:       hal_board_cfg.h
+**************************************************************************************************/
+#ifndef HAL_BOARD_CFG_H
+#define HAL_BOARD_CFG_H
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "hal_mcu.h"
+#include "hal_defs.h"
+#include "hal_types.h"
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Board Indentifier
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_BOARD_HOST
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Clock Speed
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_CPU_CLOCK_MHZ     32
+
+/* ------------------------------------------------------------------------------------------------
+ *                                         Key Release detect support
+ * ------------------------------------------------------------------------------------------------
+ */
+#define HAL_KEY_CODE_NOKEY 0xff
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       LED Configuration
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_NUM_LEDS            0
+
+#define HAL_LED_BLINK_DELAY()
+
+/* ------------------------------------------------------------------------------------------------
+ *                         OSAL NV implemented by internal flash pages.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* The host flash is laid out as on a CC2533F96, so that the NV modules run with the page sizes
+ * they are built for on target.
+ */
+#define HAL_FLASH_PAGE_PHYS        1024UL
+#define HAL_FLASH_PAGE_SIZE       (HAL_FLASH_PAGE_PHYS * 2)
+#define HAL_FLASH_PAGE_CNT         96
+#define HAL_FLASH_WORD_SIZE        4
+
+// Flash is partitioned into banks of 32K.
+#define HAL_FLASH_PAGE_PER_BANK   ((uint8)(32768 / HAL_FLASH_PAGE_SIZE))
+
+// CODE banks get mapped into the upper 32K XDATA range 8000-FFFF.
+#define HAL_FLASH_PAGE_MAP         0x8000
+
+// The last 16 bytes of the last available page are reserved for flash lock bits.
+#define HAL_FLASH_LOCK_BITS        16
+
+// Re-defining Z_EXTADDR_LEN here so as not to include a Z-Stack .h file.
+#define HAL_FLASH_IEEE_SIZE        8
+#define HAL_FLASH_IEEE_OSET       (HAL_FLASH_PAGE_SIZE - HAL_FLASH_LOCK_BITS - HAL_FLASH_IEEE_SIZE)
+#define HAL_FLASH_IEEE_PAGE       ((uint8)(HAL_FLASH_PAGE_CNT * HAL_FLASH_PAGE_PHYS\
+                                                              / HAL_FLASH_PAGE_SIZE - 1))
+#define HAL_NV_PAGE_END            HAL_FLASH_IEEE_PAGE
+#if !defined HAL_NV_PAGE_CNT
+#define HAL_NV_PAGE_CNT            2
+#endif
+#define HAL_NV_PAGE_BEG           (HAL_NV_PAGE_END-HAL_NV_PAGE_CNT)
+
+/* ------------------------------------------------------------------------------------------------
+ *                Critical Vdd Monitoring to prevent flash damage or radio lockup.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#if !defined HAL_BATMON_MIN_FLASH
+#define HAL_BATMON_MIN_FLASH   (11 << 1)
+#endif
+
+/* ------------------------------------------------------------------------------------------------
+ *                                            Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* ----------- Board Initialization ---------- */
+#define HAL_BOARD_INIT()
+
+/* ----------- Delay macro ---------- */
+#define HAL_BOARD_DELAY_USEC( usec )
+
+/* ----------- Debounce ---------- */
+#define HAL_DEBOUNCE(expr)
+
+/* ----------- Push Buttons ---------- */
+#define HAL_PUSH_BUTTON1()        (0)
+#define HAL_PUSH_BUTTON2()        (0)
+#define HAL_PUSH_BUTTON3()        (0)
+#define HAL_PUSH_BUTTON4()        (0)
+#define HAL_PUSH_BUTTON5()        (0)
+#define HAL_PUSH_BUTTON6()        (0)
+
+/* ----------- LED's ---------- */
+#define HAL_TURN_OFF_LED1()
+#define HAL_TURN_OFF_LED2()
+#define HAL_TURN_OFF_LED3()
+#define HAL_TURN_OFF_LED4()
+
+#define HAL_TURN_ON_LED1()
+#define HAL_TURN_ON_LED2()
+#define HAL_TURN_ON_LED3()
+#define HAL_TURN_ON_LED4()
+
+#define HAL_TOGGLE_LED1()
+#define HAL_TOGGLE_LED2()
+#define HAL_TOGGLE_LED3()
+#define HAL_TOGGLE_LED4()
+
+#define HAL_STATE_LED1()          0
+#define HAL_STATE_LED2()          0
+#define HAL_STATE_LED3()          0
+#define HAL_STATE_LED4()          0
+
+/* ------------------------------------------------------------------------------------------------
+ *                                     Driver Configuration
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* Only the drivers that a host harness supplies itself are enabled; a harness may set any of
+ * these on the compiler command line.
+ */
+#ifndef HAL_ADC
+#define HAL_ADC       FALSE
+#endif
+#ifndef HAL_BATMON
+#define HAL_BATMON    FALSE
+#endif
+#ifndef HAL_BUZZER
+#define HAL_BUZZER    FALSE
+#endif
+#ifndef HAL_FLASH
+#define HAL_FLASH     TRUE
+#endif
+#ifndef HAL_KEY
+#define HAL_KEY       TRUE
+#endif
+#ifndef HAL_LCD
+#define HAL_LCD       FALSE
+#endif
+#ifndef HAL_LED
+#define HAL_LED       FALSE
+#endif
+#ifndef HAL_MOTION
+#define HAL_MOTION    FALSE
+#endif
+#ifndef HAL_TIMER
+#define HAL_TIMER     FALSE
+#endif
+#ifndef HAL_UART
+#define HAL_UART      FALSE
+#endif
+#ifndef HAL_AES
+#define HAL_AES       FALSE
+#endif
+#ifndef HAL_DMA
+#define HAL_DMA       FALSE
+#endif
+#ifndef HAL_VDDMON
+#define HAL_VDDMON    FALSE
+#endif
+
+#define HAL_UART_DMA  0
+#define HAL_UART_ISR  0
+#define HAL_UART_USB  0
+
+#endif
+/*******************************************************************************************************
+*/
@@ -0,0 +1,77 @@
+/**************************************************************************************************
+  Filename:       hal_mcu.h
+**************************************************************************************************/
+#ifndef _HAL_MCU_H
+#define _HAL_MCU_H
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+#include <stdlib.h>
+#include "hal_defs.h"
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Target Defines
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_MCU_HOST
+
+/* ------------------------------------------------------------------------------------------------
+ *                                     Compiler Abstraction
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#ifdef __GNUC__
+#define HAL_COMPILER_GCC
+#define HAL_MCU_LITTLE_ENDIAN()   (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define HAL_ISR_FUNC_DECLARATION(f,v)   void f(void)
+#define HAL_ISR_FUNC_PROTOTYPE(f,v)     void f(void)
+#define HAL_ISR_FUNCTION(f,v)           HAL_ISR_FUNC_PROTOTYPE(f,v); HAL_ISR_FUNC_DECLARATION(f,v)
+#else
+#error "ERROR: Unknown compiler."
+#endif
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Interrupt Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* The host harnesses run the code under test and its simulated interrupts on one thread, so the
+ * interrupt enable only has to be tracked, not enforced.
+ */
+extern volatile uint8 halHostEA;
+
+#define HAL_ENABLE_INTERRUPTS()         st( halHostEA = 1; )
+#define HAL_DISABLE_INTERRUPTS()        st( halHostEA = 0; )
+#define HAL_INTERRUPTS_ARE_ENABLED()    (halHostEA)
+
+typedef unsigned char halIntState_t;
+#define HAL_ENTER_CRITICAL_SECTION(x)   st( x = halHostEA;  HAL_DISABLE_INTERRUPTS(); )
+#define HAL_EXIT_CRITICAL_SECTION(x)    st( halHostEA = x; )
+#define HAL_CRITICAL_STATEMENT(x)       st( halIntState_t _s; HAL_ENTER_CRITICAL_SECTION(_s); x; HAL_EXIT_CRITICAL_SECTION(_s); )
+
+#define HAL_ENTER_ISR()                 { halIntState_t _isrIntState = halHostEA; HAL_ENABLE_INTERRUPTS();
+#define HAL_EXIT_ISR()                    halHostEA = _isrIntState; }
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Reset Macro
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_SYSTEM_RESET()  abort()
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Sleep Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define CLEAR_SLEEP_MODE()
+#define ALLOW_SLEEP_MODE()
+#define CHECK_SLEEP_MODE()
+
+#endif
+/**************************************************************************************************
+ */
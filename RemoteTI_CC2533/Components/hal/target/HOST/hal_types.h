@@ -0,0 +1,71 @@
+/**************************************************************************************************
+  Filename:       hal_types.h
+**************************************************************************************************/
+
+#ifndef _HAL_TYPES_H
+#define _HAL_TYPES_H
+
+/* Host build (GNU C on a 32 or 64-bit POSIX system) */
+
+/* ------------------------------------------------------------------------------------------------
+ *                                               Types
+ * ------------------------------------------------------------------------------------------------
+ */
+typedef signed   char   int8;
+typedef unsigned char   uint8;
+
+typedef signed   short  int16;
+typedef unsigned short  uint16;
+
+typedef signed   int    int32;
+typedef unsigned int    uint32;
+
+typedef unsigned char   bool;
+
+typedef uint8           halDataAlign_t;
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Memory Attributes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* ----------- GNU Compiler ----------- */
+#ifdef __GNUC__
+#define  CODE
+#define  XDATA
+#define NO_INIT
+
+/* IAR memory and calling keywords used directly in the sources */
+#define __code
+#define __data
+#define __xdata
+#define __near_func
+#define __monitor
+
+/* ----------- Unrecognized Compiler ----------- */
+#else
+#error "ERROR: Unknown compiler."
+#endif
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Standard Defines
+ * ------------------------------------------------------------------------------------------------
+ */
+#ifndef TRUE
+#define TRUE 1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#ifndef NULL
+#define NULL 0
+#endif
+
+
+/**************************************************************************************************
+ */
+#endif
@@ -6,16 +6,34 @@
  * INCLUDES
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_OSAL_TIMERS
+
 #include "comdef.h"
 #include "OnBoard.h"
 #include "OSAL.h"
 #include "OSAL_Timers.h"
 #include "hal_timer.h"
 
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of timer records kept in the static pool. When the pool runs dry
+// further timers are allocated from the heap, as before.
+#if !defined ( OSAL_TIMERS_POOL_SIZE )
+  #define OSAL_TIMERS_POOL_SIZE  12
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+/* The active timers are kept in a list sorted by expiration, where each
+ * record's timeout is relative to the expiration of the record before it.
+ * The head's timeout is thus the time to the next expiration, and a tick
+ * only needs to touch the timers that actually expire.
+ */
 typedef struct
 {
   void   *next;
@@ -37,6 +55,13 @@ osalTimerRec_t *timerHead;
 // Milliseconds since last reboot
 static uint32 osal_systemClock;
 
+// Static timer record pool and its free list.
+static osalTimerRec_t osalTimerPool[OSAL_TIMERS_POOL_SIZE];
+static osalTimerRec_t *osalTimerFree;
+
+// Number of timers in the active list.
+static uint8 osalTimerCnt;
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
@@ -44,6 +69,11 @@ osalTimerRec_t  *osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout
 osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag );
 void osalDeleteTimer( osalTimerRec_t *rmTimer );
 
+static osalTimerRec_t *osalTimerRecAlloc( void );
+static void osalTimerRecFree( osalTimerRec_t *rec );
+static void osalInsertTimer( osalTimerRec_t *newTimer, uint16 timeout );
+static void osalUnlinkTimer( osalTimerRec_t *rmTimer );
+
 /*********************************************************************
  * @fn      osalTimerInit
  *
@@ -55,7 +85,154 @@ void osalDeleteTimer( osalTimerRec_t *rmTimer );
  */
 void osalTimerInit( void )
 {
+  uint8 idx;
+
   osal_systemClock = 0;
+
+  timerHead = NULL;
+  osalTimerCnt = 0;
+
+  // Chain all pool records onto the free list.
+  osalTimerFree = NULL;
+  for ( idx = 0; idx < OSAL_TIMERS_POOL_SIZE; idx++ )
+  {
+    osalTimerPool[idx].next = osalTimerFree;
+    osalTimerFree = &osalTimerPool[idx];
+  }
+}
+
+/*********************************************************************
+ * @fn      osalTimerRecAlloc
+ *
+ * @brief   Get a timer record from the pool, or from the heap if the
+ *          pool is exhausted.
+ *          Ints must be disabled.
+ *
+ * @param   none
+ *
+ * @return  osalTimerRec_t * - new record, NULL if none available
+ */
+static osalTimerRec_t *osalTimerRecAlloc( void )
+{
+  osalTimerRec_t *rec = osalTimerFree;
+
+  if ( rec != NULL )
+  {
+    osalTimerFree = rec->next;
+  }
+  else
+  {
+    rec = osal_mem_alloc( sizeof( osalTimerRec_t ) );
+  }
+
+  return ( rec );
+}
+
+/*********************************************************************
+ * @fn      osalTimerRecFree
+ *
+ * @brief   Return a timer record to wherever it came from.
+ *          Ints must be disabled.
+ *
+ * @param   rec - record to free
+ *
+ * @return  none
+ */
+static void osalTimerRecFree( osalTimerRec_t *rec )
+{
+  if ( (rec >= &osalTimerPool[0]) && (rec < &osalTimerPool[OSAL_TIMERS_POOL_SIZE]) )
+  {
+    rec->next = osalTimerFree;
+    osalTimerFree = rec;
+  }
+  else
+  {
+    osal_mem_free( rec );
+  }
+}
+
+/*********************************************************************
+ * @fn      osalInsertTimer
+ *
+ * @brief   Insert a timer record into the sorted list so that it expires
+ *          timeout mSecs from now.
+ *          Ints must be disabled.
+ *
+ * @param   newTimer - record, not in the list
+ * @param   timeout - mSecs until expiration
+ *
+ * @return  none
+ */
+static void osalInsertTimer( osalTimerRec_t *newTimer, uint16 timeout )
+{
+  osalTimerRec_t *prevTimer = NULL;
+  osalTimerRec_t *srchTimer = timerHead;
+
+  // Timers with equal expiration stay in the order they were started.
+  while ( (srchTimer != NULL) && (srchTimer->timeout <= timeout) )
+  {
+    timeout -= srchTimer->timeout;
+    prevTimer = srchTimer;
+    srchTimer = srchTimer->next;
+  }
+
+  newTimer->timeout = timeout;
+  newTimer->next = srchTimer;
+
+  if ( srchTimer != NULL )
+  {
+    srchTimer->timeout -= timeout;
+  }
+
+  if ( prevTimer == NULL )
+  {
+    timerHead = newTimer;
+  }
+  else
+  {
+    prevTimer->next = newTimer;
+  }
+
+  osalTimerCnt++;
+}
+
+/*********************************************************************
+ * @fn      osalUnlinkTimer
+ *
+ * @brief   Remove a timer record from the sorted list, handing its
+ *          remaining time on to its successor.
+ *          Ints must be disabled.
+ *
+ * @param   rmTimer - record in the list
+ *
+ * @return  none
+ */
+static void osalUnlinkTimer( osalTimerRec_t *rmTimer )
+{
+  osalTimerRec_t *nextTimer = rmTimer->next;
+
+  if ( timerHead == rmTimer )
+  {
+    timerHead = nextTimer;
+  }
+  else
+  {
+    osalTimerRec_t *prevTimer = timerHead;
+
+    while ( prevTimer->next != rmTimer )
+    {
+      prevTimer = prevTimer->next;
+    }
+    prevTimer->next = nextTimer;
+  }
+
+  if ( nextTimer != NULL )
+  {
+    nextTimer->timeout += rmTimer->timeout;
+  }
+
+  rmTimer->next = NULL;
+  osalTimerCnt--;
 }
 
 /*********************************************************************
@@ -73,49 +250,30 @@ void osalTimerInit( void )
 osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout )
 {
   osalTimerRec_t *newTimer;
-  osalTimerRec_t *srchTimer;
 
   // Look for an existing timer first
   newTimer = osalFindTimer( task_id, event_flag );
   if ( newTimer )
   {
-    // Timer is found - update it.
-    newTimer->timeout = timeout;
+    // Timer is found - move it to its new place in the list.
+    osalUnlinkTimer( newTimer );
+    osalInsertTimer( newTimer, timeout );
 
     return ( newTimer );
   }
   else
   {
     // New Timer
-    newTimer = osal_mem_alloc( sizeof( osalTimerRec_t ) );
+    newTimer = osalTimerRecAlloc();
 
     if ( newTimer )
     {
       // Fill in new timer
       newTimer->task_id = task_id;
       newTimer->event_flag = event_flag;
-      newTimer->timeout = timeout;
-      newTimer->next = (void *)NULL;
       newTimer->reloadTimeout = 0;
 
-      // Does the timer list already exist
-      if ( timerHead == NULL )
-      {
-        // Start task list
-        timerHead = newTimer;
-      }
-      else
-      {
-        // Add it to the end of the timer list
-        srchTimer = timerHead;
-
-        // Stop at the last record
-        while ( srchTimer->next )
-          srchTimer = srchTimer->next;
-
-        // Add to the list
-        srchTimer->next = newTimer;
-      }
+      osalInsertTimer( newTimer, timeout );
 
       return ( newTimer );
     }
@@ -160,6 +318,7 @@ osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
  * @fn      osalDeleteTimer
  *
  * @brief   Delete a timer from a timer list.
+ *          Ints must be disabled.
  *
  * @param   table
  * @param   rmTimer
@@ -171,9 +330,8 @@ void osalDeleteTimer( osalTimerRec_t *rmTimer )
   // Does the timer list really exist
   if ( rmTimer )
   {
-    // Clear the event flag and osalTimerUpdate() will delete
-    // the timer from the list.
-    rmTimer->event_flag = 0;
+    osalUnlinkTimer( rmTimer );
+    osalTimerRecFree( rmTimer );
   }
 }
 
@@ -288,15 +446,23 @@ uint16 osal_get_timeoutEx( uint8 task_id, uint16 event_id )
 {
   halIntState_t intState;
   uint16 rtrn = 0;
-  osalTimerRec_t *tmr;
+  osalTimerRec_t *srchTimer;
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
-  tmr = osalFindTimer( task_id, event_id );
+  // Sum the relative timeouts up to and including the matching timer.
+  for ( srchTimer = timerHead; srchTimer != NULL; srchTimer = srchTimer->next )
+  {
+    rtrn += srchTimer->timeout;
+
+    if ( srchTimer->event_flag == event_id &&
+         srchTimer->task_id == task_id )
+      break;
+  }
 
-  if ( tmr )
+  if ( srchTimer == NULL )
   {
-    rtrn = tmr->timeout;
+    rtrn = 0;
   }
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
@@ -315,25 +481,7 @@ uint16 osal_get_timeoutEx( uint8 task_id, uint16 event_id )
  */
 uint8 osal_timer_num_active( void )
 {
-  halIntState_t intState;
-  uint8 num_timers = 0;
-  osalTimerRec_t *srchTimer;
-
-  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
-
-  // Head of the timer list
-  srchTimer = timerHead;
-
-  // Count timers in the list
-  while ( srchTimer != NULL )
-  {
-    num_timers++;
-    srchTimer = srchTimer->next;
-  }
-
-  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
-
-  return num_timers;
+  return osalTimerCnt;
 }
 
 /*********************************************************************
@@ -348,80 +496,70 @@ uint8 osal_timer_num_active( void )
 void osalTimerUpdate( uint16 updateTime )
 {
   halIntState_t intState;
-  osalTimerRec_t *srchTimer;
-  osalTimerRec_t *prevTimer;
+  osalTimerRec_t *expired = NULL;
+  osalTimerRec_t *reloaded = NULL;
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
   // Update the system time
   osal_systemClock += updateTime;
-  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
-  // Look for open timer slot
-  if ( timerHead != NULL )
+  // Detach every timer that expires within this update from the front of the list.
+  while ( (timerHead != NULL) && (timerHead->timeout <= updateTime) )
   {
-    // Add it to the end of the timer list
-    srchTimer = timerHead;
-    prevTimer = (void *)NULL;
+    osalTimerRec_t *srchTimer = timerHead;
+
+    updateTime -= srchTimer->timeout;
+    timerHead = srchTimer->next;
+    osalTimerCnt--;
 
-    // Look for open timer slot
-    while ( srchTimer )
+    srchTimer->timeout = 0;
+
+    // A reload timer is notified here, as it always was, and goes back into
+    // the list below; a one-shot timer is notified and freed after.
+    if ( srchTimer->reloadTimeout )
     {
-      osalTimerRec_t *freeTimer = NULL;
-
-      HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
-
-      if (srchTimer->timeout <= updateTime)
-      {
-        srchTimer->timeout = 0;
-      }
-      else
-      {
-        srchTimer->timeout = srchTimer->timeout - updateTime;
-      }
-
-      // Check for reloading
-      if ( (srchTimer->timeout == 0) && (srchTimer->reloadTimeout) && (srchTimer->event_flag) )
-      {
-        // Notify the task of a timeout
-        osal_set_event( srchTimer->task_id, srchTimer->event_flag );
-
-        // Reload the timer timeout value
-        srchTimer->timeout = srchTimer->reloadTimeout;
-      }
-
-      // When timeout or delete (event_flag == 0)
-      if ( srchTimer->timeout == 0 || srchTimer->event_flag == 0 )
-      {
-        // Take out of list
-        if ( prevTimer == NULL )
-          timerHead = srchTimer->next;
-        else
-          prevTimer->next = srchTimer->next;
-
-        // Setup to free memory
-        freeTimer = srchTimer;
-
-        // Next
-        srchTimer = srchTimer->next;
-      }
-      else
-      {
-        // Get next
-        prevTimer = srchTimer;
-        srchTimer = srchTimer->next;
-      }
-
-      HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
-
-      if ( freeTimer )
-      {
-        if ( freeTimer->timeout == 0 )
-        {
-          osal_set_event( freeTimer->task_id, freeTimer->event_flag );
-        }
-        osal_mem_free( freeTimer );
-      }
+      osal_set_event( srchTimer->task_id, srchTimer->event_flag );
+      srchTimer->next = reloaded;
+      reloaded = srchTimer;
     }
+    else
+    {
+      srchTimer->next = expired;
+      expired = srchTimer;
+    }
+  }
+
+  // The rest of the time comes off the first timer that is still pending.
+  if ( timerHead != NULL )
+  {
+    timerHead->timeout -= updateTime;
+  }
+
+  // Interrupts stay off from the detach to the re-insert, so no one can have
+  // restarted or stopped a reload timer meanwhile.
+  while ( reloaded != NULL )
+  {
+    osalTimerRec_t *srchTimer = reloaded;
+
+    reloaded = srchTimer->next;
+    osalInsertTimer( srchTimer, srchTimer->reloadTimeout );
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
+  while ( expired != NULL )
+  {
+    osalTimerRec_t *srchTimer = expired;
+
+    expired = srchTimer->next;
+
+    // Notify the task of a timeout
+    osal_set_event( srchTimer->task_id, srchTimer->event_flag );
+
+    HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+    osalTimerRecFree( srchTimer );
+    HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
   }
 }
 
@@ -431,8 +569,9 @@ void osalTimerUpdate( uint16 updateTime )
  *
  * @brief
  *
- *   Search timer table to return the lowest timeout value. If the
- *   timer list is empty, then the returned timeout will be zero.
+ *   Return the lowest timeout value, which is the head of the sorted
+ *   timer list. If the timer list is empty, then the returned timeout
+ *   will be zero.
  *
  * @param   none
  *
@@ -441,24 +580,10 @@ void osalTimerUpdate( uint16 updateTime )
 uint16 osal_next_timeout( void )
 {
   uint16 nextTimeout;
-  osalTimerRec_t *srchTimer;
 
   if ( timerHead != NULL )
   {
-    // Head of the timer list
-    srchTimer = timerHead;
-    nextTimeout = OSAL_TIMERS_MAX_TIMEOUT;
-
-    // Look for the next timeout timer
-    while ( srchTimer != NULL )
-    {
-      if (srchTimer->timeout < nextTimeout)
-      {
-        nextTimeout = srchTimer->timeout;
-      }
-      // Check next timer
-      srchTimer = srchTimer->next;
-    }
+    nextTimeout = timerHead->timeout;
   }
   else
   {
@@ -115,6 +115,33 @@ uint8 osal_snv_write( osalSnvId_t id, osalSnvLen_t len, void *pBuf )
   return result;
 }
 
+/*********************************************************************
+ * @fn      osal_snv_write_batch
+ *
+ * @brief   Write a number of data items to NV.
+ *          Unlike the native implementation, the items are written one
+ *          at a time, so a reset can leave only some of them written.
+ *
+ * @param   numOfItems - Number of items in the table, up to OSAL_SNV_BATCH_MAX.
+ * @param   pItems - Table of the items to write.
+ *
+ * @return  SUCCESS if successful, NV_OPER_FAILED if failed.
+ */
+uint8 osal_snv_write_batch( uint8 numOfItems, osalSnvItem_t *pItems )
+{
+  uint8 i;
+
+  for (i = 0; i < numOfItems; i++)
+  {
+    if (osal_snv_write(pItems[i].id, pItems[i].len, pItems[i].pBuf) != SUCCESS)
+    {
+      return NV_OPER_FAILED;
+    }
+  }
+
+  return SUCCESS;
+}
+
 /*********************************************************************
  * @fn      osal_snv_read
  *
@@ -132,6 +159,70 @@ uint8 osal_snv_read( osalSnvId_t id, osalSnvLen_t len, void *pBuf )
   return osal_nv_read(id, 0, len, pBuf);
 }
 
+#if OSAL_SNV_CACHE_SIZE
+/*********************************************************************
+ * @fn      osal_snv_cache_stats
+ *
+ * @brief   Read the hit and miss counts of the item offset cache.
+ *          OSAL_Nv keeps no such cache, so both counts are zero.
+ *
+ * @param   pHit - Buffer to receive the number of lookups found in the cache.
+ * @param   pMiss - Buffer to receive the number of lookups that searched the active page.
+ *
+ * @return  none
+ */
+void osal_snv_cache_stats( uint16 *pHit, uint16 *pMiss )
+{
+  *pHit = 0;
+  *pMiss = 0;
+}
+#endif
+
+#if OSAL_SNV_METRICS
+/*********************************************************************
+ * @fn      osal_snv_metrics
+ *
+ * @brief   Read the NV wear counts since the last reset.
+ *          OSAL_Nv counts them only when built with OSAL_NV_METRICS,
+ *          otherwise all counts are zero. OSAL_Nv does every compaction
+ *          inside a write.
+ *
+ * @param   pWrites - Buffer to receive the number of items written.
+ * @param   pErases - Buffer to receive the number of pages erased.
+ * @param   pInline - Buffer to receive the number of compactions done inside a write.
+ *
+ * @return  none
+ */
+void osal_snv_metrics( uint16 *pWrites, uint16 *pErases, uint16 *pInline )
+{
+#if ( OSAL_NV_METRICS )
+  osal_nv_metrics( pWrites, pErases, pInline );
+#else
+  *pWrites = 0;
+  *pErases = 0;
+  *pInline = 0;
+#endif
+}
+#endif
+
+#if OSAL_SNV_COMPACT_STEP
+/*********************************************************************
+ * @fn      osal_snv_compact_step
+ *
+ * @brief   Do a bounded step of background compaction of the active page.
+ *          OSAL_Nv compacts inside its writes, so there is never any
+ *          background work to do.
+ *
+ * @param   none
+ *
+ * @return  FALSE - compaction is never in progress.
+ */
+uint8 osal_snv_compact_step( void )
+{
+  return FALSE;
+}
+#endif
+
 
 /*********************************************************************
 *********************************************************************/
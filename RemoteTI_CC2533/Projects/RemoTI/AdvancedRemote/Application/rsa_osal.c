@@ -6,6 +6,9 @@
  *                                            INCLUDES
  **************************************************************************************************/
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_APP1
+
 #include "comdef.h"
 #include "hal_drivers.h"
 #include "hal_types.h"
@@ -6,6 +6,9 @@
 /**************************************************************************************************
  *                                           Includes
  */
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_APP2
+
 #include "gdp.h"
 
 /* Hal Driver includes */
@@ -53,6 +56,8 @@
 #define RSA_EVT_RANDOM_BACKOFF_TIMER    0x0008
 #define RSA_EVT_DOUBLE_CLICK_TIMER      0x0010
 #define RSA_EVT_MOTION_SENSOR_TIMER     0x0020
+#define RSA_EVT_MOTION_FLUSH            0x0040
+#define RSA_EVT_KEY_RETRY               0x0080
 
 // OAD polling timeout duration in 200 ms
 #define RSA_POLL_TIMEOUT                 200
@@ -63,6 +68,13 @@
 // Time of no movement which causes transition from motion detection to low power, in ms
 #define RSA_EXIT_MOTION_DETECT_TIMEOUT 60000 // 1 minute
 
+// Motion samples (10 ms each) that may be coalesced into one report while the link is free, which
+// bounds the latency that coalescing adds; motion held back while a report is in flight is sent as
+// soon as the link frees up, however old it is.
+#if !defined RSA_MOTION_COALESCE_MAX
+#define RSA_MOTION_COALESCE_MAX        1
+#endif
+
 // RSA States
 enum
 {
@@ -287,6 +299,15 @@ static bool rsaBlockMouseMovements;
 static bool rsaKeyPressed;
 static rsaMotionDetectorState_t rsaMotionDetectorState = RSA_MOTION_DETECTOR_DISABLED;
 static bool rsaNoMotionTimerRunning = FALSE;
+// Mouse button states last reported to the target
+static uint8 rsaSavedMouseButtonStates;
+// Motion not yet reported to the target, in Mickeys, and the samples since it was all reported
+static int16 rsaMotionX;
+static int16 rsaMotionY;
+static uint8 rsaMotionAge;
+// Keyboard report to give again after the data confirm of the report frame that went out instead
+static uint8 rsaKeyRetry;
+static bool rsaKeyRetryPending;
 #endif
 
 // current target device pairing reference
@@ -345,8 +366,11 @@ void RSA_KeyCback( uint8 keys, uint8 state );
 void RSA_CalCompleteCback( void );
 void RSA_MotionSensorCback( int16 gyroMickeysX, int16 gyroMickeysY );
 void RSA_BuzzerCompleteCback( void );
-static void rsaBuildAndSendZidMouseReport( uint8 mouseStates, int8 mickeysX, int8 mickeysY );
-static void rsaBuildAndSendZidKeyboardReport( uint8 key );
+static void rsaSendMotion( void );
+static void rsaAddMotion( int16 *pMotion, int16 mickeys );
+static int8 rsaTakeMotion( int16 *pMotion );
+static uint8 rsaBuildAndSendZidMouseReport( uint8 mouseStates, int8 mickeysX, int8 mickeysY );
+static uint8 rsaBuildAndSendZidKeyboardReport( uint8 key );
 #endif
 
 static void rsaConfig(void);
@@ -433,6 +457,13 @@ void RSA_Init(uint8 taskId)
   (void)osal_set_event( RSA_TaskId, RSA_EVT_INIT );
 
   rsaTgtDevType = RTI_DEVICE_RESERVED_FOR_WILDCARDS;
+
+#if (defined HAL_MOTION) && (HAL_MOTION == TRUE)
+  // no motion is carried over into the new session
+  rsaMotionX = 0;
+  rsaMotionY = 0;
+  rsaMotionAge = 0;
+#endif
 }
 
 /**************************************************************************************************
@@ -538,6 +569,29 @@ uint16 RSA_ProcessEvent(uint8 taskId, uint16 events)
     HalMotionDisable();
     rsaMotionDetectorState = RSA_MOTION_DETECTOR_DISABLED;
   }
+
+  if (events & RSA_EVT_KEY_RETRY)
+  {
+    /* Give the keyboard report again that could not join the previous report frame */
+    if (rsaDestIndex == RTI_INVALID_PAIRING_REF)
+    {
+      rsaKeyRetryPending = FALSE;
+    }
+    else if (rsaKeyRetryPending && (rsaState == RSA_STATE_READY))
+    {
+      rsaKeyRetryPending = FALSE;
+      (void)rsaBuildAndSendZidKeyboardReport(rsaKeyRetry);
+    }
+  }
+
+  if (events & RSA_EVT_MOTION_FLUSH)
+  {
+    /* Send the motion held back while the previous report was in flight */
+    if ((rsaDestIndex != RTI_INVALID_PAIRING_REF) && (rsaState == RSA_STATE_READY))
+    {
+      rsaSendMotion();
+    }
+  }
 #endif
 
   return 0;
@@ -741,6 +795,17 @@ void RTI_SendDataCnf( rStatus_t status )
     {
       HalLedSet(HAL_LED_1, HAL_LED_MODE_OFF);
       rsaState = RSA_STATE_READY;
+#if (defined HAL_MOTION) && (HAL_MOTION == TRUE)
+      if (rsaKeyRetryPending)
+      {
+        osal_set_event(RSA_TaskId, RSA_EVT_KEY_RETRY);
+      }
+      if ((rsaMotionX != 0) || (rsaMotionY != 0) ||
+          (rsaMouseButtonStates != rsaSavedMouseButtonStates))
+      {
+        osal_set_event(RSA_TaskId, RSA_EVT_MOTION_FLUSH);
+      }
+#endif
     }
     else if (rsaState == RSA_STATE_TEST)
     {
@@ -789,6 +854,17 @@ void RTI_SendDataCnf( rStatus_t status )
     {
       HalLedSet(HAL_LED_1, HAL_LED_MODE_OFF);
       rsaState = RSA_STATE_READY;
+#if (defined HAL_MOTION) && (HAL_MOTION == TRUE)
+      if (rsaKeyRetryPending)
+      {
+        osal_set_event(RSA_TaskId, RSA_EVT_KEY_RETRY);
+      }
+      if ((rsaMotionX != 0) || (rsaMotionY != 0) ||
+          (rsaMouseButtonStates != rsaSavedMouseButtonStates))
+      {
+        osal_set_event(RSA_TaskId, RSA_EVT_MOTION_FLUSH);
+      }
+#endif
     }
     else if (rsaState == RSA_STATE_TEST)
     {
@@ -1175,7 +1251,7 @@ void RSA_KeyCback(uint8 keys, uint8 state)
     if ((profile == RTI_PROFILE_ZID) &&
          GET_BIT(rsaPairingEntryBuf.profileDiscs, RCN_PROFILE_DISC_ZID))
     {
-      rsaBuildAndSendZidKeyboardReport( key );
+      (void)rsaBuildAndSendZidKeyboardReport( key );
     }
     else if ((profile == RTI_PROFILE_ZRC) &&
              GET_BIT(rsaPairingEntryBuf.profileDiscs, RCN_PROFILE_DISC_ZRC))
@@ -1312,9 +1388,6 @@ void RSA_BuzzerCompleteCback( void )
  */
 void RSA_MotionSensorCback( int16 gyroMickeysX, int16 gyroMickeysY )
 {
-  /* used to see if any changes in mouse buttons */
-  static uint8 savedMouseButtonStates = 0;
-
   /* Check for no motion for 10 seconds. If true, then place motion detection
    * hardware in standby mode.
    */
@@ -1342,46 +1415,144 @@ void RSA_MotionSensorCback( int16 gyroMickeysX, int16 gyroMickeysY )
     }
   }
 
+  /* Motion is only held back while a report is in flight or being coalesced, and never while
+   * mouse movements are blocked or frozen by a key press.
+   */
+  if ((rsaDestIndex == RTI_INVALID_PAIRING_REF) ||
+      ((rsaState != RSA_STATE_READY) && (rsaState != RSA_STATE_NDATA)) ||
+      (rsaBlockMouseMovements == TRUE) || (rsaKeyPressed == TRUE))
+  {
+    rsaMotionX = 0;
+    rsaMotionY = 0;
+    rsaMotionAge = 0;
+  }
+
+  /* Add the sample to the motion not yet reported */
+  if ((rsaBlockMouseMovements == FALSE) && (rsaKeyPressed == FALSE))
+  {
+    rsaAddMotion(&rsaMotionX, gyroMickeysX);
+    rsaAddMotion(&rsaMotionY, gyroMickeysY);
+  }
+
+  /* The age counts the samples since all motion was last reported */
+  if ((rsaMotionX == 0) && (rsaMotionY == 0))
+  {
+    rsaMotionAge = 0;
+  }
+  else if (rsaMotionAge < 0xFF)
+  {
+    rsaMotionAge++;
+  }
+
   /* Only send a mouse report if we are paired with a target and not currently
-   * communicating with it.
+   * communicating with it, other than with a report frame that is still being built,
+   * and once the motion has been coalesced for the window or fills a report field.
    */
-  if ((rsaDestIndex != RTI_INVALID_PAIRING_REF) && (rsaState == RSA_STATE_READY))
+  if ((rsaDestIndex != RTI_INVALID_PAIRING_REF) && ((rsaState == RSA_STATE_READY) ||
+      ((rsaState == RSA_STATE_NDATA) && zidCld_ReportPending())) &&
+      ((rsaMotionAge >= RSA_MOTION_COALESCE_MAX) ||
+       (rsaMotionX >= ZID_MOUSE_DATA_MAX) || (rsaMotionX <= -ZID_MOUSE_DATA_MAX) ||
+       (rsaMotionY >= ZID_MOUSE_DATA_MAX) || (rsaMotionY <= -ZID_MOUSE_DATA_MAX) ||
+       (rsaMouseButtonStates != rsaSavedMouseButtonStates)))
   {
-    /* Make sure movement data is within bounds of report fields */
-    if (gyroMickeysX > ZID_MOUSE_DATA_MAX)
-    {
-      gyroMickeysX = ZID_MOUSE_DATA_MAX;
-    }
-    else if (gyroMickeysX < -ZID_MOUSE_DATA_MAX)
-    {
-      gyroMickeysX = -ZID_MOUSE_DATA_MAX;
-    }
-    if (gyroMickeysY > ZID_MOUSE_DATA_MAX)
-    {
-      gyroMickeysY = ZID_MOUSE_DATA_MAX;
-    }
-    else if (gyroMickeysY < -ZID_MOUSE_DATA_MAX)
-    {
-      gyroMickeysY = -ZID_MOUSE_DATA_MAX;
-    }
+    rsaSendMotion();
+  }
+}
 
-    /* Only process mouse data if connected to a ZID capable target */
-    if (GET_BIT(rsaPairingEntryBuf.profileDiscs, RCN_PROFILE_DISC_ZID))
+/**************************************************************************************************
+ *
+ * @fn      rsaSendMotion
+ *
+ * @brief   Send the mouse button states and as much of the accumulated motion as fits in one
+ *          ZID mouse report; the remainder is kept, whole, for the next report, which the data
+ *          confirm of this one sends. The motion age only restarts once all of it is reported.
+ *
+ * @param   None
+ *
+ * @return  void
+ */
+static void rsaSendMotion( void )
+{
+  /* Only process mouse data if connected to a ZID capable target */
+  if (GET_BIT(rsaPairingEntryBuf.profileDiscs, RCN_PROFILE_DISC_ZID))
+  {
+    /* Only send the report if something meaningful to report */
+    if ((rsaMouseButtonStates != rsaSavedMouseButtonStates) || // mouse button change
+        (rsaMotionX != 0) || // mouse movement was detected
+        (rsaMotionY != 0))
     {
-      /* Only send the report if something meaningful to report */
-      if ((rsaMouseButtonStates != savedMouseButtonStates) || // mouse button change
-          ((rsaBlockMouseMovements == FALSE) && // mouse movements are allowed
-          (rsaKeyPressed == FALSE) && // freeze mouse movements if key pressed
-          ((gyroMickeysX != 0) || // mouse movement was detected
-          (gyroMickeysY != 0))))
+      int8 mickeysX = rsaTakeMotion(&rsaMotionX);
+      int8 mickeysY = rsaTakeMotion(&rsaMotionY);
+
+      if (rsaBuildAndSendZidMouseReport( rsaMouseButtonStates, mickeysX, mickeysY ))
       {
-        rsaBuildAndSendZidMouseReport( rsaMouseButtonStates,
-                                       (int8)gyroMickeysX,
-                                       (int8)gyroMickeysY );
-        savedMouseButtonStates = rsaMouseButtonStates;
+        if ((rsaMotionX == 0) && (rsaMotionY == 0))
+        {
+          rsaMotionAge = 0;
+        }
+        rsaSavedMouseButtonStates = rsaMouseButtonStates;
+      }
+      else
+      {
+        /* The pending report frame went out instead; keep the motion for the next one */
+        rsaAddMotion(&rsaMotionX, mickeysX);
+        rsaAddMotion(&rsaMotionY, mickeysY);
       }
     }
   }
+  else
+  {
+    rsaMotionX = 0;
+    rsaMotionY = 0;
+  }
+}
+
+/**************************************************************************************************
+ *
+ * @fn      rsaAddMotion
+ *
+ * @brief   Add motion along one axis to the motion not yet reported, saturating rather than
+ *          wrapping.
+ *
+ * @param   pMotion - accumulated motion along the axis
+ *          mickeys - motion to add
+ *
+ * @return  void
+ */
+static void rsaAddMotion( int16 *pMotion, int16 mickeys )
+{
+  int32 sum = (int32)*pMotion + mickeys;
+
+  *pMotion = (sum > 0x7FFF) ? 0x7FFF : ((sum < -0x7FFF) ? -0x7FFF : (int16)sum);
+}
+
+/**************************************************************************************************
+ *
+ * @fn      rsaTakeMotion
+ *
+ * @brief   Take the part of the accumulated motion along one axis that fits in the report field.
+ *
+ * @param   pMotion - accumulated motion along the axis, reduced by the part taken
+ *
+ * @return  The motion to report, within +/-ZID_MOUSE_DATA_MAX
+ */
+static int8 rsaTakeMotion( int16 *pMotion )
+{
+  int16 mickeys = *pMotion;
+
+  /* Make sure movement data is within bounds of report fields */
+  if (mickeys > ZID_MOUSE_DATA_MAX)
+  {
+    mickeys = ZID_MOUSE_DATA_MAX;
+  }
+  else if (mickeys < -ZID_MOUSE_DATA_MAX)
+  {
+    mickeys = -ZID_MOUSE_DATA_MAX;
+  }
+
+  *pMotion -= mickeys;
+
+  return (int8)mickeys;
 }
 
 /**************************************************************************************************
@@ -1394,19 +1565,17 @@ void RSA_MotionSensorCback( int16 gyroMickeysX, int16 gyroMickeysY )
  *          mickeysX - amount of mouse movement along X-axis in units of Mickeys (1/200 of an inch)
  *          mickeysY - amount of mouse movement along Y-axis
  *
- * @return  void
+ * @return  TRUE if the report was taken; FALSE if it has to be sent again after the data confirm
  */
-static void rsaBuildAndSendZidMouseReport( uint8 mouseStates, int8 mickeysX, int8 mickeysY )
+static uint8 rsaBuildAndSendZidMouseReport( uint8 mouseStates, int8 mickeysX, int8 mickeysY )
 {
-  uint8 buf[ZID_MOUSE_DATA_LEN + sizeof(zid_report_data_cmd_t) + sizeof(zid_report_record_t)];
-  zid_report_data_cmd_t *pReport = (zid_report_data_cmd_t *)buf;
-  zid_report_record_t *pRecord = (zid_report_record_t *)&pReport->reportRecordList[0];
+  uint8 buf[ZID_MOUSE_DATA_LEN + sizeof(zid_report_record_t)];
+  zid_report_record_t *pRecord = (zid_report_record_t *)buf;
   zid_mouse_data_t *pMouse = (zid_mouse_data_t *)(&pRecord->data[0]);
   // Set reliable control pipe mode for mouse click (i.e. like a keyboard key press).
   uint8 txOptions = (mouseStates==0) ? ZID_TX_OPTIONS_INTERRUPT_PIPE : ZID_TX_OPTIONS_CONTROL_PIPE;
 
   /* Rapid mouse movements should go OTA via Interrupt transmission model, no broadcast */
-  pReport->cmd = ZID_CMD_REPORT_DATA;
   pRecord->len = sizeof(zid_report_record_t) + ZID_MOUSE_DATA_LEN - 1;
   pRecord->type = ZID_REPORT_TYPE_IN;
   pRecord->id = ZID_STD_REPORT_MOUSE;
@@ -1414,14 +1583,9 @@ static void rsaBuildAndSendZidMouseReport( uint8 mouseStates, int8 mickeysX, int
   pMouse->x = mickeysX;
   pMouse->y = mickeysY;
 
-  /* Send report */
+  /* Send report, possibly in one frame with other reports given shortly before or after */
   rsaState = RSA_STATE_NDATA;
-  RTI_SendDataReq( rsaDestIndex,
-                   RTI_PROFILE_ZID,
-                   RTI_VENDOR_TEXAS_INSTRUMENTS,
-                   txOptions,
-                   sizeof( buf ),
-                   buf );
+  return zidCld_SendReport( rsaDestIndex, txOptions, pRecord );
 }
 
 /**************************************************************************************************
@@ -1432,18 +1596,18 @@ static void rsaBuildAndSendZidMouseReport( uint8 mouseStates, int8 mickeysX, int
  *
  * @param   key  - key that was pressed
  *
- * @return  void
+ * @return  TRUE if the report was taken; FALSE if it is given again after the data confirm or,
+ *          when no report frame went out instead, dropped
  */
-static void rsaBuildAndSendZidKeyboardReport( uint8 key )
+static uint8 rsaBuildAndSendZidKeyboardReport( uint8 key )
 {
-  uint8 buf[ZID_KEYBOARD_DATA_LEN + sizeof(zid_report_data_cmd_t) + sizeof(zid_report_record_t)];
-  zid_report_data_cmd_t *pReport = (zid_report_data_cmd_t *)buf;
-  zid_report_record_t *pRecord = (zid_report_record_t *)&pReport->reportRecordList[0];
+  uint8 pending = zidCld_ReportPending();
+  uint8 buf[ZID_KEYBOARD_DATA_LEN + sizeof(zid_report_record_t)];
+  zid_report_record_t *pRecord = (zid_report_record_t *)buf;
   zid_keyboard_data_t *pKeyboard = (zid_keyboard_data_t *)(&pRecord->data[0]);
   uint8 txOptions = ZID_TX_OPTIONS_CONTROL_PIPE;
 
   /* Keyboard reports should go OTA via reliable Control transmission model, no broadcast */
-  pReport->cmd = ZID_CMD_REPORT_DATA;
   pRecord->len = sizeof(zid_report_record_t) + ZID_KEYBOARD_DATA_LEN - 1;
   pRecord->type = ZID_REPORT_TYPE_IN;
   pRecord->id = ZID_STD_REPORT_KEYBOARD;
@@ -1456,14 +1620,26 @@ static void rsaBuildAndSendZidKeyboardReport( uint8 key )
   pKeyboard->keys[4] = 0;
   pKeyboard->keys[5] = 0;
 
-  /* Send report */
+  /* Send report, possibly in one frame with other reports given shortly before or after */
   rsaState = RSA_STATE_NDATA;
-  RTI_SendDataReq( rsaDestIndex,
-                   RTI_PROFILE_ZID,
-                   RTI_VENDOR_TEXAS_INSTRUMENTS,
-                   txOptions,
-                   sizeof( buf ),
-                   buf );
+  if (zidCld_SendReport( rsaDestIndex, txOptions, pRecord ))
+  {
+    return TRUE;
+  }
+
+  if (pending)
+  {
+    /* The pending report frame went out instead; give the key again after its data confirm */
+    rsaKeyRetry = key;
+    rsaKeyRetryPending = TRUE;
+  }
+  else
+  {
+    /* Nothing went out, so no data confirm will bring the state back */
+    rsaState = RSA_STATE_READY;
+  }
+
+  return FALSE;
 }
 #endif
 
@@ -0,0 +1,515 @@
+/**************************************************************************************************
+  Filename:       rsa_motion_replay.c
+
+  Description:    Host replay of recorded gyro traces through the air-mouse motion accumulator of
+                  rsa_point.c, against a simulated ZID report link, measuring how far the
+                  reported cursor ends up from the motion that was recorded.
+
+  Usage:          rsa_motion_replay <trace> [<trace> ...]
+
+                  A trace holds one gyro sample per line, "<x> <y>" in Mickeys per 10 ms, as
+                  given to RSA_MotionSensorCback(); lines starting with '#' are comments.
+                  Every trace is replayed over each link profile below. The exit status is 1 if
+                  any run breaks one of the checks printed with it.
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal_key.h"
+#include "hal_motion.h"
+#include "hal_buzzer.h"
+#include "OSAL.h"
+#include "OSAL_Timers.h"
+#include "OSAL_PwrMgr.h"
+#include "rti.h"
+#include "zid_common.h"
+#include "zid_class_device.h"
+#include "zid_profile.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ */
+
+#define REPLAY_SAMPLE_MS          10
+#define REPLAY_MAX_SAMPLES        10000
+
+// Motion along an axis that a run may leave unreported beyond the full rate link: the report still
+// in flight at the end, and one for the phase of the link against the samples.
+#define REPLAY_SLACK              (2 * ZID_MOUSE_DATA_MAX)
+
+/**************************************************************************************************
+ *                                           Typedefs
+ */
+
+// A simulated link: the time a Report Data frame takes to its data confirm and the time a report
+// record is held for others to share its frame, as zidCld_SendReport() does with
+// ZID_CLD_BATCH_TIME.
+typedef struct
+{
+  const char *name;
+  uint16 cnfMs;
+  uint16 batchMs;
+} replayLink_t;
+
+typedef struct
+{
+  int32 inX, inY;        // Motion recorded
+  int32 outX, outY;      // Motion reported
+  uint32 inPath;         // Path length recorded, in Mickeys
+  uint32 reports;        // Mouse report records sent
+  uint32 retries;        // Records that zidCld_SendReport() refused for the pending frame
+  int32 lagX, lagY;      // Motion that a link reporting at its full rate would still hold
+  uint32 lastInMs;       // Time of the last sample with motion
+  uint32 lastInLag;      // Motion not yet reported then, along the axis with more of it
+  uint32 lastOutMs;      // Time of the last report with motion
+} replayStats_t;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ */
+
+static const replayLink_t replayLinks[] =
+{
+  { "idle",    4,  0 },
+  { "busy",   25,  0 },
+  { "batch",  25, 15 },
+  { "slow",   60,  0 },
+};
+
+static int16 replaySamples[REPLAY_MAX_SAMPLES][2];
+static uint16 replayCnt;
+
+static const replayLink_t *pLink;
+static replayStats_t stats;
+static uint32 nowMs;
+static uint16 rsaEvents;
+static halMotionCBack_t motionCback;
+
+// Report Data frame being held and the frame waiting for its data confirm.
+static uint8 heldValid;
+static uint32 heldUntil;
+static int16 heldX, heldY;
+static uint8 flightValid;
+static uint32 flightUntil;
+static int16 flightX, flightY;
+
+volatile uint8 halHostEA = 1;
+const uint8 ZID_StdReportLen[ZID_STD_REPORT_TOTAL_NUM+1];
+
+extern void RSA_Init(uint8 taskId);
+extern uint16 RSA_ProcessEvent(uint8 taskId, uint16 events);
+
+/**************************************************************************************************
+ *                                 Simulated OSAL, HAL and RTI
+ */
+
+uint8 osal_set_event(uint8 task_id, uint16 event_flag)
+{
+  (void)task_id;
+  rsaEvents |= event_flag;
+  return SUCCESS;
+}
+
+uint8 osal_start_timerEx(uint8 task_id, uint16 event_id, uint16 timeout_value)
+{
+  (void)task_id; (void)event_id; (void)timeout_value;
+  return SUCCESS;
+}
+
+uint8 osal_stop_timerEx(uint8 task_id, uint16 event_id)
+{
+  (void)task_id; (void)event_id;
+  return SUCCESS;
+}
+
+uint32 osal_GetSystemClock(void)
+{
+  return nowMs;
+}
+
+uint8 osal_pwrmgr_task_state(uint8 task_id, uint8 state)
+{
+  (void)task_id; (void)state;
+  return SUCCESS;
+}
+
+uint8 *osal_msg_receive(uint8 task_id)
+{
+  (void)task_id;
+  return NULL;
+}
+
+uint8 osal_msg_deallocate(uint8 *msg_ptr)
+{
+  (void)msg_ptr;
+  return SUCCESS;
+}
+
+void *osal_mem_alloc(uint16 size)
+{
+  return malloc(size);
+}
+
+void osal_mem_free(void *ptr)
+{
+  free(ptr);
+}
+
+void *osal_memcpy(void *dst, const void *src, unsigned int len)
+{
+  return (uint8 *)memcpy(dst, src, len) + len;
+}
+
+void *osal_memset(void *dest, uint8 value, int len)
+{
+  return memset(dest, value, len);
+}
+
+uint16 osal_rand(void)
+{
+  return (uint16)rand();
+}
+
+void HalKeyConfig(bool interruptEnable, const halKeyCBack_t cback)
+{
+  (void)interruptEnable; (void)cback;
+}
+
+void HalMotionConfig(halMotionCBack_t measCback)
+{
+  motionCback = measCback;
+}
+
+void HalMotionEnable(void) {}
+void HalMotionDisable(void) {}
+void HalMotionStandby(void) {}
+void HalMotionModifyAirMouseResolution(halMotionMouseResolution_t action) { (void)action; }
+
+void HalMotionCal(halMotionCalCBack_t calCback, uint16 calDuration)
+{
+  (void)calCback; (void)calDuration;
+}
+
+void HalBuzzerRing(uint16 msec, halBuzzerCBack_t buzzerCback)
+{
+  (void)msec; (void)buzzerCback;
+}
+
+void RTI_InitReq(void) {}
+void RTI_EnableSleepReq(void) {}
+void RTI_PairReq(void) {}
+void RTI_PairAbortReq(void) {}
+void RTI_UnpairReq(uint8 dstIndex) { (void)dstIndex; }
+void RTI_RxEnableReq(uint16 duration) { (void)duration; }
+void RTI_SwResetReq(void) { abort(); }
+
+void RTI_SendDataReq(uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions,
+                     uint8 len, uint8 *pData)
+{
+  (void)dstIndex; (void)profileId; (void)vendorId; (void)txOptions; (void)len; (void)pData;
+}
+
+rStatus_t RTI_ReadItemEx(uint8 profileId, uint8 itemId, uint8 len, uint8 *pValue)
+{
+  (void)profileId;
+
+  if (itemId == RTI_CONST_ITEM_MAX_PAIRING_TABLE_ENTRIES)
+  {
+    *pValue = 1;
+  }
+  else if (itemId == RTI_SA_ITEM_PT_CURRENT_ENTRY)
+  {
+    rcnNwkPairingEntry_t *pEntry = (rcnNwkPairingEntry_t *)pValue;
+
+    memset(pValue, 0, len);
+    SET_BIT(pEntry->profileDiscs, RCN_PROFILE_DISC_ZID);
+  }
+
+  return RTI_SUCCESS;
+}
+
+rStatus_t RTI_WriteItemEx(uint8 profileId, uint8 itemId, uint8 len, uint8 *pValue)
+{
+  (void)profileId; (void)itemId; (void)len; (void)pValue;
+  return RTI_SUCCESS;
+}
+
+/**************************************************************************************************
+ *                                   Simulated ZID report link
+ */
+
+static void linkSend(int16 x, int16 y)
+{
+  flightValid = TRUE;
+  flightUntil = nowMs + pLink->cnfMs;
+  flightX = x;
+  flightY = y;
+}
+
+uint8 zidCld_ReportPending(void)
+{
+  return heldValid;
+}
+
+uint8 zidCld_SendReport(uint8 dstIndex, uint8 txOptions, zid_report_record_t *pRecord)
+{
+  zid_mouse_data_t *pMouse = (zid_mouse_data_t *)pRecord->data;
+
+  (void)dstIndex; (void)txOptions;
+
+  if (pRecord->id != ZID_STD_REPORT_MOUSE)
+  {
+    return TRUE;
+  }
+
+  if (heldValid)
+  {
+    // The held frame already has a mouse record, so it goes out and the new one is refused.
+    heldValid = FALSE;
+    linkSend(heldX, heldY);
+    stats.retries++;
+    return FALSE;
+  }
+
+  if (flightValid)
+  {
+    fprintf(stderr, "%6u ms: report given while a frame is waiting for its confirm\n",
+            (unsigned)nowMs);
+    exit(2);
+  }
+
+  stats.reports++;
+  if (pLink->batchMs != 0)
+  {
+    heldValid = TRUE;
+    heldUntil = nowMs + pLink->batchMs;
+    heldX = (int8)pMouse->x;
+    heldY = (int8)pMouse->y;
+  }
+  else
+  {
+    linkSend((int8)pMouse->x, (int8)pMouse->y);
+  }
+
+  return TRUE;
+}
+
+/**************************************************************************************************
+ *                                            Replay
+ */
+
+static void runEvents(void)
+{
+  while (rsaEvents != 0)
+  {
+    uint16 events = rsaEvents;
+
+    rsaEvents = 0;
+    rsaEvents |= RSA_ProcessEvent(0, events);
+  }
+}
+
+static void linkTick(void)
+{
+  if (heldValid && (nowMs >= heldUntil))
+  {
+    heldValid = FALSE;
+    linkSend(heldX, heldY);
+  }
+
+  if (flightValid && (nowMs >= flightUntil))
+  {
+    flightValid = FALSE;
+    stats.outX += flightX;
+    stats.outY += flightY;
+    if ((flightX != 0) || (flightY != 0))
+    {
+      stats.lastOutMs = nowMs;
+    }
+    RTI_SendDataCnf(RTI_SUCCESS);
+  }
+}
+
+static int loadTrace(const char *path)
+{
+  FILE *fp = fopen(path, "r");
+  char line[128];
+  int x, y;
+
+  if (fp == NULL)
+  {
+    perror(path);
+    return -1;
+  }
+
+  replayCnt = 0;
+  while (fgets(line, sizeof(line), fp) != NULL)
+  {
+    if ((line[0] == '#') || (sscanf(line, "%d %d", &x, &y) != 2))
+    {
+      continue;
+    }
+    if (replayCnt == REPLAY_MAX_SAMPLES)
+    {
+      fprintf(stderr, "%s: more than %d samples\n", path, REPLAY_MAX_SAMPLES);
+      break;
+    }
+    replaySamples[replayCnt][0] = (int16)x;
+    replaySamples[replayCnt][1] = (int16)y;
+    replayCnt++;
+  }
+
+  fclose(fp);
+  return 0;
+}
+
+static int32 drainLag(int32 lag)
+{
+  return (lag > ZID_MOUSE_DATA_MAX) ? lag - ZID_MOUSE_DATA_MAX :
+         ((lag < -ZID_MOUSE_DATA_MAX) ? lag + ZID_MOUSE_DATA_MAX : 0);
+}
+
+static void replay(uint32 perMs)
+{
+  uint32 endMs = (uint32)replayCnt * REPLAY_SAMPLE_MS + 1000;
+  uint16 idx = 0;
+
+  memset(&stats, 0, sizeof(stats));
+  heldValid = flightValid = FALSE;
+  rsaEvents = 0;
+  nowMs = 0;
+
+  // rsa_point.c keeps its state in statics, so each run starts it afresh from RSA_Init().
+  RSA_Init(0);
+  runEvents();
+  RTI_InitCnf(RTI_SUCCESS);
+  runEvents();
+
+  for (nowMs = 0; nowMs < endMs; nowMs++)
+  {
+    linkTick();
+    runEvents();
+
+    if ((nowMs % perMs) == 0)
+    {
+      stats.lagX = drainLag(stats.lagX);
+      stats.lagY = drainLag(stats.lagY);
+    }
+
+    if ((nowMs % REPLAY_SAMPLE_MS) == 0)
+    {
+      int16 x = 0, y = 0;
+
+      if (idx < replayCnt)
+      {
+        x = replaySamples[idx][0];
+        y = replaySamples[idx][1];
+        idx++;
+      }
+
+      stats.inX += x;
+      stats.inY += y;
+      stats.lagX += x;
+      stats.lagY += y;
+      stats.inPath += abs(x) + abs(y);
+      if ((x != 0) || (y != 0))
+      {
+        stats.lastInMs = nowMs;
+        stats.lastInLag = abs(stats.inX - stats.outX);
+        if (stats.lastInLag < (uint32)abs(stats.inY - stats.outY))
+        {
+          stats.lastInLag = abs(stats.inY - stats.outY);
+        }
+      }
+
+      motionCback(x, y);
+      runEvents();
+    }
+  }
+
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       Replay each trace over each link profile, print the cursor error and check that
+ *              - the motion left unreported at the end along each axis is no more than a link
+ *                that sends a report of up to ZID_MOUSE_DATA_MAX every confirm or sample, with
+ *                nothing else in the way, would have left over the whole run, give or take
+ *                REPLAY_SLACK, and
+ *              - motion stops being reported no later than the coalescing window, plus the
+ *                reports needed to drain what was held back at the last moving sample.
+ */
+int main(int argc, char **argv)
+{
+  int fail = 0;
+  int arg;
+  unsigned idx;
+
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s <trace> [<trace> ...]\n", argv[0]);
+    return 2;
+  }
+
+  printf("%-16s %-6s %11s %11s %7s %7s %8s %7s %8s  %s\n", "trace", "link", "in x,y", "out x,y",
+         "error", "err %", "reports", "retries", "tail ms", "checks");
+
+  for (arg = 1; arg < argc; arg++)
+  {
+    const char *name = strrchr(argv[arg], '/') ? strrchr(argv[arg], '/') + 1 : argv[arg];
+
+    if (loadTrace(argv[arg]) != 0)
+    {
+      return 2;
+    }
+
+    for (idx = 0; idx < sizeof(replayLinks) / sizeof(replayLinks[0]); idx++)
+    {
+      uint32 span, perMs, tailMax;
+      int32 ex, ey;
+      uint32 tail, err;
+      const char *check = "ok";
+
+      pLink = &replayLinks[idx];
+      span = pLink->cnfMs + pLink->batchMs;
+      // A report goes out at least once per confirm or per sample, whichever is later.
+      perMs = (span > REPLAY_SAMPLE_MS) ? span : REPLAY_SAMPLE_MS;
+
+      replay(perMs);
+      tailMax = (RSA_MOTION_COALESCE_MAX + 1) * REPLAY_SAMPLE_MS + span +
+                (stats.lastInLag + ZID_MOUSE_DATA_MAX - 1) / ZID_MOUSE_DATA_MAX * perMs;
+
+      ex = stats.inX - stats.outX;
+      ey = stats.inY - stats.outY;
+      err = abs(ex) + abs(ey);
+      tail = (stats.lastOutMs > stats.lastInMs) ? stats.lastOutMs - stats.lastInMs : 0;
+
+      if ((abs(ex) > abs(stats.lagX) + REPLAY_SLACK) || (abs(ey) > abs(stats.lagY) + REPLAY_SLACK))
+      {
+        check = "FAIL: motion lost that the reports could carry";
+        fail = 1;
+      }
+      else if (tail > tailMax)
+      {
+        check = "FAIL: cursor kept moving after the motion held back was drained";
+        fail = 1;
+      }
+
+      printf("%-16s %-6s %5d,%-5d %5d,%-5d %7u %6.1f%% %8u %7u %8u  %s\n", name, pLink->name,
+             (int)stats.inX, (int)stats.inY, (int)stats.outX, (int)stats.outY, (unsigned)err,
+             stats.inPath ? 100.0 * err / stats.inPath : 0.0, (unsigned)stats.reports,
+             (unsigned)stats.retries, (unsigned)tail, check);
+    }
+  }
+
+  return fail;
+}
+
+/**************************************************************************************************
+*/
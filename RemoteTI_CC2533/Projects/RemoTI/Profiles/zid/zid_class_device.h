@@ -24,6 +24,19 @@ extern "C" {
 
 #define ZID_CLD_EVT_CFG                    0x4000
 #define ZID_CLD_EVT_SAFE_TX                0x0020
+#define ZID_CLD_EVT_BATCH                  0x0040
+#define ZID_CLD_EVT_CFG_WINDOW             0x0080
+
+// Time in msec that zidCld_SendReport() holds a report record so that others given meanwhile
+// go in the same Report Data command frame; zero sends each record in a frame of its own.
+#if !defined ZID_CLD_BATCH_TIME
+#define ZID_CLD_BATCH_TIME                 0
+#endif
+
+// Largest Report Data command frame built by zidCld_SendReport(); must fit the network payload.
+#if !defined ZID_CLD_BATCH_LEN
+#define ZID_CLD_BATCH_LEN                  32
+#endif
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Typedefs
@@ -153,6 +166,46 @@ uint16 zidCld_ProcessEvent(uint8 taskId, uint16 events);
  */
 uint8 zidCld_SendDataReq(uint8 dstIndex, uint8 txOptions, uint8 *cmd);
 
+/**************************************************************************************************
+ * @fn          zidCld_SendReport
+ *
+ * @brief       This API is used to send a report record in a ZID Report Data command frame.
+ *              The record is held for up to ZID_CLD_BATCH_TIME so that the records given
+ *              meanwhile share the frame, which is then sent by RTI_SendDataReq(); one
+ *              RTI_SendDataCnf() follows for the whole frame.
+ *
+ * input parameters
+ *
+ * @param       dstIndex  - Pairing table index of target.
+ * @param       txOptions - Bit mask according to the ZID_TX_OPTION_... definitions.
+ * @param       *pRecord  - A pointer to the report record.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if the record was taken; FALSE if it could not join the pending frame, which
+ *              is then sent at once, and has to be given again after its RTI_SendDataCnf().
+ */
+uint8 zidCld_SendReport(uint8 dstIndex, uint8 txOptions, zid_report_record_t *pRecord);
+
+/**************************************************************************************************
+ * @fn          zidCld_ReportPending
+ *
+ * @brief       This API is used to check whether report records are being held for a frame.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if zidCld_SendReport() can add a record to a frame not yet sent.
+ */
+uint8 zidCld_ReportPending(void);
+
 /**************************************************************************************************
  * @fn      zidCld_ReceiveDataInd
  *
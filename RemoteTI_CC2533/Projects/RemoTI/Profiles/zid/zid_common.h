@@ -61,7 +61,20 @@ extern "C" {
 #define ZID_EVT_RSP_WAIT                   0x0010
 
 // A ZID proxy must limit the number of paired ZID devices to the maximum number that it can proxy.
+#if !defined ZID_COMMON_MAX_NUM_PROXIED_DEVICES
 #define ZID_COMMON_MAX_NUM_PROXIED_DEVICES                1
+#endif
+
+// Number of configuration push frames that a Class Device may send per Adapter response. All but
+// the last frame of a window carry the GDP data pending bit and are acknowledged by the response to
+// that last one; only a failure is answered at once. A window is used only when both ends offer one
+// by ZID_ATTR_CFG_WINDOW, so other peers keep the stop-and-wait exchange of the ZID specification.
+#if !defined ZID_CFG_WINDOW
+#define ZID_CFG_WINDOW                     1
+#endif
+
+// TI proprietary attribute, not defined by the ZID specification, carrying ZID_CFG_WINDOW (uint8).
+#define ZID_ATTR_CFG_WINDOW                0xAF
 
 // Maximum number of non standard descriptor fragments per non standard descriptor
 #define ZID_MAX_NON_STD_DESC_FRAGS_PER_DESC    ((aplcMaxNonStdDescCompSize + aplcMaxNonStdDescFragmentSize - 1) / aplcMaxNonStdDescFragmentSize)
@@ -107,6 +120,13 @@ extern "C" {
 #define ZID_NVID_INVALID       0x00        // Failure return value for DescSpecN NV Id lookup.
 #define ZID_TABLE_IDX_INVALID  0xFF        // Failure return value for the table index lookup.
 
+// The zid_table_t attribute tables are indexed directly by the attribute Id: one entry for each Id
+// from aplZIDProfileVersion to aplReportRepeatInterval, then one for each Id from
+// aplHIDParserVersion to aplHIDNumNonStdDescComps, with ZID_TABLE_ENTRY_UNUSED for the Ids not held.
+#define ZID_ATTR_TABLE_HID_IDX (aplReportRepeatInterval - aplZIDProfileVersion + 1)
+#define ZID_ATTR_TABLE_LEN     (ZID_ATTR_TABLE_HID_IDX + aplHIDNumNonStdDescComps - aplHIDParserVersion + 1)
+#define ZID_TABLE_ENTRY_UNUSED { 0, 0, 0 }
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Typedefs
  * ------------------------------------------------------------------------------------------------
@@ -162,7 +182,7 @@ typedef enum {
   eZidStatDiscCnfing,    // Confirming: ZID message sent Control Pipe.
   eZidStatDiscRsping,    // Responding: ZID response expected within aplcMaxResponseWaitTime.
   eZidStatDiscUnsafe,    // Within the Interrupt Pipe Unsafe Tx Window time.
-  eZidStatDiscSpare4,
+  eZidStatDiscWindow,    // Windowing: ZID config push acknowledged with the later ones.
   eZidStatDiscSpare5,
   eZidStatDiscStandby,   // Was in standby mode (when acting as Target device) before wait for Rsp.
   eZidStatDiscTarget     // Acting as a Target vice Controller device.
@@ -218,6 +238,9 @@ typedef enum {
 #define ZID_IS_RSPING          GET_BIT(&zidStatDisc, eZidStatDiscRsping)
 #define ZID_SET_RSPING()       SET_BIT(&zidStatDisc, eZidStatDiscRsping)
 #define ZID_CLR_RSPING()       CLR_BIT(&zidStatDisc, eZidStatDiscRsping)
+#define ZID_IS_WINDOW          GET_BIT(&zidStatDisc, eZidStatDiscWindow)
+#define ZID_SET_WINDOW()       SET_BIT(&zidStatDisc, eZidStatDiscWindow)
+#define ZID_CLR_WINDOW()       CLR_BIT(&zidStatDisc, eZidStatDiscWindow)
 #define ZID_IS_UNSAFE          GET_BIT(&zidStatDisc, eZidStatDiscUnsafe)
 #define ZID_SET_UNSAFE()       SET_BIT(&zidStatDisc, eZidStatDiscUnsafe)
 #define ZID_CLR_UNSAFE()       CLR_BIT(&zidStatDisc, eZidStatDiscUnsafe)
@@ -568,6 +591,25 @@ uint8 zidCommon_GetLastNonStdDescCompFragNum( void );
  */
 uint8 zidCommon_specCheckWrite(uint8 attrId, uint8 len, uint8 *pValue);
 
+/**************************************************************************************************
+ * @fn          zidCommon_GetAttrTableIdx
+ *
+ * @brief       Resolve the index in a ZID_ATTR_TABLE_LEN attribute table of the attribute 'attrId'.
+ *
+ * input parameters
+ *
+ * @param       pTable - The attribute table.
+ * @param       attrId - The ZID Attribute identifier.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      ZID_TABLE_IDX_INVALID if the table does not hold the attribute.
+ *              Otherwise, the index into the table.
+ */
+uint8 zidCommon_GetAttrTableIdx(const zid_table_t *pTable, uint8 attrId);
+
 #ifdef __cplusplus
 };
 #endif
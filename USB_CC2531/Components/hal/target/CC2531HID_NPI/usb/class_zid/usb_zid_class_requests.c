@@ -11,6 +11,9 @@
 * INCLUDES
 */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_USB_ZID
+
 #include "usb_descriptor.h"
 #include "usb_framework.h"
 #include "usb_zid_class_requests.h"
@@ -125,7 +128,7 @@ void usbcrSetProtocol(void)
     // Sanity check setup request parameters
     if ((usbSetupHeader.value & 0xFFFE) ||
         (usbSetupHeader.length != 0) ||
-          (usbSetupHeader.index > ZID_IFCE_INDEX)) {
+          (usbSetupHeader.index > ZID_IFCE_INDEX_LAST)) {
 
             // Unsupported: Stall the request
             usbfwData.ep0Status = EP_STALL;
@@ -161,7 +164,7 @@ void usbcrGetProtocol(void)
     // Sanity check setup request parameters
     if ((usbSetupHeader.value != 0) ||
         (usbSetupHeader.length != 1) ||
-          (usbSetupHeader.index > ZID_IFCE_INDEX)) {
+          (usbSetupHeader.index > ZID_IFCE_INDEX_LAST)) {
 
             // Unsupported: Stall the request
             usbfwData.ep0Status = EP_STALL;
@@ -209,7 +212,8 @@ void usbcrSetIdle(void)
 
     // Sanity check setup request parameters
     if ((usbSetupHeader.length != 0) ||
-        (usbSetupHeader.index != ZID_IFCE_INDEX)) {
+        (usbSetupHeader.index < ZID_IFCE_INDEX) ||
+        (usbSetupHeader.index > ZID_IFCE_INDEX_LAST)) {
 
           // Unsupported: Stall the request
           usbfwData.ep0Status = EP_STALL;
@@ -221,15 +225,9 @@ void usbcrSetIdle(void)
           */
           uint8 value;
           //uint8 idleRate = HI_UINT16(usbSetupHeader.value);
-          switch (LO_UINT16(usbSetupHeader.index)) {
-
-          case ZID_IFCE_INDEX:
-            value = HI_UINT16(usbSetupHeader.value);
-            zidPxyServeHIDClassRequests(SET_IDLE, (uint8*) &value);
-            break;
-          default:
-            break;
-          }
+          // The proxy finds the device from the interface in usbSetupHeader.index.
+          value = HI_UINT16(usbSetupHeader.value);
+          zidPxyServeHIDClassRequests(SET_IDLE, (uint8*) &value);
 
           // This request has only a setup stage (no data stage)
           return;
@@ -256,7 +254,7 @@ void usbcrGetIdle(void)
 
         // Sanity check setup request parameters
         if ((usbSetupHeader.length != 1) ||
-            (usbSetupHeader.index > ZID_IFCE_INDEX)) {
+            (usbSetupHeader.index > ZID_IFCE_INDEX_LAST)) {
 
             // Unsupported: Stall the request
             usbfwData.ep0Status = EP_STALL;
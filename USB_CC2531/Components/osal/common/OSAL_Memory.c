@@ -16,6 +16,12 @@
 extern int dprintf(const char *fmt, ...);
 #endif /* DPRINTF_HEAPTRACE */
 
+#if ( OSALMEM_TRACE ) && !defined ( DPRINTF_OSALHEAPTRACE )
+// This module defines the real entry points that the trace macros stand in for.
+#undef osal_mem_alloc
+#undef osal_mem_free
+#endif
+
 #if ( MAXMEMHEAP >= 32768 )
   #error MAXMEMHEAP is too big to manage!
 #endif
@@ -32,6 +38,41 @@ extern int dprintf(const char *fmt, ...);
   #define OSALMEM_SMALL_BLKSZ  16
 #endif
 
+/* Fixed-size block pools serve the few allocation sizes that dominate at run
+ * time in O(1) and without fragmenting the heap; any request that does not
+ * fit, or finds its pool empty, falls back to the heap. Each pool is a block
+ * size (in bytes, as requested from osal_mem_alloc) and a count of blocks;
+ * a count of zero disables the pool. Pools must be listed in increasing
+ * block size.
+ */
+#if !defined ( OSALMEM_POOLS )
+  #define OSALMEM_POOLS        FALSE
+#endif
+
+#if ( OSALMEM_POOLS )
+  #if !defined ( OSALMEM_POOL0_BLKSZ )
+    #define OSALMEM_POOL0_BLKSZ   16
+  #endif
+  #if !defined ( OSALMEM_POOL0_BLKCNT )
+    #define OSALMEM_POOL0_BLKCNT  8
+  #endif
+  #if !defined ( OSALMEM_POOL1_BLKSZ )
+    #define OSALMEM_POOL1_BLKSZ   32
+  #endif
+  #if !defined ( OSALMEM_POOL1_BLKCNT )
+    #define OSALMEM_POOL1_BLKCNT  6
+  #endif
+  // Large enough for a full NPI frame in an OSAL message.
+  #if !defined ( OSALMEM_POOL2_BLKSZ )
+    #define OSALMEM_POOL2_BLKSZ   140
+  #endif
+  #if !defined ( OSALMEM_POOL2_BLKCNT )
+    #define OSALMEM_POOL2_BLKCNT  2
+  #endif
+
+  #define OSALMEM_POOL_CNT        3
+#endif
+
 #if !defined ( OSALMEM_NODEBUG )
   #define OSALMEM_NODEBUG      TRUE
 #endif
@@ -40,6 +81,13 @@ extern int dprintf(const char *fmt, ...);
   #define OSALMEM_PROFILER     FALSE
 #endif
 
+#if ( OSALMEM_TRACE )
+  // Number of records kept in the trace ring buffer.
+  #if !defined ( OSALMEM_TRACE_CNT )
+    #define OSALMEM_TRACE_CNT  32
+  #endif
+#endif
+
 #if ( OSALMEM_PROFILER )
   #define OSALMEM_INIT   'X'
   #define OSALMEM_ALOC   'A'
@@ -73,6 +121,26 @@ extern int dprintf(const char *fmt, ...);
 
 typedef uint16  osalMemHdr_t;
 
+#if ( OSALMEM_POOLS )
+typedef struct
+{
+  uint16 blkSz;   // Block size, rounded up to the data alignment.
+  uint8  blkCnt;  // Number of blocks.
+} osalMemPoolCfg_t;
+
+typedef struct
+{
+  void  *free;    // Free list - the link is kept in the first bytes of a free block.
+  uint8 *beg;     // First block.
+  uint8 *end;     // Just past the last block.
+#if ( OSALMEM_METRICS )
+  uint8  cur;     // Current cnt of blocks in use.
+  uint8  max;     // Max cnt of blocks ever in use at once.
+  uint16 fail;    // Cnt of allocations that fell back to the heap because the pool was empty.
+#endif
+} osalMemPool_t;
+#endif
+
 /*********************************************************************
  * CONSTANTS
  */
@@ -90,6 +158,17 @@ typedef uint16  osalMemHdr_t;
 #define HDRSZ  ( (sizeof ( halDataAlign_t ) > sizeof( osalMemHdr_t )) ? \
                   sizeof ( halDataAlign_t ) : sizeof( osalMemHdr_t ) )
 
+#if ( OSALMEM_POOLS )
+// Pool block size rounded up so that every block stays aligned and can hold the free list link.
+#define OSALMEM_POOL_ALIGN( sz )  ( ((((sz) < sizeof( void * )) ? sizeof( void * ) : (sz)) + \
+                                     sizeof( halDataAlign_t ) - 1) / sizeof( halDataAlign_t ) * \
+                                     sizeof( halDataAlign_t ) )
+
+#define OSALMEM_POOL_BYTES  ( OSALMEM_POOL_ALIGN( OSALMEM_POOL0_BLKSZ ) * OSALMEM_POOL0_BLKCNT + \
+                              OSALMEM_POOL_ALIGN( OSALMEM_POOL1_BLKSZ ) * OSALMEM_POOL1_BLKCNT + \
+                              OSALMEM_POOL_ALIGN( OSALMEM_POOL2_BLKSZ ) * OSALMEM_POOL2_BLKCNT )
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -117,6 +196,13 @@ static osalMemHdr_t *ff2;  // First free block after the small-block bucket.
   static uint16 memMax;  // Max total memory ever allocated at once.
 #endif
 
+#if ( OSALMEM_TRACE )
+  static uint8 osalMemTrace[OSALMEM_TRACE_CNT][OSALMEM_TRACE_REC_LEN];
+  static uint8 osalMemTraceHead;  // Oldest record.
+  static uint8 osalMemTraceCnt;   // Records in the ring.
+  static uint8 osalMemTraceLost;  // Records dropped because the ring was full.
+#endif
+
 #if ( OSALMEM_PROFILER )
   #define OSALMEM_PROMAX  8
   /* The profiling buckets must differ by at least OSALMEM_MIN_BLKSZ; the
@@ -131,6 +217,17 @@ static osalMemHdr_t *ff2;  // First free block after the small-block bucket.
   static uint16 proSmallBlkMiss;
 #endif
 
+#if ( OSALMEM_POOLS )
+  static CODE const osalMemPoolCfg_t osalMemPoolCfg[OSALMEM_POOL_CNT] = {
+    { OSALMEM_POOL_ALIGN( OSALMEM_POOL0_BLKSZ ), OSALMEM_POOL0_BLKCNT },
+    { OSALMEM_POOL_ALIGN( OSALMEM_POOL1_BLKSZ ), OSALMEM_POOL1_BLKCNT },
+    { OSALMEM_POOL_ALIGN( OSALMEM_POOL2_BLKSZ ), OSALMEM_POOL2_BLKCNT }
+  };
+  static osalMemPool_t osalMemPool[OSALMEM_POOL_CNT];
+  static halDataAlign_t osalMemPoolArena[ (OSALMEM_POOL_BYTES + sizeof( halDataAlign_t ) - 1) /
+                                          sizeof( halDataAlign_t ) ];
+#endif
+
 // Memory Allocation Heap.
 #if defined( EXTERNAL_RAM )
   static uint8 *theHeap = (uint8 *)EXT_RAM_BEG;
@@ -143,6 +240,189 @@ static osalMemHdr_t *ff2;  // First free block after the small-block bucket.
  * LOCAL FUNCTIONS
  */
 
+#if ( OSALMEM_POOLS )
+static void osalMemPoolInit( void );
+static void *osalMemPoolAlloc( uint16 size );
+static uint8 osalMemPoolFree( void *ptr );
+
+/*********************************************************************
+ * @fn      osalMemPoolInit
+ *
+ * @brief   Carve the pool arena into blocks and chain each pool's free list.
+ *
+ * @param   void
+ *
+ * @return  void
+ */
+static void osalMemPoolInit( void )
+{
+  uint8 *blk = (uint8 *)osalMemPoolArena;
+  uint8 idx;
+
+  for ( idx = 0; idx < OSALMEM_POOL_CNT; idx++ )
+  {
+    osalMemPool_t *pool = &osalMemPool[idx];
+    uint8 cnt;
+
+    pool->free = NULL;
+    pool->beg = blk;
+
+    for ( cnt = 0; cnt < osalMemPoolCfg[idx].blkCnt; cnt++ )
+    {
+      *(void **)blk = pool->free;
+      pool->free = blk;
+      blk += osalMemPoolCfg[idx].blkSz;
+    }
+
+    pool->end = blk;
+#if ( OSALMEM_METRICS )
+    pool->cur = pool->max = 0;
+    pool->fail = 0;
+#endif
+  }
+}
+
+/*********************************************************************
+ * @fn      osalMemPoolAlloc
+ *
+ * @brief   Take a block from the smallest pool that fits the size.
+ *          Ints must be disabled.
+ *
+ * @param   size - number of bytes requested.
+ *
+ * @return  void * - pointer to the block; NULL if no pool fits or the
+ *                   pool is empty.
+ */
+static void *osalMemPoolAlloc( uint16 size )
+{
+  uint8 idx;
+
+  for ( idx = 0; idx < OSALMEM_POOL_CNT; idx++ )
+  {
+    if ( (size <= osalMemPoolCfg[idx].blkSz) && (osalMemPoolCfg[idx].blkCnt != 0) )
+    {
+      osalMemPool_t *pool = &osalMemPool[idx];
+      void *blk = pool->free;
+
+      if ( blk != NULL )
+      {
+        pool->free = *(void **)blk;
+#if ( OSALMEM_METRICS )
+        if ( ++pool->cur > pool->max )
+        {
+          pool->max = pool->cur;
+        }
+#endif
+      }
+#if ( OSALMEM_METRICS )
+      else
+      {
+        pool->fail++;
+      }
+#endif
+
+      return blk;
+    }
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      osalMemPoolFree
+ *
+ * @brief   Return a block to the pool it came from.
+ *          Ints must be disabled.
+ *
+ * @param   ptr - pointer to the memory to free.
+ *
+ * @return  TRUE if the block belonged to a pool, FALSE otherwise.
+ */
+static uint8 osalMemPoolFree( void *ptr )
+{
+  uint8 idx;
+
+  if ( ((uint8 *)ptr < (uint8 *)osalMemPoolArena) ||
+       ((uint8 *)ptr >= osalMemPool[OSALMEM_POOL_CNT-1].end) )
+  {
+    return FALSE;
+  }
+
+  for ( idx = 0; idx < OSALMEM_POOL_CNT; idx++ )
+  {
+    osalMemPool_t *pool = &osalMemPool[idx];
+
+    if ( (uint8 *)ptr < pool->end )
+    {
+      *(void **)ptr = pool->free;
+      pool->free = ptr;
+#if ( OSALMEM_METRICS )
+      pool->cur--;
+#endif
+      break;
+    }
+  }
+
+  return TRUE;
+}
+#endif
+
+#if ( OSALMEM_TRACE )
+/*********************************************************************
+ * @fn      osalMemTraceLog
+ *
+ * @brief   Append a record to the heap trace ring buffer. A record is
+ *          op(1), size(2), caller(2), block address(2), time in mSecs(2),
+ *          multi-byte fields LSB first. Records are dropped and counted
+ *          when the ring is full.
+ *
+ * @param   op - OSALMEM_TRACE_ALLOC, OSALMEM_TRACE_FREE, OSALMEM_TRACE_FAIL
+ *               or OSALMEM_TRACE_KICK.
+ * @param   size - number of bytes requested, 0 for a free or a kick.
+ * @param   caller - caller id, 0 if unknown.
+ * @param   ptr - block allocated or freed.
+ *
+ * @return  void
+ */
+static void osalMemTraceLog( uint8 op, uint16 size, uint16 caller, void *ptr )
+{
+  halIntState_t intState;
+  uint16 now = (uint16)osal_GetSystemClock();
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  if ( osalMemTraceCnt < OSALMEM_TRACE_CNT )
+  {
+    uint8 idx = osalMemTraceHead + osalMemTraceCnt;
+    uint8 *pRec;
+
+    if ( idx >= OSALMEM_TRACE_CNT )
+    {
+      idx -= OSALMEM_TRACE_CNT;
+    }
+    pRec = osalMemTrace[idx];
+
+    *pRec++ = op;
+    *pRec++ = LO_UINT16( size );
+    *pRec++ = HI_UINT16( size );
+    *pRec++ = LO_UINT16( caller );
+    *pRec++ = HI_UINT16( caller );
+    *pRec++ = LO_UINT16( (uint16)ptr );
+    *pRec++ = HI_UINT16( (uint16)ptr );
+    *pRec++ = LO_UINT16( now );
+    *pRec   = HI_UINT16( now );
+
+    osalMemTraceCnt++;
+  }
+  else if ( osalMemTraceLost < 0xFF )
+  {
+    osalMemTraceLost++;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+}
+#endif
+
 /*********************************************************************
  * @fn      osal_mem_init
  *
@@ -178,6 +458,10 @@ void osal_mem_init( void )
   ff2 = osal_mem_alloc( 0 );
   ff1 = (osalMemHdr_t *)theHeap;
 
+#if ( OSALMEM_POOLS )
+  osalMemPoolInit();
+#endif
+
 #if ( OSALMEM_METRICS )
   /* Start with the small-block bucket and the wilderness - don't count the
    * end-of-heap NULL block nor the end-of-small-block NULL block.
@@ -209,6 +493,11 @@ void osal_mem_kick( void )
   ff1 = ff2;
 
   HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+#if ( OSALMEM_TRACE ) && !defined ( DPRINTF_OSALHEAPTRACE )
+  // A replay must move its own search start at the same point.
+  osalMemTraceLog( OSALMEM_TRACE_KICK, 0, 0, ff2 );
+#endif
 }
 
 /*********************************************************************
@@ -222,6 +511,8 @@ void osal_mem_kick( void )
  */
 #ifdef DPRINTF_OSALHEAPTRACE
 void *osal_mem_alloc_dbg( uint16 size, const char *fname, unsigned lnum )
+#elif ( OSALMEM_TRACE )
+void *osal_mem_alloc_trc( uint16 size, uint16 caller )
 #else /* DPRINTF_OSALHEAPTRACE */
 void *osal_mem_alloc( uint16 size )
 #endif /* DPRINTF_OSALHEAPTRACE */
@@ -231,9 +522,28 @@ void *osal_mem_alloc( uint16 size )
   halIntState_t intState;
   uint16 tmp;
   uint8 coal = 0;
+#if ( OSALMEM_TRACE ) && !defined ( DPRINTF_OSALHEAPTRACE )
+  const uint16 reqSize = size;
+#endif
 
   OSALMEM_ASSERT( size );
 
+#if ( OSALMEM_POOLS )
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+  hdr = osalMemPoolAlloc( size );
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
+  if ( hdr != NULL )
+  {
+#ifdef DPRINTF_OSALHEAPTRACE
+    dprintf("osal_mem_alloc(%u)->%lx:%s:%u\n", size, (unsigned) hdr, fname, lnum);
+#elif ( OSALMEM_TRACE )
+    osalMemTraceLog( OSALMEM_TRACE_ALLOC, reqSize, caller, hdr );
+#endif /* DPRINTF_OSALHEAPTRACE */
+    return (void *)hdr;
+  }
+#endif
+
   size += HDRSZ;
 
   // Calculate required bytes to add to 'size' to align to halDataAlign_t.
@@ -396,10 +706,29 @@ void *osal_mem_alloc( uint16 size )
 
 #ifdef DPRINTF_OSALHEAPTRACE
   dprintf("osal_mem_alloc(%u)->%lx:%s:%u\n", size, (unsigned) hdr, fname, lnum);
+#elif ( OSALMEM_TRACE )
+  osalMemTraceLog( (hdr != NULL) ? OSALMEM_TRACE_ALLOC : OSALMEM_TRACE_FAIL, reqSize, caller, hdr );
 #endif /* DPRINTF_OSALHEAPTRACE */
   return (void *)hdr;
 }
 
+#if ( OSALMEM_TRACE ) && !defined ( DPRINTF_OSALHEAPTRACE )
+/*********************************************************************
+ * @fn      osal_mem_alloc
+ *
+ * @brief   Allocator entry point for code that was not compiled with
+ *          the tracing macros (e.g. libraries) - traced with caller id 0.
+ *
+ * @param   size - number of bytes to allocate from the heap.
+ *
+ * @return  void * - pointer to the heap allocation; NULL if error or failure.
+ */
+void *osal_mem_alloc( uint16 size )
+{
+  return osal_mem_alloc_trc( size, 0 );
+}
+#endif
+
 /*********************************************************************
  * @fn      osal_mem_free
  *
@@ -411,6 +740,8 @@ void *osal_mem_alloc( uint16 size )
  */
 #ifdef DPRINTF_OSALHEAPTRACE
 void osal_mem_free_dbg( void *ptr, const char *fname, unsigned lnum)
+#elif ( OSALMEM_TRACE )
+void osal_mem_free_trc( void *ptr, uint16 caller )
 #else /* DPRINTF_OSALHEAPTRACE */
 void osal_mem_free( void *ptr )
 #endif /* DPRINTF_OSALHEAPTRACE */
@@ -420,10 +751,20 @@ void osal_mem_free( void *ptr )
 
 #ifdef DPRINTF_OSALHEAPTRACE
   dprintf("osal_mem_free(%lx):%s:%u\n", (unsigned) ptr, fname, lnum);
+#elif ( OSALMEM_TRACE )
+  osalMemTraceLog( OSALMEM_TRACE_FREE, 0, caller, ptr );
 #endif /* DPRINTF_OSALHEAPTRACE */
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
+#if ( OSALMEM_POOLS )
+  if ( osalMemPoolFree( ptr ) )
+  {
+    HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+    return;
+  }
+#endif
+
   HAL_ASSERT(((uint8 *)ptr >= (uint8 *)_theHeap) && ((uint8 *)ptr < (uint8 *)_theHeap+MAXMEMHEAP));
 
   currHdr = (osalMemHdr_t *)ptr - 1;
@@ -466,6 +807,62 @@ void osal_mem_free( void *ptr )
   HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
 }
 
+#if ( OSALMEM_TRACE ) && !defined ( DPRINTF_OSALHEAPTRACE )
+/*********************************************************************
+ * @fn      osal_mem_free
+ *
+ * @brief   De-allocator entry point for code that was not compiled with
+ *          the tracing macros (e.g. libraries) - traced with caller id 0.
+ *
+ * @param   ptr - pointer to the memory to free.
+ *
+ * @return  void
+ */
+void osal_mem_free( void *ptr )
+{
+  osal_mem_free_trc( ptr, 0 );
+}
+
+/*********************************************************************
+ * @fn      osal_mem_trace_read
+ *
+ * @brief   Copy out and remove the oldest heap trace records.
+ *
+ * @param   buf - buffer to copy whole records into.
+ * @param   maxLen - size of buf in bytes.
+ * @param   pLost - returns the number of records dropped since the
+ *                  last read (saturates at 255).
+ *
+ * @return  Number of bytes copied - a multiple of OSALMEM_TRACE_REC_LEN.
+ */
+uint8 osal_mem_trace_read( uint8 *buf, uint8 maxLen, uint8 *pLost )
+{
+  halIntState_t intState;
+  uint8 len = 0;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  while ( (osalMemTraceCnt != 0) && ((maxLen - len) >= OSALMEM_TRACE_REC_LEN) )
+  {
+    buf = osal_memcpy( buf, osalMemTrace[osalMemTraceHead], OSALMEM_TRACE_REC_LEN );
+    len += OSALMEM_TRACE_REC_LEN;
+
+    if ( ++osalMemTraceHead == OSALMEM_TRACE_CNT )
+    {
+      osalMemTraceHead = 0;
+    }
+    osalMemTraceCnt--;
+  }
+
+  *pLost = osalMemTraceLost;
+  osalMemTraceLost = 0;
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  return len;
+}
+#endif
+
 #if ( OSALMEM_METRICS )
 /*********************************************************************
  * @fn      osal_heap_block_max
@@ -522,6 +919,37 @@ uint16 osal_heap_mem_used( void )
 {
   return memAlo;
 }
+
+#if ( OSALMEM_POOLS )
+/*********************************************************************
+ * @fn      osal_mem_pool_high_water
+ *
+ * @brief   Return the maximum number of blocks ever used at once in a pool.
+ *
+ * @param   pool - pool index.
+ *
+ * @return  Maximum number of blocks ever used at once, 0 if no such pool.
+ */
+uint8 osal_mem_pool_high_water( uint8 pool )
+{
+  return ( pool < OSALMEM_POOL_CNT ) ? osalMemPool[pool].max : 0;
+}
+
+/*********************************************************************
+ * @fn      osal_mem_pool_fail
+ *
+ * @brief   Return the number of allocations that found a pool empty and
+ *          fell back to the heap.
+ *
+ * @param   pool - pool index.
+ *
+ * @return  Number of pool misses, 0 if no such pool.
+ */
+uint16 osal_mem_pool_fail( uint8 pool )
+{
+  return ( pool < OSALMEM_POOL_CNT ) ? osalMemPool[pool].fail : 0;
+}
+#endif
 #endif
 
 #if defined (ZTOOL_P1) || defined (ZTOOL_P2)
@@ -211,6 +211,13 @@ typedef void * osal_msg_q_t;
    */
   extern uint8 osal_self( void );
 
+#if defined ( OSAL_DRAIN_BUDGET ) && OSAL_DRAIN_BUDGET
+  /*
+   * Keep servicing a task while it has events, up to OSAL_DRAIN_BUDGET times
+   */
+  extern uint8 osal_drain_enable( uint8 task_id );
+#endif
+
 
 /*** Helper Functions ***/
 
@@ -58,12 +58,65 @@ extern "C"
   #define OSALMEM_METRICS  FALSE
 #endif
 
+/* Record every allocation and free in a RAM ring buffer that can be read out
+ * with osal_mem_trace_read() and replayed off target.
+ */
+#if !defined ( OSALMEM_TRACE )
+  #define OSALMEM_TRACE    FALSE
+#endif
+
+#if ( OSALMEM_TRACE )
+  // Heap trace record operations.
+  #define OSALMEM_TRACE_ALLOC    'A'
+  #define OSALMEM_TRACE_FREE     'F'
+  #define OSALMEM_TRACE_FAIL     'X'
+  #define OSALMEM_TRACE_KICK     'K'
+
+  // Heap trace record length in bytes.
+  #define OSALMEM_TRACE_REC_LEN  9
+
+  // The caller id of a module that does not set OSALMEM_TRACE_FILE_ID.
+  #if !defined ( OSALMEM_TRACE_FILE_ID )
+    #define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_NONE
+  #endif
+#endif
+
+/* The caller id of a heap trace record holds the OSALMEM_TRACE_FILE_ID of the calling module in
+ * its top 4 bits and the line of the call in its low 12; 0 is a call from a library. A module
+ * defines OSALMEM_TRACE_FILE_ID as one of these ahead of its includes.
+ */
+#define OSALMEM_TRACE_FILE_NONE         0
+#define OSALMEM_TRACE_FILE_OSAL         1   // OSAL.c
+#define OSALMEM_TRACE_FILE_OSAL_TIMERS  2   // OSAL_Timers.c
+#define OSALMEM_TRACE_FILE_RTI          3   // rti.c
+#define OSALMEM_TRACE_FILE_GDP          4   // gdp.c
+#define OSALMEM_TRACE_FILE_ZID_CLD      5   // zid_class_device.c
+#define OSALMEM_TRACE_FILE_ZID_CLD_APP  6   // zid_cld_app_helper.c
+#define OSALMEM_TRACE_FILE_ZID_ADA      7   // zid_adaptor.c
+#define OSALMEM_TRACE_FILE_ZID_ADA_APP  8   // zid_ada_app_helper.c
+#define OSALMEM_TRACE_FILE_USB_ZID      9   // usb_zid_class_requests.c
+#define OSALMEM_TRACE_FILE_HAL_CCM      10  // hal_ccm.c
+#define OSALMEM_TRACE_FILE_HAL_LCD      11  // hal_lcd.c
+#define OSALMEM_TRACE_FILE_NP_MAIN      12  // np_main.c
+#define OSALMEM_TRACE_FILE_APP1         13  // Modules of the application, numbered by the project.
+#define OSALMEM_TRACE_FILE_APP2         14
+#define OSALMEM_TRACE_FILE_APP3         15
+
+#define OSALMEM_TRACE_CALLER_FILE(_caller )  ((_caller) >> 12)
+#define OSALMEM_TRACE_CALLER_LINE(_caller )  ((_caller) & 0x0FFF)
+
 /*********************************************************************
  * MACROS
  */
   
 #define osal_stack_used()  OnBoard_stack_used()
 
+#if ( OSALMEM_TRACE )
+  // The caller id of the line that expands it.
+  #define OSALMEM_TRACE_CALLER  \
+    ((uint16)(((uint16)(OSALMEM_TRACE_FILE_ID) << 12) | (__LINE__ & 0x0FFF)))
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -92,6 +145,10 @@ extern "C"
 #ifdef DPRINTF_OSALHEAPTRACE
   ONLY NULL_OK void *osal_mem_alloc_dbg( uint16 size, const char *fname, unsigned lnum );
 #define osal_mem_alloc(_size ) osal_mem_alloc_dbg(_size, __FILE__, __LINE__)
+#elif ( OSALMEM_TRACE )
+  ONLY NULL_OK void *osal_mem_alloc( uint16 size );
+  ONLY NULL_OK void *osal_mem_alloc_trc( uint16 size, uint16 caller );
+#define osal_mem_alloc(_size ) osal_mem_alloc_trc(_size, OSALMEM_TRACE_CALLER)
 #else /* DPRINTF_OSALHEAPTRACE */
   ONLY NULL_OK void *osal_mem_alloc( uint16 size );
 #endif /* DPRINTF_OSALHEAPTRACE */
@@ -102,10 +159,21 @@ extern "C"
 #ifdef DPRINTF_OSALHEAPTRACE
   void osal_mem_free_dbg( ONLY void *ptr, const char *fname, unsigned lnum );
 #define osal_mem_free(_ptr ) osal_mem_free_dbg(_ptr, __FILE__, __LINE__)
+#elif ( OSALMEM_TRACE )
+  void osal_mem_free( ONLY void *ptr );
+  void osal_mem_free_trc( ONLY void *ptr, uint16 caller );
+#define osal_mem_free(_ptr ) osal_mem_free_trc(_ptr, OSALMEM_TRACE_CALLER)
 #else /* DPRINTF_OSALHEAPTRACE */
   void osal_mem_free( ONLY void *ptr );
 #endif /* DPRINTF_OSALHEAPTRACE */
 
+#if ( OSALMEM_TRACE ) && !defined ( DPRINTF_OSALHEAPTRACE )
+ /*
+  * Copy out and remove the oldest heap trace records.
+  */
+  uint8 osal_mem_trace_read( uint8 *buf, uint8 maxLen, uint8 *pLost );
+#endif
+
 #if ( OSALMEM_METRICS )
  /*
   * Return the maximum number of blocks ever allocated at once.
@@ -126,6 +194,18 @@ extern "C"
   * Return the current number of bytes allocated.
   */
   uint16 osal_heap_mem_used( void );
+
+#if defined ( OSALMEM_POOLS ) && ( OSALMEM_POOLS )
+ /*
+  * Return the maximum number of blocks ever used at once in a block pool.
+  */
+  uint8 osal_mem_pool_high_water( uint8 pool );
+
+ /*
+  * Return the number of allocations that found a block pool empty.
+  */
+  uint16 osal_mem_pool_fail( uint8 pool );
+#endif
 #endif
 
 #if defined (ZTOOL_P1) || defined (ZTOOL_P2)
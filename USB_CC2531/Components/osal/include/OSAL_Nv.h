@@ -55,6 +55,11 @@ extern "C"
  * CONSTANTS
  */
 
+// Count item writes, page erases and page compactions, to size the NV pages.
+#if !defined ( OSAL_NV_METRICS )
+  #define OSAL_NV_METRICS  FALSE
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -96,6 +101,13 @@ extern uint8 osal_nv_write( uint16 id, uint16 offset, uint16 len, void *buf );
  */
 extern uint16 osal_nv_item_len( uint16 id );
 
+#if ( OSAL_NV_METRICS )
+/*
+ * Read the NV wear counts since the last reset.
+ */
+extern void osal_nv_metrics( uint16 *pWrites, uint16 *pErases, uint16 *pCompacts );
+#endif
+
 
 /*********************************************************************
 *********************************************************************/
@@ -55,6 +55,26 @@ extern "C"
  * CONSTANTS
  */
 
+// Number of slots, a power of 2, in the direct-mapped cache of active page item offsets;
+// 0 to always search the active page.
+#if !defined ( OSAL_SNV_CACHE_SIZE )
+  #define OSAL_SNV_CACHE_SIZE  0
+#endif
+
+// Max number of items visited per step of background compaction, driven from the OSAL idle loop;
+// 0 to compact only when a write does not fit in the active page.
+#if !defined ( OSAL_SNV_COMPACT_STEP )
+  #define OSAL_SNV_COMPACT_STEP  0
+#endif
+
+// Max number of items in one call to osal_snv_write_batch()
+#define OSAL_SNV_BATCH_MAX     16
+
+// Count item writes, page erases and compactions done inside a write, to size the NV pages.
+#if !defined ( OSAL_SNV_METRICS )
+  #define OSAL_SNV_METRICS  FALSE
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -70,6 +90,14 @@ extern "C"
   typedef uint8 osalSnvLen_t;
 #endif
 
+// Item of an osal_snv_write_batch() table
+typedef struct
+{
+  osalSnvId_t id;
+  osalSnvLen_t len;
+  void *pBuf;
+} osalSnvItem_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -114,6 +142,18 @@ extern uint8 osal_snv_read( osalSnvId_t id, osalSnvLen_t len, void *pBuf);
  */
 extern uint8 osal_snv_write( osalSnvId_t id, osalSnvLen_t len, void *pBuf);
 
+/*********************************************************************
+ * @fn      osal_snv_write_batch
+ *
+ * @brief   Write a number of data items to NV, all or none of them.
+ *
+ * @param   numOfItems - Number of items in the table, up to OSAL_SNV_BATCH_MAX.
+ * @param   pItems - Table of the items to write.
+ *
+ * @return  SUCCESS if successful, NV_OPER_FAILED if failed.
+ */
+extern uint8 osal_snv_write_batch( uint8 numOfItems, osalSnvItem_t *pItems );
+
 /*********************************************
  * @fn      osal_snv_makeRoomInActivePage
  *
@@ -129,6 +169,48 @@ extern uint8 osal_snv_write( osalSnvId_t id, osalSnvLen_t len, void *pBuf);
  */
 extern uint8 osal_snv_makeRoomInActivePage(uint8 numOfItems, osalSnvLen_t lenTable[]);
 
+#if OSAL_SNV_CACHE_SIZE
+/*********************************************************************
+ * @fn      osal_snv_cache_stats
+ *
+ * @brief   Read the hit and miss counts of the item offset cache.
+ *
+ * @param   pHit - Buffer to receive the number of lookups found in the cache.
+ * @param   pMiss - Buffer to receive the number of lookups that searched the active page.
+ *
+ * @return  none
+ */
+extern void osal_snv_cache_stats( uint16 *pHit, uint16 *pMiss );
+#endif
+
+#if OSAL_SNV_METRICS
+/*********************************************************************
+ * @fn      osal_snv_metrics
+ *
+ * @brief   Read the NV wear counts since the last reset.
+ *
+ * @param   pWrites - Buffer to receive the number of items written.
+ * @param   pErases - Buffer to receive the number of pages erased.
+ * @param   pInline - Buffer to receive the number of compactions done inside a write.
+ *
+ * @return  none
+ */
+extern void osal_snv_metrics( uint16 *pWrites, uint16 *pErases, uint16 *pInline );
+#endif
+
+#if OSAL_SNV_COMPACT_STEP
+/*********************************************************************
+ * @fn      osal_snv_compact_step
+ *
+ * @brief   Do a bounded step of background compaction of the active page,
+ *          starting one if the page is getting full.
+ *          To be called when the system is idle.
+ *
+ * @return  TRUE if compaction is still in progress, FALSE otherwise.
+ */
+extern uint8 osal_snv_compact_step( void );
+#endif
+
 /*********************************************************************
 *********************************************************************/
 
@@ -48,6 +48,7 @@
  */
 
 #include "hal_adc.h"
+#include "hal_batmon.h"
 #include "hal_flash.h"
 #include "hal_types.h"
 #include "OSAL_Nv.h"
@@ -79,6 +80,23 @@
 
 #define OSAL_NV_PAGE_HDR_OFFSET 0
 
+// Build with OSAL_NV_INDEX=TRUE to trade RAM for a sorted index of the item locations in NV so
+// that findItem() no longer walks every item header of every page.
+#if !defined ( OSAL_NV_INDEX )
+  #define OSAL_NV_INDEX         FALSE
+#endif
+
+#if ( OSAL_NV_INDEX )
+  // Max number of item Ids indexed; beyond this, findItem() reverts to the page scans.
+  #if !defined ( OSAL_NV_INDEX_CNT )
+    #define OSAL_NV_INDEX_CNT   32
+  #endif
+
+  #define OSAL_NV_IDX_STALE     0  // Must be re-built before the next use.
+  #define OSAL_NV_IDX_OK        1
+  #define OSAL_NV_IDX_FULL      2  // More item Ids than OSAL_NV_INDEX_CNT.
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -147,6 +165,15 @@ typedef struct
 #define OSAL_NV_PAGE_HDR_SIZE  8
 #define OSAL_NV_PAGE_HDR_HALF (OSAL_NV_PAGE_HDR_SIZE / 2)
 
+#if ( OSAL_NV_INDEX )
+typedef struct
+{
+  uint16 id;   // Item Id, with OSAL_NV_SOURCE_ID set if this copy is the old/transferred one.
+  uint16 off;  // Offset into the page of the item data.
+  uint8  pg;
+} osalNvIdx_t;
+#endif
+
 typedef enum
 {
   eNvXfer,
@@ -188,6 +215,20 @@ static uint8 pgRes;  // Page reserved for item compacting transfer.
 // Saving ~100 code bytes to move a uint8* parameter/return value from findItem() to a global.
 static uint8 findPg;
 
+#if ( OSAL_NV_INDEX )
+// Item locations sorted by Id - trusted by findItem() only while nvIdxState is OSAL_NV_IDX_OK.
+static osalNvIdx_t nvIdx[OSAL_NV_INDEX_CNT];
+static uint8 nvIdxCnt;
+static uint8 nvIdxState;
+#endif
+
+#if ( OSAL_NV_METRICS )
+// NV wear counts
+static uint16 nvWriteCnt;
+static uint16 nvEraseCnt;
+static uint16 nvCompactCnt;
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -214,6 +255,13 @@ static void   xferBuf( uint8 srcPg, uint16 srcOff, uint8 dstPg, uint16 dstOff, u
 
 static uint8  writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag );
 
+#if ( OSAL_NV_INDEX )
+static void   idxBuild( void );
+static uint8  idxFind( uint16 id );
+static void   idxSet( uint8 pg, uint16 offset, uint16 id );
+static void   idxDrop( uint8 pg, uint16 offset );
+#endif
+
 /*********************************************************************
  * @fn      initNV
  *
@@ -230,6 +278,9 @@ static uint8 initNV( void )
   uint8 findDups = FALSE;
   uint8 pg;
 
+#if ( OSAL_NV_INDEX )
+  nvIdxState = OSAL_NV_IDX_STALE;
+#endif
   pgRes = OSAL_NV_PAGE_NULL;
 
   for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
@@ -330,6 +381,10 @@ static uint8 initNV( void )
     erasePage( pgRes );  // The last page erase had been interrupted by a power-cycle.
   }
 
+#if ( OSAL_NV_INDEX )
+  idxBuild();
+#endif
+
   return TRUE;
 }
 
@@ -484,9 +539,15 @@ static uint16 initPage( uint8 pg, uint16 id, uint8 findDups )
 static void erasePage( uint8 pg )
 {
   HalFlashErase(pg);
+#if ( OSAL_NV_METRICS )
+  nvEraseCnt++;
+#endif
 
   pgOff[pg - OSAL_NV_PAGE_BEG] = OSAL_NV_PAGE_HDR_SIZE;
   pgLost[pg - OSAL_NV_PAGE_BEG] = 0;
+#if ( OSAL_NV_INDEX )
+  idxDrop( pg, OSAL_NV_ITEM_NULL );
+#endif
 }
 
 /*********************************************************************
@@ -521,6 +582,10 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
   uint16 srcOff = OSAL_NV_PAGE_HDR_SIZE;
   uint8 rtrn = TRUE;
 
+#if ( OSAL_NV_METRICS )
+  nvCompactCnt++;
+#endif
+
   while ( srcOff < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE ) )
   {
     osalNvHdr_t hdr;
@@ -618,6 +683,30 @@ static uint16 findItem( uint16 id )
   uint16 off;
   uint8 pg;
 
+#if ( OSAL_NV_INDEX )
+  if ( (id & OSAL_NV_SOURCE_ID) == 0 )
+  {
+    if ( nvIdxState == OSAL_NV_IDX_STALE )
+    {
+      idxBuild();
+    }
+
+    if ( nvIdxState == OSAL_NV_IDX_OK )
+    {
+      uint8 idx = idxFind( id );
+
+      if ( (idx < nvIdxCnt) && ((nvIdx[idx].id & ~OSAL_NV_SOURCE_ID) == id) )
+      {
+        findPg = nvIdx[idx].pg;
+        return nvIdx[idx].off;
+      }
+
+      findPg = OSAL_NV_PAGE_NULL;
+      return OSAL_NV_ITEM_NULL;
+    }
+  }
+#endif
+
   for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
   {
     if ( (off = initPage( pg, id, FALSE )) != OSAL_NV_ITEM_NULL )
@@ -724,6 +813,13 @@ static uint8 initItem( uint8 flag, uint16 id, uint16 len, void *buf )
     }
   }
 
+#if ( OSAL_NV_METRICS )
+  if ( rtrn != OSAL_NV_PAGE_NULL )
+  {
+    nvWriteCnt++;
+  }
+#endif
+
   return rtrn;
 }
 
@@ -743,6 +839,9 @@ static void setItem( uint8 pg, uint16 offset, eNvHdrEnum stat )
 {
   osalNvHdr_t hdr;
 
+#if ( OSAL_NV_INDEX )
+  idxDrop( pg, offset );
+#endif
   offset -= OSAL_NV_HDR_SIZE;
   HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
 
@@ -1024,6 +1123,10 @@ static uint8 writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag )
 
   if ( (hdr.id == id) && (hdr.len == len) )
   {
+#if ( OSAL_NV_INDEX )
+    // Even with a bad checksum, this is the copy that a scan of the pages would now find.
+    idxSet( pg, (offset + OSAL_NV_HDR_SIZE), id );
+#endif
     if ( flag )
     {
       uint16 chk = calcChkB( len, buf );
@@ -1054,6 +1157,13 @@ static uint8 writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag )
   }
   else
   {
+#if ( OSAL_NV_INDEX )
+    // The header read back could be any Id, so the index must be re-built from NV.
+    if ( nvIdxState == OSAL_NV_IDX_OK )
+    {
+      nvIdxState = OSAL_NV_IDX_STALE;
+    }
+#endif
     len = OSAL_NV_ITEM_SIZE( hdr.len );
 
     if (len > (OSAL_NV_PAGE_SIZE - pgOff[pg - OSAL_NV_PAGE_BEG]))
@@ -1068,6 +1178,186 @@ static uint8 writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag )
   return rtrn;
 }
 
+#if ( OSAL_NV_INDEX )
+/*********************************************************************
+ * @fn      idxBuild
+ *
+ * @brief   Walk the item headers of all pages to re-build the index. Where an item Id has more
+ *          than one copy, the one indexed is the one that the findItem() page scans would return.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void idxBuild( void )
+{
+  uint8 pg;
+
+  nvIdxCnt = 0;
+  nvIdxState = OSAL_NV_IDX_OK;
+
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+  {
+    uint16 offset = OSAL_NV_PAGE_HDR_SIZE;
+
+    do
+    {
+      osalNvHdr_t hdr;
+      uint16 sz;
+
+      HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+
+      if ( hdr.id == OSAL_NV_ERASED_ID )
+      {
+        break;
+      }
+
+      sz = OSAL_NV_DATA_SIZE( hdr.len );
+
+      if (sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - offset))
+      {
+        break;
+      }
+
+      offset += OSAL_NV_HDR_SIZE;
+
+      // An Id with the MSB set can never be found, so do not index it.
+      if ( (hdr.id != OSAL_NV_ZEROED_ID) && ((hdr.id & OSAL_NV_SOURCE_ID) == 0) )
+      {
+        uint8 idx = idxFind( hdr.id );
+
+        /* The first copy found is indexed, unless it has been marked as transferred and a later
+         * copy has not, just as findItem() only falls back to searching for the old copy.
+         */
+        if ( (idx == nvIdxCnt) || ((nvIdx[idx].id & ~OSAL_NV_SOURCE_ID) != hdr.id) ||
+            ((nvIdx[idx].id != hdr.id) && (hdr.stat == OSAL_NV_ERASED_ID)) )
+        {
+          idxSet( pg, offset, (hdr.stat == OSAL_NV_ERASED_ID) ? hdr.id :
+                                                                (hdr.id | OSAL_NV_SOURCE_ID) );
+
+          if ( nvIdxState != OSAL_NV_IDX_OK )
+          {
+            return;
+          }
+        }
+      }
+
+      offset += sz;
+
+    } while (offset < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE));
+  }
+}
+
+/*********************************************************************
+ * @fn      idxFind
+ *
+ * @brief   Binary search of the index for an item Id.
+ *
+ * @param   id - Valid NV item Id without the OSAL_NV_SOURCE_ID bit.
+ *
+ * @return  Position of the item Id in the index, if present; otherwise the position at which
+ *          it would be inserted.
+ */
+static uint8 idxFind( uint16 id )
+{
+  uint8 lo = 0, hi = nvIdxCnt;
+
+  while ( lo < hi )
+  {
+    uint8 mid = (lo + hi) / 2;
+
+    if ( (nvIdx[mid].id & ~OSAL_NV_SOURCE_ID) < id )
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+/*********************************************************************
+ * @fn      idxSet
+ *
+ * @brief   Set the location of an item Id in the index, inserting it if not yet present.
+ *
+ * @param   pg - Valid NV page.
+ * @param   offset - Valid offset into the page of the item data.
+ * @param   id - Valid NV item Id, with OSAL_NV_SOURCE_ID set if the copy is an old one.
+ *
+ * @return  none
+ */
+static void idxSet( uint8 pg, uint16 offset, uint16 id )
+{
+  uint8 idx;
+
+  if ( nvIdxState != OSAL_NV_IDX_OK )
+  {
+    return;
+  }
+
+  idx = idxFind( id & ~OSAL_NV_SOURCE_ID );
+
+  if ( (idx == nvIdxCnt) ||
+      ((nvIdx[idx].id & ~OSAL_NV_SOURCE_ID) != (id & ~OSAL_NV_SOURCE_ID)) )
+  {
+    uint8 cnt;
+
+    if ( nvIdxCnt == OSAL_NV_INDEX_CNT )
+    {
+      // Item Ids are never deleted, so there is no point in ever re-building.
+      nvIdxState = OSAL_NV_IDX_FULL;
+      return;
+    }
+
+    for ( cnt = nvIdxCnt; cnt > idx; cnt-- )
+    {
+      nvIdx[cnt] = nvIdx[cnt-1];
+    }
+    nvIdxCnt++;
+  }
+
+  nvIdx[idx].id = id;
+  nvIdx[idx].off = offset;
+  nvIdx[idx].pg = pg;
+}
+
+/*********************************************************************
+ * @fn      idxDrop
+ *
+ * @brief   Mark the index as stale if it refers to an item copy that is being changed or erased,
+ *          since another copy of the item may then be the one to be found.
+ *
+ * @param   pg - Valid NV page.
+ * @param   offset - Valid offset into the page of the item data,
+ *                   or OSAL_NV_ITEM_NULL for any item in the page.
+ *
+ * @return  none
+ */
+static void idxDrop( uint8 pg, uint16 offset )
+{
+  uint8 idx;
+
+  if ( nvIdxState != OSAL_NV_IDX_OK )
+  {
+    return;
+  }
+
+  for ( idx = 0; idx < nvIdxCnt; idx++ )
+  {
+    if ( (nvIdx[idx].pg == pg) &&
+        ((offset == OSAL_NV_ITEM_NULL) || (nvIdx[idx].off == offset)) )
+    {
+      nvIdxState = OSAL_NV_IDX_STALE;
+      break;
+    }
+  }
+}
+#endif
+
 /*********************************************************************
  * @fn      osal_nv_init
  *
@@ -1310,5 +1600,26 @@ uint8 osal_nv_read( uint16 id, uint16 ndx, uint16 len, void *buf )
   }
 }
 
+#if ( OSAL_NV_METRICS )
+/*********************************************************************
+ * @fn      osal_nv_metrics
+ *
+ * @brief   Read the NV wear counts since the last reset. Every compaction
+ *          is done inside an item write or at init.
+ *
+ * @param   pWrites - Buffer to receive the number of items written.
+ * @param   pErases - Buffer to receive the number of pages erased.
+ * @param   pCompacts - Buffer to receive the number of pages compacted.
+ *
+ * @return  none
+ */
+void osal_nv_metrics( uint16 *pWrites, uint16 *pErases, uint16 *pCompacts )
+{
+  *pWrites = nvWriteCnt;
+  *pErases = nvEraseCnt;
+  *pCompacts = nvCompactCnt;
+}
+#endif
+
 /*********************************************************************
 *********************************************************************/
@@ -75,6 +75,33 @@
 #define OSAL_SNV_RECHARGEABLE  FALSE
 #endif
 
+#if OSAL_SNV_CACHE_SIZE
+#if (OSAL_SNV_CACHE_SIZE & (OSAL_SNV_CACHE_SIZE - 1))
+#error OSAL_SNV_CACHE_SIZE must be a power of 2.
+#endif
+
+// Offset value of a cache slot that holds no item
+#define OSAL_SNV_CACHE_EMPTY      0xFFFF
+#endif
+
+#if OSAL_SNV_COMPACT_STEP
+// Background compaction starts when free space in the active page drops below this many bytes,
+// provided at least as many bytes have been written since the last compaction.
+#if !defined OSAL_SNV_COMPACT_START
+#define OSAL_SNV_COMPACT_START    (OSAL_NV_PAGE_SIZE / 4)
+#endif
+
+// Background compaction is completed in one step when free space drops below this many bytes.
+#if !defined OSAL_SNV_COMPACT_URGENT
+#define OSAL_SNV_COMPACT_URGENT   (OSAL_NV_PAGE_SIZE / 16)
+#endif
+
+// Background compaction states
+#define OSAL_SNV_XFER_IDLE        0
+#define OSAL_SNV_XFER_COPY        1 // Copying the items written before compaction started
+#define OSAL_SNV_XFER_ERASE       2 // New page is active; the old page is yet to be erased
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -101,6 +128,15 @@ typedef struct
 } osalNvItemHdr_t;
 // Note that osalSnvId_t and osalSnvLen_t cannot be bigger than uint16
 
+#if OSAL_SNV_CACHE_SIZE
+// Item offset cache slot
+typedef struct
+{
+  osalSnvId_t id;
+  uint16 offset;  // Offset of the item data in the active page, 0 if the item is not in the page.
+} osalSnvCache_t;
+#endif
+
 /*********************************************************************
  * EXTERNAL FUNCTIONS
  */
@@ -132,6 +168,42 @@ static uint16 pgOff;
 // another write or erase.
 static uint8 failF;
 
+#if OSAL_SNV_CACHE_SIZE
+// cache of the active page offsets of the most recently used items, indexed by item ID
+static osalSnvCache_t snvCache[OSAL_SNV_CACHE_SIZE];
+
+// cache lookup statistics
+static uint16 snvCacheHit;
+static uint16 snvCacheMiss;
+#endif
+
+#if OSAL_SNV_COMPACT_STEP
+// background compaction state
+static uint8 xferState;
+
+// page being compacted into, or the old page to erase in OSAL_SNV_XFER_ERASE state
+static uint8 xferPg;
+
+// offset of the next item header to visit in the active page
+static uint16 xferSrcOff;
+
+// offset in xferPg where to copy the next item to
+static uint16 xferDstOff;
+
+// active page offset when the last compaction started or finished
+static uint16 xferMark;
+
+// last item ID visited, to skip contiguous values of the same item as compactPage() does
+static osalSnvId_t xferLastId;
+#endif
+
+#if OSAL_SNV_METRICS
+// NV wear counts
+static uint16 snvWriteCnt;
+static uint16 snvEraseCnt;
+static uint16 snvInlineCnt;
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -144,6 +216,17 @@ static void   erasePage( uint8 pg );
 static void   cleanErasedPage( uint8 pg );
 static void   findOffset( void );
 static void   compactPage( uint8 pg );
+static uint16 findActiveItem( osalSnvId_t id );
+#if OSAL_SNV_CACHE_SIZE
+static void   flushCache( void );
+#endif
+static void   makeRoom( uint16 size );
+static uint8  sameValue( osalSnvId_t id, osalSnvLen_t len, uint8 *pBuf );
+static void   writeSkip( uint16 offset, uint16 len );
+#if OSAL_SNV_COMPACT_STEP
+static uint16 xferNext( uint8 final );
+static uint8  compactStep( uint8 budget );
+#endif
 
 static void   writeWord( uint8 pg, uint16 offset, uint8 *pBuf );
 static void   writeWordM( uint8 pg, uint16 offset, uint8 *pBuf, osalSnvLen_t cnt );
@@ -171,6 +254,13 @@ static uint8 initNV( void )
 
   failF = FALSE;
   activePg = OSAL_NV_PAGE_NULL;
+#if OSAL_SNV_CACHE_SIZE
+  flushCache();
+#endif
+#if OSAL_SNV_COMPACT_STEP
+  xferState = OSAL_SNV_XFER_IDLE;
+  xferMark = OSAL_NV_PAGE_HDR_SIZE;
+#endif
 
   // Pick active page and clean up erased page if necessary
   for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
@@ -308,6 +398,9 @@ static void erasePage( uint8 pg )
   }
 
   HalFlashErase(pg);
+#if OSAL_SNV_METRICS
+  snvEraseCnt++;
+#endif
 
   {
     // Verify the erase operation
@@ -435,6 +528,58 @@ static uint16 findItem(uint8 pg, uint16 offset, osalSnvId_t id)
   return 0;
 }
 
+/*********************************************************************
+ * @fn      findActiveItem
+ *
+ * @brief   find the latest value of an item in the active page,
+ *          trying the item offset cache before searching the page.
+ *
+ * @param   id       - NV item ID to search for
+ *
+ * @return  offset of the item, 0 when not found
+ */
+static uint16 findActiveItem( osalSnvId_t id )
+{
+#if OSAL_SNV_CACHE_SIZE
+  osalSnvCache_t *pSlot = &snvCache[id & (OSAL_SNV_CACHE_SIZE - 1)];
+
+  if ((pSlot->offset != OSAL_SNV_CACHE_EMPTY) && (pSlot->id == id))
+  {
+    snvCacheHit++;
+    return pSlot->offset;
+  }
+
+  snvCacheMiss++;
+  pSlot->id = id;
+  pSlot->offset = findItem(activePg, pgOff, id);
+
+  return pSlot->offset;
+#else
+  return findItem(activePg, pgOff, id);
+#endif
+}
+
+#if OSAL_SNV_CACHE_SIZE
+/*********************************************************************
+ * @fn      flushCache
+ *
+ * @brief   Empty all slots of the item offset cache.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void flushCache( void )
+{
+  uint8 i;
+
+  for (i = 0; i < OSAL_SNV_CACHE_SIZE; i++)
+  {
+    snvCache[i].offset = OSAL_SNV_CACHE_EMPTY;
+  }
+}
+#endif
+
 /*********************************************************************
  * @fn      writeItem
  *
@@ -522,6 +667,11 @@ static void compactPage( uint8 srcPg )
   uint8 dstPg;
   osalSnvId_t lastId = (osalSnvId_t) 0xFFFF;
 
+#if OSAL_SNV_CACHE_SIZE
+  // All items move, so the cached offsets are of no further use.
+  flushCache();
+#endif
+
   dstPg = (srcPg == OSAL_NV_PAGE_BEG)? OSAL_NV_PAGE_END : OSAL_NV_PAGE_BEG;
 
   dstOff = OSAL_NV_PAGE_HDR_SIZE;
@@ -607,12 +757,292 @@ static void compactPage( uint8 srcPg )
   if (!failF)
   {
     pgOff = dstOff; // update active page offset
+#if OSAL_SNV_COMPACT_STEP
+    xferMark = dstOff;
+#endif
   }
 
   // Erase the currently active page
   erasePage(srcPg);
 }
 
+/*********************************************************************
+ * @fn      makeRoom
+ *
+ * @brief   Compact the active page if there is not enough room for
+ *          the size given after the active page offset.
+ *          Background compaction in progress is completed first.
+ *
+ * @param   size - Number of bytes, headers included, about to be written.
+ *
+ * @return  none.
+ */
+static void makeRoom( uint16 size )
+{
+  if ( pgOff + size > OSAL_NV_PAGE_SIZE )
+  {
+#if OSAL_SNV_COMPACT_STEP
+    if (xferState != OSAL_SNV_XFER_IDLE)
+    {
+#if OSAL_SNV_METRICS
+      // Only the erase of the old page is left once the copy is done in the background.
+      if (xferState == OSAL_SNV_XFER_COPY)
+      {
+        snvInlineCnt++;
+      }
+#endif
+      (void)compactStep(0);
+
+      if ( pgOff + size <= OSAL_NV_PAGE_SIZE )
+      {
+        return;
+      }
+    }
+#endif
+#if OSAL_SNV_METRICS
+    snvInlineCnt++;
+#endif
+    setXferPage();
+    compactPage(activePg);
+  }
+}
+
+/*********************************************************************
+ * @fn      sameValue
+ *
+ * @brief   Check if the latest value of an item in the active page
+ *          is the same as the data given.
+ *
+ * @param   id     - NV item ID
+ * @param   len    - Length of the data
+ * @param  *pBuf   - Data to compare
+ *
+ * @return  TRUE if the item is found with the same value, FALSE otherwise.
+ */
+static uint8 sameValue( osalSnvId_t id, osalSnvLen_t len, uint8 *pBuf )
+{
+  uint16 offset = findActiveItem(id);
+
+  if (offset > 0)
+  {
+    uint8 tmp;
+    osalSnvLen_t i;
+
+    for (i = 0; i < len; i++)
+    {
+      HalFlashRead(activePg, offset, &tmp, 1);
+      if (tmp != pBuf[i])
+      {
+        return FALSE;
+      }
+      offset++;
+    }
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*********************************************************************
+ * @fn      writeSkip
+ *
+ * @brief   Write an invalid item header to the active page which the
+ *          page walks take as an item of the given length to step over.
+ *          As writeItem() does, the length is first written marked invalid.
+ *
+ * @param   offset - offset within the active page where to write the header
+ * @param   len    - number of bytes below the header to step over
+ *
+ * @return  none
+ */
+static void writeSkip( uint16 offset, uint16 len )
+{
+  osalNvItemHdr_t hdr;
+
+  hdr.id = 0xFFFF;
+  hdr.len = len | OSAL_NV_INVALID_LEN_MARK;
+  writeWord(activePg, offset, (uint8 *) &hdr);
+
+  hdr.len &= ~OSAL_NV_INVALID_LEN_MARK;
+  writeWord(activePg, offset, (uint8 *) &hdr);
+}
+
+#if OSAL_SNV_COMPACT_STEP
+/*********************************************************************
+ * @fn      xferNext
+ *
+ * @brief   Visit the item header at xferSrcOff in the active page and
+ *          copy the item to xferPg if it is the latest value.
+ *
+ * @param   final - FALSE to visit an item written before compaction started,
+ *                  in which case the latest value is the first one visited.
+ *                  TRUE to visit an item written since compaction started,
+ *                  in which case a later value may be in the active page only.
+ *
+ * @return  number of bytes to step down to the next item header,
+ *          0 if the active page is corrupt or the item does not fit in xferPg.
+ */
+static uint16 xferNext( uint8 final )
+{
+  osalNvItemHdr_t hdr;
+  uint16 step;
+
+  HalFlashRead(activePg, xferSrcOff, (uint8 *) &hdr, OSAL_NV_WORD_SIZE);
+
+  if ((hdr.id == 0xFFFF) && (hdr.len & OSAL_NV_INVALID_LEN_MARK))
+  {
+    return OSAL_NV_WORD_SIZE;
+  }
+
+  step = hdr.len + OSAL_NV_WORD_SIZE;
+
+  if (step > xferSrcOff)
+  {
+    // invalid length. See compactPage().
+    HAL_ASSERT_FORCED();
+    return 0;
+  }
+
+  // Consider only valid item
+  if ((hdr.id != 0xFFFF) && !(hdr.id & OSAL_NV_INVALID_ID_MARK))
+  {
+    uint8 copy = FALSE;
+
+    if (final)
+    {
+      copy = (findItem(activePg, pgOff, (osalSnvId_t) hdr.id) == xferSrcOff - hdr.len);
+    }
+    else if (hdr.id != xferLastId)
+    {
+      xferLastId = (osalSnvId_t) hdr.id;
+      copy = (findItem(xferPg, xferDstOff, xferLastId) == 0);
+    }
+
+    if (copy)
+    {
+      if (xferDstOff + step > OSAL_NV_PAGE_SIZE)
+      {
+        return 0;
+      }
+
+      xferItem(xferPg, xferDstOff, hdr.len, xferSrcOff - hdr.len);
+      xferDstOff += step;
+    }
+  }
+
+  return step;
+}
+
+/*********************************************************************
+ * @fn      compactStep
+ *
+ * @brief   Advance the background compaction of the active page.
+ *          The power-fail safety is that of compactPage(): the active page
+ *          is in xfer state while its items are copied and the new page
+ *          is activated before the old page is erased.
+ *          Items written while the copy is in progress are copied over in
+ *          the same step that activates the new page.
+ *
+ * @param   budget - Max number of item headers to visit, 0 for no limit.
+ *
+ * @return  TRUE if compaction is still in progress, FALSE otherwise.
+ */
+static uint8 compactStep( uint8 budget )
+{
+  uint16 step;
+  uint8 srcPg, done = FALSE;
+
+  if ((OSAL_NV_PAGE_SIZE - pgOff) < OSAL_SNV_COMPACT_URGENT)
+  {
+    // Finish now, so that a foreground write does not have to.
+    budget = 0;
+  }
+
+  if (xferState == OSAL_SNV_XFER_COPY)
+  {
+    while (xferSrcOff >= OSAL_NV_PAGE_HDR_SIZE)
+    {
+      if (failF || ((step = xferNext(FALSE)) == 0))
+      {
+        break;
+      }
+      xferSrcOff -= step;
+
+      if (budget && (--budget == 0))
+      {
+        return TRUE;
+      }
+    }
+
+    if (!failF && (xferSrcOff < OSAL_NV_PAGE_HDR_SIZE))
+    {
+      // Copy over the items written since compaction started, from the latest value.
+      xferSrcOff = pgOff - OSAL_NV_WORD_SIZE;
+
+      while (xferSrcOff >= xferMark)
+      {
+        if (failF || ((step = xferNext(TRUE)) == 0))
+        {
+          break;
+        }
+        xferSrcOff -= step;
+      }
+      done = (xferSrcOff < xferMark);
+    }
+
+    if (failF)
+    {
+      xferState = OSAL_SNV_XFER_IDLE;
+      return FALSE;
+    }
+
+    if (!done)
+    {
+      // Either the active page is corrupt or too many items were written since compaction
+      // started to fit in the new page, so start over and compact the whole page at once.
+      xferState = OSAL_SNV_XFER_IDLE;
+      erasePage(xferPg);
+      compactPage(activePg);
+      return FALSE;
+    }
+
+    // All items copied.
+    // Activate the new page
+    srcPg = activePg;
+    setActivePage(xferPg);
+
+    if (failF)
+    {
+      xferState = OSAL_SNV_XFER_IDLE;
+      return FALSE;
+    }
+
+    pgOff = xferDstOff;
+    xferMark = xferDstOff;
+    xferPg = srcPg;
+    xferState = OSAL_SNV_XFER_ERASE;
+#if OSAL_SNV_CACHE_SIZE
+    flushCache();
+#endif
+
+    if (budget)
+    {
+      return TRUE;
+    }
+  }
+
+  if (xferState == OSAL_SNV_XFER_ERASE)
+  {
+    // Erase the previously active page
+    erasePage(xferPg);
+    xferState = OSAL_SNV_XFER_IDLE;
+  }
+
+  return FALSE;
+}
+#endif
+
 /*********************************************************************
  * @fn      verifyWordM
  *
@@ -722,54 +1152,159 @@ uint8 osal_snv_write( osalSnvId_t id, osalSnvLen_t len, void *pBuf )
 {
   uint16 alignedLen;
 
+  if (sameValue(id, len, pBuf))
   {
-    uint16 offset = findItem(activePg, pgOff, id);
+    // Changed value is the same value as before.
+    // Return here instead of re-writing the same value to NV.
+    return SUCCESS;
+  }
+
+  alignedLen = ((len + OSAL_NV_WORD_SIZE - 1) / OSAL_NV_WORD_SIZE) * OSAL_NV_WORD_SIZE;
+
+  makeRoom(alignedLen + OSAL_NV_WORD_SIZE);
+
+  // pBuf shall be referenced beyond its valid length to save code size.
+  writeItem(activePg, pgOff, id, alignedLen, pBuf);
+  if (failF)
+  {
+#if OSAL_SNV_CACHE_SIZE
+    flushCache();
+#endif
+#if OSAL_SNV_RECHARGEABLE
+    osal_snv_init();
+#endif
+    return NV_OPER_FAILED;
+  }
+
+#if OSAL_SNV_CACHE_SIZE
+  {
+    osalSnvCache_t *pSlot = &snvCache[id & (OSAL_SNV_CACHE_SIZE - 1)];
+
+    pSlot->id = id;
+    pSlot->offset = pgOff;
+  }
+#endif
+#if OSAL_SNV_METRICS
+  snvWriteCnt++;
+#endif
+
+  pgOff += alignedLen + OSAL_NV_WORD_SIZE;
+
+  return SUCCESS;
+}
 
-    if (offset > 0)
+/*********************************************************************
+ * @fn      osal_snv_write_batch
+ *
+ * @brief   Write a number of data items to NV, all or none of them.
+ *          Items whose value is unchanged are not re-written.
+ *          The changed items are laid out in the active page as usual,
+ *          topped by two extra words:
+ *          - First a header below the items that steps the page walks over
+ *            all of them, hiding them while they are being written.
+ *          - Then, once all items are written, a header above that one
+ *            which steps over it alone. Clearing the invalid length mark
+ *            of this last header is the single bit write that commits
+ *            the whole batch.
+ *
+ * @param   numOfItems - Number of items in the table, up to OSAL_SNV_BATCH_MAX.
+ * @param   pItems - Table of the items to write. pBuf of each item shall
+ *                   be readable up to the flash word aligned length.
+ *
+ * @return  SUCCESS if successful, NV_OPER_FAILED if failed.
+ */
+uint8 osal_snv_write_batch( uint8 numOfItems, osalSnvItem_t *pItems )
+{
+  uint16 changed = 0;
+  uint16 size = OSAL_NV_WORD_SIZE * 2;
+  uint16 offset, top;
+  uint8 i;
+
+  if (numOfItems > OSAL_SNV_BATCH_MAX)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  for (i = 0; i < numOfItems; i++)
+  {
+    if (!sameValue(pItems[i].id, pItems[i].len, pItems[i].pBuf))
     {
-      uint8 tmp;
-      osalSnvLen_t i;
+      changed |= BV(i);
+      size += ((pItems[i].len + OSAL_NV_WORD_SIZE - 1) / OSAL_NV_WORD_SIZE) * OSAL_NV_WORD_SIZE +
+              OSAL_NV_WORD_SIZE;
+    }
+  }
+
+  if (changed == 0)
+  {
+    return SUCCESS;
+  }
+
+  // Check the supply voltage once for the whole batch.
+  if (!OSAL_NV_CHECK_BUS_VOLTAGE)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  // One reservation for all of the items, so that no compaction can happen in between them.
+  makeRoom(size);
 
-      for (i = 0; i < len; i++)
+  if (!failF && (pgOff + size <= OSAL_NV_PAGE_SIZE))
+  {
+    top = pgOff + size - (OSAL_NV_WORD_SIZE * 2);
+    writeSkip(top, top - pgOff);
+
+    // Headers need not be marked invalid while being written as they are hidden until commit.
+    offset = pgOff;
+    for (i = 0; i < numOfItems; i++)
+    {
+      if (changed & BV(i))
       {
-        HalFlashRead(activePg, offset, &tmp, 1);
-        if (tmp != ((uint8 *)pBuf)[i])
+        osalNvItemHdr_t hdr;
+
+        hdr.id = pItems[i].id;
+        hdr.len = ((pItems[i].len + OSAL_NV_WORD_SIZE - 1) / OSAL_NV_WORD_SIZE) *
+                  OSAL_NV_WORD_SIZE;
+
+        writeWordM(activePg, offset, pItems[i].pBuf, hdr.len / OSAL_NV_WORD_SIZE);
+        writeWord(activePg, offset + hdr.len, (uint8 *) &hdr);
+
+#if OSAL_SNV_CACHE_SIZE
         {
-          break;
-        }
-        offset++;
-      }
+          osalSnvCache_t *pSlot = &snvCache[pItems[i].id & (OSAL_SNV_CACHE_SIZE - 1)];
 
-      if (i == len)
-      {
-        // Changed value is the same value as before.
-        // Return here instead of re-writing the same value to NV.
-        return SUCCESS;
+          pSlot->id = pItems[i].id;
+          pSlot->offset = offset;
+        }
+#endif
+#if OSAL_SNV_METRICS
+        snvWriteCnt++;
+#endif
+        offset += hdr.len + OSAL_NV_WORD_SIZE;
       }
     }
-  }
 
-  alignedLen = ((len + OSAL_NV_WORD_SIZE - 1) / OSAL_NV_WORD_SIZE) * OSAL_NV_WORD_SIZE;
+    // Commit
+    writeSkip(top + OSAL_NV_WORD_SIZE, OSAL_NV_WORD_SIZE);
 
-  if ( pgOff + alignedLen + OSAL_NV_WORD_SIZE > OSAL_NV_PAGE_SIZE )
-  {
-    setXferPage();
-    compactPage(activePg);
+    if (!failF)
+    {
+      pgOff += size;
+      return SUCCESS;
+    }
   }
 
-  // pBuf shall be referenced beyond its valid length to save code size.
-  writeItem(activePg, pgOff, id, alignedLen, pBuf);
   if (failF)
   {
+#if OSAL_SNV_CACHE_SIZE
+    flushCache();
+#endif
 #if OSAL_SNV_RECHARGEABLE
     osal_snv_init();
 #endif
-    return NV_OPER_FAILED;
   }
 
-  pgOff += alignedLen + OSAL_NV_WORD_SIZE;
-
-  return SUCCESS;
+  return NV_OPER_FAILED;
 }
 
 /*********************************************************************
@@ -786,7 +1321,7 @@ uint8 osal_snv_write( osalSnvId_t id, osalSnvLen_t len, void *pBuf )
  */
 uint8 osal_snv_read( osalSnvId_t id, osalSnvLen_t len, void *pBuf )
 {
-  uint16 offset = findItem(activePg, pgOff, id);
+  uint16 offset = findActiveItem(id);
 
   if (offset != 0)
   {
@@ -820,11 +1355,7 @@ uint8 osal_snv_makeRoomInActivePage(uint8 numOfItems, osalSnvLen_t lenTable[])
     alignedLen += ((lenTable[i] + OSAL_NV_WORD_SIZE - 1) / OSAL_NV_WORD_SIZE) * OSAL_NV_WORD_SIZE;
   }
 
-  if ( pgOff + alignedLen + (OSAL_NV_WORD_SIZE * numOfItems) > OSAL_NV_PAGE_SIZE )
-  {
-    setXferPage();
-    compactPage(activePg);
-  }
+  makeRoom(alignedLen + (OSAL_NV_WORD_SIZE * numOfItems));
 
   if (failF)
   {
@@ -837,5 +1368,83 @@ uint8 osal_snv_makeRoomInActivePage(uint8 numOfItems, osalSnvLen_t lenTable[])
   return SUCCESS;
 }
 
+#if OSAL_SNV_CACHE_SIZE
+/*********************************************************************
+ * @fn      osal_snv_cache_stats
+ *
+ * @brief   Read the hit and miss counts of the item offset cache.
+ *
+ * @param   pHit - Buffer to receive the number of lookups found in the cache.
+ * @param   pMiss - Buffer to receive the number of lookups that searched the active page.
+ *
+ * @return  none
+ */
+void osal_snv_cache_stats( uint16 *pHit, uint16 *pMiss )
+{
+  *pHit = snvCacheHit;
+  *pMiss = snvCacheMiss;
+}
+#endif
+
+#if OSAL_SNV_METRICS
+/*********************************************************************
+ * @fn      osal_snv_metrics
+ *
+ * @brief   Read the NV wear counts since the last reset.
+ *
+ * @param   pWrites - Buffer to receive the number of items written.
+ * @param   pErases - Buffer to receive the number of pages erased.
+ * @param   pInline - Buffer to receive the number of compactions done inside a write.
+ *
+ * @return  none
+ */
+void osal_snv_metrics( uint16 *pWrites, uint16 *pErases, uint16 *pInline )
+{
+  *pWrites = snvWriteCnt;
+  *pErases = snvEraseCnt;
+  *pInline = snvInlineCnt;
+}
+#endif
+
+#if OSAL_SNV_COMPACT_STEP
+/*********************************************************************
+ * @fn      osal_snv_compact_step
+ *
+ * @brief   Do a bounded step of background compaction of the active page,
+ *          starting one if the page is getting full.
+ *          To be called when the system is idle.
+ *
+ * @param   none
+ *
+ * @return  TRUE if compaction is still in progress, FALSE otherwise.
+ */
+uint8 osal_snv_compact_step( void )
+{
+  if (xferState == OSAL_SNV_XFER_IDLE)
+  {
+    if (failF || ((OSAL_NV_PAGE_SIZE - pgOff) >= OSAL_SNV_COMPACT_START) ||
+        ((pgOff - xferMark) < OSAL_SNV_COMPACT_START))
+    {
+      return FALSE;
+    }
+
+    setXferPage();
+    if (failF)
+    {
+      return FALSE;
+    }
+
+    xferPg = (activePg == OSAL_NV_PAGE_BEG)? OSAL_NV_PAGE_END : OSAL_NV_PAGE_BEG;
+    xferSrcOff = pgOff - OSAL_NV_WORD_SIZE;
+    xferDstOff = OSAL_NV_PAGE_HDR_SIZE;
+    xferMark = pgOff;
+    xferLastId = (osalSnvId_t) 0xFFFF;
+    xferState = OSAL_SNV_XFER_COPY;
+  }
+
+  return compactStep(OSAL_SNV_COMPACT_STEP);
+}
+#endif
+
 /*********************************************************************
 *********************************************************************/
@@ -6,6 +6,9 @@
  *                                           Includes
  **************************************************************************************************/
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_RTI
+
 /* HAL includes */
 #include "hal_assert.h"
 #include "hal_led.h"
@@ -84,6 +87,8 @@ extern __near_func void nvReadBuf(uint8 pg, uint16 offset, uint8 *buf, uint16 cn
 #define RTI_EVT_ALLOW_PAIR_TIMEOUT 0x2000
 // Implement a timer event for ZID so that Adapter-only does not need to instantiate its own task.
 //efine ZID_ADA_EVT_RSP_WAIT       0x1000
+// Self-scheduled event to hand the next queued data request to the network layer.
+#define RTI_EVT_TX_NEXT            0x0400
 
 // NV Ids
 #ifdef OSAL_SNV_UINT16_ID
@@ -152,6 +157,21 @@ typedef enum
   RTI_STATE_CONFIGURATION
 } rtiState_t;
 
+#if RTI_TX_QUEUE_DEPTH
+// Data request held by the RTI until the network layer confirms it.
+typedef struct
+{
+  uint8 *pData;     // Copy of the payload, or NULL if the caller's buffer was sent directly.
+  uint16 vendorId;
+  uint8 dstIndex;
+  uint8 profileId;
+  uint8 txOptions;
+  uint8 len;
+  uint8 handle;
+  uint8 legacy;     // TRUE if queued by RTI_SendDataReq() rather than by RTI_SendDataReqEx().
+} rtiTxEntry_t;
+#endif
+
 /**************************************************************************************************
  *                                        Global Variables
  */
@@ -282,12 +302,29 @@ static const struct
 
 static uint8 dppKeyTransferCnt;
 
+#if RTI_TX_QUEUE_DEPTH
+// Data requests in the order given to the RTI; the head entry is the one at the network layer.
+static rtiTxEntry_t rtiTxQ[RTI_TX_QUEUE_DEPTH];
+static uint8 rtiTxHead;
+static uint8 rtiTxCnt;
+static uint8 rtiTxBusy;  // TRUE while the head entry waits for its NLDE-DATA.confirm.
+#endif
+
 /**************************************************************************************************
  *                                     Local Function Prototypes
  */
 
 static rStatus_t rtiReadItem(uint8 itemId, uint8 len, uint8 *pValue);
 static rStatus_t rtiWriteItem(uint8 itemId, uint8 len, uint8 *pValue);
+static rStatus_t rtiSendData(uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions,
+                             uint8 len, uint8 *pData, uint8 coLayer);
+#if RTI_TX_QUEUE_DEPTH
+static void rtiTxQueue(uint8 handle, uint8 legacy, uint8 dstIndex, uint8 profileId,
+                       uint16 vendorId, uint8 txOptions, uint8 len, uint8 *pData);
+static void rtiTxNext(void);
+static void rtiTxPop(void);
+static void rtiTxCnf(uint8 legacy, uint8 handle, rStatus_t status);
+#endif
 
 // Callback Related
 void         RCN_CbackEvent( rcnCbackEvent_t *pData );
@@ -443,6 +480,15 @@ uint16 RTI_ProcessEvent( uint8 taskId, uint16 events )
     return (events ^ RTI_EVT_RCN_START_REQ);
   }
 
+#if RTI_TX_QUEUE_DEPTH
+  if (events & RTI_EVT_TX_NEXT)
+  {
+    rtiTxNext();
+
+    return (events ^ RTI_EVT_TX_NEXT);
+  }
+#endif
+
   if (events == GDP_EVT_CONFIGURE_NEXT)
   {
     gdpCfgParam.prevConfiguredProfile++;
@@ -585,6 +631,46 @@ static rStatus_t rtiReadItem(uint8 itemId, uint8 len, uint8 *pValue)
       *pValue = RTI_CONST_RNP_IMAGE_ID;
       break;
 
+#if OSAL_SNV_CACHE_SIZE
+    case RTI_SA_ITEM_SNV_CACHE_STATS:
+      if (len < 4)
+      {
+        status = RTI_ERROR_INVALID_PARAMETER;
+      }
+      else
+      {
+        uint16 hit, miss;
+
+        osal_snv_cache_stats(&hit, &miss);
+        pValue[0] = LO_UINT16(hit);
+        pValue[1] = HI_UINT16(hit);
+        pValue[2] = LO_UINT16(miss);
+        pValue[3] = HI_UINT16(miss);
+      }
+      break;
+#endif
+
+#if OSAL_SNV_METRICS
+    case RTI_SA_ITEM_SNV_METRICS:
+      if (len < 6)
+      {
+        status = RTI_ERROR_INVALID_PARAMETER;
+      }
+      else
+      {
+        uint16 writes, erases, inl;
+
+        osal_snv_metrics(&writes, &erases, &inl);
+        pValue[0] = LO_UINT16(writes);
+        pValue[1] = HI_UINT16(writes);
+        pValue[2] = LO_UINT16(erases);
+        pValue[3] = HI_UINT16(erases);
+        pValue[4] = LO_UINT16(inl);
+        pValue[5] = HI_UINT16(inl);
+      }
+      break;
+#endif
+
     default:
       status = RTI_ERROR_INVALID_PARAMETER;
       break;
@@ -748,6 +834,12 @@ static rStatus_t rtiWriteItem(uint8 itemId, uint8 len, uint8 *pValue)
     case RTI_CONST_ITEM_OAD_IMAGE_ID:
 #endif
     case RTI_CONST_ITEM_RNP_IMAGE_ID:
+#if OSAL_SNV_CACHE_SIZE
+    case RTI_SA_ITEM_SNV_CACHE_STATS:
+#endif
+#if OSAL_SNV_METRICS
+    case RTI_SA_ITEM_SNV_METRICS:
+#endif
       status = RTI_ERROR_NOT_PERMITTED;  // These items are read-only.
     break;
 
@@ -1299,41 +1391,301 @@ void RTI_UnpairReq(uint8 dstIndex)
  */
 void RTI_SendDataReq(uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions,
                                                                        uint8 len, uint8 *pData)
+{
+#if RTI_TX_QUEUE_DEPTH
+  rtiTxQueue(0, TRUE, dstIndex, profileId, vendorId, txOptions, len, pData);
+#else
+  rStatus_t status;
+
+  if ((status = rtiSendData(dstIndex, profileId, vendorId, txOptions, len, pData, TRUE)) !=
+                                                                                    RTI_SUCCESS)
+  {
+    RTI_SendDataCnf(status);
+  }
+#endif
+}
+
+#if RTI_TX_QUEUE_DEPTH
+/**************************************************************************************************
+ *
+ * @fn          RTI_SendDataReqEx
+ *
+ * @brief       This function queues data to the destination specified by the
+ *              pairing table index. Up to RTI_TX_QUEUE_DEPTH requests, counting
+ *              those made with RTI_SendDataReq(), may be outstanding at once.
+ *              They are sent one after the other in the order requested, so the
+ *              order of the frames to any one destination is preserved.
+ *
+ *              The Tx Options are passed to the network layer as given: the
+ *              profile co-layers (e.g. ZID) neither see these frames nor their
+ *              confirms, so co-layer traffic must use RTI_SendDataReq().
+ *
+ *              The client's RTI_SendDataCnfEx() callback will provide the handle
+ *              and a status, which can be one of those of RTI_SendDataReq() or
+ *              RTI_ERROR_OUT_OF_MEMORY if the queue is full.
+ *
+ * input parameters
+ *
+ * @param       handle    - Client's identifier of the request, returned in the confirm.
+ * @param       dstIndex  - Pairing table index of target.
+ * @param       profileId - Profile identifier.
+ * @param       vendorId  - Vendor identifier.
+ * @param       txOptions - value corresponding to TxOptions NLDE-DATA.request
+ *                          primitive of the RF4CE spec.
+ * @param       len       - Number of bytes to send.
+ * @param       *pData    - Pointer to data to be sent; copied if the request must wait.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void RTI_SendDataReqEx(uint8 handle, uint8 dstIndex, uint8 profileId, uint16 vendorId,
+                                                 uint8 txOptions, uint8 len, uint8 *pData)
+{
+  rtiTxQueue(handle, FALSE, dstIndex, profileId, vendorId, txOptions, len, pData);
+}
+#endif
+
+/**************************************************************************************************
+ *
+ * @fn          rtiSendData
+ *
+ * @brief       This function hands a data request to the network layer.
+ *
+ * input parameters
+ *
+ * @param       dstIndex  - Pairing table index of target.
+ * @param       profileId - Profile identifier.
+ * @param       vendorId  - Vendor identifier.
+ * @param       txOptions - value corresponding to TxOptions NLDE-DATA.request
+ *                          primitive of the RF4CE spec.
+ * @param       len       - Number of bytes to send.
+ * @param       *pData    - Pointer to data to be sent.
+ * @param       coLayer   - TRUE if the profile co-layers handle the request and its confirm.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      RTI_SUCCESS if the NLDE-DATA.confirm is to follow; an error status otherwise.
+ */
+static rStatus_t rtiSendData(uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions,
+                             uint8 len, uint8 *pData, uint8 coLayer)
 {
   rcnNwkPairingEntry_t *pEntry;
   rStatus_t status;
 
-  if ((status = RCN_NlmeGetPairingEntryReq(dstIndex, &pEntry)) != RCN_SUCCESS)
+  if (RCN_NlmeGetPairingEntryReq(dstIndex, &pEntry) != RCN_SUCCESS)
   {
-    status = RTI_ERROR_INVALID_PARAMETER;
+    return RTI_ERROR_INVALID_PARAMETER;
   }
-  else
+
+  // ZID may fill-in more Tx Options according to requisite behavior.
+  if (FEATURE_ZID && coLayer && (profileId == RTI_PROFILE_ZID))
+  {
+    txOptions = zidSendDataReq(dstIndex, txOptions, pData);
+  }
+
+  rtiReqRspPrim.prim.dataReq.pairingRef = dstIndex;
+  rtiReqRspPrim.prim.dataReq.profileId  = profileId;
+  rtiReqRspPrim.prim.dataReq.vendorId   = vendorId;
+  rtiReqRspPrim.prim.dataReq.txOptions  = txOptions;
+  rtiReqRspPrim.prim.dataReq.nsduLength = len;
+
+  if ( (status = RCN_NldeDataAlloc(&rtiReqRspPrim.prim.dataReq)) == RCN_SUCCESS )
+  {
+    osal_memcpy( rtiReqRspPrim.prim.dataReq.nsdu, pData, len );
+
+    rtiState = RTI_STATE_NDATA;
+#if RTI_TX_QUEUE_DEPTH
+    rtiTxBusy = TRUE;
+#endif
+    RCN_NldeDataReq( &rtiReqRspPrim.prim.dataReq );
+  }
+
+  return status;
+}
+
+#if RTI_TX_QUEUE_DEPTH
+/**************************************************************************************************
+ *
+ * @fn          rtiTxQueue
+ *
+ * @brief       This function adds a data request to the tail of the transmit queue.
+ *              A request with nothing ahead of it goes to the network layer at once,
+ *              straight from the caller's buffer; any other is copied to the heap.
+ *
+ * input parameters
+ *
+ * @param       handle    - Client's identifier of the request.
+ * @param       legacy    - TRUE if the request came from RTI_SendDataReq().
+ * @param       dstIndex  - Pairing table index of target.
+ * @param       profileId - Profile identifier.
+ * @param       vendorId  - Vendor identifier.
+ * @param       txOptions - value corresponding to TxOptions NLDE-DATA.request
+ *                          primitive of the RF4CE spec.
+ * @param       len       - Number of bytes to send.
+ * @param       *pData    - Pointer to data to be sent.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void rtiTxQueue(uint8 handle, uint8 legacy, uint8 dstIndex, uint8 profileId,
+                       uint16 vendorId, uint8 txOptions, uint8 len, uint8 *pData)
+{
+  rStatus_t status = RTI_ERROR_OUT_OF_MEMORY;
+
+  if (rtiTxCnt < RTI_TX_QUEUE_DEPTH)
   {
-    // ZID may fill-in more Tx Options according to requisite behavior.
-    if (FEATURE_ZID && (profileId == RTI_PROFILE_ZID))
+    uint8 idx = rtiTxHead + rtiTxCnt;
+    rtiTxEntry_t *pEntry;
+
+    if (idx >= RTI_TX_QUEUE_DEPTH)
     {
-      txOptions = zidSendDataReq(dstIndex, txOptions, pData);
+      idx -= RTI_TX_QUEUE_DEPTH;
     }
+    pEntry = rtiTxQ + idx;
+
+    pEntry->pData = NULL;
+    pEntry->vendorId = vendorId;
+    pEntry->dstIndex = dstIndex;
+    pEntry->profileId = profileId;
+    pEntry->txOptions = txOptions;
+    pEntry->len = len;
+    pEntry->handle = handle;
+    pEntry->legacy = legacy;
+
+    if (rtiTxCnt == 0)
+    {
+      // The entry must be at the head before the request, whose confirm may come back at once.
+      rtiTxCnt = 1;
 
-    rtiReqRspPrim.prim.dataReq.pairingRef = dstIndex;
-    rtiReqRspPrim.prim.dataReq.profileId  = profileId;
-    rtiReqRspPrim.prim.dataReq.vendorId   = vendorId;
-    rtiReqRspPrim.prim.dataReq.txOptions  = txOptions;
-    rtiReqRspPrim.prim.dataReq.nsduLength = len;
+      if ((status = rtiSendData(dstIndex, profileId, vendorId, txOptions, len, pData, legacy))
+                                                                                  == RTI_SUCCESS)
+      {
+        return;
+      }
 
-    if ( (status = RCN_NldeDataAlloc(&rtiReqRspPrim.prim.dataReq)) == RCN_SUCCESS )
+      rtiTxPop();
+    }
+    else if ((len == 0) || ((pEntry->pData = osal_mem_alloc(len)) != NULL))
     {
-      osal_memcpy( rtiReqRspPrim.prim.dataReq.nsdu, pData, len );
-
-      rtiState = RTI_STATE_NDATA;
-      RCN_NldeDataReq( &rtiReqRspPrim.prim.dataReq );
+      (void)osal_memcpy(pEntry->pData, pData, len);
+      rtiTxCnt++;
       return;
     }
   }
 
-  RTI_SendDataCnf(status);
+  rtiTxCnf(legacy, handle, status);
 }
 
+/**************************************************************************************************
+ *
+ * @fn          rtiTxNext
+ *
+ * @brief       This function hands the queued data request at the head to the network
+ *              layer, confirming with an error and dropping any that it refuses.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void rtiTxNext(void)
+{
+  while ((rtiTxCnt != 0) && !rtiTxBusy)
+  {
+    rtiTxEntry_t *pEntry = rtiTxQ + rtiTxHead;
+    uint8 handle = pEntry->handle;
+    uint8 legacy = pEntry->legacy;
+    rStatus_t status;
+
+    if ((status = rtiSendData(pEntry->dstIndex, pEntry->profileId, pEntry->vendorId,
+                 pEntry->txOptions, pEntry->len, pEntry->pData, legacy)) != RTI_SUCCESS)
+    {
+      rtiTxPop();
+
+      if (rtiTxCnt == 0)
+      {
+        rtiState = RTI_STATE_READY;
+      }
+
+      rtiTxCnf(legacy, handle, status);
+    }
+  }
+}
+
+/**************************************************************************************************
+ *
+ * @fn          rtiTxPop
+ *
+ * @brief       This function removes the data request at the head of the transmit queue.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void rtiTxPop(void)
+{
+  if (rtiTxQ[rtiTxHead].pData != NULL)
+  {
+    osal_mem_free(rtiTxQ[rtiTxHead].pData);
+  }
+
+  if (++rtiTxHead == RTI_TX_QUEUE_DEPTH)
+  {
+    rtiTxHead = 0;
+  }
+  rtiTxCnt--;
+}
+
+/**************************************************************************************************
+ *
+ * @fn          rtiTxCnf
+ *
+ * @brief       This function confirms a data request that did not reach the network layer.
+ *
+ * input parameters
+ *
+ * @param       legacy - TRUE if the request came from RTI_SendDataReq().
+ * @param       handle - Client's identifier of the request.
+ * @param       status - Result of the request.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void rtiTxCnf(uint8 legacy, uint8 handle, rStatus_t status)
+{
+  if (legacy)
+  {
+    RTI_SendDataCnf(status);
+  }
+  else
+  {
+    RTI_SendDataCnfEx(handle, status);
+  }
+}
+#endif
+
 /**************************************************************************************************
  *
  * @fn          RTI_StandbyReq
@@ -1645,8 +1997,34 @@ void RTI_SetBridgeMode(rtiRcnCbackFn_t pCback)
  */
 static void rtiOnNldeDataCnf( rcnCbackEvent_t *pData )
 {
+#if RTI_TX_QUEUE_DEPTH
+  uint8 handle = rtiTxQ[rtiTxHead].handle;
+  uint8 legacy = (rtiTxCnt == 0) || rtiTxQ[rtiTxHead].legacy;
+
+  rtiTxBusy = FALSE;
+  if (rtiTxCnt != 0)
+  {
+    rtiTxPop();
+  }
+#endif
+
   rtiState = RTI_STATE_READY;
 
+#if RTI_TX_QUEUE_DEPTH
+  if (rtiTxCnt != 0)
+  {
+    // Stay busy with data and send the next request from the RTI task, not from this callback.
+    rtiState = RTI_STATE_NDATA;
+    (void)osal_set_event(RTI_TaskId, RTI_EVT_TX_NEXT);
+  }
+
+  if (!legacy)
+  {
+    RTI_SendDataCnfEx(handle, pData->prim.dataCnf.status);
+    return;
+  }
+#endif
+
   // If the ZID co-layer sent data, don't bother Application layer with an unexpected data confirm.
   if ((!FEATURE_ZID || (zidSendDataCnf(pData->prim.dataCnf.status) == FALSE)) &&
       (!FEATURE_Z3D || (z3dSendDataCnf(pData->prim.dataCnf.status) == FALSE)) &&
@@ -2433,7 +2811,18 @@ static void rtiReadNV( void )
  */
 static void rtiWriteNV( void )
 {
-  rtiReadWriteNV( osal_snv_write );  // Write Configuration Parameters table from RAM into NV.
+  osalSnvItem_t items[sizeof(rtiCpStorage)/sizeof(rtiCpStorage[0])];
+  uint8 i;
+
+  for (i = 0; i < sizeof(rtiCpStorage)/sizeof(rtiCpStorage[0]); i++)
+  {
+    items[i].id = rtiCpStorage[i].nvid;
+    items[i].len = rtiCpStorage[i].size;
+    items[i].pBuf = rtiCpStorage[i].pCache;
+  }
+
+  // Write Configuration Parameters table from RAM into NV, all items or none of them.
+  (void)osal_snv_write_batch( sizeof(rtiCpStorage)/sizeof(rtiCpStorage[0]), items );
 }
 
 /**************************************************************************************************
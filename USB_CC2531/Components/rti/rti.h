@@ -63,6 +63,12 @@ extern "C"
 #define FEATURE_USER_STRING_PAIRING                      FALSE
 #endif
 
+// Number of data requests that the RTI holds until they are confirmed, including the one at the
+// network layer. Zero keeps the single outstanding RTI_SendDataReq() and omits RTI_SendDataReqEx().
+#if !defined RTI_TX_QUEUE_DEPTH
+#define RTI_TX_QUEUE_DEPTH                               0
+#endif
+
 // RTI API Status Values
 
 // Application framework layer primitive status field values
@@ -285,6 +291,8 @@ extern "C"
 #endif
 #define RTI_CONST_ITEM_RNP_IMAGE_ID                      0xD1
 #define DPP_CP_ITEM_KEY_TRANSFER_CNT                     0xD2
+#define RTI_SA_ITEM_SNV_CACHE_STATS                      0xD3   // SNV cache hits & misses (uint16 each)
+#define RTI_SA_ITEM_SNV_METRICS                          0xD4   // SNV writes, erases & inline compactions
 
 // Constants Table Constants
 // SW version has format of 0b'xxxyyyzz' where xxx is major rev; yyy is minor rev; zz is incremental rev
@@ -439,6 +447,9 @@ extern RTILIB_API void RTI_UnpairReq( uint8 dstIndex );
 extern RTILIB_API void RTI_AllowPairReq( void );
 extern RTILIB_API void RTI_AllowPairAbortReq( void );
 extern RTILIB_API void RTI_SendDataReq( uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions, uint8 len, uint8 *pData );
+#if RTI_TX_QUEUE_DEPTH
+extern RTILIB_API void RTI_SendDataReqEx( uint8 handle, uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions, uint8 len, uint8 *pData );
+#endif
 extern RTILIB_API void RTI_StandbyReq( uint8 mode );
 extern RTILIB_API void RTI_RxEnableReq( uint16 duration );
 extern RTILIB_API void RTI_EnableSleepReq( void );
@@ -453,6 +464,9 @@ extern void RTI_UnpairCnf( rStatus_t status, uint8 dstIndex );
 extern void RTI_UnpairInd( uint8 dstIndex );
 extern void RTI_AllowPairCnf( rStatus_t status, uint8 dstIndex, uint8 devType );
 extern void RTI_SendDataCnf( rStatus_t status );
+#if RTI_TX_QUEUE_DEPTH
+extern void RTI_SendDataCnfEx( uint8 handle, rStatus_t status );
+#endif
 extern void RTI_StandbyCnf( rStatus_t status );
 extern void RTI_ReceiveDataInd( uint8 srcIndex, uint8 profileId, uint16 vendorId, uint8 rxLQI, uint8 rxFlags, uint8 len, uint8 *pData );
 extern void RTI_RxEnableCnf( rStatus_t status );
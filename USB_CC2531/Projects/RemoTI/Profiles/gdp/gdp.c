@@ -7,6 +7,9 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_GDP
+
 #include "comdef.h"
 #include "gdp.h"
 #include "gdp_profile.h"
@@ -7,6 +7,9 @@
  *                                          Includes
  * ------------------------------------------------------------------------------------------------
  */
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_ZID_ADA_APP
+
 #include "comdef.h"
 #include "OSAL.h"
 #include "rti.h"
@@ -7,6 +7,9 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_ZID_ADA
+
 #include "comdef.h"
 #include "gdp_profile.h"
 #include "OSAL.h"
@@ -61,6 +64,10 @@ enum {
   (ZID_ADA_NVID_NULL_REPORT_BEG + ((pxyNum) * aplcMaxNonStdDescCompsPerHID) + (descNum))
 
 #define ZID_ADA_CFG_PXY_ENTRY(pxyNum)     (ZID_ADA_NVID_CFG_PXY + (pxyNum))
+
+// Most NV items pushed in one configuration phase: all descriptor fragments and NULL reports.
+#define ZID_ADA_CFG_NV_ITEMS_MAX \
+  (aplcMaxNonStdDescCompsPerHID * (ZID_MAX_NON_STD_DESC_FRAGS_PER_DESC + 1))
 /* ------------------------------------------------------------------------------------------------
  *                                           Typedefs
  * ------------------------------------------------------------------------------------------------
@@ -84,6 +91,18 @@ typedef struct
   uint8 reportId;
 } zidAdaReportInfo_t;
 
+#if ZID_ADA_DESC_CACHE
+/* RAM copy of the NV items of one proxy table entry that are needed outside of configuration */
+typedef struct
+{
+  zid_proxy_entry_t pxy;
+  uint8 descHdr[aplcMaxNonStdDescCompsPerHID][sizeof(zid_non_std_desc_comp_t)];
+  uint8 nullReport[aplcMaxNonStdDescCompsPerHID][ZID_NULL_REPORT_T_MAX];
+  uint8 nullValid;  // Bit map by descriptor number of the NULL reports present.
+  uint8 valid;
+} zidAdaDescCache_t;
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Local Functions
  * ------------------------------------------------------------------------------------------------
@@ -107,6 +126,17 @@ static uint8 getProxyTableEntry( uint8 pairIdx );
 static uint8 getAttrTableIdx( uint8 attrId );
 static uint8 getPxyTableIdx( uint8 attrId );
 static void rspWaitTimeout( void );
+#if ZID_ADA_DESC_CACHE
+static void descCacheLoad( uint8 proxyIdx );
+static void descCacheDrop( uint8 proxyIdx );
+static zidAdaDescCache_t *descCacheGet( uint8 proxyIdx );
+#endif
+#if ZID_ADA_CFG_NV_BATCH
+static void cfgNvWrite( uint8 id, uint8 len, void *pBuf );
+static uint8 cfgNvRead( uint8 id, uint8 len, void *pBuf );
+static uint8 cfgNvCommit( void );
+static void cfgNvDrop( void );
+#endif
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Local Variables
@@ -123,18 +153,33 @@ static adaState_t adaState;
 /* Used to save last report sent info in case we need to send a NULL report later */
 static zidAdaReportInfo_t zidAdaNullReportInfo;
 
-static const zid_table_t zidAda_attributeTable[] =
+#if ZID_ADA_DESC_CACHE
+/* Indexed by proxy table entry, as are the NV items that it mirrors */
+static zidAdaDescCache_t zidAdaDescCache[ZID_COMMON_MAX_NUM_PROXIED_DEVICES];
+#endif
+
+#if ZID_ADA_CFG_NV_BATCH
+// NV items pushed in the configuration phase, held for the commit by rxCfgComplete().
+static osalSnvItem_t zidAdaCfgNvItems[ZID_ADA_CFG_NV_ITEMS_MAX];
+static uint8 zidAdaCfgNvCnt;
+#endif
+
+static const zid_table_t zidAda_attributeTable[ZID_ATTR_TABLE_LEN] =
 {
   {
     aplZIDProfileVersion,
     ZID_DATATYPE_UINT16_LEN,
     offsetof(zid_ada_cfg_t, ZIDProfileVersion)
   },
+  ZID_TABLE_ENTRY_UNUSED,  // aplIntPipeUnsafeTxWindowTime
+  ZID_TABLE_ENTRY_UNUSED,  // aplReportRepeatInterval
   {
     aplHIDParserVersion,
     ZID_DATATYPE_UINT16_LEN,
     offsetof(zid_ada_cfg_t, HIDParserVersion)
   },
+  ZID_TABLE_ENTRY_UNUSED,  // aplHIDDeviceSubclass
+  ZID_TABLE_ENTRY_UNUSED,  // aplHIDProtocolCode
   {
     aplHIDCountryCode,
     ZID_DATATYPE_UINT8_LEN,
@@ -154,32 +199,29 @@ static const zid_table_t zidAda_attributeTable[] =
     aplHIDProductId,
     ZID_DATATYPE_UINT16_LEN,
     offsetof(zid_ada_cfg_t, HIDProductId)
-  }
+  },
+  ZID_TABLE_ENTRY_UNUSED,  // aplHIDNumEndpoints
+  ZID_TABLE_ENTRY_UNUSED,  // aplHIDPollInterval
+  ZID_TABLE_ENTRY_UNUSED,  // aplHIDNumStdDescComps
+  ZID_TABLE_ENTRY_UNUSED,  // aplHIDStdDescCompsList
+  ZID_TABLE_ENTRY_UNUSED,  // aplHIDNumNullReports
+  ZID_TABLE_ENTRY_UNUSED,  // 0xEC (reserved)
+  ZID_TABLE_ENTRY_UNUSED,  // 0xED (reserved)
+  ZID_TABLE_ENTRY_UNUSED,  // 0xEE (reserved)
+  ZID_TABLE_ENTRY_UNUSED,  // 0xEF (reserved)
+  ZID_TABLE_ENTRY_UNUSED  // aplHIDNumNonStdDescComps
 };
-#define ZID_ADA_ATTRIBUTE_TABLE_LEN  (sizeof(zidAda_attributeTable) / sizeof(zidAda_attributeTable[0]))
 
-static const zid_table_t zidAda_proxyAttributeTable[] =
+static const zid_table_t zidAda_proxyAttributeTable[ZID_ATTR_TABLE_LEN] =
 {
+  ZID_TABLE_ENTRY_UNUSED,  // aplZIDProfileVersion
+  ZID_TABLE_ENTRY_UNUSED,  // aplIntPipeUnsafeTxWindowTime
+  ZID_TABLE_ENTRY_UNUSED,  // aplReportRepeatInterval
   {
     aplHIDParserVersion,
     ZID_DATATYPE_UINT16_LEN,
     offsetof(zid_proxy_entry_t, HIDParserVersion)
   },
-  {
-    aplHIDDeviceReleaseNumber,
-    ZID_DATATYPE_UINT16_LEN,
-    offsetof(zid_proxy_entry_t, HIDDeviceReleaseNumber)
-  },
-  {
-    aplHIDVendorId,
-    ZID_DATATYPE_UINT16_LEN,
-    offsetof(zid_proxy_entry_t, HIDVendorId)
-  },
-  {
-    aplHIDProductId,
-    ZID_DATATYPE_UINT16_LEN,
-    offsetof(zid_proxy_entry_t, HIDProductId)
-  },
   {
     aplHIDDeviceSubclass,
     ZID_DATATYPE_UINT8_LEN,
@@ -195,6 +237,21 @@ static const zid_table_t zidAda_proxyAttributeTable[] =
     ZID_DATATYPE_UINT8_LEN,
     offsetof(zid_proxy_entry_t, HIDCountryCode)
   },
+  {
+    aplHIDDeviceReleaseNumber,
+    ZID_DATATYPE_UINT16_LEN,
+    offsetof(zid_proxy_entry_t, HIDDeviceReleaseNumber)
+  },
+  {
+    aplHIDVendorId,
+    ZID_DATATYPE_UINT16_LEN,
+    offsetof(zid_proxy_entry_t, HIDVendorId)
+  },
+  {
+    aplHIDProductId,
+    ZID_DATATYPE_UINT16_LEN,
+    offsetof(zid_proxy_entry_t, HIDProductId)
+  },
   {
     aplHIDNumEndpoints,
     ZID_DATATYPE_UINT8_LEN,
@@ -216,17 +273,20 @@ static const zid_table_t zidAda_proxyAttributeTable[] =
     offsetof(zid_proxy_entry_t, HIDStdDescCompsList)
   },
   {
-    aplHIDNumNonStdDescComps,
+    aplHIDNumNullReports,
     ZID_DATATYPE_UINT8_LEN,
-    offsetof(zid_proxy_entry_t, HIDNumNonStdDescComps)
+    offsetof(zid_proxy_entry_t, HIDNumNullReports)
   },
+  ZID_TABLE_ENTRY_UNUSED,  // 0xEC (reserved)
+  ZID_TABLE_ENTRY_UNUSED,  // 0xED (reserved)
+  ZID_TABLE_ENTRY_UNUSED,  // 0xEE (reserved)
+  ZID_TABLE_ENTRY_UNUSED,  // 0xEF (reserved)
   {
-    aplHIDNumNullReports,
+    aplHIDNumNonStdDescComps,
     ZID_DATATYPE_UINT8_LEN,
-    offsetof(zid_proxy_entry_t, HIDNumNullReports)
+    offsetof(zid_proxy_entry_t, HIDNumNonStdDescComps)
   }
 };
-#define ZID_ADA_PROXY_ATTRIBUTE_TABLE_LEN  (sizeof(zidAda_proxyAttributeTable) / sizeof(zidAda_proxyAttributeTable[0]))
 
 /* Map the RTI pairing table index to the Proxy Entry Index. */
 static uint8 zidAda_pxyInfoTable[RCN_CAP_PAIR_TABLE_SIZE];
@@ -309,6 +369,24 @@ void zidAda_InitItems(void)
     (void)osal_snv_write( ZID_ADA_NVID_PXY_LIST, sizeof(zidAda_pxyInfoTable), (uint8 *)zidAda_pxyInfoTable );
   }
 
+#if ZID_ADA_DESC_CACHE
+  {
+    uint8 i;
+
+    for (i = 0; i < ZID_COMMON_MAX_NUM_PROXIED_DEVICES; i++)
+    {
+      if (zidAda_pxyInfoTable[i] == RTI_INVALID_PAIRING_REF)
+      {
+        descCacheDrop( i );
+      }
+      else
+      {
+        descCacheLoad( i );
+      }
+    }
+  }
+#endif
+
   zidAdaCurrentProxyIdx = 0;
   zidAdaCurrentNonStdDescNum = 0;
   zidAdaCurrentNonStdDescFragNum = 0;
@@ -524,10 +602,23 @@ static void sendNullReport( void )
       {
         uint8 nonStdDescBuf[ZID_NULL_REPORT_T_MAX];
         zid_null_report_t *pBuf = (zid_null_report_t *)nonStdDescBuf;
-        uint8 nvId;
+        uint8 status;
+#if ZID_ADA_DESC_CACHE
+        zidAdaDescCache_t *pCache = descCacheGet( proxyIdx );
 
-        nvId = ZID_ADA_NVID_NULL_REPORT_START( proxyIdx, descNum );
-        if (osal_snv_read( nvId, ZID_NULL_REPORT_T_MAX, pBuf ) == SUCCESS)
+        if (pCache != NULL)
+        {
+          pBuf = (zid_null_report_t *)pCache->nullReport[descNum];
+          status = GET_BIT(&pCache->nullValid, descNum) ? SUCCESS : NV_OPER_FAILED;
+        }
+        else
+#endif
+        {
+          uint8 nvId = ZID_ADA_NVID_NULL_REPORT_START( proxyIdx, descNum );
+          status = osal_snv_read( nvId, ZID_NULL_REPORT_T_MAX, pBuf );
+        }
+
+        if (status == SUCCESS)
         {
           pRecord->len = sizeof(zid_report_record_t) + pBuf->len - 1;
           osal_memcpy( pRecord->data, pBuf->data, pBuf->len );
@@ -757,6 +848,16 @@ uint8 zidAda_ReceiveDataInd( uint8 srcIndex,
     }
   }
 
+#if (ZID_CFG_WINDOW > 1)
+  // A successful windowed config push is acknowledged by the response to a later push.
+  if (((cmd == GDP_CMD_PUSH_ATTR) || (cmd == ZID_CMD_SET_REPORT)) &&
+      (pData[ZID_FRAME_CTL_IDX] & GDP_HEADER_DATA_PENDING) &&
+      (rsp == GDP_GENERIC_RSP_SUCCESS) && (adaState == eAdaCfg))
+  {
+    sendGenericResponse = FALSE;
+  }
+#endif
+
   if (sendGenericResponse == TRUE)
   {
     uint8 buf[2] = { (GDP_CMD_GENERIC_RSP | rxOn), rsp };
@@ -802,6 +903,13 @@ void zidAda_AllowPairCnf(uint8 dstIndex)
       SET_BIT(zidPairInfo.adapterDisc, dstIndex);
       CLR_BIT(zidPairInfo.cfgCompleteDisc, dstIndex);
       (void)osal_snv_write(ZID_COMMON_NVID_PAIR_INFO, sizeof(zid_pair_t), (uint8 *)&zidPairInfo);
+#if ZID_ADA_CFG_NV_BATCH
+      cfgNvDrop();
+#endif
+#if ZID_ADA_DESC_CACHE
+      // A re-pairing device re-uses its proxy entry, whose NV items are about to be re-written.
+      descCacheDrop(zidAda_nextProxyIdx);
+#endif
 
       // Set all bits to begin and clear bits as the corresponding Attribute is pushed.
       // Clear any non-applicable bits upon receipt of GDP_CMD_CFG_COMPLETE & check for zero.
@@ -914,6 +1022,22 @@ rStatus_t zidAda_ReadItem(uint8 itemId, uint8 len, uint8 *pValue)
 {
   rStatus_t status = RTI_SUCCESS;
 
+#if ZID_ADA_DESC_CACHE
+  zidAdaDescCache_t *pCache = descCacheGet( zidAdaCurrentProxyIdx );
+
+  if ((itemId == ZID_ITEM_CURRENT_PXY_ENTRY) && (pCache != NULL))
+  {
+    (void)osal_memcpy( pValue, &pCache->pxy, sizeof(zid_proxy_entry_t) );
+  }
+  else if ((itemId == ZID_ITEM_NON_STD_DESC_FRAG) && (pCache != NULL) &&
+           (zidAdaCurrentNonStdDescFragNum == 0) && (len <= sizeof(zid_non_std_desc_comp_t)) &&
+           (zidAdaCurrentNonStdDescNum < pCache->pxy.HIDNumNonStdDescComps))
+  {
+    // Only the header of the first fragment is requested, so serve it without reading NV.
+    (void)osal_memcpy( pValue, pCache->descHdr[zidAdaCurrentNonStdDescNum], len );
+  }
+  else
+#endif
   if (itemId == ZID_ITEM_CURRENT_PXY_ENTRY)
   {
     status = osal_snv_read( ZID_ADA_CFG_PXY_ENTRY(zidAdaCurrentProxyIdx), sizeof(zid_proxy_entry_t), pValue );
@@ -998,9 +1122,42 @@ rStatus_t zidAda_WriteItem(uint8 itemId, uint8 len, uint8 *pValue)
   else if (itemId == ZID_ITEM_CURRENT_PXY_ENTRY)
   {
     status = osal_snv_write( ZID_ADA_CFG_PXY_ENTRY(zidAdaCurrentProxyIdx), sizeof(zid_proxy_entry_t), pValue );
+#if ZID_ADA_DESC_CACHE
+    if (status == SUCCESS)
+    {
+      zidAdaDescCache_t *pCache = descCacheGet( zidAdaCurrentProxyIdx );
+
+      // The cached descriptor headers stay good unless the number of descriptors changed.
+      if ((pCache != NULL) &&
+          (pCache->pxy.HIDNumNonStdDescComps == ((zid_proxy_entry_t *)pValue)->HIDNumNonStdDescComps))
+      {
+        (void)osal_memcpy( &pCache->pxy, pValue, sizeof(zid_proxy_entry_t) );
+      }
+      else
+      {
+        descCacheLoad( zidAdaCurrentProxyIdx );
+      }
+    }
+#endif
   }
   else if (itemId == ZID_ITEM_PXY_LIST)
   {
+#if ZID_ADA_DESC_CACHE
+    uint8 i;
+
+    // Reload each entry that was added or replaced, and drop each one that was removed.
+    for (i = 0; i < ZID_COMMON_MAX_NUM_PROXIED_DEVICES; i++)
+    {
+      if (pValue[i] == RTI_INVALID_PAIRING_REF)
+      {
+        descCacheDrop( i );
+      }
+      else if ((pValue[i] != zidAda_pxyInfoTable[i]) || (descCacheGet( i ) == NULL))
+      {
+        descCacheLoad( i );
+      }
+    }
+#endif
     (void)osal_memcpy( zidAda_pxyInfoTable, pValue, sizeof(zidAda_pxyInfoTable) );
     if (osal_snv_write( ZID_ADA_NVID_PXY_LIST, sizeof(zidAda_pxyInfoTable), (uint8 *)zidAda_pxyInfoTable ) != SUCCESS)
     {
@@ -1077,6 +1234,10 @@ static void endCfgState(void)
     pCfgProxy = NULL;
   }
 
+#if ZID_ADA_CFG_NV_BATCH
+  cfgNvDrop();
+#endif
+
   zidCfgIdx = RTI_INVALID_PAIRING_REF;
   zidRspDone(zidAda_TaskId, TRUE);
   adaState = eAdaDor;
@@ -1101,6 +1262,9 @@ static void endCfgState(void)
 static uint8 rxCfgComplete(uint8 srcIndex)
 {
   uint8 cnt;
+#if ZID_ADA_CFG_NV_BATCH
+  uint8 pxyOld;
+#endif
 
   if ((adaState != eAdaCfg) || (zidCfgIdx != srcIndex) || (pCfgProxy == NULL))
   {
@@ -1142,14 +1306,32 @@ static uint8 rxCfgComplete(uint8 srcIndex)
 
   SET_BIT(zidPairInfo.cfgCompleteDisc, zidCfgIdx);
 
+#if ZID_ADA_CFG_NV_BATCH
+  pxyOld = zidAda_pxyInfoTable[zidAda_nextProxyIdx];
+#endif
+
   /* Note -- we wouldn't have entered the configuration phase if there was no room in
    * the proxy table, so the add operation should be successful.
    */
   addToProxyTable( srcIndex );
 
+#if ZID_ADA_CFG_NV_BATCH
+  if (cfgNvCommit() != SUCCESS)
+  {
+    // The pairing info, proxy entry and list in NV are unchanged, so put them back in RAM too;
+    // the caller then unpairs the device.
+    CLR_BIT(zidPairInfo.cfgCompleteDisc, zidCfgIdx);
+    zidAda_pxyInfoTable[zidAda_nextProxyIdx] = pxyOld;
+    return GDP_GENERIC_RSP_CONFIG_FAILURE;
+  }
+#else
   (void)osal_snv_write( ZID_COMMON_NVID_PAIR_INFO, sizeof(zid_pair_t), (uint8 *)&zidPairInfo );
   (void)osal_snv_write( ZID_ADA_CFG_PXY_ENTRY(zidAda_nextProxyIdx), sizeof(zid_proxy_entry_t), (uint8 *)pCfgProxy );
   (void)osal_snv_write( ZID_ADA_NVID_PXY_LIST, sizeof(zidAda_pxyInfoTable), (uint8 *)zidAda_pxyInfoTable );
+#endif
+#if ZID_ADA_DESC_CACHE
+  descCacheLoad( zidAda_nextProxyIdx );
+#endif
   endCfgState();
 
   return GDP_GENERIC_RSP_SUCCESS;
@@ -1264,6 +1446,9 @@ void zidAda_RemoveFromProxyTable( uint8 pairIdx )
     {
       zidAda_pxyInfoTable[i] = RTI_INVALID_PAIRING_REF;
       (void)osal_snv_write( ZID_ADA_NVID_PXY_LIST, sizeof(zidAda_pxyInfoTable), (uint8 *)zidAda_pxyInfoTable );
+#if ZID_ADA_DESC_CACHE
+      descCacheDrop( i );
+#endif
     }
   }
 }
@@ -1299,8 +1484,8 @@ static void rxGetAdaAttr(uint8 srcIndex, uint8 len, uint8 *pData)
   len--;
   pData++;
 
-  /* Allocate buffer to hold all adaptor attributes */
-  pBuf = osal_mem_alloc(GDP_ATTR_RSP_SIZE_HDR * len + sizeof(zid_ada_cfg_t) + 1);
+  /* Allocate buffer to hold all adaptor attributes (and the ZID_ATTR_CFG_WINDOW byte) */
+  pBuf = osal_mem_alloc(GDP_ATTR_RSP_SIZE_HDR * len + sizeof(zid_ada_cfg_t) + 1 + 1);
 
   if (pBuf != NULL)
   {
@@ -1374,7 +1559,11 @@ static uint8 rxPushAdaAttr(uint8 srcIndex, uint16 len, uint8 *pData)
           {
             /* Store fragment in NV */
             uint8 id = ZID_ADA_NVID_DESC_START(zidAda_nextProxyIdx, attrId - aplHIDNonStdDescCompSpec1) + zidCommon_GetLastNonStdDescCompFragNum();
+#if ZID_ADA_CFG_NV_BATCH
+            cfgNvWrite( id, len, pData );
+#else
             (void)osal_snv_write( id, len, pData );
+#endif
           }
 
           if (descComplete == TRUE)
@@ -1620,7 +1809,11 @@ static uint8 rxSetReport( uint16 len, uint8 *pData )
     pBuf->len = reportLen;
     osal_memcpy( pBuf->data, pReport->data, reportLen );
     nvId = ZID_ADA_NVID_NULL_REPORT_START( zidAda_nextProxyIdx, descNum );
+#if ZID_ADA_CFG_NV_BATCH
+    cfgNvWrite( nvId, sizeof(zid_null_report_t) + reportLen, pBuf );
+#else
     (void)osal_snv_write( nvId, sizeof(zid_null_report_t) + reportLen, pBuf );
+#endif
   }
 
   return rtrn;
@@ -1639,12 +1832,33 @@ static uint8 rxSetReport( uint16 len, uint8 *pData )
 static bool findNonStdDescReport( uint8 proxyIdx, uint8 reportId, uint8 *descId )
 {
   uint8 descNum;
+#if ZID_ADA_DESC_CACHE
+  zidAdaDescCache_t *pCache = descCacheGet( proxyIdx );
+
+  if (pCache != NULL)
+  {
+    for (descNum = 0; descNum < pCache->pxy.HIDNumNonStdDescComps; descNum++)
+    {
+      if (((zid_non_std_desc_comp_t *)pCache->descHdr[descNum])->reportId == reportId)
+      {
+        *descId = descNum;
+        return( TRUE );
+      }
+    }
+
+    return( FALSE );
+  }
+#endif
 
   for (descNum = 0; descNum < pCfgProxy->HIDNumNonStdDescComps; descNum++)
   {
     uint8 nvId = ZID_ADA_NVID_DESC_START(proxyIdx, descNum);
     zid_non_std_desc_comp_t buf;
+#if ZID_ADA_CFG_NV_BATCH
+    if (cfgNvRead( nvId, sizeof(zid_non_std_desc_comp_t), &buf ) == SUCCESS)
+#else
     if (osal_snv_read( nvId, sizeof(zid_non_std_desc_comp_t), &buf ) == SUCCESS)
+#endif
     {
       if (buf.reportId == reportId)
       {
@@ -1657,6 +1871,271 @@ static bool findNonStdDescReport( uint8 proxyIdx, uint8 reportId, uint8 *descId
   return( FALSE );
 }
 
+#if ZID_ADA_DESC_CACHE
+/**************************************************************************************************
+ * @fn          descCacheLoad
+ *
+ * @brief       Load the RAM copy of a proxy table entry's proxy info, non-standard descriptor
+ *              headers and NULL reports from NV. The copy is left invalid if any read fails.
+ *
+ * input parameters
+ *
+ * @param       proxyIdx - Proxy table index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void descCacheLoad( uint8 proxyIdx )
+{
+  zidAdaDescCache_t *pCache;
+  uint8 descNum;
+
+  if (proxyIdx >= ZID_COMMON_MAX_NUM_PROXIED_DEVICES)
+  {
+    return;
+  }
+
+  pCache = zidAdaDescCache + proxyIdx;
+  pCache->valid = FALSE;
+  pCache->nullValid = 0;
+
+  if ((osal_snv_read( ZID_ADA_CFG_PXY_ENTRY(proxyIdx), sizeof(zid_proxy_entry_t), &pCache->pxy ) != SUCCESS) ||
+      (pCache->pxy.HIDNumNonStdDescComps > aplcMaxNonStdDescCompsPerHID))
+  {
+    return;
+  }
+
+  for (descNum = 0; descNum < pCache->pxy.HIDNumNonStdDescComps; descNum++)
+  {
+    if (osal_snv_read( ZID_ADA_NVID_DESC_START(proxyIdx, descNum),
+                       sizeof(zid_non_std_desc_comp_t), pCache->descHdr[descNum] ) != SUCCESS)
+    {
+      return;
+    }
+
+    // A NULL report is optional for each non-standard descriptor.
+    if (osal_snv_read( ZID_ADA_NVID_NULL_REPORT_START(proxyIdx, descNum),
+                       ZID_NULL_REPORT_T_MAX, pCache->nullReport[descNum] ) == SUCCESS)
+    {
+      SET_BIT(&pCache->nullValid, descNum);
+    }
+  }
+
+  pCache->valid = TRUE;
+}
+
+/**************************************************************************************************
+ * @fn          descCacheDrop
+ *
+ * @brief       Invalidate the RAM copy of a proxy table entry.
+ *
+ * input parameters
+ *
+ * @param       proxyIdx - Proxy table index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void descCacheDrop( uint8 proxyIdx )
+{
+  if (proxyIdx < ZID_COMMON_MAX_NUM_PROXIED_DEVICES)
+  {
+    zidAdaDescCache[proxyIdx].valid = FALSE;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          descCacheGet
+ *
+ * @brief       Get the RAM copy of a proxy table entry.
+ *
+ * input parameters
+ *
+ * @param       proxyIdx - Proxy table index.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      Pointer to the copy, or NULL if it is not valid and NV must be read instead.
+ */
+static zidAdaDescCache_t *descCacheGet( uint8 proxyIdx )
+{
+  if ((proxyIdx < ZID_COMMON_MAX_NUM_PROXIED_DEVICES) && zidAdaDescCache[proxyIdx].valid)
+  {
+    return zidAdaDescCache + proxyIdx;
+  }
+
+  return NULL;
+}
+#endif
+
+#if ZID_ADA_CFG_NV_BATCH
+/**************************************************************************************************
+ * @fn          cfgNvWrite
+ *
+ * @brief       Hold an NV item pushed in the configuration phase until cfgNvCommit(). The item is
+ *              written to NV at once if it cannot be held.
+ *
+ * input parameters
+ *
+ * @param       id   - NV item Id.
+ * @param       len  - Length of the item.
+ * @param       pBuf - Pointer to the item.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void cfgNvWrite( uint8 id, uint8 len, void *pBuf )
+{
+  uint8 *pCopy;
+  uint8 idx;
+
+  for (idx = 0; idx < zidAdaCfgNvCnt; idx++)
+  {
+    if (zidAdaCfgNvItems[idx].id == id)
+    {
+      break;
+    }
+  }
+
+  // The batch write reads the item in whole flash words.
+  if ((idx == ZID_ADA_CFG_NV_ITEMS_MAX) ||
+      ((pCopy = osal_mem_alloc( (len + 3) & ~3 )) == NULL))
+  {
+    (void)osal_snv_write( id, len, pBuf );
+    return;
+  }
+
+  (void)osal_memcpy( pCopy, pBuf, len );
+
+  if (idx == zidAdaCfgNvCnt)
+  {
+    zidAdaCfgNvCnt++;
+  }
+  else
+  {
+    osal_mem_free( zidAdaCfgNvItems[idx].pBuf );
+  }
+
+  zidAdaCfgNvItems[idx].id = id;
+  zidAdaCfgNvItems[idx].len = len;
+  zidAdaCfgNvItems[idx].pBuf = pCopy;
+}
+
+/**************************************************************************************************
+ * @fn          cfgNvRead
+ *
+ * @brief       Read an NV item, held or already written.
+ *
+ * input parameters
+ *
+ * @param       id   - NV item Id.
+ * @param       len  - Length to read.
+ *
+ * output parameters
+ *
+ * @param       pBuf - Buffer to read into.
+ *
+ * @return      SUCCESS or the osal_snv_read() status.
+ */
+static uint8 cfgNvRead( uint8 id, uint8 len, void *pBuf )
+{
+  uint8 idx;
+
+  for (idx = 0; idx < zidAdaCfgNvCnt; idx++)
+  {
+    if (zidAdaCfgNvItems[idx].id == id)
+    {
+      (void)osal_memcpy( pBuf, zidAdaCfgNvItems[idx].pBuf, MIN(len, zidAdaCfgNvItems[idx].len) );
+      return SUCCESS;
+    }
+  }
+
+  return osal_snv_read( id, len, pBuf );
+}
+
+/**************************************************************************************************
+ * @fn          cfgNvCommit
+ *
+ * @brief       Write the held configuration items to NV, followed by the pairing info, proxy
+ *              entry and proxy list in one batch, so the entry is never valid without its
+ *              descriptors. Nothing more is written once a batch fails. The held items are freed
+ *              in any case.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      SUCCESS or the failing osal_snv_write_batch() status.
+ */
+static uint8 cfgNvCommit( void )
+{
+  osalSnvItem_t cfgItems[3];
+  uint8 idx, status = SUCCESS;
+
+  for (idx = 0; idx < zidAdaCfgNvCnt; idx += OSAL_SNV_BATCH_MAX)
+  {
+    status = osal_snv_write_batch( MIN(zidAdaCfgNvCnt - idx, OSAL_SNV_BATCH_MAX), zidAdaCfgNvItems + idx );
+    if (status != SUCCESS)
+    {
+      cfgNvDrop();
+      return status;
+    }
+  }
+
+  cfgItems[0].id = ZID_COMMON_NVID_PAIR_INFO;
+  cfgItems[0].len = sizeof(zid_pair_t);
+  cfgItems[0].pBuf = &zidPairInfo;
+  cfgItems[1].id = ZID_ADA_CFG_PXY_ENTRY(zidAda_nextProxyIdx);
+  cfgItems[1].len = sizeof(zid_proxy_entry_t);
+  cfgItems[1].pBuf = pCfgProxy;
+  cfgItems[2].id = ZID_ADA_NVID_PXY_LIST;
+  cfgItems[2].len = sizeof(zidAda_pxyInfoTable);
+  cfgItems[2].pBuf = zidAda_pxyInfoTable;
+  status = osal_snv_write_batch( 3, cfgItems );
+
+  cfgNvDrop();
+  return status;
+}
+
+/**************************************************************************************************
+ * @fn          cfgNvDrop
+ *
+ * @brief       Free the held configuration items.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void cfgNvDrop( void )
+{
+  while (zidAdaCfgNvCnt != 0)
+  {
+    osal_mem_free( zidAdaCfgNvItems[--zidAdaCfgNvCnt].pBuf );
+  }
+}
+#endif
+
 /**************************************************************************************************
  * @fn          sendDataReq
  *
@@ -1739,6 +2218,17 @@ static uint8 procGetAdaAttr(uint8 cnt, uint8 *pReq, uint8 *pBuf)
     /* Store attribute ID in get attribute response command buffer */
     *pBuf++ = id;
 
+#if (ZID_CFG_WINDOW > 1)
+    if (id == ZID_ATTR_CFG_WINDOW)
+    {
+      /* Offer the Class Device a config push window */
+      *pBuf++ = GDP_ATTR_RSP_SUCCESS;
+      *pBuf++ = sizeof(uint8);
+      *pBuf++ = ZID_CFG_WINDOW;
+      continue;
+    }
+#endif
+
     if (idx == ZID_TABLE_IDX_INVALID)
     {
       *pBuf++ = GDP_ATTR_RSP_UNSUPPORTED;
@@ -1866,17 +2356,7 @@ static uint8 stdDescCheck(uint8 len, uint8 *pData)
  */
 static uint8 getAttrTableIdx( uint8 attrId )
 {
-  uint8 idx;
-
-  for (idx = 0; idx < ZID_ADA_ATTRIBUTE_TABLE_LEN; idx++)
-  {
-    if (zidAda_attributeTable[idx].attrId == attrId)
-    {
-      return idx;
-    }
-  }
-
-  return ZID_TABLE_IDX_INVALID;
+  return zidCommon_GetAttrTableIdx( zidAda_attributeTable, attrId );
 }
 
 /**************************************************************************************************
@@ -1897,17 +2377,7 @@ static uint8 getAttrTableIdx( uint8 attrId )
  */
 static uint8 getPxyTableIdx( uint8 attrId )
 {
-  uint8 idx;
-
-  for (idx = 0; idx < ZID_ADA_PROXY_ATTRIBUTE_TABLE_LEN; idx++)
-  {
-    if (zidAda_proxyAttributeTable[idx].attrId == attrId)
-    {
-      return idx;
-    }
-  }
-
-  return ZID_TABLE_IDX_INVALID;
+  return zidCommon_GetAttrTableIdx( zidAda_proxyAttributeTable, attrId );
 }
 
 /**************************************************************************************************
@@ -268,6 +268,22 @@ uint8 zidSendDataCnf(rStatus_t status)
     }
   }
 
+#if FEATURE_ZID_CLD && (ZID_CFG_WINDOW > 1)
+  if (ZID_IS_WINDOW)  // If a config push is to be acknowledged with the later ones.
+  {
+    ZID_CLR_WINDOW();
+
+    if (status == RTI_SUCCESS)
+    {
+      (void)osal_set_event(taskId, ZID_CLD_EVT_CFG_WINDOW);
+    }
+    else
+    {
+      zidRspDone(taskId, FALSE);
+    }
+  }
+#endif
+
   if (ZID_IS_TXING)  // If the ZID co-layer initiated this SendDataReq.
   {
     ZID_CLR_TXING();
@@ -809,5 +825,43 @@ uint8 zidCommon_specCheckWrite(uint8 attrId, uint8 len, uint8 *pValue)
   return rtrn;
 }
 
+/**************************************************************************************************
+ * @fn          zidCommon_GetAttrTableIdx
+ *
+ * @brief       Resolve the index in a ZID_ATTR_TABLE_LEN attribute table of the attribute 'attrId'.
+ *
+ * input parameters
+ *
+ * @param       pTable - The attribute table.
+ * @param       attrId - The ZID Attribute identifier.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      ZID_TABLE_IDX_INVALID if the table does not hold the attribute.
+ *              Otherwise, the index into the table.
+ */
+uint8 zidCommon_GetAttrTableIdx(const zid_table_t *pTable, uint8 attrId)
+{
+  uint8 idx;
+
+  if ((attrId >= aplZIDProfileVersion) && (attrId <= aplReportRepeatInterval))
+  {
+    idx = attrId - aplZIDProfileVersion;
+  }
+  else if ((attrId >= aplHIDParserVersion) && (attrId <= aplHIDNumNonStdDescComps))
+  {
+    idx = attrId - aplHIDParserVersion + ZID_ATTR_TABLE_HID_IDX;
+  }
+  else
+  {
+    return ZID_TABLE_IDX_INVALID;
+  }
+
+  // An unused entry, or one out of place in the table, does not match the Id.
+  return ((pTable[idx].attrId == attrId) ? idx : ZID_TABLE_IDX_INVALID);
+}
+
 /**************************************************************************************************
 */
@@ -7,6 +7,9 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_NP_MAIN
+
 // HAL includes
 #include "hal_types.h"
 #include "hal_board.h"
@@ -7,6 +7,9 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_APP1
+
 #include "comdef.h"
 #include "hal_assert.h"
 #if !defined(ZID_DONGLE_NANO)
@@ -490,6 +493,11 @@ uint16 Dongle_ProcessEvent(uint8 taskId, uint16 events)
     zidDongleKeyReleaseDetected();
   }
 
+  if (events & ZID_DONGLE_EVT_USB_OUT)
+  {
+    zidUsbOutProcess();
+  }
+
   return 0;  // All events processed in one pass; discard unexpected events.
 }
 
@@ -1039,6 +1047,65 @@ void zidDongleOutputReport(uint8 endPoint, uint8 *zidDongleOutBuf , uint8 len)
           zidDongleSendCmdReport(cmdId, ch);
         }
         break;
+      case ZID_DONGLE_CMD_GET_IN_QUEUE_STAT:
+        {
+          uint8 stat = 0;
+#if ZID_IN_QUEUE_DEPTH
+          zidInQueueStats_t stats;
+
+          if (zidInQueueGetStats(zidDongleOutBuf[2] & 0x0F, &stats))
+          {
+            switch (zidDongleOutBuf[2] >> 4)
+            {
+            case ZID_DONGLE_IN_QUEUE_STAT_DROPPED:
+              stat = stats.dropped;
+              break;
+            case ZID_DONGLE_IN_QUEUE_STAT_COALESCED:
+              stat = stats.coalesced;
+              break;
+            case ZID_DONGLE_IN_QUEUE_STAT_HIGH_WATER:
+              stat = stats.highWater;
+              break;
+            default:
+              break;
+            }
+          }
+#endif
+          zidDongleSendCmdReport(cmdId, stat);
+        }
+        break;
+      case ZID_DONGLE_CMD_GET_IN_LATENCY:
+        {
+          uint16 ticks = 0;
+#if ZID_IN_LATENCY
+          zidInLatency_t latency;
+
+          zidInLatencyGet(&latency, (zidDongleOutBuf[2] == ZID_DONGLE_IN_LATENCY_CNT));
+          switch (zidDongleOutBuf[2])
+          {
+          case ZID_DONGLE_IN_LATENCY_LAST:
+            ticks = latency.last;
+            break;
+          case ZID_DONGLE_IN_LATENCY_MAX:
+            ticks = latency.max;
+            break;
+          case ZID_DONGLE_IN_LATENCY_CNT:
+            ticks = latency.cnt;
+            break;
+          default:
+            break;
+          }
+#endif
+          zidDongleSendCmdReport(cmdId, (ticks > 0xFF) ? 0xFF : (uint8)ticks);
+        }
+        break;
+      case ZID_DONGLE_CMD_GET_OUT_RATE:
+        {
+          uint16 rate = zidUsbGetOutRate();
+
+          zidDongleSendCmdReport(cmdId, (rate > 0xFF) ? 0xFF : (uint8)rate);
+        }
+        break;
 #ifdef FEATURE_SBL
       case ZID_DONGLE_CMD_ENTER_BOOTMODE:
         {
@@ -1168,6 +1235,10 @@ static void zidDataInd(uint8 srcIndex, uint8 len, uint8 *pData)
           return;
         }
       }
+#endif
+#if ZID_IN_LATENCY
+      // The RCN library, MAC receive ISR included, is prebuilt, so time from the RTI callback.
+      zidInLatencyStart();
 #endif
       /* Report records were validated in ZID, so no error checking needed */
       len -= 1; // subtract GDP header length
@@ -1510,9 +1581,12 @@ void RTI_AllowPairCnf( rStatus_t status, uint8 dstIndex, uint8 devType )
   {
     // May be allowing pairing with non-ZID (i.e. CERC profile), so check for ZID.
     if ((RCN_NlmeGetPairingEntryReq(dstIndex, &pEntry) == RCN_SUCCESS) &&  // Fail not expected here.
-        GET_BIT(pEntry->profileDiscs, RCN_PROFILE_DISC_ZID))
+        GET_BIT(pEntry->profileDiscs, RCN_PROFILE_DISC_ZID) &&
+        !zidPxyEntry(dstIndex))
     {
-      zidPxyEntry(dstIndex);
+      // Every ZID interface is taken, so the new device is not kept paired without one.
+      RTI_UnpairReq(dstIndex);
+      status = RTI_ERROR_NO_PAIRING_INDEX;
     }
   }
 
@@ -27,6 +27,7 @@ extern "C" {
 #define ZID_DONGLE_EVT_START              0x0001 // Start the application
 #define ZID_DONGLE_EVT_KEY_RELEASE_TIMER  0x0002 // timer to detect key release
 #define ZID_DONGLE_EVT_RTI_INIT_CNF       0x0004 // timer to detect key release
+#define ZID_DONGLE_EVT_USB_OUT            0x0008 // output reports received from the USB host
 
 // output report buffer size
 #define ZID_DONGLE_OUTBUF_SIZE              3
@@ -50,6 +51,23 @@ extern "C" {
 #ifdef FEATURE_SBL
 #define ZID_DONGLE_CMD_ENTER_BOOTMODE    7
 #endif
+#define ZID_DONGLE_CMD_GET_IN_QUEUE_STAT 8
+// Replies with the number of output reports handled in the last second, saturated at 255.
+#define ZID_DONGLE_CMD_GET_OUT_RATE      9
+// Replies with a report latency counter of ZID_IN_LATENCY, saturated at 255.
+#define ZID_DONGLE_CMD_GET_IN_LATENCY    10
+
+// Counters read by ZID_DONGLE_CMD_GET_IN_QUEUE_STAT, whose parameter is the IN endpoint in the
+// low nibble and one of these in the high nibble. The counter value is returned as the status.
+#define ZID_DONGLE_IN_QUEUE_STAT_DROPPED     0
+#define ZID_DONGLE_IN_QUEUE_STAT_COALESCED   1
+#define ZID_DONGLE_IN_QUEUE_STAT_HIGH_WATER  2
+
+// Counters read by ZID_DONGLE_CMD_GET_IN_LATENCY, whose parameter is one of these. Latencies are
+// in sleep timer ticks (30.5 usec); reading the count clears all three.
+#define ZID_DONGLE_IN_LATENCY_LAST           0
+#define ZID_DONGLE_IN_LATENCY_MAX            1
+#define ZID_DONGLE_IN_LATENCY_CNT            2
 
 /**************************************************************************************************
  * TYPEDEFS
@@ -7,6 +7,9 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_APP2
+
 #include <stddef.h>
 #include "comdef.h"
 #include "hal_assert.h"
@@ -24,6 +27,7 @@
 #include "zid_usb.h"
 #include "usb_zid_reports.h"
 #include "usb_zid_class_requests.h"
+#include "usb_framework.h"
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Constants
@@ -92,13 +96,25 @@ const zid_proxy_entry_t pPxyZIDNPIKeyboard =
  * ------------------------------------------------------------------------------------------------
  */
 
+static uint8 pxyReadEntry(uint8 pairIdx, zid_proxy_entry_t *pProxy);
+static uint8 pxyEnumerate(void);
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Local Variables
  * ------------------------------------------------------------------------------------------------
  */
 
 static bool zidPxy_deviceEnumerated = FALSE;
-static uint8 zidPxy_enumeratedDevicePairingEntry = RTI_INVALID_PAIRING_REF;
+// Pairing index proxied on each ZID interface, in interface order.
+static uint8 zidPxy_ifacePairIdx[ZID_USB_NUM_PXY_IFACES];
+// Number of ZID interfaces currently enumerated on the USB.
+static uint8 zidPxy_numIfaces = 0;
+// Number of IN reports dropped because their device had no ZID interface.
+static uint16 zidPxy_numDropped = 0;
+#if defined ZID_USB_RNP
+// The one ZID interface is the fixed standard Keyboard interface, shared by all devices.
+static bool zidPxy_stdIface = FALSE;
+#endif
 static uint8 pxyInfoTable[RCN_CAP_PAIR_TABLE_SIZE];
 
 /* ------------------------------------------------------------------------------------------------
@@ -109,86 +125,65 @@ static uint8 pxyInfoTable[RCN_CAP_PAIR_TABLE_SIZE];
 /**************************************************************************************************
  * @fn          zidPxyEntry
  *
- * @brief       This function saves the Proxy Entry to NV & enumerates it on the USB.
+ * @brief       This function assigns the paired device a ZID interface & enumerates it on the USB.
+ *              A new device is refused when all interfaces are taken, rather than displacing a
+ *              device that would then be left paired with no interface.
  *
  * input parameters
  *
  * @param       pairIdx - Pairing table index of source.
- * @param       pProxy - Pointer to the zid_proxy_entry_t.
  *
  * output parameters
  *
  * None.
  *
- * @return      None.
+ * @return      TRUE if the device has an interface; FALSE if all interfaces are taken.
  */
-void zidPxyEntry( uint8 pairIdx )
+uint8 zidPxyEntry( uint8 pairIdx )
 {
-  rStatus_t status;
-  zid_proxy_entry_t *pProxy;
-  uint8 i;
-  zid_non_std_desc_comp_t *nonStdDescCompList[aplcMaxNonStdDescCompsPerHID] = { NULL };
-  uint8 localPairIndex = pairIdx;
+  uint8 slot;
 
-  /* Set current proxy entry in preparation for reading of proxy info */
-  status = RTI_WriteItemEx( RTI_PROFILE_ZID,
-                            ZID_ITEM_CURRENT_PXY_NUM,
-                            sizeof( uint8 ),
-                            &localPairIndex );
-  if (status == RTI_SUCCESS)
+  // A re-pairing device keeps its interface, a new one takes the first free interface.
+  for (slot = 0; slot < ZID_USB_NUM_PXY_IFACES; slot++)
   {
-    /* Read proxy info from ZID ADA */
-    pProxy = osal_mem_alloc( sizeof(zid_proxy_entry_t) );
-    if (pProxy != NULL)
+    if (zidPxy_ifacePairIdx[slot] == pairIdx)
     {
-      status = RTI_ReadItemEx( RTI_PROFILE_ZID,
-                               ZID_ITEM_CURRENT_PXY_ENTRY,
-                               sizeof(zid_proxy_entry_t),
-                               (uint8 *)pProxy );
-
-      if (status == RTI_SUCCESS)
+      break;
+    }
+  }
+  if (slot == ZID_USB_NUM_PXY_IFACES)
+  {
+    for (slot = 0; slot < ZID_USB_NUM_PXY_IFACES; slot++)
+    {
+      if (zidPxy_ifacePairIdx[slot] == RTI_INVALID_PAIRING_REF)
       {
-        /* If proxy entry indicates non std descriptors, read them here */
-        if (pProxy->HIDNumNonStdDescComps > 0)
-        {
-          for (i = 0; i < pProxy->HIDNumNonStdDescComps; i++)
-          {
-            nonStdDescCompList[i] = osal_mem_alloc( ZID_NON_STD_DESC_SPEC_T_MAX );
-            (void)zidAdaAppHlp_ReadNonStdDescComp( pairIdx, i, nonStdDescCompList[i] );
-          }
-        }
+        break;
+      }
+    }
+  }
+  if (slot == ZID_USB_NUM_PXY_IFACES)
+  {
+    // No free interface; the devices already proxied keep theirs.
+    return FALSE;
+  }
+  zidPxy_ifacePairIdx[slot] = pairIdx;
 
-        /* Now that information has been collected, enumerate the device */
+  /* Now that information has been collected, enumerate the devices */
 #if !defined ZID_USB_RNP
-        if (USB_ALREADY == zidUsbEnumerate( pProxy ))
-        {
-          // un-enumerate and try again
-          zidUsbUnEnum();
-          (void)zidUsbEnumerate(pProxy);
-        }
+  if (pxyEnumerate() == USB_SUCCESS)
 #endif
-        zidPxy_deviceEnumerated = TRUE;
-        zidPxy_enumeratedDevicePairingEntry = pairIdx;
+  {
+    zidPxy_deviceEnumerated = TRUE;
 
-        /* Set LEDs to indicate device is ready to use */
+    /* Set LEDs to indicate device is ready to use */
 #if (defined HAL_LED && (HAL_LED == TRUE))
-        HalLedSet(HAL_LED_1, HAL_LED_MODE_ON);
-        HalLedSet(HAL_LED_2, HAL_LED_MODE_OFF);
-        osal_stop_timerEx(zidDongleTaskId, ZID_DONGLE_EVT_LED);
+    HalLedSet(HAL_LED_1, HAL_LED_MODE_ON);
+    HalLedSet(HAL_LED_2, HAL_LED_MODE_OFF);
+    osal_stop_timerEx(zidDongleTaskId, ZID_DONGLE_EVT_LED);
 #endif
-      }
-
-      /* Done with memory, so free it */
-      for (i = 0; i < pProxy->HIDNumNonStdDescComps; i++)
-      {
-        if (nonStdDescCompList[i] != NULL)
-        {
-          osal_mem_free( nonStdDescCompList[i] );
-        }
-      }
-      osal_mem_free( pProxy );
-    }
   }
+
+  return TRUE;
 }
 
 /**************************************************************************************************
@@ -209,9 +204,16 @@ void zidPxyEntry( uint8 pairIdx )
 void zidPxyInit(void)
 {
   rStatus_t status;
-  uint8 pxyIdx;
-  bool proxyDevice = FALSE;
-  zid_proxy_entry_t *pProxy = NULL;
+  uint8 idx, slot;
+
+  for (slot = 0; slot < ZID_USB_NUM_PXY_IFACES; slot++)
+  {
+    zidPxy_ifacePairIdx[slot] = RTI_INVALID_PAIRING_REF;
+  }
+  zidPxy_numIfaces = 0;
+#if defined ZID_USB_RNP
+  zidPxy_stdIface = FALSE;
+#endif
 
   /* First see if there is a saved proxy info table */
   status = RTI_ReadItemEx( RTI_PROFILE_ZID,
@@ -220,59 +222,32 @@ void zidPxyInit(void)
                            (uint8 *)pxyInfoTable );
   if (status == RTI_SUCCESS)
   {
-    /* There was a saved table. If any proxied items exist, enumerate them */
-    uint8 idx;
-
-    pxyIdx = RTI_INVALID_PAIRING_REF;
+    /* There was a saved table. If any proxied items exist, enumerate them.
+     * If there are more than there are interfaces, proxy the last devices added,
+     * which should correspond to the highest pairing indices, and unpair the others
+     * rather than keep them paired with no interface.
+     */
+    slot = 0;
     for (idx = 0; idx < ZID_COMMON_MAX_NUM_PROXIED_DEVICES; idx++)
     {
       if (pxyInfoTable[idx] != RTI_INVALID_PAIRING_REF)
       {
-        /* In this application, we are only allowing 1 proxy entry. So, we are
-         * just going to proxy the last device added, which should correspond
-         * to the highest pairing index.
-         */
-        pxyIdx = pxyInfoTable[idx];
-      }
-    }
-  }
-  else
-  {
-    /* No table, so no proxy entry */
-    pxyIdx = RTI_INVALID_PAIRING_REF;
-  }
-
-  if (pxyIdx != RTI_INVALID_PAIRING_REF)
-  {
-    /* Found a device, so attempt to extract its proxy info. First set
-     * current proxy entry in preparation for reading of proxy info.
-     */
-    status = RTI_WriteItemEx( RTI_PROFILE_ZID,
-                              ZID_ITEM_CURRENT_PXY_NUM,
-                              sizeof( uint8 ),
-                              &pxyIdx );
-    if (status == RTI_SUCCESS)
-    {
-      pProxy = osal_mem_alloc( sizeof(zid_proxy_entry_t) );
-      if (pProxy != NULL)
-      {
-        status = RTI_ReadItemEx( RTI_PROFILE_ZID,
-                                 ZID_ITEM_CURRENT_PXY_ENTRY,
-                                 sizeof(zid_proxy_entry_t),
-                                 (uint8 *)pProxy );
-        if (status == RTI_SUCCESS)
+        if (slot == ZID_USB_NUM_PXY_IFACES)
         {
-          proxyDevice = TRUE;
+          RTI_UnpairReq(zidPxy_ifacePairIdx[0]);
+          (void)osal_memcpy(zidPxy_ifacePairIdx, zidPxy_ifacePairIdx + 1, ZID_USB_NUM_PXY_IFACES - 1);
+          slot--;
         }
+        zidPxy_ifacePairIdx[slot++] = pxyInfoTable[idx];
       }
     }
   }
 
-  if (proxyDevice == TRUE)
+  if (zidPxy_ifacePairIdx[0] != RTI_INVALID_PAIRING_REF)
   {
     zidUsbUnEnum();
 #if (defined HAL_LED && (HAL_LED == TRUE))
-    if (USB_SUCCESS == zidUsbEnumerate( pProxy ))
+    if (USB_SUCCESS == pxyEnumerate())
     {
       HalLedSet(HAL_LED_1, HAL_LED_MODE_ON);
     }
@@ -281,21 +256,22 @@ void zidPxyInit(void)
       HalLedSet(HAL_LED_1, HAL_LED_MODE_BLINK);
     }
 #else
-    (void)zidUsbEnumerate( pProxy );
+    (void)pxyEnumerate();
 #endif
     zidPxy_deviceEnumerated = TRUE;
-    zidPxy_enumeratedDevicePairingEntry = pxyIdx;
   }
   else
   {
 #if defined ZID_USB_RNP
+    zid_proxy_entry_t *pProxy;
+
     zidUsbUnEnum();
     pProxy = osal_mem_alloc(sizeof(zid_proxy_entry_t));
     if (pProxy != NULL)
     {
       osal_memcpy((uint8*)pProxy, (uint8*)&pPxyZIDNPIKeyboard, sizeof(zid_proxy_entry_t));
 #if (defined HAL_LED && (HAL_LED == TRUE))
-      if (USB_SUCCESS == zidUsbEnumerate( pProxy ))
+      if (USB_SUCCESS == zidUsbEnumerate( 1, pProxy ))
       {
 //      HalLedSet(HAL_LED_1, HAL_LED_MODE_ON);
       }
@@ -304,17 +280,16 @@ void zidPxyInit(void)
         HalLedSet(HAL_LED_1, HAL_LED_MODE_BLINK);
       }
 #else
-      (void)zidUsbEnumerate( pProxy );
+      (void)zidUsbEnumerate( 1, pProxy );
 #endif
+      zidPxy_numIfaces = 1;
+      zidPxy_stdIface = TRUE;
+
+      /* Free up memory */
+      osal_mem_free( pProxy );
     }
 #endif
   }
-
-  /* Free up memory if necessary */
-  if (pProxy != NULL)
-  {
-    osal_mem_free( pProxy );
-  }
 }
 
 /**************************************************************************************************
@@ -331,27 +306,58 @@ void zidPxyInit(void)
  *
  * None.
  *
- * @return      TRUE if the report was successfully proxied; FALSE otherwise.
+ * @return      TRUE if the report was successfully proxied; FALSE otherwise, including when the
+ *              device has no interface of its own, which drops the report.
  */
 uint8 zidPxyReport( uint8 pairIdx, zid_report_record_t *pReport )
 {
   uint8 rtrn = FALSE;
+  uint8 slot;
+#if !ZID_IN_QUEUE_DEPTH
   uint8 i;
-
-  /* Since this application only allows 1 proxy device, the pairing index
-   * is not used.
-   */
-  (void) pairIdx;
+#endif
 
   if (pReport->type == ZID_REPORT_TYPE_IN)
   {
     // we will allow any report ID so that user can configure own desired implementation
-    uint8 endPoint = ZID_PROXY_ZID_EP_IN_ADDR;
+    uint8 endPoint;
+
+    // Each proxied device reports on the IN EP of its own interface.
+    for (slot = 0; slot < zidPxy_numIfaces; slot++)
+    {
+      if (zidPxy_ifacePairIdx[slot] == pairIdx)
+      {
+        break;
+      }
+    }
+
+#if defined ZID_USB_RNP
+    // The fixed standard interface has no device of its own, so it serves every device alike.
+    if (zidPxy_stdIface)
+    {
+      slot = 0;
+    }
+#endif
+
+    if (slot == zidPxy_numIfaces)
+    {
+      // Another device's interface would give the report its descriptor and report Ids.
+      if (zidPxy_numDropped != 0xFFFF)
+      {
+        zidPxy_numDropped++;
+      }
+      return FALSE;
+    }
+    endPoint = zid_usb_pxy_in_ep[slot];
 
     // Assert the dependency on the packed, consecutive placement of 'id' & 'data'
     // in zid_report_data_cmd_t.
     HAL_ASSERT(offsetof(zid_report_record_t, data) == offsetof(zid_report_record_t, id)+1);
 
+#if ZID_IN_QUEUE_DEPTH
+    // A busy endpoint queues the report, to be sent as soon as the host has taken the last one.
+    rtrn = zidSendInReport((uint8 *)&pReport->id, endPoint, pReport->len - 1);
+#else
     // Attempt up to 3 times to send the report.
     for (i = 0; i < 3; i++)
     {
@@ -360,11 +366,33 @@ uint8 zidPxyReport( uint8 pairIdx, zid_report_record_t *pReport )
         break;
       }
     }
+#endif
   }
 
   return rtrn;
 }
 
+/**************************************************************************************************
+ * @fn          zidPxyNumDropped
+ *
+ * @brief       This function returns the number of IN reports dropped because their device had no
+ *              ZID interface.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The number of reports dropped since start-up, saturating.
+ */
+uint16 zidPxyNumDropped( void )
+{
+  return zidPxy_numDropped;
+}
+
 /**************************************************************************************************
  * @fn          zidPxyServeHIDClassRequests
  *
@@ -386,14 +414,18 @@ uint8 zidPxyServeHIDClassRequests(uint8 requestType, ZID_CLASS_REQUEST_DATA_OUT
   uint8 rtrn = FALSE, write = FALSE;
   rStatus_t status = !RTI_SUCCESS;
   zid_proxy_entry_t pProxy;
+  // The request is addressed to the interface of one of the proxied devices.
+  uint8 slot = (uint8)(usbSetupHeader.index - INTERFACE_NUMBER_ZID);
+
+  if (slot >= zidPxy_numIfaces)
+  {
+    slot = 0;
+  }
 
   if (zidPxy_deviceEnumerated == TRUE)
   {
     /* Read proxy info from ZID ADA */
-    status = RTI_ReadItemEx( RTI_PROFILE_ZID,
-                             ZID_ITEM_CURRENT_PXY_ENTRY,
-                             sizeof(zid_proxy_entry_t),
-                             (uint8 *)&pProxy );
+    status = pxyReadEntry( zidPxy_ifacePairIdx[slot], &pProxy );
     if (status == RTI_SUCCESS)
     {
       switch (requestType)
@@ -471,7 +503,12 @@ void zidPxyReset( void )
     zidUsbUnEnum();
 #endif
     zidPxy_deviceEnumerated = FALSE;
-    zidPxy_enumeratedDevicePairingEntry = RTI_INVALID_PAIRING_REF;
+    zidPxy_numIfaces = 0;
+
+    for (idx = 0; idx < ZID_USB_NUM_PXY_IFACES; idx++)
+    {
+      zidPxy_ifacePairIdx[idx] = RTI_INVALID_PAIRING_REF;
+    }
 
     for (idx = 0; idx < RCN_CAP_PAIR_TABLE_SIZE; idx++)
     {
@@ -504,18 +541,124 @@ void zidPxyReset( void )
  */
 void zidPxyUnpair( uint8 pairIdx )
 {
-  if (pairIdx == zidPxy_enumeratedDevicePairingEntry)
+  uint8 slot;
+
+  for (slot = 0; slot < ZID_USB_NUM_PXY_IFACES; slot++)
+  {
+    if (zidPxy_ifacePairIdx[slot] == pairIdx)
+    {
+      zidPxy_ifacePairIdx[slot] = RTI_INVALID_PAIRING_REF;
+      break;
+    }
+  }
+
+  if (slot < ZID_USB_NUM_PXY_IFACES)
   {
 #if !defined ZID_USB_RNP
-    zidUsbUnEnum();
+    // Re-enumerate without the interface of the unpaired device.
+    (void)pxyEnumerate();
 #endif
-    zidPxy_deviceEnumerated = FALSE;
-    zidPxy_enumeratedDevicePairingEntry = RTI_INVALID_PAIRING_REF;
   }
 
+  for (slot = 0; slot < ZID_USB_NUM_PXY_IFACES; slot++)
+  {
+    if (zidPxy_ifacePairIdx[slot] != RTI_INVALID_PAIRING_REF)
+    {
+      break;
+    }
+  }
+
+  if (slot == ZID_USB_NUM_PXY_IFACES)
+  {
+    zidPxy_deviceEnumerated = FALSE;
 #if (defined HAL_LED && (HAL_LED == TRUE))
-  HalLedSet(HAL_LED_1, HAL_LED_MODE_OFF);
+    HalLedSet(HAL_LED_1, HAL_LED_MODE_OFF);
 #endif
+  }
+}
+
+/**************************************************************************************************
+ * @fn          pxyReadEntry
+ *
+ * @brief       This function reads the proxy entry of a paired device from the ZID ADA.
+ *
+ * input parameters
+ *
+ * @param       pairIdx - Pairing table index of the device.
+ *
+ * output parameters
+ *
+ * @param       pProxy - Pointer to the zid_proxy_entry_t to read into.
+ *
+ * @return      RTI_SUCCESS if the entry was read; otherwise the RTI status.
+ */
+static uint8 pxyReadEntry(uint8 pairIdx, zid_proxy_entry_t *pProxy)
+{
+  /* Set current proxy entry in preparation for reading of proxy info */
+  rStatus_t status = RTI_WriteItemEx( RTI_PROFILE_ZID,
+                                      ZID_ITEM_CURRENT_PXY_NUM,
+                                      sizeof( uint8 ),
+                                      &pairIdx );
+  if (status == RTI_SUCCESS)
+  {
+    status = RTI_ReadItemEx( RTI_PROFILE_ZID,
+                             ZID_ITEM_CURRENT_PXY_ENTRY,
+                             sizeof(zid_proxy_entry_t),
+                             (uint8 *)pProxy );
+  }
+
+  return status;
+}
+
+/**************************************************************************************************
+ * @fn          pxyEnumerate
+ *
+ * @brief       This function packs the proxied devices onto the first interfaces and (re-)enumerates
+ *              them on the USB, one ZID interface per device.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The zidUsbEnumerate() status; USB_MEMORY0 if out of memory.
+ */
+static uint8 pxyEnumerate(void)
+{
+  zid_proxy_entry_t *pProxy;
+  uint8 slot, numPxy = 0;
+  uint8 status = USB_MEMORY0;
+
+  // Pack the devices, dropping any whose proxy entry can no longer be read.
+  pProxy = osal_mem_alloc( ZID_USB_NUM_PXY_IFACES * sizeof(zid_proxy_entry_t) );
+  if (pProxy != NULL)
+  {
+    for (slot = 0; slot < ZID_USB_NUM_PXY_IFACES; slot++)
+    {
+      if ((zidPxy_ifacePairIdx[slot] != RTI_INVALID_PAIRING_REF) &&
+          (pxyReadEntry(zidPxy_ifacePairIdx[slot], pProxy + numPxy) == RTI_SUCCESS))
+      {
+        zidPxy_ifacePairIdx[numPxy++] = zidPxy_ifacePairIdx[slot];
+      }
+    }
+    for (slot = numPxy; slot < ZID_USB_NUM_PXY_IFACES; slot++)
+    {
+      zidPxy_ifacePairIdx[slot] = RTI_INVALID_PAIRING_REF;
+    }
+
+    zidUsbUnEnum();
+    status = zidUsbEnumerate( numPxy, pProxy );
+    zidPxy_numIfaces = (status == USB_SUCCESS) ? numPxy : 0;
+#if defined ZID_USB_RNP
+    zidPxy_stdIface = FALSE;
+#endif
+    osal_mem_free( pProxy );
+  }
+
+  return status;
 }
 
 /**************************************************************************************************
@@ -29,7 +29,7 @@ extern "C" {
 /**************************************************************************************************
  * @fn          zidPxyEntry
  *
- * @brief       This function saves the Proxy Entry to NV.
+ * @brief       This function assigns the paired device a ZID interface & enumerates it on the USB.
  *
  * input parameters
  *
@@ -39,9 +39,9 @@ extern "C" {
  *
  * None.
  *
- * @return      None.
+ * @return      TRUE if the device has an interface; FALSE if all interfaces are taken.
  */
-void zidPxyEntry( uint8 pairIdx );
+uint8 zidPxyEntry( uint8 pairIdx );
 
 /**************************************************************************************************
  * @fn          zidPxyInit
@@ -78,6 +78,24 @@ void zidPxyInit(void);
  */
 uint8 zidPxyReport( uint8 pairIdx, zid_report_record_t *pReport );
 
+/**************************************************************************************************
+ * @fn          zidPxyNumDropped
+ *
+ * @brief       This function returns the number of IN reports dropped because their device had no
+ *              ZID interface.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The number of reports dropped since start-up, saturating.
+ */
+uint16 zidPxyNumDropped( void );
+
 /**************************************************************************************************
  * @fn          zidSPxyerveHIDClassRequests
  *
@@ -8,6 +8,9 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_APP3
+
 #include "comdef.h"
 #include "hal_assert.h"
 #include "OSAL.h"
@@ -64,13 +67,14 @@
 #define ZID_USB_NUM_INTERFACES                1
 #endif
 
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-#define DESC_LUT_INFO_SIZE                   (sizeof(DESC_LUT_INFO) * 3 * 2)  // Need both HID and HID Report descriptors
-#define DBLBUF_LUT_INFO_SIZE                 (sizeof(DBLBUF_LUT_INFO) * 3)
-#else //ZID_USB_RNP
-#define DESC_LUT_INFO_SIZE                   (sizeof(DESC_LUT_INFO) * 1 * 2)  // Need both HID and HID Report descriptors
-#define DBLBUF_LUT_INFO_SIZE                 (sizeof(DBLBUF_LUT_INFO) * 1)
-#endif //ZID_USB_RNP && ZID_USB_CE
+// Number of interfaces enumerated with N proxied devices.
+#define ZID_USB_NUM_IFACES(N)                (ZID_USB_NUM_INTERFACES - 1 + (N))
+
+#define DESC_LUT_INFO_SIZE(N)                (sizeof(DESC_LUT_INFO) * ZID_USB_NUM_IFACES(N) * 2)  // Need both HID and HID Report descriptors
+#define DBLBUF_LUT_INFO_SIZE(N)              (sizeof(DBLBUF_LUT_INFO) * ZID_USB_NUM_IFACES(N))
+
+// The EP1 FIFO is only 32 bytes.
+#define ZID_USB_EP1_MAX_PACKET_SIZE          0x20
 
 const uint8 usb_device_desc[] =
 {
@@ -105,6 +109,11 @@ const uint8 zid_usb_report_len[ZID_STD_REPORT_TOTAL_NUM+1] =
   ZID_TAP_SUPPORT_PROPERTIES_DATA_LEN + 1
 };
 
+const uint8 zid_usb_pxy_in_ep[ZID_USB_MAX_PXY_IFACES] =
+{
+  ZID_USB_PXY_IN_EPS
+};
+
 /**************************************************************************************************
  * Start of the Configuration1 total size.
  */
@@ -833,26 +842,19 @@ USB_DESCRIPTOR_MARKER usbDescriptorMarker;
 #define ZID_IFACE_DESC                (ZID_CONFIG_DESC              +  DESC_SIZE_CONFIG)
 #endif // ZID_USB_RNP
 
-#define ZID_HID_DESC                  (ZID_IFACE_DESC               +  DESC_SIZE_INTERFACE)
-#define ZID_IN_EP_DESC                (ZID_HID_DESC                 +  DESC_SIZE_HID_W1HIDRD)
-#define ZID_OUT_EP_DESC               (ZID_IN_EP_DESC               +  DESC_SIZE_ENDPOINT)
-
-#define ZID_STRING_DESC_LANGID        (ZID_OUT_EP_DESC              +  DESC_SIZE_ENDPOINT)
-#define ZID_STRING_DESC_MANUFACTURER  (ZID_STRING_DESC_LANGID       +  DESC_SIZE_STRING_LANGID)
-#define ZID_STRING_DESC_PRODUCT       (ZID_STRING_DESC_MANUFACTURER +  DESC_SIZE_STRING_MANUFACTURER)
-#define ZID_STRING_DESC_SERIALNO      (ZID_STRING_DESC_PRODUCT      +  DESC_SIZE_STRING_PRODUCT)
-
-#define ZID_DEVICE_DESC_2EP_END       (ZID_STRING_DESC_SERIALNO     +  DESC_SIZE_STRING_SERIALNO)
-#define ZID_DEVICE_DESC_1EP_END       (ZID_DEVICE_DESC_2EP_END      -  DESC_SIZE_ENDPOINT)
-
-#define DESC_SIZE_ZID_ADD             (DESC_SIZE_INTERFACE + DESC_SIZE_HID_W1HIDRD + 2*DESC_SIZE_ENDPOINT)
-#define ZID_DEVICE_DESC_NO_ZID_END    (ZID_DEVICE_DESC_2EP_END      -  DESC_SIZE_ZID_ADD)
+/* The proxied ZID interfaces follow ZID_IFACE_DESC, each with its Interface, HID and Endpoint
+ * Descriptors; their sizes vary, so they are located as they are built.
+ */
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Local Functions
  * ------------------------------------------------------------------------------------------------
  */
 
+#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
+static void outRateUpdate(void);
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Local Variables
  * ------------------------------------------------------------------------------------------------
@@ -860,6 +862,30 @@ USB_DESCRIPTOR_MARKER usbDescriptorMarker;
 
 static uint8 *zidDesc = NULL;
 
+#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
+#define ZID_USB_OUT_EP_CNT     2  // The RNP and the ZID OUT EPs.
+#define ZID_USB_OUT_BUF_CNT    2  // Double buffered: one packet can be read while one is handled.
+#define ZID_USB_OUT_BUF_LEN    RNP_EP_OUT_PACKET_LEN
+
+// Receive buffers of an OUT EP, filled from the FIFO & handed to the application task in turn.
+typedef struct
+{
+  uint8 len[ZID_USB_OUT_BUF_CNT];  // Length of the report in each buffer; 0 if the buffer is free.
+  uint8 buf[ZID_USB_OUT_BUF_CNT][ZID_USB_OUT_BUF_LEN];
+  uint8 rd;
+  uint8 wr;
+} zidUsbOutEp_t;
+
+static zidUsbOutEp_t zidUsbOutEp[ZID_USB_OUT_EP_CNT];
+static const uint8 zidUsbOutEpAddr[ZID_USB_OUT_EP_CNT] = { RNP_EP_OUT_ADDR, ZID_EP_OUT_ADDR };
+static const uint8 zidUsbOutEpLen[ZID_USB_OUT_EP_CNT] = { RNP_EP_OUT_PACKET_LEN, 2 };
+
+// OUT packets handled in the current second, and in the last full second.
+static uint16 zidUsbOutCnt;
+static uint16 zidUsbOutRate;
+static uint32 zidUsbOutRateStart;
+#endif  //ZID_USB_RNP
+
 /* ------------------------------------------------------------------------------------------------
  *                                           Global Variables
  * ------------------------------------------------------------------------------------------------
@@ -868,7 +894,9 @@ static uint8 *zidDesc = NULL;
 /**************************************************************************************************
  * @fn          usbOutReportPoll
  *
- * @brief       Poll output reports from the USB Host.
+ * @brief       Poll output reports from the USB Host. A report is read straight from the FIFO into
+ *              a free receive buffer of the EP and handed to the application task. With no free
+ *              buffer, the packet is left in the FIFO, NAK'ing the host until zidUsbOutProcess().
  *
  * input parameters
  *
@@ -883,38 +911,36 @@ static uint8 *zidDesc = NULL;
 void usbOutReportPoll(uint8 endPoint)
 {
 #if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  uint8 controlReg;
-  uint16 bytesNow;
   uint8 oldEndpoint;
-  uint8 *pBuf;
-  uint8 readSize;   // Dependent on EP
-
-  // Variables and buffers that should be controlled by application
-  uint8 *pData;
-  uint8 len = 0;
-  switch (endPoint) {
-  case RNP_EP_OUT_ADDR:
-    len = RNP_EP_OUT_PACKET_LEN;
-    break;
-  case ZID_EP_OUT_ADDR:
-    len = 2;
-    break;
+  uint16 bytesNow;
+  uint8 idx, len;
+  zidUsbOutEp_t *pOut;
+
+  for (idx = 0; idx < ZID_USB_OUT_EP_CNT; idx++)
+  {
+    if (zidUsbOutEpAddr[idx] == endPoint)
+    {
+      break;
+    }
+  }
+  if (idx == ZID_USB_OUT_EP_CNT)
+  {
+    return;
   }
-  pData = osal_mem_alloc(len);
+  pOut = zidUsbOutEp + idx;
+  len = zidUsbOutEpLen[idx];
 
-  // Save the old index setting, then select endpoint 0 and fetch the control register
+  if (pOut->len[pOut->wr] != 0)
+  {
+    return;
+  }
+
+  // Save the old index setting, then select the endpoint
   oldEndpoint = USBFW_GET_SELECTED_ENDPOINT();
   USBFW_SELECT_ENDPOINT(endPoint);
 
-  // Read registers for interrupt reason
-  controlReg = USBCSOL;
-
-  // Check allocated size for this OUT EP. This is the maximum number of bytes
-  // that can be read out of the FIFO.
-  readSize = (USBMAXO << 3);
-
   // Receive OUT packets
-  if (controlReg & USBCSOL_OUTPKT_RDY)
+  if (USBCSOL & USBCSOL_OUTPKT_RDY)
   {
     // Read FIFO
     bytesNow = (uint16) USBCNTL;
@@ -925,41 +951,28 @@ void usbOutReportPoll(uint8 endPoint)
       // Ignore invalid length report.
       while (bytesNow > len)
       {
-        usbfwReadFifo(((&USBF0) + (endPoint << 1)), len, pData);
+        usbfwReadFifo(((&USBF0) + (endPoint << 1)), len, pOut->buf[pOut->wr]);
         bytesNow -= len;
       }
       if (bytesNow > 0)
       {
-        usbfwReadFifo(((&USBF0) + (endPoint << 1)), bytesNow, pData);
+        usbfwReadFifo(((&USBF0) + (endPoint << 1)), bytesNow, pOut->buf[pOut->wr]);
       }
       // clear outpkt_ready flag and overrun, sent_stall, etc. just in case
       USBCSOL = 0;
     }
     else
     {
-      pBuf = pData;
-      while (bytesNow > readSize)
-      {
-        // since usbfwReadFifo function supports only upto readSize byte read
-        // multiple calls are made in the loop
-        usbfwReadFifo(((&USBF0) + (endPoint << 1)), readSize, pBuf);
-        bytesNow -= readSize;
-        pBuf += readSize;
-      }
-      if (bytesNow > 0)
-      {
-        // read the remainder
-        usbfwReadFifo(((&USBF0) + (endPoint << 1)), bytesNow, pBuf);
-      }
+      // The report fits the FIFO packet, so it is read out in one go.
+      usbfwReadFifo(((&USBF0) + (endPoint << 1)), bytesNow, pOut->buf[pOut->wr]);
       // clear outpkt_ready flag and overrun, sent_stall, etc. just in case
       USBCSOL = 0;
 
-      // application specific handling
-      zidDongleOutputReport(endPoint, pData, len);
+      pOut->len[pOut->wr] = len;
+      pOut->wr ^= 1;
+      (void)osal_set_event(zidDongleTaskId, ZID_DONGLE_EVT_USB_OUT);
     }
   }
-  // free memory
-  osal_mem_free(pData);
 
   // Restore the old index setting
   USBFW_SELECT_ENDPOINT(oldEndpoint);
@@ -968,15 +981,113 @@ void usbOutReportPoll(uint8 endPoint)
 #endif  //ZID_USB_RNP
 }
 
+/**************************************************************************************************
+ * @fn          zidUsbOutProcess
+ *
+ * @brief       This function hands the received output reports to the application, in order of
+ *              reception per EP, and then reads any packet that was held back in an EP FIFO.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void zidUsbOutProcess(void)
+{
+#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
+  uint8 idx;
+  zidUsbOutEp_t *pOut;
+
+  outRateUpdate();
+
+  for (idx = 0; idx < ZID_USB_OUT_EP_CNT; idx++)
+  {
+    pOut = zidUsbOutEp + idx;
+
+    while (pOut->len[pOut->rd] != 0)
+    {
+      // application specific handling
+      zidDongleOutputReport(zidUsbOutEpAddr[idx], pOut->buf[pOut->rd], pOut->len[pOut->rd]);
+      pOut->len[pOut->rd] = 0;
+      pOut->rd ^= 1;
+      zidUsbOutCnt++;
+    }
+
+    usbOutReportPoll(zidUsbOutEpAddr[idx]);
+  }
+#endif  //ZID_USB_RNP
+}
+
+/**************************************************************************************************
+ * @fn          zidUsbGetOutRate
+ *
+ * @brief       This function returns the number of output reports handled in the last second.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The number of OUT EP packets handled per second.
+ */
+uint16 zidUsbGetOutRate(void)
+{
+#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
+  outRateUpdate();
+  return zidUsbOutRate;
+#else
+  return 0;
+#endif  //ZID_USB_RNP
+}
+
+#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
+/**************************************************************************************************
+ * @fn          outRateUpdate
+ *
+ * @brief       This function latches the OUT packet count once a second has elapsed.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void outRateUpdate(void)
+{
+  uint32 elapsed = osal_GetSystemClock() - zidUsbOutRateStart;
+
+  if (elapsed >= 1000)
+  {
+    // A count idle for more than a whole second is stale.
+    zidUsbOutRate = (elapsed < 2000) ? zidUsbOutCnt : 0;
+    zidUsbOutCnt = 0;
+    zidUsbOutRateStart += elapsed;
+  }
+}
+#endif  //ZID_USB_RNP
+
 /**************************************************************************************************
  * @fn          zidUsbEnumerate
  *
  * @brief       This function initializes the USB Descriptor globals and enumerates the CC2531 to
- *              the USB host.
+ *              the USB host with one ZID interface per proxied device.
  *
  * input parameters
  *
- * @param       pPxy - A pointer to the zid_proxy_entry_t.
+ * @param       numPxy - The number of proxied devices, up to ZID_USB_NUM_PXY_IFACES.
+ * @param       pPxy - A pointer to an array of numPxy zid_proxy_entry_t, in interface order.
  *
  * output parameters
  *
@@ -987,24 +1098,28 @@ void usbOutReportPoll(uint8 endPoint)
  *              2 = Invalid config.
  *              3 = Already enumerated.
  */
-uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy)
+uint8 zidUsbEnumerate(uint8 numPxy, zid_proxy_entry_t *pPxy)
 {
   // zidDesc points to a super buffer in order to have 1 alloc & test for failure; rep desc at end.
   #define STD_HID_REPORT_DESC_BUF  (zidDesc + wTotalLength + DESC_SIZE_DEVICE + DESC_SIZE_STRING)
   #define RNP_HID_REPORT_DESC_BUF  (STD_HID_REPORT_DESC_BUF + wStdHIDReportDescLength)
   #define  CE_HID_REPORT_DESC_BUF  (RNP_HID_REPORT_DESC_BUF + DESC_SIZE_HIDREPORT_RNP)
 
-  uint16 wTotalLength = DESC_SIZE_CONFIG + DESC_SIZE_INTERFACE + DESC_SIZE_ENDPOINT;
+  uint16 wTotalLength = DESC_SIZE_CONFIG;
 #if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  if (pPxy == NULL) {
-    // enumerate as only RNP over HID
-    wTotalLength += 2*DESC_SIZE_ENDPOINT + DESC_SIZE_INTERFACE;
-  } else {
-    wTotalLength += 2*DESC_SIZE_INTERFACE + 3*(DESC_SIZE_ENDPOINT);
-  }
+  // The RNP and CE interfaces are always enumerated, alone if there is no proxied device.
+  wTotalLength += 2*DESC_SIZE_INTERFACE + 3*DESC_SIZE_ENDPOINT;
+  // The "RNP" over USB defines one Vendor Specific HID Descriptor and a HID Consumer Control descriptor
+  wTotalLength += 2*DESC_SIZE_HID_W1HIDRD;
 #endif //ZID_USB_RNP && ZID_USB_CE
-  uint16 wStdHIDReportDescLength = 0;
+  uint16 wStdHIDReportDescLength = 0;  // Of all the proxied interfaces.
+  uint16 wReportDescLength[ZID_USB_NUM_PXY_IFACES];
+  uint8 *pIfaceDesc[ZID_USB_NUM_PXY_IFACES];
+  uint8 *pHidDesc[ZID_USB_NUM_PXY_IFACES];
+  uint8 *pReportDesc[ZID_USB_NUM_PXY_IFACES];
   uint8 usb_hid_desc_zid[DESC_SIZE_HID_W1HIDRD];
+  uint8 *ptr;
+  uint8 i, n, lutIdx;
 
   if (zidDesc != NULL)
   {
@@ -1014,57 +1129,63 @@ uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy)
 #if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
   uint8 hasKeyboard = FALSE;
 
-  if (pPxy == NULL) {
-    // enumerate as only RNP over HID
-  } else {
+  if (numPxy > ZID_USB_NUM_PXY_IFACES)
+#else
+  if ((numPxy == 0) || (numPxy > ZID_USB_NUM_PXY_IFACES))
 #endif
-  // If the number of endpoints are equal to 0x02 it means the optional OUT EP is active.
-  // In that case, add this descriptor, and of course add to the wTotalLength
-  if (pPxy->HIDNumEndpoints == ZID_SUPPORT_OPT_OUT_EP)
-  {
-    wTotalLength += DESC_SIZE_ENDPOINT; // Add size of optional EP
-  }
-  else
-    if (pPxy->HIDNumEndpoints != ZID_SUPPORT_ONLY_IN_EP)  // Invalid number of EPs.
   {
     return USB_INVALID;
   }
 
-  for (uint8 i = 0; i < pPxy->HIDNumStdDescComps; i++)
+  for (n = 0; n < numPxy; n++)
   {
-    wStdHIDReportDescLength += zidStdHIDReportSizeTable[pPxy->HIDStdDescCompsList[i]];
+    wTotalLength += DESC_SIZE_INTERFACE + DESC_SIZE_ENDPOINT;
+
+    // If the number of endpoints are equal to 0x02 it means the optional OUT EP is active.
+    // In that case, add this descriptor, and of course add to the wTotalLength.
+    // Only the first interface has the OUT EP; the others get output reports by SET_REPORT.
+    if (pPxy[n].HIDNumEndpoints == ZID_SUPPORT_OPT_OUT_EP)
+    {
+      if (n == 0)
+      {
+        wTotalLength += DESC_SIZE_ENDPOINT; // Add size of optional EP
+      }
+    }
+    else
+      if (pPxy[n].HIDNumEndpoints != ZID_SUPPORT_ONLY_IN_EP)  // Invalid number of EPs.
+    {
+      return USB_INVALID;
+    }
+
+    wReportDescLength[n] = 0;
+    for (i = 0; i < pPxy[n].HIDNumStdDescComps; i++)
+    {
+      wReportDescLength[n] += zidStdHIDReportSizeTable[pPxy[n].HIDStdDescCompsList[i]];
 #if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-    if (pPxy->HIDStdDescCompsList[i] == ZID_STD_REPORT_KEYBOARD)
-      hasKeyboard = TRUE;
+      if ((n == 0) && (pPxy[n].HIDStdDescCompsList[i] == ZID_STD_REPORT_KEYBOARD))
+        hasKeyboard = TRUE;
 #endif //defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  }
+    }
 
 #if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  if (hasKeyboard == FALSE)
-    wStdHIDReportDescLength += zidStdHIDReportSizeTable[ZID_STD_REPORT_KEYBOARD];
+    // The RNP sends its keyboard reports on the first ZID interface.
+    if ((n == 0) && (hasKeyboard == FALSE))
+      wReportDescLength[n] += zidStdHIDReportSizeTable[ZID_STD_REPORT_KEYBOARD];
 #endif //defined (ZID_USB_RNP) && defined (ZID_USB_CE)
 
-  // Add size of HID Descriptor, since this is now known.
-  /* NOTE: This may seem stupid since the size is fixed.
-   *       This is however because two standard reports are merged for one HID Report Descriptor.
-   *       This again to support Windows standard HID driver. ZID spec allows for an increasing
-   *       size of the HID Report Descriptor depending on the number of descriptors.
-   */
-  wTotalLength += DESC_SIZE_HID_W1HIDRD;
+    wStdHIDReportDescLength += wReportDescLength[n];
 
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
+    // Add size of HID Descriptor, since this is now known.
+    /* NOTE: This may seem stupid since the size is fixed.
+     *       This is however because two standard reports are merged for one HID Report Descriptor.
+     *       This again to support Windows standard HID driver. ZID spec allows for an increasing
+     *       size of the HID Report Descriptor depending on the number of descriptors.
+     */
+    wTotalLength += DESC_SIZE_HID_W1HIDRD;
   }
-    // The "RNP" over USB defines one Vendor Specific HID Descriptor and a HID Consumer Control descriptor
-  wTotalLength += 2*DESC_SIZE_HID_W1HIDRD;
-#endif //defined ZID_USB_RNP
 
 #if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  if (pPxy == NULL) {
-    // enumerate as only RNP over HID
-    zidDesc = osal_mem_alloc(wTotalLength + DESC_SIZE_DEVICE + DESC_SIZE_HIDREPORT_RNP + DESC_SIZE_HIDREPORT_CE + DESC_SIZE_STRING);
-  } else {
-    zidDesc = osal_mem_alloc(wTotalLength + DESC_SIZE_DEVICE + wStdHIDReportDescLength + DESC_SIZE_HIDREPORT_RNP + DESC_SIZE_HIDREPORT_CE + DESC_SIZE_STRING);
-  }
+  zidDesc = osal_mem_alloc(wTotalLength + DESC_SIZE_DEVICE + wStdHIDReportDescLength + DESC_SIZE_HIDREPORT_RNP + DESC_SIZE_HIDREPORT_CE + DESC_SIZE_STRING);
   if (zidDesc == NULL)
 #else  // ZID_USB_RNP
   if ((zidDesc = osal_mem_alloc(wTotalLength + DESC_SIZE_DEVICE + wStdHIDReportDescLength + DESC_SIZE_STRING)) == NULL)
@@ -1073,69 +1194,35 @@ uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy)
     return USB_MEMORY0;
   }
 
-  uint8 *ptr = STD_HID_REPORT_DESC_BUF;
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  if (pPxy == NULL) {
-    // enumerate as only RNP over HID
-  } else {
-#endif // ZID_USB_RNP
-
-    /*** HID Class Descriptor
-    * Generic ZID standard HID Class Descriptor, populated on run-time from
-    * ZID attributes in NV.
-    * Must be generated first since the const version does not exist in flash,
-    * as they do for the other descriptors. The reason is that size is a function
-    * of the number of supported reports, which is conveyed during the configuration
-    * phase.
-    * According to ZID spec we should increase the size of this descriptor based
-    * on the aplHIDNumNonStdDescComps + aplHIDNumStdDescComps. However, this does not
-    * work for standard windows HID driver. Windows standard HID driver can handle
-    * a single concatenated HID Report Descriptor. Thus, we implemented this to
-    * support standard Windows HID driver.
-    */
-
-    // Size could be a function of the number of Report Descriptors supported
-    usb_hid_desc_zid[ZID_DESC_HID_INDEX_LENGTH] = DESC_SIZE_HID_W1HIDRD;
-    // Type is for ZID always 0x21 - HID descriptor
-    usb_hid_desc_zid[ZID_DESC_HID_INDEX_DESCRIPTORTYPE] = DESC_TYPE_HID;
-
-    usb_hid_desc_zid[ZID_DESC_HID_INDEX_BCDHID+0] = LO_UINT16(pPxy->HIDParserVersion);
-    usb_hid_desc_zid[ZID_DESC_HID_INDEX_BCDHID+1] = HI_UINT16(pPxy->HIDParserVersion);
-    usb_hid_desc_zid[ZID_DESC_HID_INDEX_COUNTRYCODE] = pPxy->HIDCountryCode;
-
-    // Must be only 1 HID Report Descriptor per interface to be recognized by standard
-    // Windows HID driver
-    usb_hid_desc_zid[ZID_DESC_HID_INDEX_NUMDESCRIPTORS] = 0x01;
-    usb_hid_desc_zid[ZID_DESC_HID_INDEX_DESCRIPTORTYPE_1] = DESC_TYPE_HIDREPORT;
-
-    // Low byte first, since all the standard reports are less than 255 -> only low byte.
-    usb_hid_desc_zid[ZID_DESC_HID_INDEX_DESCRIPTORTYPE_1+1] = LO_UINT16(wStdHIDReportDescLength);
-    usb_hid_desc_zid[ZID_DESC_HID_INDEX_DESCRIPTORTYPE_1+2] = HI_UINT16(wStdHIDReportDescLength);
+  ptr = STD_HID_REPORT_DESC_BUF;
+  for (n = 0; n < numPxy; n++)
+  {
+    pReportDesc[n] = ptr;
 
-//    uint8 *ptr = STD_HID_REPORT_DESC_BUF;
-    uint8 i = 0;
     // If ZID_STD_REPORT_MOUSE is reported, this must come first in the concatenated report descriptor
-    for (i = 0; i < pPxy->HIDNumStdDescComps; i++)
+    for (i = 0; i < pPxy[n].HIDNumStdDescComps; i++)
     {
-      if (pPxy->HIDStdDescCompsList[i] == ZID_STD_REPORT_MOUSE) {
-        ptr = osal_memcpy(ptr, zidStdHIDReportTable[pPxy->HIDStdDescCompsList[i]],
-                          zidStdHIDReportSizeTable[pPxy->HIDStdDescCompsList[i]]);
+      if (pPxy[n].HIDStdDescCompsList[i] == ZID_STD_REPORT_MOUSE) {
+        ptr = osal_memcpy(ptr, zidStdHIDReportTable[pPxy[n].HIDStdDescCompsList[i]],
+                          zidStdHIDReportSizeTable[pPxy[n].HIDStdDescCompsList[i]]);
         break;
       }
     }
     // Then all the others
-    for (i = 0; i < pPxy->HIDNumStdDescComps; i++)
+    for (i = 0; i < pPxy[n].HIDNumStdDescComps; i++)
     {
-      if (pPxy->HIDStdDescCompsList[i] != ZID_STD_REPORT_MOUSE) {
-        ptr = osal_memcpy(ptr, zidStdHIDReportTable[pPxy->HIDStdDescCompsList[i]],
-                          zidStdHIDReportSizeTable[pPxy->HIDStdDescCompsList[i]]);
+      if (pPxy[n].HIDStdDescCompsList[i] != ZID_STD_REPORT_MOUSE) {
+        ptr = osal_memcpy(ptr, zidStdHIDReportTable[pPxy[n].HIDStdDescCompsList[i]],
+                          zidStdHIDReportSizeTable[pPxy[n].HIDStdDescCompsList[i]]);
       }
     }
 #if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  if (hasKeyboard == FALSE)
-    ptr = osal_memcpy(ptr, zidStdHIDReportTable[ZID_STD_REPORT_KEYBOARD],
-                      zidStdHIDReportSizeTable[ZID_STD_REPORT_KEYBOARD]);
+    if ((n == 0) && (hasKeyboard == FALSE))
+      ptr = osal_memcpy(ptr, zidStdHIDReportTable[ZID_STD_REPORT_KEYBOARD],
+                        zidStdHIDReportSizeTable[ZID_STD_REPORT_KEYBOARD]);
+#endif //(ZID_USB_RNP)
   }
+#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
   ptr = RNP_HID_REPORT_DESC_BUF;
   ptr = osal_memcpy(ptr, zid_hid_rnp_report_desc, sizeof(zid_hid_rnp_report_desc));
   ptr = osal_memcpy(ptr, zid_hid_ce_report_desc, sizeof(zid_hid_ce_report_desc));
@@ -1157,39 +1244,87 @@ uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy)
   ptr = osal_memcpy(ptr, usb_iface_desc_ce,     sizeof(usb_iface_desc_ce));
   ptr = osal_memcpy(ptr, usb_hid_desc_ce,       sizeof(usb_hid_desc_ce));
   ptr = osal_memcpy(ptr, int_in_ep_desc_ce,     sizeof(int_in_ep_desc_ce));
-
-  if (pPxy == NULL) {
-    // enumerate as only RNP over HID
-  } else {
 #endif // ZID_USB_RNP
+
+  for (n = 0; n < numPxy; n++)
+  {
+    /*** HID Class Descriptor
+    * Generic ZID standard HID Class Descriptor, populated on run-time from
+    * ZID attributes in NV.
+    * Must be generated first since the const version does not exist in flash,
+    * as they do for the other descriptors. The reason is that size is a function
+    * of the number of supported reports, which is conveyed during the configuration
+    * phase.
+    * According to ZID spec we should increase the size of this descriptor based
+    * on the aplHIDNumNonStdDescComps + aplHIDNumStdDescComps. However, this does not
+    * work for standard windows HID driver. Windows standard HID driver can handle
+    * a single concatenated HID Report Descriptor. Thus, we implemented this to
+    * support standard Windows HID driver.
+    */
+
+    // Size could be a function of the number of Report Descriptors supported
+    usb_hid_desc_zid[ZID_DESC_HID_INDEX_LENGTH] = DESC_SIZE_HID_W1HIDRD;
+    // Type is for ZID always 0x21 - HID descriptor
+    usb_hid_desc_zid[ZID_DESC_HID_INDEX_DESCRIPTORTYPE] = DESC_TYPE_HID;
+
+    usb_hid_desc_zid[ZID_DESC_HID_INDEX_BCDHID+0] = LO_UINT16(pPxy[n].HIDParserVersion);
+    usb_hid_desc_zid[ZID_DESC_HID_INDEX_BCDHID+1] = HI_UINT16(pPxy[n].HIDParserVersion);
+    usb_hid_desc_zid[ZID_DESC_HID_INDEX_COUNTRYCODE] = pPxy[n].HIDCountryCode;
+
+    // Must be only 1 HID Report Descriptor per interface to be recognized by standard
+    // Windows HID driver
+    usb_hid_desc_zid[ZID_DESC_HID_INDEX_NUMDESCRIPTORS] = 0x01;
+    usb_hid_desc_zid[ZID_DESC_HID_INDEX_DESCRIPTORTYPE_1] = DESC_TYPE_HIDREPORT;
+
+    // Low byte first, since all the standard reports are less than 255 -> only low byte.
+    usb_hid_desc_zid[ZID_DESC_HID_INDEX_DESCRIPTORTYPE_1+1] = LO_UINT16(wReportDescLength[n]);
+    usb_hid_desc_zid[ZID_DESC_HID_INDEX_DESCRIPTORTYPE_1+2] = HI_UINT16(wReportDescLength[n]);
+
+    /** Interface Descriptor
+    */
+    pIfaceDesc[n] = ptr;
     ptr = osal_memcpy(ptr, usb_iface_desc_zid,    sizeof(usb_iface_desc_zid));
+    pIfaceDesc[n][2] = INTERFACE_NUMBER_ZID + n;
+    pIfaceDesc[n][4] = (n == 0) ? pPxy[n].HIDNumEndpoints : ZID_SUPPORT_ONLY_IN_EP;
+    pIfaceDesc[n][6] = pPxy[n].HIDDeviceSubclass;
+    pIfaceDesc[n][7] = pPxy[n].HIDProtocolCode;
+
+    pHidDesc[n] = ptr;
     ptr = osal_memcpy(ptr, usb_hid_desc_zid,      DESC_SIZE_HID_W1HIDRD);
+
+    /** Endpoint IN Descriptor
+    */
     ptr = osal_memcpy(ptr, int_in_ep_desc_zid,    sizeof(int_in_ep_desc_zid));
-    if (pPxy->HIDNumEndpoints == ZID_SUPPORT_OPT_OUT_EP)  // Add optional OUT EP Descriptor.
+    ptr[2-DESC_SIZE_ENDPOINT] = 0x80 | zid_usb_pxy_in_ep[n];
+    if (zid_usb_pxy_in_ep[n] == 0x01)
+    {
+      ptr[4-DESC_SIZE_ENDPOINT] = ZID_USB_EP1_MAX_PACKET_SIZE;
+    }
+    ptr[6-DESC_SIZE_ENDPOINT] = pPxy[n].HIDPollInterval;
+
+    /** Endpoint OUT Descriptor (optional)
+    */
+    if ((n == 0) && (pPxy[n].HIDNumEndpoints == ZID_SUPPORT_OPT_OUT_EP))
     {
       ptr = osal_memcpy(ptr, int_out_ep_desc_zid, sizeof(int_out_ep_desc_zid));
+      ptr[6-DESC_SIZE_ENDPOINT] = pPxy[n].HIDPollInterval;
     }
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
   }
-#endif // ZID_USB_RNP
+
   // Strings must come last, because when it gives the full Configuration Descriptor
   // it utilizes the fact that they actually come packed in a superstructer. It
   // only finds the pointer to the Configuration Descriptor and reports back the wTotalLength
   ptr = osal_memcpy(ptr, string0LangId,         sizeof(string0LangId));
   ptr = osal_memcpy(ptr, string1Manufacterer,   sizeof(string1Manufacterer));
   ptr = osal_memcpy(ptr, string2Product,        sizeof(string2Product));
-  (void)osal_memcpy(ptr, string3SerialNo,       sizeof(string3SerialNo));
+  ptr = osal_memcpy(ptr, string3SerialNo,       sizeof(string3SerialNo));
 
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  if (pPxy == NULL) {
-    // enumerate as only RNP over HID
-  } else {
-#endif // ZID_USB_RNP
-    /** For all descriptors, change fields according to attributes set in the
-    *  configuration phase.
-    */
+  usbDescriptorMarker.pUsbDescStart = ZID_DEVICE_DESC;
+  usbDescriptorMarker.pUsbDescEnd = ptr;
 
-    /** Device Descriptor
+  if (numPxy != 0)
+  {
+    /** Device Descriptor - the first proxied device identifies the composite device.
     */
     ptr = ZID_DEVICE_DESC + 8;
 #if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
@@ -1201,32 +1336,7 @@ uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy)
     ptr = osal_memcpy(ptr, (uint8 *)&pPxy->HIDProductId, 2);
 #endif //defined (ZID_USB_RNP) && defined (ZID_USB_CE)
     ptr = osal_memcpy(ptr, (uint8 *)&pPxy->HIDDeviceReleaseNumber, 2);
-
-    /** Interface Descriptor
-    */
-    ptr = ZID_IFACE_DESC + 4;
-    *ptr = pPxy->HIDNumEndpoints;
-    ptr = ZID_IFACE_DESC + 6;
-    *ptr = pPxy->HIDDeviceSubclass;
-    ptr = ZID_IFACE_DESC + 7;
-    *ptr = pPxy->HIDProtocolCode;
-
-    /** Endpoint IN Descriptor
-    */
-    ptr = ZID_IN_EP_DESC + 6;
-    *ptr = pPxy->HIDPollInterval;
-
-    /** Endpoint OUT Descriptor (optional)
-    */
-    if (pPxy->HIDNumEndpoints == ZID_SUPPORT_OPT_OUT_EP)
-    {
-      ptr = ZID_OUT_EP_DESC + 6;
-      *ptr = pPxy->HIDPollInterval;
-    }
-
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
   }
-#endif // ZID_USB_RNP
 
   /*** Configuration Descriptor
    * wTotalLength field of Configuration Descriptor is the total length in
@@ -1236,13 +1346,8 @@ uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy)
   ptr = ZID_CONFIG_DESC + 2; // Index to the wTotalLength, in usb_config_desc.
   *ptr++ = LO_UINT16(wTotalLength);
   *ptr++ = HI_UINT16(wTotalLength);
+  *ptr = ZID_USB_NUM_IFACES(numPxy); // bNumInterfaces
 
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  if (pPxy == NULL) {
-    // enumerate as only RNP over HID, i.e. only two interface
-    *ptr = 2; // bNumInterfaces
-  }
-#endif // ZID_USB_RNP
   usbDescInit(ZID_DEVICE_DESC);
 
   // Serial Number - left erased for programming of the IEEE.
@@ -1250,38 +1355,19 @@ uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy)
   {
     (void)osal_mem_free(usbDescriptorMarker.pUsbDescLut);
   }
-  usbDescriptorMarker.pUsbDescLut = (DESC_LUT_INFO *)osal_mem_alloc(DESC_LUT_INFO_SIZE);
+  usbDescriptorMarker.pUsbDescLut = (DESC_LUT_INFO *)osal_mem_alloc(DESC_LUT_INFO_SIZE(numPxy));
   HAL_ASSERT(usbDescriptorMarker.pUsbDescLut != NULL);
   usbDescriptorMarker.pUsbDescLutEnd = usbDescriptorMarker.pUsbDescLut;
-  usbDescriptorMarker.pUsbDescLutEnd += (uint16)(DESC_LUT_INFO_SIZE / (sizeof(DESC_LUT_INFO)));
-
-  usbDescriptorMarker.pUsbDescStart = ZID_DEVICE_DESC;
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  if (pPxy == NULL) {
-    // enumerate as only RNP over HID
-    usbDescriptorMarker.pUsbDescEnd = ZID_DEVICE_DESC_NO_ZID_END;
-  } else {
-#endif // ZID_USB_RNP
-    if (pPxy->HIDNumEndpoints == ZID_SUPPORT_ONLY_IN_EP)
-    {
-      usbDescriptorMarker.pUsbDescEnd = ZID_DEVICE_DESC_1EP_END;
-    }
-    else
-    {
-      usbDescriptorMarker.pUsbDescEnd = ZID_DEVICE_DESC_2EP_END;
-    }
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
-  }
-#endif // ZID_USB_RNP
+  usbDescriptorMarker.pUsbDescLutEnd += (uint16)(DESC_LUT_INFO_SIZE(numPxy) / (sizeof(DESC_LUT_INFO)));
 
   if (usbDescriptorMarker.pUsbDblbufLut != NULL)
   {
     (void)osal_mem_free(usbDescriptorMarker.pUsbDblbufLut);
   }
-  usbDescriptorMarker.pUsbDblbufLut = (DBLBUF_LUT_INFO *)osal_mem_alloc(DBLBUF_LUT_INFO_SIZE);
+  usbDescriptorMarker.pUsbDblbufLut = (DBLBUF_LUT_INFO *)osal_mem_alloc(DBLBUF_LUT_INFO_SIZE(numPxy));
   HAL_ASSERT(usbDescriptorMarker.pUsbDblbufLut != NULL);
   usbDescriptorMarker.pUsbDblbufLutEnd = usbDescriptorMarker.pUsbDblbufLut;
-  usbDescriptorMarker.pUsbDblbufLutEnd += (uint16)(DBLBUF_LUT_INFO_SIZE / sizeof(DBLBUF_LUT_INFO));
+  usbDescriptorMarker.pUsbDblbufLutEnd += (uint16)(DBLBUF_LUT_INFO_SIZE(numPxy) / sizeof(DBLBUF_LUT_INFO));
 
 #if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
 
@@ -1312,33 +1398,7 @@ uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy)
   usbDescriptorMarker.pUsbDescLut[3].indexLsb = INTERFACE_NUMBER_CE; // Interface number
   usbDescriptorMarker.pUsbDescLut[3].pDescStart = CE_HID_REPORT_DESC_BUF;
   usbDescriptorMarker.pUsbDescLut[3].length = DESC_SIZE_HIDREPORT_CE;
-  
-  usbDescriptorMarker.pUsbDescLut[4].valueMsb = DESC_TYPE_HID;
-  usbDescriptorMarker.pUsbDescLut[4].valueLsb = 0x00;
-  usbDescriptorMarker.pUsbDescLut[4].indexMsb = 0x00;
-  usbDescriptorMarker.pUsbDescLut[4].indexLsb = INTERFACE_NUMBER_ZID; // Interface number
-  usbDescriptorMarker.pUsbDescLut[4].pDescStart = ZID_HID_DESC;
-  usbDescriptorMarker.pUsbDescLut[4].length = DESC_SIZE_HID_W1HIDRD;
-  
-  usbDescriptorMarker.pUsbDescLut[5].valueMsb = DESC_TYPE_HIDREPORT;
-  usbDescriptorMarker.pUsbDescLut[5].valueLsb = 0x00;
-  usbDescriptorMarker.pUsbDescLut[5].indexMsb = 0x00;
-  usbDescriptorMarker.pUsbDescLut[5].indexLsb = INTERFACE_NUMBER_ZID; // Interface number
-  usbDescriptorMarker.pUsbDescLut[5].pDescStart = STD_HID_REPORT_DESC_BUF;
-  usbDescriptorMarker.pUsbDescLut[5].length = wStdHIDReportDescLength;
-  
-#else
-  
-  usbDescriptorMarker.pUsbDescLut[0].valueMsb = DESC_TYPE_HIDREPORT;
-  usbDescriptorMarker.pUsbDescLut[0].valueLsb = 0x00;
-  usbDescriptorMarker.pUsbDescLut[0].indexMsb = 0x00;
-  usbDescriptorMarker.pUsbDescLut[0].indexLsb = INTERFACE_NUMBER_ZID; // Interface number
-  usbDescriptorMarker.pUsbDescLut[0].pDescStart = STD_HID_REPORT_DESC_BUF;
-  usbDescriptorMarker.pUsbDescLut[0].length = wStdHIDReportDescLength;
-
-#endif //ZID_USB_RNP && ZID_USB_CE
 
-#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
   usbDescriptorMarker.pUsbDblbufLut[0].pInterface = (USB_INTERFACE_DESCRIPTOR *)ZID_RNP_IFACE_DESC;
   usbDescriptorMarker.pUsbDblbufLut[0].inMask = 0;
   usbDescriptorMarker.pUsbDblbufLut[0].outMask = 0;
@@ -1346,18 +1406,31 @@ uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy)
   usbDescriptorMarker.pUsbDblbufLut[1].pInterface = (USB_INTERFACE_DESCRIPTOR *)ZID_CE_IFACE_DESC;
   usbDescriptorMarker.pUsbDblbufLut[1].inMask = 0;
   usbDescriptorMarker.pUsbDblbufLut[1].outMask = 0;
-  
-  usbDescriptorMarker.pUsbDblbufLut[2].pInterface = (USB_INTERFACE_DESCRIPTOR *)ZID_IFACE_DESC;
-  usbDescriptorMarker.pUsbDblbufLut[2].inMask = 0x10; // Set EP5 to double buffering on IN
-  usbDescriptorMarker.pUsbDblbufLut[2].outMask = 0;
-#else
-  
-  usbDescriptorMarker.pUsbDblbufLut[0].pInterface = (USB_INTERFACE_DESCRIPTOR *)ZID_IFACE_DESC;
-  usbDescriptorMarker.pUsbDblbufLut[0].inMask = 0x10; // Set EP5 to double buffering on IN
-  usbDescriptorMarker.pUsbDblbufLut[0].outMask = 0;
-  
+
 #endif //ZID_USB_RNP && ZID_USB_CE
 
+  lutIdx = 2 * ZID_USB_NUM_IFACES(0);
+  for (n = 0; n < numPxy; n++, lutIdx += 2)
+  {
+    usbDescriptorMarker.pUsbDescLut[lutIdx].valueMsb = DESC_TYPE_HID;
+    usbDescriptorMarker.pUsbDescLut[lutIdx].valueLsb = 0x00;
+    usbDescriptorMarker.pUsbDescLut[lutIdx].indexMsb = 0x00;
+    usbDescriptorMarker.pUsbDescLut[lutIdx].indexLsb = INTERFACE_NUMBER_ZID + n; // Interface number
+    usbDescriptorMarker.pUsbDescLut[lutIdx].pDescStart = pHidDesc[n];
+    usbDescriptorMarker.pUsbDescLut[lutIdx].length = DESC_SIZE_HID_W1HIDRD;
+
+    usbDescriptorMarker.pUsbDescLut[lutIdx+1].valueMsb = DESC_TYPE_HIDREPORT;
+    usbDescriptorMarker.pUsbDescLut[lutIdx+1].valueLsb = 0x00;
+    usbDescriptorMarker.pUsbDescLut[lutIdx+1].indexMsb = 0x00;
+    usbDescriptorMarker.pUsbDescLut[lutIdx+1].indexLsb = INTERFACE_NUMBER_ZID + n; // Interface number
+    usbDescriptorMarker.pUsbDescLut[lutIdx+1].pDescStart = pReportDesc[n];
+    usbDescriptorMarker.pUsbDescLut[lutIdx+1].length = wReportDescLength[n];
+
+    usbDescriptorMarker.pUsbDblbufLut[ZID_USB_NUM_IFACES(n)].pInterface = (USB_INTERFACE_DESCRIPTOR *)pIfaceDesc[n];
+    usbDescriptorMarker.pUsbDblbufLut[ZID_USB_NUM_IFACES(n)].inMask = (n == 0) ? 0x10 : 0; // Set EP5 to double buffering on IN
+    usbDescriptorMarker.pUsbDblbufLut[ZID_USB_NUM_IFACES(n)].outMask = 0;
+  }
+
   usbHidInit();
 
   return USB_SUCCESS;
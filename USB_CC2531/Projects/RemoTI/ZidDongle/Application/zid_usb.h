@@ -43,18 +43,42 @@ extern "C" {
 #define ZID_PROXY_RNP_EP_IN_ADDR         ZID_PROXY_RNP_EP_OUT_ADDR
 #define ZID_PROXY_ZID_EP_OUT_ADDR        0x04
 #define ZID_PROXY_ZID_EP_IN_ADDR         0x05
-  
+
+// Each proxied device is enumerated as its own ZID interface with its own IN EP, so concurrent
+// devices do not share an endpoint. The first interface keeps EP5 IN (and the optional EP4 OUT);
+// the others take the IN EPs left over by the RNP and CE interfaces.
+#if defined (ZID_USB_RNP) && defined (ZID_USB_CE)
+#define ZID_USB_PXY_IN_EPS               ZID_PROXY_ZID_EP_IN_ADDR, 0x01
+#define ZID_USB_MAX_PXY_IFACES           2
+#else
+#define ZID_USB_PXY_IN_EPS               ZID_PROXY_ZID_EP_IN_ADDR, 0x01, 0x02, 0x03
+#define ZID_USB_MAX_PXY_IFACES           4
+#endif
+
+#if !defined ZID_USB_NUM_PXY_IFACES
+#define ZID_USB_NUM_PXY_IFACES           ZID_COMMON_MAX_NUM_PROXIED_DEVICES
+#endif
+
+#if (ZID_USB_NUM_PXY_IFACES > ZID_USB_MAX_PXY_IFACES)
+#error There are not enough USB endpoints to proxy ZID_USB_NUM_PXY_IFACES devices.
+#endif
+
+#define INTERFACE_NUMBER_ZID_LAST        (INTERFACE_NUMBER_ZID + ZID_USB_NUM_PXY_IFACES - 1)
+
 extern const uint8 zid_usb_report_len[ZID_STD_REPORT_TOTAL_NUM+1];
+// IN EP of each proxied ZID interface.
+extern const uint8 zid_usb_pxy_in_ep[ZID_USB_MAX_PXY_IFACES];
 
 /**************************************************************************************************
  * @fn          zidUsbEnumerate
  *
  * @brief       This function initializes the USB Descriptor globals and enumerates the CC2531 to
- *              the USB host.
+ *              the USB host with one ZID interface per proxied device.
  *
  * input parameters
  *
- * @param       pPxy - A pointer to the zid_proxy_entry_t.
+ * @param       numPxy - The number of proxied devices, up to ZID_USB_NUM_PXY_IFACES.
+ * @param       pPxy - A pointer to an array of numPxy zid_proxy_entry_t, in interface order.
  *
  * output parameters
  *
@@ -65,7 +89,42 @@ extern const uint8 zid_usb_report_len[ZID_STD_REPORT_TOTAL_NUM+1];
  *              2 = Invalid config.
  *              3 = Already enumerated.
  */
-uint8 zidUsbEnumerate(zid_proxy_entry_t *pPxy);
+uint8 zidUsbEnumerate(uint8 numPxy, zid_proxy_entry_t *pPxy);
+
+/**************************************************************************************************
+ * @fn          zidUsbOutProcess
+ *
+ * @brief       This function hands the received output reports to the application, in order of
+ *              reception per EP, and then reads any packet that was held back in an EP FIFO.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void zidUsbOutProcess(void);
+
+/**************************************************************************************************
+ * @fn          zidUsbGetOutRate
+ *
+ * @brief       This function returns the number of output reports handled in the last second.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The number of OUT EP packets handled per second.
+ */
+uint16 zidUsbGetOutRate(void);
 
 /**************************************************************************************************
  * @fn          zidUsbUnEnum
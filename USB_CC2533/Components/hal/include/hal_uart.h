@@ -38,6 +38,9 @@ extern "C"
 #define HAL_UART_BR_38400  0x02
 #define HAL_UART_BR_57600  0x03
 #define HAL_UART_BR_115200 0x04
+#define HAL_UART_BR_230400 0x05
+#define HAL_UART_BR_460800 0x06
+#define HAL_UART_BR_921600 0x07
 
 /* Frame Format constant */
 
@@ -40,6 +40,9 @@
 /**************************************************************************************************
  *                                           INCLUDES
  **************************************************************************************************/
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_HAL_LCD
+
 #include "hal_types.h"
 #include "hal_lcd.h"
 #include "OSAL.h"
@@ -11,6 +11,12 @@
 
 // HID Interface indices (as used in USB descriptor) for class request parsing
 #define ZID_IFCE_INDEX          INTERFACE_NUMBER_ZID
+// Each proxied device has its own interface, numbered up from ZID_IFCE_INDEX.
+#if defined INTERFACE_NUMBER_ZID_LAST
+#define ZID_IFCE_INDEX_LAST     INTERFACE_NUMBER_ZID_LAST
+#else
+#define ZID_IFCE_INDEX_LAST     INTERFACE_NUMBER_ZID
+#endif
 
 // Constants specifying HID Class requests (bRequest)
 #define GET_REPORT              0x01
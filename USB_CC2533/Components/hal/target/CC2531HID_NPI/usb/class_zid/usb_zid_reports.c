@@ -23,6 +23,41 @@ static halIntState_t halIntLock(void)
 
 ZID_CLASS_REQUEST_DATA_OUT *zidClassRequestDataOut;
 
+#if ZID_IN_QUEUE_DEPTH
+typedef struct
+{
+  uint8 len;
+#if ZID_IN_LATENCY
+  uint8 timed;   // The report was given after zidInLatencyStart().
+  uint16 stamp;  // Sleep timer at zidInLatencyStart().
+#endif
+  uint8 buf[ZID_IN_QUEUE_REPORT_LEN];
+} zidInReport_t;
+
+typedef struct
+{
+  zidInReport_t reports[ZID_IN_QUEUE_DEPTH];
+  uint8 head;
+  uint8 cnt;
+} zidInQueue_t;
+
+static zidInQueue_t zidInQueue[ZID_IN_QUEUE_EP_CNT];
+static zidInQueueStats_t zidInQueueStats[ZID_IN_QUEUE_EP_CNT];
+
+static uint8 inQueuePut(uint8 endPoint, uint8 *pReport, uint8 len);
+static uint8 inQueueCoalesce(zidInReport_t *pTail, uint8 *pReport, uint8 len);
+static void inQueueWrite(uint8 endPoint, uint8 *pReport, uint8 len);
+#endif
+
+#if ZID_IN_LATENCY
+static zidInLatency_t zidInLatency;
+static uint16 latencyStamp;
+static uint8 latencyTimed;
+
+static uint16 latencyNow(void);
+static void latencyStop(uint16 stamp);
+#endif
+
 /**************************************************************************************************
  * @fn      zidSendInReport
  *
@@ -48,19 +83,388 @@ uint8 zidSendInReport(uint8 *pReport, uint8 endPoint, uint8 len)
   {
     uint8 ea = halIntLock();
 
-    USBFW_SELECT_ENDPOINT(endPoint);
-    if (!(USBCSIL & USBCSIL_INPKT_RDY))
+#if ZID_IN_QUEUE_DEPTH
+    // Reports already waiting go first; the interrupt loads them as the endpoint frees up.
+    if ((endPoint != 0) && (endPoint <= ZID_IN_QUEUE_EP_CNT) && (zidInQueue[endPoint-1].cnt != 0))
+    {
+      result = inQueuePut(endPoint, pReport, len);
+    }
+    else
+#endif
     {
-      usbfwWriteFifo(((&USBF0) + (endPoint << 1)), len, pReport);
-      USBCSIL |= USBCSIL_INPKT_RDY;
-      result = TRUE;
+      USBFW_SELECT_ENDPOINT(endPoint);
+      if (!(USBCSIL & USBCSIL_INPKT_RDY))
+      {
+        usbfwWriteFifo(((&USBF0) + (endPoint << 1)), len, pReport);
+        USBCSIL |= USBCSIL_INPKT_RDY;
+        result = TRUE;
+#if ZID_IN_LATENCY
+        if (latencyTimed)
+        {
+          latencyStop(latencyStamp);
+        }
+#endif
+      }
+#if ZID_IN_QUEUE_DEPTH
+      else if ((endPoint != 0) && (endPoint <= ZID_IN_QUEUE_EP_CNT))
+      {
+        result = inQueuePut(endPoint, pReport, len);
+      }
+#endif
     }
+#if ZID_IN_LATENCY
+    latencyTimed = FALSE;  // A queued report carries its own stamp.
+#endif
     halIntUnlock(ea);
   }
 
   return result;
 }
 
+#if ZID_IN_QUEUE_DEPTH
+/**************************************************************************************************
+ * @fn      zidInQueueDrain
+ *
+ * @brief   Load the next queued report into each IN endpoint whose packet has just been sent.
+ *          Called from the USB interrupt.
+ *
+ * input parameters
+ *
+ * @param   usbiif - USBIIF flags read by the USB interrupt.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  None.
+ */
+void zidInQueueDrain(uint8 usbiif)
+{
+  uint8 usbIndex = USBINDEX;  // The interrupted code may have an endpoint selected.
+  uint8 endPoint;
+
+  for (endPoint = 1; endPoint <= ZID_IN_QUEUE_EP_CNT; endPoint++)
+  {
+    zidInQueue_t *pQ = zidInQueue + endPoint - 1;
+
+    // The USBIIF_INEPxIF flag of endpoint x is bit x.
+    if ((usbiif & BV(endPoint)) && (pQ->cnt != 0))
+    {
+      USBFW_SELECT_ENDPOINT(endPoint);
+      if (!(USBCSIL & USBCSIL_INPKT_RDY))
+      {
+        inQueueWrite(endPoint, pQ->reports[pQ->head].buf, pQ->reports[pQ->head].len);
+#if ZID_IN_LATENCY
+        if (pQ->reports[pQ->head].timed)
+        {
+          latencyStop(pQ->reports[pQ->head].stamp);
+        }
+#endif
+        pQ->head = (pQ->head + 1) % ZID_IN_QUEUE_DEPTH;
+        pQ->cnt--;
+      }
+    }
+  }
+
+  USBFW_SELECT_ENDPOINT(usbIndex);
+}
+
+/**************************************************************************************************
+ * @fn      zidInQueueFlush
+ *
+ * @brief   Discard all queued IN reports, as on a USB reset.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  None.
+ */
+void zidInQueueFlush(void)
+{
+  uint8 endPoint;
+
+  for (endPoint = 0; endPoint < ZID_IN_QUEUE_EP_CNT; endPoint++)
+  {
+    zidInQueue[endPoint].head = 0;
+    zidInQueue[endPoint].cnt = 0;
+  }
+}
+
+/**************************************************************************************************
+ * @fn      zidInQueueGetStats
+ *
+ * @brief   Read the queue counters of an IN endpoint.
+ *
+ * input parameters
+ *
+ * @param   endPoint - IN endpoint.
+ *
+ * output parameters
+ *
+ * @param   pStats - counters.
+ *
+ * @return  TRUE if the endpoint has a queue; FALSE otherwise.
+ */
+uint8 zidInQueueGetStats(uint8 endPoint, zidInQueueStats_t *pStats)
+{
+  uint8 ea;
+
+  if ((endPoint == 0) || (endPoint > ZID_IN_QUEUE_EP_CNT))
+  {
+    return FALSE;
+  }
+
+  ea = halIntLock();
+  *pStats = zidInQueueStats[endPoint-1];
+  halIntUnlock(ea);
+
+  return TRUE;
+}
+
+/**************************************************************************************************
+ * @fn      inQueuePut
+ *
+ * @brief   Queue an IN report behind the reports already waiting for the endpoint. A mouse report
+ *          is merged into a queued mouse report if possible; otherwise, when the queue is full,
+ *          the oldest report is dropped so that the host always gets the most recent input.
+ *          Must be called with interrupts disabled.
+ *
+ * input parameters
+ *
+ * @param   endPoint - IN endpoint, 1 to ZID_IN_QUEUE_EP_CNT.
+ * @param   pReport - report to be sent
+ * @param   len - length of report
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  TRUE if the report was queued; FALSE otherwise.
+ */
+static uint8 inQueuePut(uint8 endPoint, uint8 *pReport, uint8 len)
+{
+  zidInQueue_t *pQ = zidInQueue + endPoint - 1;
+  zidInQueueStats_t *pStats = zidInQueueStats + endPoint - 1;
+  zidInReport_t *pTail;
+  uint8 idx;
+
+  if (len > ZID_IN_QUEUE_REPORT_LEN)
+  {
+    pStats->dropped++;
+    return FALSE;
+  }
+
+  if (pQ->cnt != 0)
+  {
+    pTail = pQ->reports + (pQ->head + pQ->cnt - 1) % ZID_IN_QUEUE_DEPTH;
+    if (inQueueCoalesce(pTail, pReport, len))
+    {
+      pStats->coalesced++;
+      return TRUE;
+    }
+  }
+
+  if (pQ->cnt == ZID_IN_QUEUE_DEPTH)
+  {
+    pQ->head = (pQ->head + 1) % ZID_IN_QUEUE_DEPTH;
+    pQ->cnt--;
+    pStats->dropped++;
+  }
+
+  pTail = pQ->reports + (pQ->head + pQ->cnt) % ZID_IN_QUEUE_DEPTH;
+  pTail->len = len;
+#if ZID_IN_LATENCY
+  pTail->timed = latencyTimed;
+  pTail->stamp = latencyStamp;
+#endif
+  for (idx = 0; idx < len; idx++)
+  {
+    pTail->buf[idx] = pReport[idx];
+  }
+  pQ->cnt++;
+
+  if (pStats->highWater < pQ->cnt)
+  {
+    pStats->highWater = pQ->cnt;
+  }
+
+  return TRUE;
+}
+
+/**************************************************************************************************
+ * @fn      inQueueCoalesce
+ *
+ * @brief   Add the movement of a standard mouse report to the last queued report if that is a
+ *          mouse report with the same buttons and the sums fit in the report.
+ *
+ * input parameters
+ *
+ * @param   pTail - last queued report.
+ * @param   pReport - new report.
+ * @param   len - length of new report.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  TRUE if the new report was merged; FALSE otherwise.
+ */
+static uint8 inQueueCoalesce(zidInReport_t *pTail, uint8 *pReport, uint8 len)
+{
+  zid_mouse_data_t *pOld = (zid_mouse_data_t *)(pTail->buf + 1);
+  zid_mouse_data_t *pNew = (zid_mouse_data_t *)(pReport + 1);
+  int16 x, y;
+
+  if ((len != ZID_MOUSE_DATA_LEN + 1) || (pTail->len != len) ||
+      (pReport[0] != ZID_STD_REPORT_MOUSE) || (pTail->buf[0] != ZID_STD_REPORT_MOUSE) ||
+      (pOld->btns != pNew->btns))
+  {
+    return FALSE;
+  }
+
+  x = (int8)pOld->x + (int8)pNew->x;
+  y = (int8)pOld->y + (int8)pNew->y;
+  if ((x < -127) || (x > 127) || (y < -127) || (y > 127))
+  {
+    return FALSE;
+  }
+
+  pOld->x = (uint8)x;
+  pOld->y = (uint8)y;
+
+  return TRUE;
+}
+
+/**************************************************************************************************
+ * @fn      inQueueWrite
+ *
+ * @brief   Write a report into the FIFO of the selected, idle IN endpoint and arm it.
+ *
+ * input parameters
+ *
+ * @param   endPoint - IN endpoint.
+ * @param   pReport - report to be sent
+ * @param   len - length of report
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  None.
+ */
+static void inQueueWrite(uint8 endPoint, uint8 *pReport, uint8 len)
+{
+  usbfwWriteFifo(((&USBF0) + (endPoint << 1)), len, pReport);
+  USBCSIL |= USBCSIL_INPKT_RDY;
+}
+#endif
+
+#if ZID_IN_LATENCY
+/**************************************************************************************************
+ * @fn      zidInLatencyStart
+ *
+ * @brief   Start timing the next report given to zidSendInReport(), as on its receipt over the air.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  None.
+ */
+void zidInLatencyStart(void)
+{
+  latencyStamp = latencyNow();
+  latencyTimed = TRUE;
+}
+
+/**************************************************************************************************
+ * @fn      zidInLatencyGet
+ *
+ * @brief   Read the report latency counters, and optionally clear them.
+ *
+ * input parameters
+ *
+ * @param   clear - TRUE to clear the counters once read.
+ *
+ * output parameters
+ *
+ * @param   pLatency - counters.
+ *
+ * @return  None.
+ */
+void zidInLatencyGet(zidInLatency_t *pLatency, uint8 clear)
+{
+  uint8 ea = halIntLock();
+
+  *pLatency = zidInLatency;
+  if (clear)
+  {
+    zidInLatency.last = 0;
+    zidInLatency.max = 0;
+    zidInLatency.cnt = 0;
+  }
+
+  halIntUnlock(ea);
+}
+
+/**************************************************************************************************
+ * @fn      latencyNow
+ *
+ * @brief   Read the low 16 bits of the sleep timer.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  Sleep timer ticks.
+ */
+static uint16 latencyNow(void)
+{
+  uint16 now = ST0;  // ST0 must be read first; it latches ST1.
+
+  return (now | ((uint16)ST1 << 8));
+}
+
+/**************************************************************************************************
+ * @fn      latencyStop
+ *
+ * @brief   Count the latency of a timed report whose endpoint has just been armed.
+ *          Must be called with interrupts disabled.
+ *
+ * input parameters
+ *
+ * @param   stamp - Sleep timer when the report was received.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  None.
+ */
+static void latencyStop(uint16 stamp)
+{
+  zidInLatency.last = latencyNow() - stamp;
+  if (zidInLatency.max < zidInLatency.last)
+  {
+    zidInLatency.max = zidInLatency.last;
+  }
+  zidInLatency.cnt++;
+}
+#endif
+
 /*
 +------------------------------------------------------------------------------
 |  Copyright 2004-2011 Texas Instruments Incorporated. All rights reserved.
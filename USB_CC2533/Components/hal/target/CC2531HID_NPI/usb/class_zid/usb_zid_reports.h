@@ -12,8 +12,48 @@
 #include "usb_zid_reports.h"
 #include "zid_profile.h"
 
+// Depth of the per-endpoint queue of IN reports waiting for the endpoint FIFO; 0 disables queuing.
+#if !defined ZID_IN_QUEUE_DEPTH
+#define ZID_IN_QUEUE_DEPTH  0
+#endif
+
+// Longest IN report that can be queued.
+#if !defined ZID_IN_QUEUE_REPORT_LEN
+#define ZID_IN_QUEUE_REPORT_LEN  16
+#endif
+
+// IN endpoints 1 to ZID_IN_QUEUE_EP_CNT get a queue.
+#if !defined ZID_IN_QUEUE_EP_CNT
+#define ZID_IN_QUEUE_EP_CNT  5
+#endif
+
+// Setting to TRUE times each report from zidInLatencyStart() until its endpoint is armed with
+// USBCSIL_INPKT_RDY, directly or from the queue, in sleep timer ticks (30.5 usec).
+#if !defined ZID_IN_LATENCY
+#define ZID_IN_LATENCY  FALSE
+#endif
+
 typedef uint8 ZID_CLASS_REQUEST_DATA_OUT;
 
+#if ZID_IN_QUEUE_DEPTH
+// The drop and coalesce counters are free running and wrap; read them twice to get a rate.
+typedef struct
+{
+  uint8 dropped;    // Reports lost to a full queue (oldest dropped) or that did not fit a slot.
+  uint8 coalesced;  // Mouse reports merged into the last queued mouse report.
+  uint8 highWater;  // Most reports queued at once.
+} zidInQueueStats_t;
+#endif
+
+#if ZID_IN_LATENCY
+typedef struct
+{
+  uint16 last;  // Latency of the last timed report.
+  uint16 max;   // Largest latency since the counters were cleared.
+  uint16 cnt;   // Reports timed since the counters were cleared.
+} zidInLatency_t;
+#endif
+
 extern ZID_CLASS_REQUEST_DATA_OUT *zidClassRequestDataOut;
 
 /**************************************************************************************************
@@ -35,6 +75,96 @@ extern ZID_CLASS_REQUEST_DATA_OUT *zidClassRequestDataOut;
  */
 uint8 zidSendInReport(uint8 *data, uint8 endPoint, uint8 len);
 
+#if ZID_IN_QUEUE_DEPTH
+/**************************************************************************************************
+ * @fn      zidInQueueDrain
+ *
+ * @brief   Load the next queued report into each IN endpoint whose packet has just been sent.
+ *          Called from the USB interrupt.
+ *
+ * input parameters
+ *
+ * @param   usbiif - USBIIF flags read by the USB interrupt.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  None.
+ */
+void zidInQueueDrain(uint8 usbiif);
+
+/**************************************************************************************************
+ * @fn      zidInQueueFlush
+ *
+ * @brief   Discard all queued IN reports, as on a USB reset.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  None.
+ */
+void zidInQueueFlush(void);
+
+/**************************************************************************************************
+ * @fn      zidInQueueGetStats
+ *
+ * @brief   Read the queue counters of an IN endpoint.
+ *
+ * input parameters
+ *
+ * @param   endPoint - IN endpoint.
+ *
+ * output parameters
+ *
+ * @param   pStats - counters.
+ *
+ * @return  TRUE if the endpoint has a queue; FALSE otherwise.
+ */
+uint8 zidInQueueGetStats(uint8 endPoint, zidInQueueStats_t *pStats);
+#endif
+
+#if ZID_IN_LATENCY
+/**************************************************************************************************
+ * @fn      zidInLatencyStart
+ *
+ * @brief   Start timing the next report given to zidSendInReport(), as on its receipt over the air.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return  None.
+ */
+void zidInLatencyStart(void);
+
+/**************************************************************************************************
+ * @fn      zidInLatencyGet
+ *
+ * @brief   Read the report latency counters, and optionally clear them.
+ *
+ * input parameters
+ *
+ * @param   clear - TRUE to clear the counters once read.
+ *
+ * output parameters
+ *
+ * @param   pLatency - counters.
+ *
+ * @return  None.
+ */
+void zidInLatencyGet(zidInLatency_t *pLatency, uint8 clear);
+#endif
+
 /*
 +------------------------------------------------------------------------------
 |  Copyright 2004-2011 Texas Instruments Incorporated. All rights reserved.
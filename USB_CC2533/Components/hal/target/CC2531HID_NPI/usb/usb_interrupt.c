@@ -11,6 +11,7 @@
 #define USBINTERRUPT_C ///< Modifies the behavior of "EXTERN" in usb_interrupt.h
 #include "usb_board_cfg.h"
 #include "usb_interrupt.h"
+#include "usb_zid_reports.h"
 
 
 /** \brief Initializes the \ref module_usb_interrupt module
@@ -44,7 +45,7 @@ __interrupt void usbirqHandler(void)
 #endif
 {
    uint16 eventMask;
-   uint8 usbcif;
+   uint8 usbcif, usbiif;
 
    HAL_ENTER_ISR();
    HAL_USB_ENABLE();  // Never access the USB controller before PLL is stable.
@@ -60,6 +61,9 @@ __interrupt void usbirqHandler(void)
 
          // Enable suspend mode when suspend signaling is detected on the bus
          USBPOW |= USBPOW_SUSPEND_EN;
+#if ZID_IN_QUEUE_DEPTH
+         zidInQueueFlush();  // The reset has flushed the endpoint FIFOs.
+#endif
       }
 
       usbcif |= USBCIF_RESUMEIF;
@@ -70,8 +74,15 @@ __interrupt void usbirqHandler(void)
       usbirqData.inSuspend = TRUE;
    }
 
+   usbiif = USBIIF;  // Cleared on read.
+#if ZID_IN_QUEUE_DEPTH
+   if (usbiif & (USBIIF_INEP1IF | USBIIF_INEP2IF | USBIIF_INEP3IF | USBIIF_INEP4IF | USBIIF_INEP5IF)) {
+      zidInQueueDrain(usbiif);
+   }
+#endif
+
    eventMask  = usbcif;
-   eventMask |= (uint16)USBIIF << 4;
+   eventMask |= (uint16)usbiif << 4;
    eventMask |= (uint16)USBOIF << 9;
    usbirqData.eventMask |= eventMask;  // Record events (keeping existing).
 
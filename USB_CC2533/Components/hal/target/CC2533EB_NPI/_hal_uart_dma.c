@@ -388,16 +388,29 @@ static void HalUARTOpenDMA(halUARTCfg_t *config)
              (config->baudRate == HAL_UART_BR_19200) ||
              (config->baudRate == HAL_UART_BR_38400) ||
              (config->baudRate == HAL_UART_BR_57600) ||
-             (config->baudRate == HAL_UART_BR_115200));
-
-  if (config->baudRate == HAL_UART_BR_57600 ||
-      config->baudRate == HAL_UART_BR_115200)
+             (config->baudRate == HAL_UART_BR_115200) ||
+             (config->baudRate == HAL_UART_BR_230400) ||
+             (config->baudRate == HAL_UART_BR_460800) ||
+             (config->baudRate == HAL_UART_BR_921600));
+
+  /* A port may be re-opened at run time (e.g. to change the baud rate), so first stop the Rx
+   * and the Rx DMA, and restart the Rx ring from its beginning when the DMA is re-armed below.
+   * The caller must ensure that the Tx is idle.
+   */
+  UxCSR = CSR_MODE;
+  HAL_DMA_ABORT_CH(HAL_DMA_CH_RX);
+  dmaCfg.rxHead = dmaCfg.rxTail = 0;
+  dmaCfg.rxTick = 0;
+
+  if (config->baudRate == HAL_UART_BR_9600 ||
+      config->baudRate == HAL_UART_BR_19200 ||
+      config->baudRate == HAL_UART_BR_38400)
   {
-    UxBAUD = 216;
+    UxBAUD = 59;
   }
   else
   {
-    UxBAUD = 59;
+    UxBAUD = 216;
   }
 
   switch (config->baudRate)
@@ -412,6 +425,15 @@ static void HalUARTOpenDMA(halUARTCfg_t *config)
     case HAL_UART_BR_57600:
       UxGCR = 10;
       break;
+    case HAL_UART_BR_230400:
+      UxGCR = 12;
+      break;
+    case HAL_UART_BR_460800:
+      UxGCR = 13;
+      break;
+    case HAL_UART_BR_921600:
+      UxGCR = 14;
+      break;
     default:
       // HAL_UART_BR_115200
       UxGCR = 11;
@@ -572,6 +572,21 @@ st( \
 #define HAL_UART_GPIO_ISR
 #endif
 #endif
+
+/* The DMA Rx ring takes 2 bytes of RAM per byte received. Size it for three maximum NPI frames
+ * (of 128 bytes) so that the host can have two commands queued behind the one being processed
+ * without needing flow control. The Tx buffer is double-buffered by the driver, so one frame each.
+ */
+#if !defined HAL_UART_DMA_RX_MAX
+#if defined CC2533F64
+#define HAL_UART_DMA_RX_MAX        128
+#else
+#define HAL_UART_DMA_RX_MAX        384
+#endif
+#endif
+#if !defined HAL_UART_DMA_TX_MAX
+#define HAL_UART_DMA_TX_MAX        128
+#endif
 #endif
 
 // Used to set P2 priority - USART0 over USART1 if both are defined.
@@ -0,0 +1,317 @@
+/**************************************************************************************************
+  Filename:       hal_flash.c
+
+  Description:    Flash driver of the HOST target: the internal flash is an image file mapped into
+                  memory, or an anonymous mapping, with the NOR semantics of the CC253x flash -
+                  a write only clears bits and only a page erase sets them again. The power can be
+                  made to fail at any word write or physical page erase, leaving that operation
+                  torn, as for the NV power-fail tests.
+**************************************************************************************************/
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hal_board_cfg.h"
+#include "hal_flash.h"
+#include "hal_host.h"
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Constants
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_FLASH_HOST_SIZE       (HAL_FLASH_PAGE_CNT * HAL_FLASH_PAGE_PHYS)
+
+// Target time of the flash operations - see the CC253x datasheets.
+#define HAL_FLASH_HOST_WORD_US     20
+#define HAL_FLASH_HOST_ERASE_US    20000
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Global Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+halFlashHostCnt_t halFlashHostCnt;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static uint8 *halFlashHostImg;
+
+// The operations left before the power fails, 0 if it does not, and where to go when it does.
+static uint32 halFlashHostOps;
+static jmp_buf *halFlashHostEnv;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static uint8 halFlashHostFail(void);
+
+/**************************************************************************************************
+ * @fn          HalFlashHostOpen
+ *
+ * @brief       Map the flash image. A new or short image file is extended with erased bytes.
+ *
+ * input parameters
+ *
+ * @param       pPath - The path of the image file; NULL for an erased image in RAM only.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      0 on success; otherwise -1, with errno set.
+ **************************************************************************************************
+ */
+int HalFlashHostOpen(const char *pPath)
+{
+  struct stat st;
+  uint8 *pImg;
+  int fd;
+
+  HalFlashHostClose();
+
+  if (pPath == NULL)
+  {
+    pImg = mmap(NULL, HAL_FLASH_HOST_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                -1, 0);
+    if (pImg == MAP_FAILED)
+    {
+      return -1;
+    }
+    (void)memset(pImg, 0xFF, HAL_FLASH_HOST_SIZE);
+  }
+  else
+  {
+    if (((fd = open(pPath, O_RDWR | O_CREAT, 0644)) < 0) || (fstat(fd, &st) != 0))
+    {
+      return -1;
+    }
+
+    if ((st.st_size < (off_t)HAL_FLASH_HOST_SIZE) && (ftruncate(fd, HAL_FLASH_HOST_SIZE) != 0))
+    {
+      (void)close(fd);
+      return -1;
+    }
+
+    pImg = mmap(NULL, HAL_FLASH_HOST_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)close(fd);
+    if (pImg == MAP_FAILED)
+    {
+      return -1;
+    }
+
+    if (st.st_size < (off_t)HAL_FLASH_HOST_SIZE)
+    {
+      (void)memset(pImg + st.st_size, 0xFF, HAL_FLASH_HOST_SIZE - st.st_size);
+    }
+  }
+
+  halFlashHostImg = pImg;
+  (void)memset(&halFlashHostCnt, 0, sizeof(halFlashHostCnt));
+
+  return 0;
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashHostClose
+ *
+ * @brief       Unmap the flash image, which keeps what was written to it if it is a file.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashHostClose(void)
+{
+  if (halFlashHostImg != NULL)
+  {
+    (void)munmap(halFlashHostImg, HAL_FLASH_HOST_SIZE);
+    halFlashHostImg = NULL;
+  }
+  halFlashHostOps = 0;
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashHostPowerFail
+ *
+ * @brief       Make the power fail at a later flash operation. The word write or physical page
+ *              erase that it fails at is left torn: only half of the word is written, or only the
+ *              first half of the physical page is erased. Then the flash driver longjmp()s to the
+ *              environment given, as the reset would cut the code short on target.
+ *
+ * input parameters
+ *
+ * @param       ops  - The count of word writes and physical page erases, 1 for the next one, at
+ *                     which to fail; 0 for the power not to fail.
+ * @param       pEnv - The environment to longjmp() to, with the value 1.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashHostPowerFail(uint32 ops, jmp_buf *pEnv)
+{
+  halFlashHostOps = ops;
+  halFlashHostEnv = pEnv;
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashRead
+ *
+ * @brief       This function reads 'cnt' bytes from the internal flash.
+ *
+ * input parameters
+ *
+ * @param       pg - A valid flash page number.
+ * @param       offset - A valid offset into the page.
+ * @param       buf - A valid buffer space at least as big as the 'cnt' parameter.
+ * @param       cnt - A valid number of bytes to read.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashRead(uint8 pg, uint16 offset, uint8 *buf, uint16 cnt)
+{
+  halFlashHostCnt.reads++;
+  (void)memcpy(buf, halFlashHostImg + ((uint32)pg * HAL_FLASH_PAGE_SIZE) + offset, cnt);
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashWrite
+ *
+ * @brief       This function writes 'cnt' bytes to the internal flash.
+ *
+ * input parameters
+ *
+ * @param       addr - Valid HAL flash write address: actual addr / 4 and quad-aligned.
+ * @param       buf - Valid buffer space at least as big as 'cnt' X 4.
+ * @param       cnt - Number of 4-byte blocks to write.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashWrite(uint16 addr, uint8 *buf, uint16 cnt)
+{
+  uint8 *pData = halFlashHostImg + ((uint32)addr * HAL_FLASH_WORD_SIZE);
+  uint8 idx;
+
+  while (cnt--)
+  {
+    uint8 fail = halFlashHostFail();
+
+    for (idx = 0; idx < (fail ? HAL_FLASH_WORD_SIZE / 2 : HAL_FLASH_WORD_SIZE); idx++)
+    {
+      pData[idx] &= buf[idx];
+    }
+
+    if (fail)
+    {
+      longjmp(*halFlashHostEnv, 1);
+    }
+
+    halFlashHostCnt.words++;
+    halFlashHostCnt.usecs += HAL_FLASH_HOST_WORD_US;
+    pData += HAL_FLASH_WORD_SIZE;
+    buf += HAL_FLASH_WORD_SIZE;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashErase
+ *
+ * @brief       This function erases the specified page of the internal flash. If a virtual page
+ *              size larger than the physical page size is being used, all physical pages from the
+ *              page specified up to the next virtual page boundary are erased.
+ *
+ * input parameters
+ *
+ * @param       pg - A valid virtual flash page number to erase.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashErase(uint8 pg)
+{
+  uint8 *pData = halFlashHostImg + ((uint32)pg * HAL_FLASH_PAGE_SIZE);
+  uint8 vPg;
+
+  for (vPg = 0; vPg < (HAL_FLASH_PAGE_SIZE / HAL_FLASH_PAGE_PHYS); vPg++)
+  {
+    if (halFlashHostFail())
+    {
+      (void)memset(pData, 0xFF, HAL_FLASH_PAGE_PHYS / 2);
+      longjmp(*halFlashHostEnv, 1);
+    }
+
+    (void)memset(pData, 0xFF, HAL_FLASH_PAGE_PHYS);
+    halFlashHostCnt.usecs += HAL_FLASH_HOST_ERASE_US;
+    pData += HAL_FLASH_PAGE_PHYS;
+  }
+
+  halFlashHostCnt.erases++;
+}
+
+/**************************************************************************************************
+ * @fn          halFlashHostFail
+ *
+ * @brief       Count down the operations left before the power fails.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if the power fails at this operation; FALSE otherwise.
+ **************************************************************************************************
+ */
+static uint8 halFlashHostFail(void)
+{
+  if ((halFlashHostOps != 0) && (--halFlashHostOps == 0))
+  {
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**************************************************************************************************
+*/
@@ -0,0 +1,114 @@
+/**************************************************************************************************
+  Filename:       hal_host.c
+
+  Description:    The MCU services of the HOST target: the interrupt enable, the clock that the
+                  MAC timer provides on target, the random numbers of the ADC and the sleep of a
+                  POWER_SAVING build.
+**************************************************************************************************/
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "hal_host.h"
+#include "hal_batmon.h"
+#include "hal_mcu.h"
+#include "hal_sleep.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Global Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+volatile uint8 halHostEA;
+
+/**************************************************************************************************
+ * @fn          halHostUsecs
+ *
+ * @brief       Read the host monotonic clock, which also drives the OSAL clock and timers.
+ *
+ * @return      Microseconds, wrapping at 2^32.
+ */
+uint32 halHostUsecs(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint32)((unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+/**************************************************************************************************
+ * @fn          macMcuPrecisionCount
+ *
+ * @brief       Read the free running count of 320 usec backoff periods that osalTimeUpdate() turns
+ *              into msecs. It starts at 0 on the first read, as the MAC timer does at reset, so
+ *              that the first update does not jump the OSAL clock and timers by the host uptime.
+ *
+ * @return      The count of 320 usec periods since the first read.
+ */
+uint32 macMcuPrecisionCount(void)
+{
+  static unsigned long long start;
+  unsigned long long now;
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  now = ((unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000) / 320;
+
+  if (start == 0)
+  {
+    start = now;
+  }
+
+  return (uint32)(now - start);
+}
+
+/**************************************************************************************************
+ * @fn          HalAdcRand
+ *
+ * @brief       Generate a random number, as the ADC does from radio noise on target.
+ *
+ * @return      A 16-bit random number.
+ */
+uint16 HalAdcRand(void)
+{
+  return (uint16)rand();
+}
+
+/**************************************************************************************************
+ * @fn          HalBatMonRead
+ *
+ * @brief       Check the supply voltage before a flash write or erase; the host supply is good.
+ *
+ * @param       vddMask - A valid BATTMON_VOLTAGE mask.
+ *
+ * @return      TRUE.
+ */
+uint8 HalBatMonRead(uint8 vddMask)
+{
+  (void)vddMask;
+  return TRUE;
+}
+
+/**************************************************************************************************
+ * @fn          halSleep
+ *
+ * @brief       Link osal_pwrmgr_powerconserve() of a POWER_SAVING build. CHECK_SLEEP_MODE() is
+ *              FALSE on the host, so the OSAL loop never calls it, and nothing could wake it.
+ *
+ * @param       osal_timer - The msecs to the next OSAL timer, 0 for none.
+ *
+ * @return      None.
+ */
+void halSleep(uint16 osal_timer)
+{
+  (void)osal_timer;
+}
+
+/**************************************************************************************************
+ */
@@ -0,0 +1,127 @@
+/**************************************************************************************************
+  Filename:       hal_host.h
+
+  Description:    Hooks of the HOST target for the harnesses that run target code on a POSIX
+                  host: the clock, the attachment of the UART to a file descriptor and the recording of
+                  what it receives.
+**************************************************************************************************/
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <setjmp.h>
+
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Typedefs
+ * ------------------------------------------------------------------------------------------------
+ */
+
+// Counts of the flash operations since HalFlashHostOpen().
+typedef struct
+{
+  uint32 reads;   // HalFlashRead() calls
+  uint32 words;   // Words written
+  uint32 erases;  // Pages erased
+  uint32 usecs;   // Time that the writes and erases would take on target
+} halFlashHostCnt_t;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Global Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* TRUE (the default) to pace the UART Rx and Tx at the baud rate it is opened at, as the wire
+ * would; FALSE to move bytes as fast as the file descriptor takes them.
+ */
+extern uint8 halHostUartPaced;
+
+extern halFlashHostCnt_t halFlashHostCnt;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**************************************************************************************************
+ * @fn          halHostUsecs
+ *
+ * @brief       Read the host monotonic clock, which also drives the OSAL clock and timers.
+ *
+ * @return      Microseconds, wrapping at 2^32.
+ */
+extern uint32 halHostUsecs(void);
+
+/**************************************************************************************************
+ * @fn          HalUARTHostAttach
+ *
+ * @brief       Attach the UART to a file descriptor, e.g. a PTY master, which is made non-blocking.
+ *
+ * @param       fd - The file descriptor; -1 to detach.
+ *
+ * @return      None.
+ */
+extern void HalUARTHostAttach(int fd);
+
+/**************************************************************************************************
+ * @fn          HalUARTHostRecord
+ *
+ * @brief       Copy every byte that the UART receives to a file descriptor, e.g. to record the
+ *              traffic of a host for a later replay.
+ *
+ * @param       fd - The file descriptor; -1 to stop.
+ *
+ * @return      None.
+ */
+extern void HalUARTHostRecord(int fd);
+
+/**************************************************************************************************
+ * @fn          HalUARTHostBaud
+ *
+ * @brief       Read the rate that the UART was last opened at.
+ *
+ * @return      The rate in bits per second; 0 if it is not open.
+ */
+extern uint32 HalUARTHostBaud(void);
+
+/**************************************************************************************************
+ * @fn          HalFlashHostOpen
+ *
+ * @brief       Map the flash image. A new or short image file is extended with erased bytes.
+ *
+ * @param       pPath - The path of the image file; NULL for an erased image in RAM only.
+ *
+ * @return      0 on success; otherwise -1, with errno set.
+ */
+extern int HalFlashHostOpen(const char *pPath);
+
+/**************************************************************************************************
+ * @fn          HalFlashHostClose
+ *
+ * @brief       Unmap the flash image, which keeps what was written to it if it is a file.
+ *
+ * @return      None.
+ */
+extern void HalFlashHostClose(void);
+
+/**************************************************************************************************
+ * @fn          HalFlashHostPowerFail
+ *
+ * @brief       Make the power fail at a later word write or physical page erase, which is left
+ *              torn, and longjmp() to the environment given.
+ *
+ * @param       ops  - The count of operations, 1 for the next one, at which to fail; 0 for none.
+ * @param       pEnv - The environment to longjmp() to, with the value 1.
+ *
+ * @return      None.
+ */
+extern void HalFlashHostPowerFail(uint32 ops, jmp_buf *pEnv);
+
+#endif
+/**************************************************************************************************
+ */
@@ -0,0 +1,529 @@
+/**************************************************************************************************
+  Filename:       hal_uart.c
+
+  Description:    The UART of the HOST target, on a file descriptor such as a PTY master. It
+                  serves the port of HAL_UART_DMA as _hal_uart_dma.c does on target: an Rx ring of
+                  HAL_UART_DMA_RX_MAX bytes, two Tx buffers of HAL_UART_DMA_TX_MAX bytes written
+                  all or none, and the same callback events from HalUARTPoll().
+
+                  Unless halHostUartPaced is FALSE, bytes move no faster than the baud rate would
+                  carry them (10 bits per byte). Bytes beyond a full Rx ring wait in the file
+                  descriptor, as if the host were flow controlled.
+**************************************************************************************************/
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hal_board.h"
+#include "hal_defs.h"
+#include "hal_host.h"
+#include "hal_types.h"
+#include "hal_uart.h"
+
+#if (defined HAL_UART) && (HAL_UART == TRUE)
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Constants
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#if (HAL_UART_DMA == 1)
+#define HAL_UART_HOST_PORT         HAL_UART_PORT_0
+#elif (HAL_UART_DMA == 2)
+#define HAL_UART_HOST_PORT         HAL_UART_PORT_1
+#else
+#error "HAL_UART_DMA must select the port that the HOST UART serves."
+#endif
+
+// Rx event thresholds, as in _hal_uart_dma.c
+#define HAL_UART_HOST_HIGH        (HAL_UART_DMA_RX_MAX / 2 - 16)
+#define HAL_UART_HOST_FULL        (HAL_UART_DMA_RX_MAX - 16)
+
+// Usecs per 10-bit character at a baud rate.
+#define HAL_UART_HOST_CHAR_US(B)  (10000000UL / (B))
+
+/* ------------------------------------------------------------------------------------------------
+ *                                         Local Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+// The bits per second of each HAL_UART_BR_ value.
+static const uint32 halUartHostRate[] =
+{
+  9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600
+};
+
+static struct
+{
+  int             fd;
+  uint32          baud;       // 0 while the port is not open.
+  halUARTCBack_t  uartCB;
+
+  uint8           rxBuf[HAL_UART_DMA_RX_MAX];
+  uint16          rxHead;
+  uint16          rxCnt;
+  uint8           rxNew;      // Bytes arrived since the last poll.
+  uint32          rxUs;       // Time up to which the Rx has been credited with bytes.
+
+  uint8           txBuf[2][HAL_UART_DMA_TX_MAX];
+  uint16          txIdx[2];
+  uint8           txSel;      // The buffer being appended to; the other one is being sent.
+  uint16          txOut;      // Bytes of the buffer being sent that are out.
+  uint32          txUs;       // Time up to which the Tx has been credited with bytes.
+  uint8           txMT;
+
+  int             recFd;      // Where to copy the bytes received; -1 for nowhere.
+} halUartHost = { .fd = -1, .recFd = -1 };
+
+uint8 halHostUartPaced = TRUE;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                         Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static void halUartHostRx(void);
+static void halUartHostTx(void);
+static uint16 halUartHostCredit(uint32 *pUs, uint16 max);
+
+/**************************************************************************************************
+ * @fn          HalUARTHostAttach
+ *
+ * @brief       Attach the UART to a file descriptor, e.g. a PTY master, which is made non-blocking.
+ *
+ * @param       fd - The file descriptor; -1 to detach.
+ *
+ * @return      None.
+ */
+void HalUARTHostAttach(int fd)
+{
+  if (fd >= 0)
+  {
+    (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  }
+
+  halUartHost.fd = fd;
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTHostRecord
+ *
+ * @brief       Copy every byte that the UART receives to a file descriptor, e.g. to record the
+ *              traffic of a host for a later replay.
+ *
+ * @param       fd - The file descriptor; -1 to stop.
+ *
+ * @return      None.
+ */
+void HalUARTHostRecord(int fd)
+{
+  halUartHost.recFd = fd;
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTHostBaud
+ *
+ * @brief       Read the rate that the UART was last opened at.
+ *
+ * @return      The rate in bits per second; 0 if it is not open.
+ */
+uint32 HalUARTHostBaud(void)
+{
+  return halUartHost.baud;
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTInit
+ *
+ * @brief       Initialize the UART.
+ *
+ * @param       None.
+ *
+ * @return      None.
+ */
+void HalUARTInit(void)
+{
+  int fd = halUartHost.fd, recFd = halUartHost.recFd;
+
+  (void)memset(&halUartHost, 0, sizeof(halUartHost));
+  halUartHost.fd = fd;
+  halUartHost.recFd = recFd;
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTOpen
+ *
+ * @brief       Open, or re-open, the port. As on target, a re-open drops the bytes in the Rx ring,
+ *              and the caller must ensure that the Tx is idle.
+ *
+ * @param       port   - UART port.
+ * @param       config - The configuration; only the baud rate and the callback are used.
+ *
+ * @return      HAL_UART_SUCCESS, or HAL_UART_BAUDRATE_ERROR.
+ */
+uint8 HalUARTOpen(uint8 port, halUARTCfg_t *config)
+{
+  if (port != HAL_UART_HOST_PORT)
+  {
+    return HAL_UART_NOT_SUPPORTED;
+  }
+
+  if (config->baudRate >= sizeof(halUartHostRate) / sizeof(halUartHostRate[0]))
+  {
+    return HAL_UART_BAUDRATE_ERROR;
+  }
+
+  halUartHost.baud = halUartHostRate[config->baudRate];
+  halUartHost.uartCB = config->callBackFunc;
+  halUartHost.rxHead = halUartHost.rxCnt = 0;
+  halUartHost.rxNew = FALSE;
+  halUartHost.rxUs = halUartHost.txUs = halHostUsecs();
+
+  return HAL_UART_SUCCESS;
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTClose
+ *
+ * @brief       Close the port.
+ *
+ * @param       port - UART port.
+ *
+ * @return      None.
+ */
+void HalUARTClose(uint8 port)
+{
+  if (port == HAL_UART_HOST_PORT)
+  {
+    halUartHost.baud = 0;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTRead
+ *
+ * @brief       Read from the Rx ring.
+ *
+ * @param       port - UART port.
+ * @param       buf  - Buffer of at least len bytes.
+ * @param       len  - The most bytes to read.
+ *
+ * @return      The number of bytes read.
+ */
+uint16 HalUARTRead(uint8 port, uint8 *buf, uint16 len)
+{
+  uint16 cnt;
+
+  if ((port != HAL_UART_HOST_PORT) || (halUartHost.baud == 0))
+  {
+    return 0;
+  }
+
+  if (len > halUartHost.rxCnt)
+  {
+    len = halUartHost.rxCnt;
+  }
+
+  for (cnt = 0; cnt < len; cnt++)
+  {
+    buf[cnt] = halUartHost.rxBuf[halUartHost.rxHead];
+    if (++halUartHost.rxHead == HAL_UART_DMA_RX_MAX)
+    {
+      halUartHost.rxHead = 0;
+    }
+  }
+  halUartHost.rxCnt -= len;
+
+  return len;
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTWrite
+ *
+ * @brief       Append to the Tx buffer that is not being sent, all or none, and start sending it
+ *              if the other one is done.
+ *
+ * @param       port - UART port.
+ * @param       buf  - The bytes to write.
+ * @param       len  - The number of bytes.
+ *
+ * @return      len, or 0 if the bytes do not fit.
+ */
+uint16 HalUARTWrite(uint8 port, uint8 *buf, uint16 len)
+{
+  uint8 sel = halUartHost.txSel;
+
+  if ((port != HAL_UART_HOST_PORT) || (halUartHost.baud == 0) ||
+      (halUartHost.txIdx[sel] + len > HAL_UART_DMA_TX_MAX))
+  {
+    return 0;
+  }
+
+  (void)memcpy(&halUartHost.txBuf[sel][halUartHost.txIdx[sel]], buf, len);
+  halUartHost.txIdx[sel] += len;
+
+  // If there is no ongoing Tx, then start one here.
+  if (halUartHost.txIdx[sel ^ 1] == 0)
+  {
+    halUartHost.txSel ^= 1;
+    halUartHost.txOut = 0;
+    halUartHost.txUs = halHostUsecs();
+    halUartHostTx();
+  }
+
+  return len;
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTBusy
+ *
+ * @brief       Query whether the UART has bytes in its Rx ring or Tx buffers.
+ *
+ * @param       None.
+ *
+ * @return      TRUE if the UART is busy; FALSE otherwise.
+ */
+uint8 HalUARTBusy(void)
+{
+  return ((halUartHost.rxCnt != 0) || (halUartHost.txIdx[0] != 0) || (halUartHost.txIdx[1] != 0));
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTSuspend, HalUARTResume
+ *
+ * @brief       The host does not sleep, so there is nothing to suspend or resume.
+ *
+ * @return      None.
+ */
+void HalUARTSuspend(void)
+{
+}
+
+void HalUARTResume(void)
+{
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTPoll
+ *
+ * @brief       Move the bytes due between the file descriptor and the buffers, and make the
+ *              callback with the events of _hal_uart_dma.c.
+ *
+ * @param       None.
+ *
+ * @return      None.
+ */
+void HalUARTPoll(void)
+{
+  uint8 evt = 0;
+
+  if ((halUartHost.baud == 0) || (halUartHost.fd < 0))
+  {
+    return;
+  }
+
+  halUartHostRx();
+  halUartHostTx();
+
+  if (halUartHost.rxCnt >= HAL_UART_HOST_FULL)
+  {
+    evt = HAL_UART_RX_FULL;
+  }
+  else if (halUartHost.rxCnt >= HAL_UART_HOST_HIGH)
+  {
+    evt = HAL_UART_RX_ABOUT_FULL;
+  }
+  else if ((halUartHost.rxCnt != 0) && !halUartHost.rxNew)
+  {
+    // As HAL_UART_DMA_IDLE of 0: the line was idle since the last poll.
+    evt = HAL_UART_RX_TIMEOUT;
+  }
+  halUartHost.rxNew = FALSE;
+
+  if (halUartHost.txMT)
+  {
+    halUartHost.txMT = FALSE;
+    evt |= HAL_UART_TX_EMPTY;
+  }
+
+  if ((evt != 0) && (halUartHost.uartCB != NULL))
+  {
+    halUartHost.uartCB(HAL_UART_HOST_PORT, evt);
+  }
+}
+
+/**************************************************************************************************
+ * @fn          Hal_UART_RxBufLen, Hal_UART_TxBufLen
+ *
+ * @brief       Count the bytes in the Rx ring, or in the Tx buffers.
+ *
+ * @param       port - UART port.
+ *
+ * @return      The number of bytes.
+ */
+uint16 Hal_UART_RxBufLen(uint8 port)
+{
+  return (port == HAL_UART_HOST_PORT) ? halUartHost.rxCnt : 0;
+}
+
+uint16 Hal_UART_TxBufLen(uint8 port)
+{
+  return (port == HAL_UART_HOST_PORT) ?
+          (halUartHost.txIdx[0] + halUartHost.txIdx[1] - halUartHost.txOut) : 0;
+}
+
+/**************************************************************************************************
+ * @fn          halUartHostCredit
+ *
+ * @brief       Count the bytes that the line has carried since the given time, and advance the
+ *              time past those that will be moved.
+ *
+ * @param       pUs - The time up to which bytes were last credited.
+ * @param       max - The most bytes that can be moved now.
+ *
+ * @return      The number of bytes that may be moved, up to max.
+ */
+static uint16 halUartHostCredit(uint32 *pUs, uint16 max)
+{
+  uint32 charUs, cnt;
+
+  if (!halHostUartPaced)
+  {
+    return max;
+  }
+
+  charUs = HAL_UART_HOST_CHAR_US(halUartHost.baud);
+  cnt = (halHostUsecs() - *pUs) / charUs;
+  if (cnt > max)
+  {
+    cnt = max;
+  }
+
+  *pUs += cnt * charUs;
+
+  return (uint16)cnt;
+}
+
+/**************************************************************************************************
+ * @fn          halUartHostRx
+ *
+ * @brief       Read the bytes due from the file descriptor into the Rx ring.
+ *
+ * @param       None.
+ *
+ * @return      None.
+ */
+static void halUartHostRx(void)
+{
+  uint32 us = halUartHost.rxUs;
+  uint16 cnt = halUartHostCredit(&us, HAL_UART_DMA_RX_MAX - halUartHost.rxCnt);
+
+  while (cnt != 0)
+  {
+    uint16 tail = (halUartHost.rxHead + halUartHost.rxCnt) % HAL_UART_DMA_RX_MAX;
+    uint16 len = MIN(cnt, HAL_UART_DMA_RX_MAX - tail);
+    ssize_t rtn = read(halUartHost.fd, &halUartHost.rxBuf[tail], len);
+
+    if (rtn <= 0)
+    {
+      if ((rtn < 0) && (errno == EINTR))
+      {
+        continue;
+      }
+      break;
+    }
+
+    if (halUartHost.recFd >= 0)
+    {
+      (void)write(halUartHost.recFd, &halUartHost.rxBuf[tail], rtn);
+    }
+
+    halUartHost.rxCnt += rtn;
+    halUartHost.rxNew = TRUE;
+    halUartHost.rxUs += rtn * HAL_UART_HOST_CHAR_US(halUartHost.baud);
+    cnt -= rtn;
+  }
+
+  // A line that is idle, or that the ring cannot take from, earns no credit.
+  if ((cnt != 0) || (halUartHost.rxCnt == HAL_UART_DMA_RX_MAX))
+  {
+    halUartHost.rxUs = halHostUsecs();
+  }
+}
+
+/**************************************************************************************************
+ * @fn          halUartHostTx
+ *
+ * @brief       Write the bytes due from the Tx buffer being sent, and start sending the other one
+ *              when it is done.
+ *
+ * @param       None.
+ *
+ * @return      None.
+ */
+static void halUartHostTx(void)
+{
+  while (TRUE)
+  {
+    uint8 sel = halUartHost.txSel ^ 1;
+    uint16 cnt;
+    ssize_t rtn;
+
+    if (halUartHost.txIdx[sel] == 0)
+    {
+      break;
+    }
+
+    if ((cnt = halUartHostCredit(&halUartHost.txUs, halUartHost.txIdx[sel] - halUartHost.txOut)) == 0)
+    {
+      break;
+    }
+
+    if ((rtn = write(halUartHost.fd, &halUartHost.txBuf[sel][halUartHost.txOut], cnt)) < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      rtn = 0;
+    }
+    halUartHost.txOut += rtn;
+
+    if (rtn < cnt)
+    {
+      // The file descriptor is full: give back the credit of the bytes not taken.
+      if (halHostUartPaced)
+      {
+        halUartHost.txUs = halHostUsecs();
+      }
+      break;
+    }
+
+    if (halUartHost.txOut == halUartHost.txIdx[sel])
+    {
+      halUartHost.txIdx[sel] = 0;
+      halUartHost.txOut = 0;
+
+      if (halUartHost.txIdx[sel ^ 1] != 0)
+      {
+        halUartHost.txSel = sel;
+      }
+      else
+      {
+        halUartHost.txMT = TRUE;
+        break;
+      }
+    }
+  }
+}
+
+#endif
+/**************************************************************************************************
+ */
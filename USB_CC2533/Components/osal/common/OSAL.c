@@ -6,6 +6,9 @@
  * INCLUDES
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_OSAL
+
 #include <string.h>
 
 #include "comdef.h"
@@ -14,6 +17,7 @@
 #include "OSAL_Memory.h"
 #include "OSAL_PwrMgr.h"
 #include "OSAL_Clock.h"
+#include "osal_snv.h"
 
 #include "OnBoard.h"
 
@@ -34,17 +38,37 @@
  * CONSTANTS
  */
 
+/* When non-zero, a task enabled with osal_drain_enable() is called again
+ * right away, without the timer update and HAL poll in between, while it is
+ * still the highest priority ready task - up to this many extra times.
+ */
+#if !defined ( OSAL_DRAIN_BUDGET )
+  #define OSAL_DRAIN_BUDGET  0
+#endif
+
+/* The first this many tasks belong to the prebuilt MAC and RCN libraries,
+ * which stuff events straight into tasksEvents[] without marking the ready
+ * bitmap, so their slots are checked on every pick.
+ */
+#if !defined ( OSAL_LIB_TASKS )
+  #define OSAL_LIB_TASKS  2
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+// Per-task message queue - the tail is kept so that sending is O(1).
+typedef struct
+{
+  osal_msg_q_t head;
+  osal_msg_q_t tail;
+} osalTaskMsgQ_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
 
-// Message Pool Definitions
-osal_msg_q_t osal_qHead;
-
 /*********************************************************************
  * EXTERNAL VARIABLES
  */
@@ -57,13 +81,94 @@ osal_msg_q_t osal_qHead;
  * LOCAL VARIABLES
  */
 
+// Message Pool Definitions - one queue per task, indexed by task ID.
+static osalTaskMsgQ_t *osalTaskMsgQ;
+
+// Bit n is set while tasksEvents[n] is non-zero - bit 0 is the highest priority task.
+static uint16 osalReadyMap;
+
+// Index of the lowest bit set in a nibble.
+static CODE const uint8 osalLowBitTbl[16] = { 0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+
+#if OSAL_DRAIN_BUDGET
+// Bit n is set for each task that is drained.
+static uint16 osalDrainMap;
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
 
+static uint8 osalReadyTask( void );
+
 /*********************************************************************
  * HELPER FUNCTIONS
  */
+
+/*********************************************************************
+ * @fn      osalReadyTask
+ *
+ * @brief   Find the highest priority ready task from the ready bitmap.
+ *          The library task slots are checked on every pick, and if the
+ *          bitmap is empty tasksEvents[] is scanned once, so that events
+ *          stuffed directly into it (rather than through osal_set_event())
+ *          are not lost. A stale bit, whose events were cleared directly,
+ *          is dropped. Ints must be disabled.
+ *
+ * @param   none
+ *
+ * @return  uint8 - index of the ready task, tasksCnt if none is ready
+ */
+static uint8 osalReadyTask( void )
+{
+  uint16 map;
+  uint8 idx;
+
+  for ( idx = 0; (idx < OSAL_LIB_TASKS) && (idx < tasksCnt); idx++ )
+  {
+    if ( tasksEvents[idx] )
+    {
+      osalReadyMap |= BV( idx );
+    }
+  }
+
+  if ( osalReadyMap == 0 )
+  {
+    for ( ; idx < tasksCnt; idx++ )
+    {
+      if ( tasksEvents[idx] )
+      {
+        osalReadyMap |= BV( idx );
+      }
+    }
+  }
+
+  while ( (map = osalReadyMap) != 0 )
+  {
+    idx = 0;
+    if ( (map & 0x00FF) == 0 )
+    {
+      map >>= 8;
+      idx = 8;
+    }
+    if ( (map & 0x000F) == 0 )
+    {
+      map >>= 4;
+      idx += 4;
+    }
+    idx += osalLowBitTbl[map & 0x000F];
+
+    if ( tasksEvents[idx] )
+    {
+      return ( idx );
+    }
+
+    osalReadyMap &= ~BV( idx );  // Stale: the events were cleared directly.
+  }
+
+  return ( tasksCnt );
+}
+
 /* very ugly stub so Keil can compile */
 #ifdef __KEIL__
 char *  itoa ( int value, char * buffer, int radix )
@@ -473,8 +578,25 @@ uint8 osal_msg_send( uint8 destination_task, uint8 *msg_ptr )
 
   OSAL_MSG_ID( msg_ptr ) = destination_task;
 
-  // queue message
-  osal_msg_enqueue( &osal_qHead, msg_ptr );
+  // queue message at the tail of the destination task's queue
+  {
+    osalTaskMsgQ_t *pQ = &osalTaskMsgQ[destination_task];
+    halIntState_t intState;
+
+    HAL_ENTER_CRITICAL_SECTION(intState);
+
+    if ( pQ->head == NULL )
+    {
+      pQ->head = msg_ptr;
+    }
+    else
+    {
+      OSAL_MSG_NEXT( pQ->tail ) = msg_ptr;
+    }
+    pQ->tail = msg_ptr;
+
+    HAL_EXIT_CRITICAL_SECTION(intState);
+  }
 
   // Signal the task that a message is waiting
   osal_set_event( destination_task, SYS_EVENT_MSG );
@@ -497,42 +619,33 @@ uint8 osal_msg_send( uint8 destination_task, uint8 *msg_ptr )
  */
 uint8 *osal_msg_receive( uint8 task_id )
 {
-  osal_msg_hdr_t *listHdr;
-  osal_msg_hdr_t *prevHdr = NULL;
-  osal_msg_hdr_t *foundHdr = NULL;
+  osalTaskMsgQ_t *pQ;
+  osal_msg_hdr_t *foundHdr;
   halIntState_t   intState;
 
+  if ( task_id >= tasksCnt )
+  {
+    return ( NULL );
+  }
+
+  pQ = &osalTaskMsgQ[task_id];
+
   // Hold off interrupts
   HAL_ENTER_CRITICAL_SECTION(intState);
 
-  // Point to the top of the queue
-  listHdr = osal_qHead;
+  // The first message in the task's own queue is the one to deliver
+  foundHdr = pQ->head;
 
-  // Look through the queue for a message that belongs to the asking task
-  while ( listHdr != NULL )
+  if ( foundHdr != NULL )
   {
-    if ( (listHdr - 1)->dest_id == task_id )
-    {
-      if ( foundHdr == NULL )
-      {
-        // Save the first one
-        foundHdr = listHdr;
-      }
-      else
-      {
-        // Second msg found, stop looking
-        break;
-      }
-    }
-    if ( foundHdr == NULL )
-    {
-      prevHdr = listHdr;
-    }
-    listHdr = OSAL_MSG_NEXT( listHdr );
+    // Take off the head of the queue
+    pQ->head = OSAL_MSG_NEXT( foundHdr );
+    OSAL_MSG_NEXT( foundHdr ) = NULL;
+    OSAL_MSG_ID( foundHdr ) = TASK_NO_TASK;
   }
 
-  // Is there more than one?
-  if ( listHdr != NULL )
+  // Is there another one?
+  if ( pQ->head != NULL )
   {
     // Yes, Signal the task that a message is waiting
     osal_set_event( task_id, SYS_EVENT_MSG );
@@ -540,16 +653,10 @@ uint8 *osal_msg_receive( uint8 task_id )
   else
   {
     // No more
+    pQ->tail = NULL;
     osal_clear_event( task_id, SYS_EVENT_MSG );
   }
 
-  // Did we find a message?
-  if ( foundHdr != NULL )
-  {
-    // Take out of the link list
-    osal_msg_extract( &osal_qHead, foundHdr, prevHdr );
-  }
-
   // Release interrupts
   HAL_EXIT_CRITICAL_SECTION(intState);
 
@@ -579,14 +686,19 @@ osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
   osal_msg_hdr_t *pHdr;
   halIntState_t intState;
 
+  if (task_id >= tasksCnt)
+  {
+    return NULL;
+  }
+
   HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
 
-  pHdr = osal_qHead;  // Point to the top of the queue.
+  pHdr = osalTaskMsgQ[task_id].head;  // Point to the top of the task's queue.
 
-  // Look through the queue for a message that matches the task_id and event parameters.
+  // Look through the task's queue for a message that matches the event parameter.
   while (pHdr != NULL)
   {
-    if (((pHdr-1)->dest_id == task_id) && (((osal_event_hdr_t *)pHdr)->event == event))
+    if (((osal_event_hdr_t *)pHdr)->event == event)
     {
       break;
     }
@@ -812,6 +924,10 @@ uint8 osal_set_event( uint8 task_id, uint16 event_flag )
     halIntState_t   intState;
     HAL_ENTER_CRITICAL_SECTION(intState);    // Hold off interrupts
     tasksEvents[task_id] |= event_flag;  // Stuff the event bit(s)
+    if ( event_flag )
+    {
+      osalReadyMap |= BV( task_id );     // Mark the task ready
+    }
     HAL_EXIT_CRITICAL_SECTION(intState);     // Release interrupts
     return ( SUCCESS );
   }
@@ -841,6 +957,10 @@ uint8 osal_clear_event( uint8 task_id, uint16 event_flag )
     halIntState_t   intState;
     HAL_ENTER_CRITICAL_SECTION(intState);    // Hold off interrupts
     tasksEvents[task_id] &= ~(event_flag);   // clear the event bit(s)
+    if ( tasksEvents[task_id] == 0 )
+    {
+      osalReadyMap &= ~BV( task_id );        // Nothing left to do
+    }
     HAL_EXIT_CRITICAL_SECTION(intState);     // Release interrupts
     return ( SUCCESS );
   }
@@ -949,8 +1069,14 @@ uint8 osal_init_system( void )
   // Initialize the Memory Allocation System
   osal_mem_init();
 
-  // Initialize the message queue
-  osal_qHead = NULL;
+  // Initialize the per-task message queues
+  osalTaskMsgQ = (osalTaskMsgQ_t *)osal_mem_alloc( sizeof( osalTaskMsgQ_t ) * tasksCnt );
+  HAL_ASSERT( osalTaskMsgQ != NULL );
+  osal_memset( osalTaskMsgQ, 0, (sizeof( osalTaskMsgQ_t ) * tasksCnt) );
+
+  // The ready bitmap holds one bit per task
+  HAL_ASSERT( tasksCnt <= 16 );
+  osalReadyMap = 0;
 
   // Initialize the timers
   osalTimerInit();
@@ -990,38 +1116,63 @@ void osal_start_system( void )
   for(;;)  // Forever Loop
 #endif
   {
-    uint8 idx = 0;
+    uint8 idx;
+    halIntState_t intState;
 
     ALLOW_SLEEP_MODE();
     osalTimeUpdate();
     Hal_ProcessPoll();
 
-    do {
-      if (tasksEvents[idx])  // Task is highest priority that is ready.
-      {
-        break;
-      }
-    } while (++idx < tasksCnt);
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    idx = osalReadyTask();  // Task is highest priority that is ready.
+    HAL_EXIT_CRITICAL_SECTION(intState);
 
     if (idx < tasksCnt)
     {
       uint16 events;
-      halIntState_t intState;
+#if OSAL_DRAIN_BUDGET
+      uint8 budget = OSAL_DRAIN_BUDGET;
+      uint8 again;
 
+      do {
+#endif
       HAL_ENTER_CRITICAL_SECTION(intState);
       events = tasksEvents[idx];
       tasksEvents[idx] = 0;  // Clear the Events for this task.
+      osalReadyMap &= ~BV(idx);
       HAL_EXIT_CRITICAL_SECTION(intState);
 
-      events = (tasksArr[idx])( idx, events );
+      if (events)  // The events may have been cleared since the pick.
+      {
+        events = (tasksArr[idx])( idx, events );
+      }
 
       HAL_ENTER_CRITICAL_SECTION(intState);
       tasksEvents[idx] |= events;  // Add back unprocessed events to the current task.
+      if (tasksEvents[idx])
+      {
+        osalReadyMap |= BV(idx);
+      }
+#if OSAL_DRAIN_BUDGET
+      // Keep servicing a drained task while it is still the highest priority one ready.
+      again = ((osalDrainMap & BV(idx)) && (budget != 0) && (osalReadyTask() == idx));
+#endif
       HAL_EXIT_CRITICAL_SECTION(intState);
+#if OSAL_DRAIN_BUDGET
+      } while (again && budget--);
+#endif
     }
 
     HAL_ASSERT(HAL_INTERRUPTS_ARE_ENABLED());
 
+#if OSAL_SNV_COMPACT_STEP
+    // Complete pass with no task activity: advance any background NV compaction.
+    if (idx == tasksCnt)
+    {
+      (void)osal_snv_compact_step();
+    }
+#endif
+
 #if defined( POWER_SAVING )
     // Complete pass with no task activity and no wake-from-sleep ISR?
     if ((idx == tasksCnt) && CHECK_SLEEP_MODE())
@@ -1039,6 +1190,34 @@ void osal_start_system( void )
   }
 }
 
+#if OSAL_DRAIN_BUDGET
+/*********************************************************************
+ * @fn      osal_drain_enable
+ *
+ * @brief
+ *
+ *   Mark a task to be drained by osal_start_system(): while the task
+ *   remains the highest priority ready task it is called again, up to
+ *   OSAL_DRAIN_BUDGET extra times, before timers and HAL are polled.
+ *
+ * @param   uint8 task_id - task to drain
+ *
+ * @return  SUCCESS, INVALID_TASK
+ */
+uint8 osal_drain_enable( uint8 task_id )
+{
+  if ( task_id < tasksCnt )
+  {
+    osalDrainMap |= BV( task_id );
+    return ( SUCCESS );
+  }
+  else
+  {
+    return ( INVALID_TASK );
+  }
+}
+#endif
+
 /*********************************************************************
  * @fn      osal_buffer_uint32
  *
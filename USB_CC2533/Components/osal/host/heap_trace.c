@@ -0,0 +1,824 @@
+/**************************************************************************************************
+  Filename:       heap_trace.c
+
+  Description:    Decode a heap trace read out of the OSALMEM_TRACE ring, and replay it against
+                  OSAL_Memory.c built for the host with the heap size and pools under study. The
+                  trace is a series of RTIS_CMD_ID_HEAP_TRACE_READ_REQ replies, each preceded by its
+                  length (see heap_trace_rec.c). The replay reports the peak heap use, the
+                  fragmentation of the free space, the points at which an allocation fails, and
+                  the cost of each operation: the block headers that the first-fit search walks,
+                  which is what the time of osal_mem_alloc() scales with on target, and host nsecs.
+
+                  OSAL_Memory.c is compiled into this module, so that the replay can walk the heap.
+
+                  The caller of a record is listed as the module and line of the call. The 16-bit
+                  caller id holds the OSALMEM_TRACE_FILE_ID of the module in its top 4 bits, which
+                  heapTraceFiles maps back to its name, and the line in its low 12 bits (see
+                  OSAL_Memory.h). A module without an id is listed as "?", and a caller id of 0,
+                  a call from a library, as "lib".
+
+  Usage:          heap_trace [-c] [-d] [-n passes] [-v] trace
+                    -c  check mode: the replay must lay the heap out exactly as the trace does,
+                        and fail no allocation that did not fail on target
+                    -d  decode: list the records
+                    -n  the timed replay passes (default 20)
+                    -v  list every failure point, not only the first ones
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* OSAL includes */
+#include "OSAL_Memory.c"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+// The record format of OSALMEM_TRACE, which the replay is built without.
+#define HEAP_TRACE_ALLOC               'A'
+#define HEAP_TRACE_FREE                'F'
+#define HEAP_TRACE_FAIL                'X'
+#define HEAP_TRACE_KICK                'K'
+#define HEAP_TRACE_REC_LEN             9
+
+// The failure points listed without -v.
+#define HEAP_TRACE_FAIL_LIST           10
+
+/**************************************************************************************************
+ *                                           Typedefs
+ **************************************************************************************************/
+
+typedef struct
+{
+  uint32 msecs;   // Time since the first record, unwrapped
+  uint16 size;
+  uint16 caller;
+  uint16 addr;
+  uint8 op;
+  uint8 lost;     // Records lost, as of the read that ends with this one
+} heapTraceRec_t;
+
+// The free space of the heap past the small-block bucket, where every allocation can go.
+typedef struct
+{
+  uint16 free;    // Bytes free, headers included
+  uint16 largest; // Largest run of free blocks, header included
+  uint16 runs;    // Runs of free blocks
+  uint16 bucket;  // Bytes free in the small-block bucket
+} heapTraceFree_t;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static heapTraceRec_t *heapTraceRecs;
+static unsigned heapTraceCnt;
+
+// The replay block, and the size requested, of each block address of the trace.
+static void *heapTraceMap[0x10000];
+static uint16 heapTraceSize[0x10000];
+
+// Stands in the map for a block whose allocation failed in the replay.
+static uint8 heapTraceNoBlk;
+
+static int heapTraceVerbose;
+
+// The module of each OSALMEM_TRACE_FILE_ID, those of the application by their number.
+static const char * const heapTraceFiles[16] =
+{
+  [OSALMEM_TRACE_FILE_NONE]        = "?",
+  [OSALMEM_TRACE_FILE_OSAL]        = "OSAL.c",
+  [OSALMEM_TRACE_FILE_OSAL_TIMERS] = "OSAL_Timers.c",
+  [OSALMEM_TRACE_FILE_RTI]         = "rti.c",
+  [OSALMEM_TRACE_FILE_GDP]         = "gdp.c",
+  [OSALMEM_TRACE_FILE_ZID_CLD]     = "zid_class_device.c",
+  [OSALMEM_TRACE_FILE_ZID_CLD_APP] = "zid_cld_app_helper.c",
+  [OSALMEM_TRACE_FILE_ZID_ADA]     = "zid_adaptor.c",
+  [OSALMEM_TRACE_FILE_ZID_ADA_APP] = "zid_ada_app_helper.c",
+  [OSALMEM_TRACE_FILE_USB_ZID]     = "usb_zid_class_requests.c",
+  [OSALMEM_TRACE_FILE_HAL_CCM]     = "hal_ccm.c",
+  [OSALMEM_TRACE_FILE_HAL_LCD]     = "hal_lcd.c",
+  [OSALMEM_TRACE_FILE_NP_MAIN]     = "np_main.c",
+  [OSALMEM_TRACE_FILE_APP1]        = "app1",
+  [OSALMEM_TRACE_FILE_APP2]        = "app2",
+  [OSALMEM_TRACE_FILE_APP3]        = "app3"
+};
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static int heapTraceLoad(const char *pPath);
+static void heapTraceDecode(void);
+static const char *heapTraceCaller(uint16 caller);
+static void heapTraceInit(void);
+static void heapTraceWalk(heapTraceFree_t *pFree);
+static unsigned heapTraceSearch(uint16 size);
+static double heapTraceFrag(const heapTraceFree_t *pFree);
+static int heapTraceReport(int check);
+static void heapTraceTime(unsigned passes);
+static unsigned long long heapTraceNow(void);
+
+/**************************************************************************************************
+ * @fn          halAssertHandler
+ *
+ * @brief       An assert in the allocator means that the replay freed a block it does not own.
+ *
+ * @return      Does not return.
+ */
+void halAssertHandler(void)
+{
+  (void)printf("FAIL: HAL assert\n");
+  exit(1);
+}
+
+/**************************************************************************************************
+ * @fn          heapTraceLoad
+ *
+ * @brief       Read the trace file into heapTraceRecs, unwrapping the 16-bit msec time.
+ *
+ * @param       pPath - The trace file.
+ *
+ * @return      0 on success; -1 if the file cannot be read or is cut short.
+ */
+static int heapTraceLoad(const char *pPath)
+{
+  uint8 buf[256];
+  uint16 last = 0;
+  uint32 msecs = 0;
+  unsigned max = 0;
+  int len;
+  FILE *pFile = fopen(pPath, "rb");
+
+  if (pFile == NULL)
+  {
+    perror(pPath);
+    return -1;
+  }
+
+  while ((len = fgetc(pFile)) != EOF)
+  {
+    uint8 *pRec = &buf[1];
+
+    if ((len == 0) || ((len - 1) % HEAP_TRACE_REC_LEN != 0) ||
+        (fread(buf, 1, len, pFile) != (size_t)len))
+    {
+      (void)fprintf(stderr, "%s: bad read at record %u\n", pPath, heapTraceCnt);
+      (void)fclose(pFile);
+      return -1;
+    }
+
+    for (len = (len - 1) / HEAP_TRACE_REC_LEN; len > 0; len--, pRec += HEAP_TRACE_REC_LEN)
+    {
+      heapTraceRec_t *pNew;
+      uint16 now = BUILD_UINT16(pRec[7], pRec[8]);
+
+      if (heapTraceCnt == max)
+      {
+        max = (max == 0) ? 1024 : max * 2;
+        heapTraceRecs = realloc(heapTraceRecs, max * sizeof(heapTraceRec_t));
+        if (heapTraceRecs == NULL)
+        {
+          perror("heap_trace");
+          exit(1);
+        }
+      }
+
+      if (heapTraceCnt != 0)
+      {
+        msecs += (uint16)(now - last);
+      }
+      last = now;
+
+      pNew = &heapTraceRecs[heapTraceCnt++];
+      pNew->op = pRec[0];
+      pNew->size = BUILD_UINT16(pRec[1], pRec[2]);
+      pNew->caller = BUILD_UINT16(pRec[3], pRec[4]);
+      pNew->addr = BUILD_UINT16(pRec[5], pRec[6]);
+      pNew->msecs = msecs;
+      pNew->lost = 0;
+    }
+
+    // The records lost were dropped after those still in the ring at the read.
+    if ((buf[0] != 0) && (heapTraceCnt != 0))
+    {
+      heapTraceRecs[heapTraceCnt - 1].lost += buf[0];
+    }
+  }
+
+  (void)fclose(pFile);
+
+  return 0;
+}
+
+/**************************************************************************************************
+ * @fn          heapTraceDecode
+ *
+ * @brief       List the records.
+ *
+ * @return      None.
+ */
+static void heapTraceDecode(void)
+{
+  unsigned idx;
+
+  for (idx = 0; idx < heapTraceCnt; idx++)
+  {
+    const heapTraceRec_t *pRec = &heapTraceRecs[idx];
+
+    switch (pRec->op)
+    {
+    case HEAP_TRACE_ALLOC:
+      (void)printf("%6u %8.3f alloc %5u -> 0x%04X  caller %s%s\n", idx, pRec->msecs / 1e3,
+                   pRec->size, pRec->addr, heapTraceCaller(pRec->caller), (pRec->size == 0) ? "  (heap init)" : "");
+      break;
+
+    case HEAP_TRACE_FREE:
+      (void)printf("%6u %8.3f free        0x%04X  caller %s\n", idx, pRec->msecs / 1e3,
+                   pRec->addr, heapTraceCaller(pRec->caller));
+      break;
+
+    case HEAP_TRACE_FAIL:
+      (void)printf("%6u %8.3f alloc %5u FAILED  caller %s\n", idx, pRec->msecs / 1e3,
+                   pRec->size, heapTraceCaller(pRec->caller));
+      break;
+
+    case HEAP_TRACE_KICK:
+      (void)printf("%6u %8.3f kick        0x%04X\n", idx, pRec->msecs / 1e3, pRec->addr);
+      break;
+
+    default:
+      (void)printf("%6u %8.3f unknown op 0x%02X\n", idx, pRec->msecs / 1e3, pRec->op);
+      break;
+    }
+
+    if (pRec->lost != 0)
+    {
+      (void)printf("       -- %u records lost\n", pRec->lost);
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          heapTraceCaller
+ *
+ * @brief       Name the caller of a record, as module:line.
+ *
+ * input parameters
+ *
+ * @param       caller - The caller id of the record.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The name, valid until the next call.
+ */
+static const char *heapTraceCaller(uint16 caller)
+{
+  static char name[32];
+
+  if (caller == 0)
+  {
+    return "lib";
+  }
+
+  (void)snprintf(name, sizeof(name), "%s:%u", heapTraceFiles[OSALMEM_TRACE_CALLER_FILE(caller)],
+                 OSALMEM_TRACE_CALLER_LINE(caller));
+  return name;
+}
+
+/**************************************************************************************************
+ * @fn          heapTraceInit
+ *
+ * @brief       Start the replay heap afresh, as the target does at a reset.
+ *
+ * @return      None.
+ */
+static void heapTraceInit(void)
+{
+  (void)memset(heapTraceMap, 0, sizeof(heapTraceMap));
+  osal_mem_init();
+#if ( OSALMEM_METRICS )
+  blkMax = memAlo = memMax = 0;
+#endif
+}
+
+/**************************************************************************************************
+ * @fn          heapTraceWalk
+ *
+ * @brief       Walk the heap and measure its free space. Adjacent free blocks count as one, as
+ *              osal_mem_alloc() coalesces them when it walks over them.
+ *
+ * @param       pFree - The measures.
+ *
+ * @return      None.
+ */
+static void heapTraceWalk(heapTraceFree_t *pFree)
+{
+  osalMemHdr_t *hdr = (osalMemHdr_t *)theHeap;
+  uint16 run = 0;
+
+  (void)memset(pFree, 0, sizeof(heapTraceFree_t));
+
+  while (*hdr != 0)
+  {
+    uint16 size = *hdr & ~OSALMEM_IN_USE;
+
+    if (*hdr & OSALMEM_IN_USE)
+    {
+      run = 0;
+    }
+    else if (hdr < ff2)
+    {
+      pFree->bucket += size;
+    }
+    else
+    {
+      if (run == 0)
+      {
+        pFree->runs++;
+      }
+      run += size;
+      pFree->free += size;
+      if (pFree->largest < run)
+      {
+        pFree->largest = run;
+      }
+    }
+
+    hdr = (osalMemHdr_t *)((uint8 *)hdr + size);
+  }
+}
+
+/**************************************************************************************************
+ * @fn          heapTraceSearch
+ *
+ * @brief       Count the block headers that the first-fit search of osal_mem_alloc() will walk
+ *              for a size, without changing the heap.
+ *
+ * @param       size - The bytes requested.
+ *
+ * @return      The headers walked; 0 if a pool serves the size.
+ */
+static unsigned heapTraceSearch(uint16 size)
+{
+  osalMemHdr_t *hdr;
+  uint16 run = 0;
+  unsigned cnt = 0;
+
+#if ( OSALMEM_POOLS )
+  uint8 idx;
+
+  for (idx = 0; idx < OSALMEM_POOL_CNT; idx++)
+  {
+    if ((size <= osalMemPoolCfg[idx].blkSz) && (osalMemPoolCfg[idx].blkCnt != 0))
+    {
+      if (osalMemPool[idx].free != NULL)
+      {
+        return 0;
+      }
+      break;
+    }
+  }
+#endif
+
+  size += HDRSZ;
+  if (sizeof(halDataAlign_t) != 1)
+  {
+    size = (size + sizeof(halDataAlign_t) - 1) / sizeof(halDataAlign_t) * sizeof(halDataAlign_t);
+  }
+
+  hdr = (size <= OSALMEM_SMALL_BLKSZ) ? ff1 : ff2;
+
+  while (*hdr != 0)
+  {
+    uint16 tmp = *hdr;
+
+    cnt++;
+    if (tmp & OSALMEM_IN_USE)
+    {
+      tmp ^= OSALMEM_IN_USE;
+      run = 0;
+    }
+    else if ((run += tmp) >= size)
+    {
+      break;
+    }
+
+    hdr = (osalMemHdr_t *)((uint8 *)hdr + tmp);
+  }
+
+  return cnt;
+}
+
+/**************************************************************************************************
+ * @fn          heapTraceFrag
+ *
+ * @brief       The fragmentation of the free space: 0 when it is all one block, near 1 when the
+ *              largest block is a small part of it.
+ *
+ * @param       pFree - The free space.
+ *
+ * @return      The fragmentation.
+ */
+static double heapTraceFrag(const heapTraceFree_t *pFree)
+{
+  return (pFree->free == 0) ? 0.0 : 1.0 - (double)pFree->largest / pFree->free;
+}
+
+
+/**************************************************************************************************
+ * @fn          heapTraceReport
+ *
+ * @brief       Replay the trace once, walking the heap after each operation, and report.
+ *
+ * @param       check - Fail if the replay lays a block out elsewhere than the trace does, or
+ *                      fails an allocation that did not fail on target.
+ *
+ * @return      0 on success; 1 on a broken check.
+ */
+static int heapTraceReport(int check)
+{
+  heapTraceFree_t now, atPeak, atLow;
+  unsigned idx, allocs = 0, frees = 0, tgtFails = 0, fits = 0, fails = 0, unmatched = 0;
+  unsigned reused = 0, moved = 0, inits = 0, lost = 0;
+  unsigned walk, walks = 0, walkMax = 0;
+  unsigned live = 0, liveMax = 0, liveIdx = 0, blks = 0, blksMax = 0, fragIdx = 0, lowIdx = 0;
+  double frag, fragMax = 0.0;
+  uint16 recBase = 0;
+  uint8 *pBase = NULL;
+  int bad = 0;
+
+  heapTraceInit();
+  heapTraceWalk(&atPeak);
+  atLow = atPeak;
+
+  for (idx = 0; idx < heapTraceCnt; idx++)
+  {
+    const heapTraceRec_t *pRec = &heapTraceRecs[idx];
+    void *pBlk;
+
+    lost += pRec->lost;
+
+    switch (pRec->op)
+    {
+    case HEAP_TRACE_ALLOC:
+      if (pRec->size == 0)
+      {
+        // The null block that osal_mem_init() allocates: the target was reset.
+        if (inits++ != 0)
+        {
+          heapTraceInit();
+          live = blks = 0;
+        }
+        recBase = pRec->addr;
+        pBase = (uint8 *)ff2;
+        continue;
+      }
+
+      allocs++;
+      if ((pBlk = heapTraceMap[pRec->addr]) != NULL)
+      {
+        // The free of the block that had this address was lost.
+        reused++;
+        if (pBlk != &heapTraceNoBlk)
+        {
+          osal_mem_free(pBlk);
+          live -= heapTraceSize[pRec->addr];
+          blks--;
+        }
+      }
+
+      walk = heapTraceSearch(pRec->size);
+      walks += walk;
+      if (walkMax < walk)
+      {
+        walkMax = walk;
+      }
+
+      if ((pBlk = osal_mem_alloc(pRec->size)) == NULL)
+      {
+        heapTraceWalk(&now);
+        if ((++fails <= HEAP_TRACE_FAIL_LIST) || heapTraceVerbose)
+        {
+          (void)printf("  replay failure: rec %u at %.3f s, %u bytes for caller %s: %u bytes "
+                       "in use, %u free past the bucket, largest block %u\n", idx, pRec->msecs / 1e3, pRec->size,
+                       heapTraceCaller(pRec->caller), live, now.free, (unsigned)((now.largest > HDRSZ) ? now.largest - HDRSZ : 0));
+        }
+        heapTraceMap[pRec->addr] = &heapTraceNoBlk;
+        break;
+      }
+
+      if ((pBase != NULL) && ((uint8 *)pBlk >= theHeap) && ((uint8 *)pBlk < theHeap + MAXMEMHEAP) &&
+          ((uint16)((uint8 *)pBlk - pBase) != (uint16)(pRec->addr - recBase)))
+      {
+        moved++;
+      }
+
+      heapTraceMap[pRec->addr] = pBlk;
+      heapTraceSize[pRec->addr] = pRec->size;
+      live += pRec->size;
+      if (blksMax < ++blks)
+      {
+        blksMax = blks;
+      }
+      if (liveMax < live)
+      {
+        liveMax = live;
+        liveIdx = idx;
+        heapTraceWalk(&atPeak);
+      }
+      break;
+
+    case HEAP_TRACE_FAIL:
+      if ((++tgtFails <= HEAP_TRACE_FAIL_LIST) || heapTraceVerbose)
+      {
+        (void)printf("  target failure: rec %u at %.3f s, %u bytes for caller %s\n", idx,
+                     pRec->msecs / 1e3, pRec->size, heapTraceCaller(pRec->caller));
+      }
+
+      // Would it fit here? The block is not kept, as the target did not get it.
+      if ((pBlk = osal_mem_alloc(pRec->size)) != NULL)
+      {
+        osal_mem_free(pBlk);
+        fits++;
+      }
+      break;
+
+    case HEAP_TRACE_FREE:
+      pBlk = heapTraceMap[pRec->addr];
+      heapTraceMap[pRec->addr] = NULL;
+      frees++;
+      if (pBlk == NULL)
+      {
+        unmatched++;
+      }
+      else if (pBlk != &heapTraceNoBlk)
+      {
+        osal_mem_free(pBlk);
+        live -= heapTraceSize[pRec->addr];
+        blks--;
+      }
+      break;
+
+    case HEAP_TRACE_KICK:
+      osal_mem_kick();
+      break;
+
+    default:
+      break;
+    }
+
+    heapTraceWalk(&now);
+    if (fragMax < (frag = heapTraceFrag(&now)))
+    {
+      fragMax = frag;
+      fragIdx = idx;
+    }
+    if (now.largest < atLow.largest)
+    {
+      atLow = now;
+      lowIdx = idx;
+    }
+  }
+
+  heapTraceWalk(&now);
+
+  (void)printf("  %u allocs, %u frees, %u records lost, %u frees and %u allocs out of step\n",
+               allocs, frees, lost, unmatched, reused);
+  (void)printf("  peak: %u bytes requested in %u blocks at %.3f s", liveMax, blksMax,
+               (liveMax == 0) ? 0.0 : heapTraceRecs[liveIdx].msecs / 1e3);
+#if ( OSALMEM_METRICS )
+  (void)printf("; %u of the %u heap bytes with headers\n", memMax, MAXMEMHEAP);
+#else
+  (void)printf("\n");
+#endif
+  (void)printf("  free at the peak: %u bytes in %u run(s), largest %u, fragmentation %.0f%%; %u in "
+               "the small-block bucket\n", atPeak.free, atPeak.runs, atPeak.largest,
+               heapTraceFrag(&atPeak) * 100, atPeak.bucket);
+  (void)printf("  worst fragmentation: %.0f%% at %.3f s; largest block at its smallest: %u bytes "
+               "at %.3f s\n", fragMax * 100, (heapTraceCnt == 0) ? 0.0 : heapTraceRecs[fragIdx].msecs / 1e3,
+               (unsigned)((atLow.largest > HDRSZ) ? atLow.largest - HDRSZ : 0),
+               (heapTraceCnt == 0) ? 0.0 : heapTraceRecs[lowIdx].msecs / 1e3);
+  (void)printf("  free at the end: %u bytes in %u run(s), largest %u, fragmentation %.0f%%\n",
+               now.free, now.runs, now.largest, heapTraceFrag(&now) * 100);
+  (void)printf("  failures: %u in the replay, %u on target of which %u fit here\n", fails,
+               tgtFails, fits);
+  (void)printf("  first-fit search: %.1f headers walked per alloc, %u worst\n",
+               (allocs == 0) ? 0.0 : (double)walks / allocs, walkMax);
+
+  if (check)
+  {
+    if (inits == 0)
+    {
+      (void)printf("FAIL: no heap init in the trace\n");
+      bad = 1;
+    }
+    if (moved != 0)
+    {
+      (void)printf("FAIL: %u blocks laid out elsewhere than in the trace\n", moved);
+      bad = 1;
+    }
+    if (fails != 0)
+    {
+      (void)printf("FAIL: %u allocations failed that did not on target\n", fails);
+      bad = 1;
+    }
+    if ((lost == 0) && ((unmatched != 0) || (reused != 0)))
+    {
+      (void)printf("FAIL: frees out of step with no record lost\n");
+      bad = 1;
+    }
+  }
+
+  return bad;
+}
+
+/**************************************************************************************************
+ * @fn          heapTraceTime
+ *
+ * @brief       Replay the trace over and over, timing each osal_mem_alloc() and osal_mem_free()
+ *              on the host, less the cost of reading the clock.
+ *
+ * @param       passes - The replays.
+ *
+ * @return      None.
+ */
+static void heapTraceTime(unsigned passes)
+{
+  unsigned long long start, ns, clk = ~0ULL, allocNs = 0, allocMax = 0, freeNs = 0, freeMax = 0;
+  unsigned idx, pass, allocCnt = 0, freeCnt = 0;
+
+  for (idx = 0; idx < 1000; idx++)
+  {
+    start = heapTraceNow();
+    if (clk > (ns = heapTraceNow() - start))
+    {
+      clk = ns;
+    }
+  }
+
+  for (pass = 0; pass < passes; pass++)
+  {
+    heapTraceInit();
+
+    for (idx = 0; idx < heapTraceCnt; idx++)
+    {
+      const heapTraceRec_t *pRec = &heapTraceRecs[idx];
+      void *pBlk;
+
+      if ((pRec->op == HEAP_TRACE_ALLOC) && (pRec->size == 0))
+      {
+        heapTraceInit();
+      }
+      else if (pRec->op == HEAP_TRACE_ALLOC)
+      {
+        if (((pBlk = heapTraceMap[pRec->addr]) != NULL) && (pBlk != &heapTraceNoBlk))
+        {
+          osal_mem_free(pBlk);
+        }
+
+        start = heapTraceNow();
+        pBlk = osal_mem_alloc(pRec->size);
+        ns = heapTraceNow() - start;
+
+        heapTraceMap[pRec->addr] = (pBlk != NULL) ? pBlk : &heapTraceNoBlk;
+        ns = (ns > clk) ? ns - clk : 0;
+        allocNs += ns;
+        allocCnt++;
+        if (allocMax < ns)
+        {
+          allocMax = ns;
+        }
+      }
+      else if (pRec->op == HEAP_TRACE_FREE)
+      {
+        pBlk = heapTraceMap[pRec->addr];
+        heapTraceMap[pRec->addr] = NULL;
+
+        if ((pBlk != NULL) && (pBlk != &heapTraceNoBlk))
+        {
+          start = heapTraceNow();
+          osal_mem_free(pBlk);
+          ns = heapTraceNow() - start;
+
+          ns = (ns > clk) ? ns - clk : 0;
+          freeNs += ns;
+          freeCnt++;
+          if (freeMax < ns)
+          {
+            freeMax = ns;
+          }
+        }
+      }
+      else if (pRec->op == HEAP_TRACE_KICK)
+      {
+        osal_mem_kick();
+      }
+    }
+  }
+
+  (void)printf("  host time over %u passes: alloc %.0f ns, %llu worst; free %.0f ns, %llu worst\n",
+               passes, (allocCnt == 0) ? 0.0 : (double)allocNs / allocCnt, allocMax,
+               (freeCnt == 0) ? 0.0 : (double)freeNs / freeCnt, freeMax);
+}
+
+/**************************************************************************************************
+ * @fn          heapTraceNow
+ *
+ * @brief       Read the host monotonic clock.
+ *
+ * @return      Nsecs.
+ */
+static unsigned long long heapTraceNow(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       Load the trace, decode it if asked, then replay it to report and to time.
+ *
+ * @return      0 on success; 1 on an error or a broken check.
+ */
+int main(int argc, char **argv)
+{
+  unsigned passes = 20;
+  int opt, check = 0, decode = 0, bad;
+
+  while ((opt = getopt(argc, argv, "cdn:v")) != -1)
+  {
+    switch (opt)
+    {
+    case 'c':
+      check = 1;
+      passes = 2;
+      break;
+
+    case 'd':
+      decode = 1;
+      break;
+
+    case 'n':
+      passes = (unsigned)atoi(optarg);
+      break;
+
+    case 'v':
+      heapTraceVerbose = 1;
+      break;
+
+    default:
+      optind = argc;
+      break;
+    }
+  }
+
+  if (optind != argc - 1)
+  {
+    (void)fprintf(stderr, "usage: %s [-c] [-d] [-n passes] [-v] trace\n", argv[0]);
+    return 1;
+  }
+
+  if (heapTraceLoad(argv[optind]) != 0)
+  {
+    return 1;
+  }
+
+  if (decode)
+  {
+    heapTraceDecode();
+  }
+
+  (void)printf("%s: %u records over %.3f s, replayed on a heap of %u bytes, pools %s\n",
+               argv[optind], heapTraceCnt,
+               (heapTraceCnt == 0) ? 0.0 : heapTraceRecs[heapTraceCnt - 1].msecs / 1e3,
+               MAXMEMHEAP, OSALMEM_POOLS ? "on" : "off");
+
+  bad = heapTraceReport(check);
+  heapTraceTime(passes);
+
+  if (check)
+  {
+    (void)printf("%s\n", (bad == 0) ? "PASS" : "FAIL");
+  }
+
+  return bad;
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
@@ -0,0 +1,324 @@
+/**************************************************************************************************
+  Filename:       heap_trace_rec.c
+
+  Description:    Record a heap trace on the HOST target, with OSALMEM_TRACE, as a dongle would
+                  serve it over NPI. A task is fed bursts of messages of NPI frame sizes, keeps
+                  some buffers for a while and frees them on a timer, while the ring is read out
+                  every msec with osal_mem_trace_read(). Each read is written to the trace file
+                  as the reply of RTIS_CMD_ID_HEAP_TRACE_READ_REQ, preceded by its length:
+
+                    len(1), lost(1), len - 1 bytes of records
+
+                  which is the format that heap_trace decodes and replays.
+
+  Usage:          heap_trace_rec [-c] [-n msecs] [-s seed] -o trace
+                    -c  check mode: a shorter run
+                    -n  the msecs to run (default 3000)
+                    -o  the trace file to write
+                    -s  the random seed (default 1)
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_APP1
+
+/* POSIX includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* HAL includes */
+#include "hal_host.h"
+#include "hal_mcu.h"
+
+/* OSAL includes */
+#include "comdef.h"
+#include "OSAL.h"
+#include "OSAL_Memory.h"
+#include "OSAL_Tasks.h"
+#include "OSAL_Timers.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+// The records that fit in one NPI reply, after the count of records lost.
+#define HEAP_REC_READ_LEN              (((128 - 1) / OSALMEM_TRACE_REC_LEN) * OSALMEM_TRACE_REC_LEN)
+
+#define HEAP_REC_EVT_HOLD              0x0001
+
+// The buffers that the task can hold at once.
+#define HEAP_REC_HOLD_MAX              12
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+static uint16 heapRecTask(uint8 task_id, uint16 events);
+
+const pTaskEventHandlerFn tasksArr[] = {
+  heapRecTask
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static uint8 *heapRecHold[HEAP_REC_HOLD_MAX];
+static uint32 heapRecHoldEnd[HEAP_REC_HOLD_MAX];
+
+static FILE *heapRecFile;
+static unsigned heapRecReads, heapRecLost;
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static uint16 heapRecSize(void);
+static void heapRecDrain(void);
+
+/**************************************************************************************************
+ * @fn          halAssertHandler
+ *
+ * @brief       An assert resets the target, so it fails the recording at once.
+ *
+ * @return      Does not return.
+ */
+void halAssertHandler(void)
+{
+  (void)printf("FAIL: HAL assert\n");
+  exit(1);
+}
+
+/**************************************************************************************************
+ * @fn          osalInitTasks, Hal_ProcessPoll
+ *
+ * @brief       The one task is the application, and there is no driver to poll.
+ *
+ * @return      None.
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+}
+
+void Hal_ProcessPoll(void)
+{
+}
+
+/**************************************************************************************************
+ * @fn          heapRecTask
+ *
+ * @brief       Handle one message at a time, as the RTI surrogate does, so that a burst queues up.
+ *              Some messages leave a buffer held until a later timer event frees it.
+ *
+ * @return      The events not processed.
+ */
+static uint16 heapRecTask(uint8 task_id, uint16 events)
+{
+  uint8 idx;
+
+  if (events & SYS_EVENT_MSG)
+  {
+    uint8 *pMsg = osal_msg_receive(task_id);
+
+    if (pMsg != NULL)
+    {
+      (void)osal_msg_deallocate(pMsg);
+
+      if ((rand() % 4) == 0)
+      {
+        for (idx = 0; idx < HEAP_REC_HOLD_MAX; idx++)
+        {
+          if (heapRecHold[idx] == NULL)
+          {
+            heapRecHold[idx] = osal_mem_alloc(8 + rand() % 48);
+            heapRecHoldEnd[idx] = osal_GetSystemClock() + 5 + rand() % 60;
+            (void)osal_start_timerEx(task_id, HEAP_REC_EVT_HOLD, 5);
+            break;
+          }
+        }
+      }
+    }
+
+    return (events ^ SYS_EVENT_MSG);
+  }
+
+  if (events & HEAP_REC_EVT_HOLD)
+  {
+    uint8 held = FALSE;
+
+    for (idx = 0; idx < HEAP_REC_HOLD_MAX; idx++)
+    {
+      if (heapRecHold[idx] != NULL)
+      {
+        if ((int32)(osal_GetSystemClock() - heapRecHoldEnd[idx]) >= 0)
+        {
+          osal_mem_free(heapRecHold[idx]);
+          heapRecHold[idx] = NULL;
+        }
+        else
+        {
+          held = TRUE;
+        }
+      }
+    }
+
+    if (held)
+    {
+      (void)osal_start_timerEx(task_id, HEAP_REC_EVT_HOLD, 5);
+    }
+
+    return (events ^ HEAP_REC_EVT_HOLD);
+  }
+
+  return 0;
+}
+
+/**************************************************************************************************
+ * @fn          heapRecSize
+ *
+ * @brief       Pick the size of a received frame: mostly key and ack frames, some data frames and
+ *              a few full NPI frames.
+ *
+ * @return      The size.
+ */
+static uint16 heapRecSize(void)
+{
+  int pick = rand() % 100;
+
+  if (pick < 70)
+  {
+    return 4 + rand() % 17;
+  }
+  else if (pick < 95)
+  {
+    return 20 + rand() % 41;
+  }
+
+  return 100 + rand() % 34;
+}
+
+/**************************************************************************************************
+ * @fn          heapRecDrain
+ *
+ * @brief       Read the trace ring out as the host would, one NPI reply at a time.
+ *
+ * @return      None.
+ */
+static void heapRecDrain(void)
+{
+  uint8 buf[2 + HEAP_REC_READ_LEN];
+
+  do {
+    buf[0] = 1 + osal_mem_trace_read(&buf[2], HEAP_REC_READ_LEN, &buf[1]);
+    if ((buf[0] != 1) || (buf[1] != 0))
+    {
+      (void)fwrite(buf, 1, 1 + buf[0], heapRecFile);
+      heapRecReads++;
+      heapRecLost += buf[1];
+    }
+  } while (buf[0] == 1 + HEAP_REC_READ_LEN);
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       Run the workload for the msecs given, reading the trace ring out every msec.
+ *
+ * @return      0 on success; 1 on an error.
+ */
+int main(int argc, char **argv)
+{
+  const char *pPath = NULL;
+  unsigned msecs = 3000, msec, fails = 0;
+  int opt, seed = 1;
+
+  while ((opt = getopt(argc, argv, "cn:o:s:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'c':
+      msecs = 500;
+      break;
+
+    case 'n':
+      msecs = (unsigned)atoi(optarg);
+      break;
+
+    case 'o':
+      pPath = optarg;
+      break;
+
+    case 's':
+      seed = atoi(optarg);
+      break;
+
+    default:
+      pPath = NULL;
+      break;
+    }
+  }
+
+  if (pPath == NULL)
+  {
+    (void)fprintf(stderr, "usage: %s [-c] [-n msecs] [-s seed] -o trace\n", argv[0]);
+    return 1;
+  }
+
+  if ((heapRecFile = fopen(pPath, "wb")) == NULL)
+  {
+    perror(pPath);
+    return 1;
+  }
+
+  srand(seed);
+  HAL_ENABLE_INTERRUPTS();
+  osal_init_system();
+  heapRecDrain();
+
+  for (msec = 0; msec < msecs; msec++)
+  {
+    // A burst of received frames now and then, and a few between bursts.
+    unsigned frames = ((rand() % 50) == 0) ? 4 + rand() % 12 : rand() % 2;
+    unsigned passes = rand() % 3;
+
+    while (frames--)
+    {
+      uint8 *pMsg = osal_msg_allocate(heapRecSize());
+
+      if (pMsg == NULL)
+      {
+        fails++;
+      }
+      else
+      {
+        (void)osal_msg_send(0, pMsg);
+      }
+    }
+
+    while (passes--)
+    {
+      osal_start_system();
+    }
+
+    heapRecDrain();
+    (void)usleep(1000);
+  }
+
+  (void)fclose(heapRecFile);
+  (void)printf("%s: %u msecs in %u reads, %u records lost, %u allocations failed\n", pPath, msecs,
+               heapRecReads, heapRecLost, fails);
+
+  return 0;
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
@@ -0,0 +1,327 @@
+/**************************************************************************************************
+  Filename:       msg_bench.c
+
+  Description:    Latency of osal_msg_send() and osal_msg_receive() with 1 to 64 messages queued,
+                  across three tasks that stand in for the NPI, RTI and MAC tasks of the network
+                  processor. Each step sends one message to a task and receives one from it, so
+                  the depth holds; every message must come back in order to the task it was sent
+                  to, with SYS_EVENT_MSG set as long as the task has one queued. It is built
+                  against OSAL.c and, to compare, against the OSAL.c of the single global list.
+
+  Usage:          msg_bench|msg_bench_base [-c] [-n steps]
+                    -c  check mode: fewer steps
+                    -n  the steps at each depth (default 20000)
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/* HAL includes */
+#include "hal_host.h"
+#include "hal_mcu.h"
+
+/* OSAL includes */
+#include "comdef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+#define MSG_BENCH_TASK_CNT             3
+#define MSG_BENCH_DEPTH_MAX            64
+
+/**************************************************************************************************
+ *                                           Typedefs
+ **************************************************************************************************/
+
+typedef struct
+{
+  osal_event_hdr_t hdr;
+  uint32 seq;
+} msgBenchMsg_t;
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+static uint16 msgBenchTask(uint8 task_id, uint16 events);
+
+const pTaskEventHandlerFn tasksArr[MSG_BENCH_TASK_CNT] = {
+  msgBenchTask,
+  msgBenchTask,
+  msgBenchTask
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+// The next sequence number to send to, and to receive at, each task.
+static uint32 msgBenchTx[MSG_BENCH_TASK_CNT];
+static uint32 msgBenchRx[MSG_BENCH_TASK_CNT];
+
+static unsigned msgBenchBad;
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static unsigned long long msgBenchNow(void);
+static unsigned long long msgBenchSend(uint8 task);
+static unsigned long long msgBenchReceive(uint8 task);
+static int msgBenchCmp(const void *pA, const void *pB);
+static double msgBenchSort(unsigned long long *pNs, unsigned cnt);
+
+/**************************************************************************************************
+ * @fn          halAssertHandler
+ *
+ * @brief       An assert resets the target, so it fails the benchmark at once.
+ *
+ * @return      Does not return.
+ */
+void halAssertHandler(void)
+{
+  (void)printf("FAIL: HAL assert\n");
+  exit(1);
+}
+
+/**************************************************************************************************
+ * @fn          osalInitTasks, msgBenchTask, Hal_ProcessPoll
+ *
+ * @brief       The benchmark sends and receives for the tasks itself, so they never run.
+ *
+ * @return      None; the events not processed.
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+}
+
+static uint16 msgBenchTask(uint8 task_id, uint16 events)
+{
+  (void)task_id;
+  return events;
+}
+
+void Hal_ProcessPoll(void)
+{
+}
+
+/**************************************************************************************************
+ * @fn          msgBenchNow
+ *
+ * @brief       Read the host monotonic clock.
+ *
+ * @return      Nsecs.
+ */
+static unsigned long long msgBenchNow(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**************************************************************************************************
+ * @fn          msgBenchSend, msgBenchReceive
+ *
+ * @brief       Queue the next message of a task, or take the oldest one off and check it.
+ *
+ * @param       task - The task.
+ *
+ * @return      The nsecs of the osal_msg_send() or osal_msg_receive() call, with the clock read.
+ */
+static unsigned long long msgBenchSend(uint8 task)
+{
+  msgBenchMsg_t *pMsg = (msgBenchMsg_t *)osal_msg_allocate(sizeof(msgBenchMsg_t));
+  unsigned long long start;
+
+  if (pMsg == NULL)
+  {
+    (void)printf("FAIL: out of heap\n");
+    exit(1);
+  }
+
+  pMsg->hdr.event = 0;
+  pMsg->seq = msgBenchTx[task]++;
+
+  start = msgBenchNow();
+  (void)osal_msg_send(task, (uint8 *)pMsg);
+  return msgBenchNow() - start;
+}
+
+static unsigned long long msgBenchReceive(uint8 task)
+{
+  unsigned long long start = msgBenchNow();
+  msgBenchMsg_t *pMsg = (msgBenchMsg_t *)osal_msg_receive(task);
+  unsigned long long ns = msgBenchNow() - start;
+
+  if ((pMsg == NULL) || (pMsg->seq != msgBenchRx[task]++))
+  {
+    msgBenchBad++;
+  }
+
+  if (((tasksEvents[task] & SYS_EVENT_MSG) != 0) != (msgBenchTx[task] != msgBenchRx[task]))
+  {
+    msgBenchBad++;
+  }
+
+  if (pMsg != NULL)
+  {
+    (void)osal_msg_deallocate((uint8 *)pMsg);
+  }
+
+  return ns;
+}
+
+/**************************************************************************************************
+ * @fn          msgBenchCmp, msgBenchSort
+ *
+ * @brief       Sort the times of a depth, for its percentiles.
+ *
+ * @return      The order of two times; the average time.
+ */
+static int msgBenchCmp(const void *pA, const void *pB)
+{
+  unsigned long long a = *(const unsigned long long *)pA, b = *(const unsigned long long *)pB;
+
+  return (a > b) - (a < b);
+}
+
+static double msgBenchSort(unsigned long long *pNs, unsigned cnt)
+{
+  unsigned long long sum = 0;
+  unsigned idx;
+
+  for (idx = 0; idx < cnt; idx++)
+  {
+    sum += pNs[idx];
+  }
+  qsort(pNs, cnt, sizeof(*pNs), msgBenchCmp);
+
+  return (double)sum / cnt;
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       At each depth, fill the queues round robin, then send and receive step by step,
+ *              timing each call less the cost of reading the clock, then empty the queues. The
+ *              depths are run once unreported first.
+ *
+ * @return      0 on success; 1 on a broken check.
+ */
+int main(int argc, char **argv)
+{
+  unsigned long long start, ns, clk = ~0ULL, *pTx, *pRx;
+  unsigned steps = 20000, depth, step, pass;
+  int opt, check = 0;
+
+  while ((opt = getopt(argc, argv, "cn:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'c':
+      check = 1;
+      steps = 2000;
+      break;
+
+    case 'n':
+      steps = (unsigned)atoi(optarg);
+      break;
+
+    default:
+      (void)fprintf(stderr, "usage: %s [-c] [-n steps]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if ((steps == 0) || ((pTx = malloc(steps * sizeof(*pTx))) == NULL) ||
+      ((pRx = malloc(steps * sizeof(*pRx))) == NULL))
+  {
+    (void)fprintf(stderr, "%s: no room for %u steps\n", argv[0], steps);
+    return 1;
+  }
+
+  for (step = 0; step < 1000; step++)
+  {
+    start = msgBenchNow();
+    if (clk > (ns = msgBenchNow() - start))
+    {
+      clk = ns;
+    }
+  }
+
+  HAL_ENABLE_INTERRUPTS();
+  osal_init_system();
+
+  (void)printf("%s: %u tasks, %u steps at each depth, nsecs on the host\n", argv[0],
+               MSG_BENCH_TASK_CNT, steps);
+  (void)printf("  queued   send avg    p50    p99   recv avg    p50    p99\n");
+
+  // The first pass warms the caches and the heap up, and is not reported.
+  for (depth = 1, pass = 0; depth <= MSG_BENCH_DEPTH_MAX; depth *= (pass++ == 0) ? 1 : 2)
+  {
+    double txAvg, rxAvg;
+
+    for (step = 0; step < depth; step++)
+    {
+      (void)msgBenchSend(step % MSG_BENCH_TASK_CNT);
+    }
+
+    for (step = 0; step < steps; step++)
+    {
+      uint8 task = step % MSG_BENCH_TASK_CNT;
+
+      ns = msgBenchSend(task);
+      pTx[step] = (ns > clk) ? ns - clk : 0;
+      ns = msgBenchReceive(task);
+      pRx[step] = (ns > clk) ? ns - clk : 0;
+    }
+
+    for (step = 0; step < depth; step++)
+    {
+      (void)msgBenchReceive(step % MSG_BENCH_TASK_CNT);
+    }
+
+    if (pass != 0)
+    {
+      txAvg = msgBenchSort(pTx, steps);
+      rxAvg = msgBenchSort(pRx, steps);
+      (void)printf("  %6u %10.1f %6llu %6llu %10.1f %6llu %6llu\n", depth,
+                   txAvg, pTx[steps / 2], pTx[steps * 99 / 100],
+                   rxAvg, pRx[steps / 2], pRx[steps * 99 / 100]);
+    }
+  }
+
+  free(pTx);
+  free(pRx);
+
+  if (msgBenchBad != 0)
+  {
+    (void)printf("FAIL: %u messages out of order or with the wrong event\n", msgBenchBad);
+  }
+  else if (check)
+  {
+    (void)printf("PASS\n");
+  }
+
+  return (msgBenchBad == 0) ? 0 : 1;
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
@@ -0,0 +1,409 @@
+/**************************************************************************************************
+  Filename:       nv_bench.c
+
+  Description:    NV benchmark and power-fail test on the HOST flash emulator. It is built once
+                  against osal_snv.c and once against OSAL_Nv.c through osal_snv_wrapper.c, so
+                  that both back ends run the same workload through the osal_snv API:
+                  - random updates of a set of items, reporting the host write rate, the erases per
+                    1000 updates and the flash time of the average and the worst write on target;
+                  - power failures at random word writes and page erases during the updates, each
+                    followed by osal_snv_init(), reporting its flash time on target and checking
+                    that every item reads back either its last value written or, for the item
+                    being written when the power failed, the new value.
+
+  Usage:          nv_bench_snv|nv_bench_nv [-c] [-i items] [-l len] [-n updates] [-p fails]
+                                           [-f image] [-s seed]
+                    -c  check mode: fewer rounds, and fail on a broken check
+                    -i  the number of items (default 16)
+                    -l  the length of each item (default 16)
+                    -n  the number of updates to time (default 20000)
+                    -p  the number of power failures (default 500)
+                    -f  an image file to keep the flash in (default RAM only)
+                    -s  the random seed (default 1)
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* HAL includes */
+#include "hal_host.h"
+
+/* OSAL includes */
+#include "comdef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "osal_snv.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+#define NV_BENCH_ID_BASE               0x10
+#define NV_BENCH_ITEM_MAX              64
+#define NV_BENCH_LEN_MAX               64
+
+// The power fails at random within this many flash operations of being armed.
+#define NV_BENCH_FAIL_WINDOW           2000
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+static uint16 nvBenchTask(uint8 task_id, uint16 events);
+
+const pTaskEventHandlerFn tasksArr[] = {
+  nvBenchTask
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static uint8 nvBenchItems = 16;
+static uint8 nvBenchLen = 16;
+
+// The values last written with success, and whether each item was ever written.
+static uint8 nvBenchModel[NV_BENCH_ITEM_MAX][NV_BENCH_LEN_MAX];
+static uint8 nvBenchValid[NV_BENCH_ITEM_MAX];
+
+// The update in progress.
+static uint8 nvBenchPendIdx;
+static uint8 nvBenchPendVal[NV_BENCH_LEN_MAX];
+
+static jmp_buf nvBenchEnv;
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static unsigned long long nvBenchNow(void);
+static uint8 nvBenchUpdate(void);
+static unsigned nvBenchVerify(uint8 crashed);
+static void nvBenchCrashLoop(void);
+
+/**************************************************************************************************
+ * @fn          halAssertHandler
+ *
+ * @brief       An NV assert resets the target, so it fails the benchmark at once.
+ *
+ * @return      Does not return.
+ */
+void halAssertHandler(void)
+{
+  (void)printf("FAIL: HAL assert\n");
+  exit(1);
+}
+
+/**************************************************************************************************
+ * @fn          osalInitTasks, nvBenchTask, Hal_ProcessPoll
+ *
+ * @brief       The OSAL is linked for its services only, so it runs no tasks and polls no driver.
+ *
+ * @return      None; the events not processed.
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+}
+
+static uint16 nvBenchTask(uint8 task_id, uint16 events)
+{
+  (void)task_id;
+  (void)events;
+  return 0;
+}
+
+void Hal_ProcessPoll(void)
+{
+}
+
+/**************************************************************************************************
+ * @fn          nvBenchNow
+ *
+ * @brief       Read the host monotonic clock.
+ *
+ * @return      Nsecs.
+ */
+static unsigned long long nvBenchNow(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**************************************************************************************************
+ * @fn          nvBenchUpdate
+ *
+ * @brief       Write a new random value to a random item, and keep it in the model on success.
+ *
+ * @return      The status of osal_snv_write().
+ */
+static uint8 nvBenchUpdate(void)
+{
+  uint8 idx, status;
+
+  nvBenchPendIdx = (uint8)(rand() % nvBenchItems);
+  for (idx = 0; idx < nvBenchLen; idx++)
+  {
+    nvBenchPendVal[idx] = (uint8)rand();
+  }
+  if (nvBenchValid[nvBenchPendIdx] && (nvBenchPendVal[0] == nvBenchModel[nvBenchPendIdx][0]))
+  {
+    // Make sure that the value changes, for every update to reach the flash.
+    nvBenchPendVal[0] ^= 0x01;
+  }
+
+  status = osal_snv_write(NV_BENCH_ID_BASE + nvBenchPendIdx, nvBenchLen, nvBenchPendVal);
+  if (status == SUCCESS)
+  {
+    (void)memcpy(nvBenchModel[nvBenchPendIdx], nvBenchPendVal, nvBenchLen);
+    nvBenchValid[nvBenchPendIdx] = TRUE;
+  }
+
+  return status;
+}
+
+/**************************************************************************************************
+ * @fn          nvBenchVerify
+ *
+ * @brief       Read back every item and compare it with the model. After a power failure, the item
+ *              being written may read either way, and the model takes the value read.
+ *
+ * @param       crashed - TRUE if the update in progress was cut short by a power failure.
+ *
+ * @return      The number of items that read back wrong.
+ */
+static unsigned nvBenchVerify(uint8 crashed)
+{
+  uint8 buf[NV_BENCH_LEN_MAX];
+  unsigned bad = 0;
+  uint8 idx, found;
+
+  for (idx = 0; idx < nvBenchItems; idx++)
+  {
+    found = (osal_snv_read(NV_BENCH_ID_BASE + idx, nvBenchLen, buf) == SUCCESS);
+
+    if (crashed && (idx == nvBenchPendIdx) && found &&
+        (memcmp(buf, nvBenchPendVal, nvBenchLen) == 0))
+    {
+      (void)memcpy(nvBenchModel[idx], buf, nvBenchLen);
+      nvBenchValid[idx] = TRUE;
+    }
+    else if ((found != nvBenchValid[idx]) ||
+             (found && (memcmp(buf, nvBenchModel[idx], nvBenchLen) != 0)))
+    {
+      (void)printf("  item 0x%02X reads back %s\n", NV_BENCH_ID_BASE + idx,
+                   found ? "a wrong value" : "as missing");
+      bad++;
+    }
+  }
+
+  return bad;
+}
+
+/**************************************************************************************************
+ * @fn          nvBenchCrashLoop
+ *
+ * @brief       Update items until the power fails; it longjmp()s out of here.
+ *
+ * @return      Only if updating fails without a power failure.
+ */
+static void nvBenchCrashLoop(void)
+{
+  HalFlashHostPowerFail(1 + (uint32)(rand() % NV_BENCH_FAIL_WINDOW), &nvBenchEnv);
+
+  while (nvBenchUpdate() == SUCCESS);
+
+  HalFlashHostPowerFail(0, NULL);
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       Run the updates, then the power failures, and report.
+ *
+ * @return      0 on success; 1 on a broken check.
+ */
+int main(int argc, char **argv)
+{
+  halFlashHostCnt_t cnt0, cnt1;
+  unsigned long long start, hostNs, recNs, recNsMax = 0;
+  const char *pImage = NULL;
+  unsigned updates = 20000, fails = 500, idx, bad = 0, recovered = 0;
+  uint32 us, usMax = 0, usSum = 0, recUs, recUsMax = 0, recUsSum = 0, recReads = 0;
+  int opt, check = 0, seed = 1;
+
+  while ((opt = getopt(argc, argv, "ci:l:n:p:f:s:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'c':
+      check = 1;
+      updates = 5000;
+      fails = 200;
+      break;
+
+    case 'i':
+      nvBenchItems = (uint8)atoi(optarg);
+      break;
+
+    case 'l':
+      nvBenchLen = (uint8)atoi(optarg);
+      break;
+
+    case 'n':
+      updates = (unsigned)atoi(optarg);
+      break;
+
+    case 'p':
+      fails = (unsigned)atoi(optarg);
+      break;
+
+    case 'f':
+      pImage = optarg;
+      break;
+
+    case 's':
+      seed = atoi(optarg);
+      break;
+
+    default:
+      (void)fprintf(stderr, "usage: %s [-c] [-i items] [-l len] [-n updates] [-p fails] "
+                            "[-f image] [-s seed]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if ((nvBenchItems == 0) || (nvBenchItems > NV_BENCH_ITEM_MAX) ||
+      (nvBenchLen == 0) || (nvBenchLen > NV_BENCH_LEN_MAX) || (updates == 0))
+  {
+    (void)fprintf(stderr, "nv_bench: 1 to %u items of 1 to %u bytes, and some updates\n",
+                  NV_BENCH_ITEM_MAX, NV_BENCH_LEN_MAX);
+    return 1;
+  }
+
+  srand(seed);
+  if (pImage != NULL)
+  {
+    // Each run starts from erased flash.
+    (void)unlink(pImage);
+  }
+  if (HalFlashHostOpen(pImage) != 0)
+  {
+    perror("nv_bench: flash image");
+    return 1;
+  }
+  osal_init_system();
+  osal_snv_init();
+
+  // Updates, timed one by one.
+  cnt0 = halFlashHostCnt;
+  hostNs = 0;
+  for (idx = 0; idx < updates; idx++)
+  {
+    us = halFlashHostCnt.usecs;
+    start = nvBenchNow();
+    if (nvBenchUpdate() != SUCCESS)
+    {
+      (void)printf("FAIL: update %u\n", idx);
+      bad++;
+      break;
+    }
+    hostNs += nvBenchNow() - start;
+
+    us = halFlashHostCnt.usecs - us;
+    usSum += us;
+    if (us > usMax)
+    {
+      usMax = us;
+    }
+  }
+  cnt1 = halFlashHostCnt;
+  bad += nvBenchVerify(FALSE);
+
+  (void)printf("%u updates of %u items x %u bytes on %u NV pages\n", idx, nvBenchItems, nvBenchLen,
+               HAL_NV_PAGE_CNT);
+  (void)printf("  host rate            %.0f writes/s\n", idx * 1e9 / hostNs);
+  (void)printf("  erases               %.2f per 1000 updates\n",
+               (cnt1.erases - cnt0.erases) * 1000.0 / idx);
+  (void)printf("  flash reads          %.1f per update\n", (double)(cnt1.reads - cnt0.reads) / idx);
+  (void)printf("  target flash time    avg %.0f us, worst %u us per update\n",
+               (double)usSum / idx, (unsigned)usMax);
+#if OSAL_SNV_METRICS
+  {
+    uint16 writes, erases, inlined;
+
+    osal_snv_metrics(&writes, &erases, &inlined);
+    (void)printf("  osal_snv_metrics     %u writes, %u erases, %u compactions inside a write\n",
+                 writes, erases, inlined);
+  }
+#endif
+
+  // Power failures, each followed by the recovery at init.
+  for (idx = 0; idx < fails; idx++)
+  {
+    if (setjmp(nvBenchEnv) == 0)
+    {
+      nvBenchCrashLoop();
+      (void)printf("FAIL: update without a power failure\n");
+      bad++;
+      break;
+    }
+
+    HalFlashHostPowerFail(0, NULL);
+    cnt0 = halFlashHostCnt;
+    start = nvBenchNow();
+    osal_snv_init();
+    recNs = nvBenchNow() - start;
+    recUs = halFlashHostCnt.usecs - cnt0.usecs;
+    recReads += halFlashHostCnt.reads - cnt0.reads;
+
+    recUsSum += recUs;
+    if (recUs > recUsMax)
+    {
+      recUsMax = recUs;
+    }
+    if (recNs > recNsMax)
+    {
+      recNsMax = recNs;
+    }
+
+    bad += nvBenchVerify(TRUE);
+    recovered++;
+  }
+
+  if (recovered != 0)
+  {
+    (void)printf("%u power failures\n", recovered);
+    (void)printf("  recovery flash time  avg %.0f us, worst %u us on target; %.0f reads avg\n",
+                 (double)recUsSum / recovered, (unsigned)recUsMax, (double)recReads / recovered);
+    (void)printf("  recovery host time   worst %.1f us\n", recNsMax / 1e3);
+  }
+
+  HalFlashHostClose();
+
+  if (check)
+  {
+    (void)printf("%s\n", (bad == 0) ? "PASS" : "FAIL");
+  }
+
+  return (bad == 0) ? 0 : 1;
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
@@ -0,0 +1,340 @@
+/**************************************************************************************************
+  Filename:       nv_index_bench.c
+
+  Description:    Flash reads per OSAL_Nv operation on the HOST flash emulator. It is built once
+                  with the page scans of findItem() and once with the RAM index of OSAL_NV_INDEX,
+                  and counts the HalFlashRead() calls of osal_nv_read(), osal_nv_item_len(),
+                  osal_nv_write(), the lookup of an item that does not exist, and osal_nv_init().
+                  Every value read is checked against a model of what was written, across
+                  re-inits.
+
+  Usage:          nv_index_bench_scan|nv_index_bench_idx [-c] [-i items] [-l len] [-n rounds]
+                                                         [-s seed]
+                    -c  check mode: fewer rounds, and fail on a broken check
+                    -i  the number of items (default 30)
+                    -l  the length of each item (default 16)
+                    -n  the number of rounds, each of which writes every item once (default 50)
+                    -s  the random seed (default 1)
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* HAL includes */
+#include "hal_host.h"
+
+/* OSAL includes */
+#include "comdef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "OSAL_Tasks.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+#define NV_IDX_BENCH_ID_BASE           0x0100
+#define NV_IDX_BENCH_ID_MISSING        0x0F00
+#define NV_IDX_BENCH_ITEM_MAX          64
+#define NV_IDX_BENCH_LEN_MAX           64
+
+// Rounds between re-inits, which re-build the index.
+#define NV_IDX_BENCH_INIT_EVERY        10
+
+// The operations counted.
+enum
+{
+  NV_IDX_BENCH_READ,
+  NV_IDX_BENCH_LEN,
+  NV_IDX_BENCH_WRITE,
+  NV_IDX_BENCH_MISSING,
+  NV_IDX_BENCH_INIT,
+  NV_IDX_BENCH_OP_CNT
+};
+
+/**************************************************************************************************
+ *                                           Typedefs
+ **************************************************************************************************/
+
+typedef struct
+{
+  const char *pName;
+  unsigned long long reads;
+  unsigned long long ns;
+  unsigned cnt;
+} nvIdxBenchOp_t;
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+static uint16 nvIdxBenchTask(uint8 task_id, uint16 events);
+
+const pTaskEventHandlerFn tasksArr[] = {
+  nvIdxBenchTask
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static nvIdxBenchOp_t nvIdxBenchOps[NV_IDX_BENCH_OP_CNT] = {
+  { "osal_nv_read" },
+  { "osal_nv_item_len" },
+  { "osal_nv_write" },
+  { "lookup of a missing item" },
+  { "osal_nv_init" }
+};
+
+static uint8 nvIdxBenchModel[NV_IDX_BENCH_ITEM_MAX][NV_IDX_BENCH_LEN_MAX];
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static unsigned long long nvIdxBenchNow(void);
+static void nvIdxBenchStart(halFlashHostCnt_t *pCnt, unsigned long long *pNs);
+static void nvIdxBenchStop(uint8 op, halFlashHostCnt_t *pCnt, unsigned long long *pNs);
+
+/**************************************************************************************************
+ * @fn          halAssertHandler
+ *
+ * @brief       An NV assert resets the target, so it fails the benchmark at once.
+ *
+ * @return      Does not return.
+ */
+void halAssertHandler(void)
+{
+  (void)printf("FAIL: HAL assert\n");
+  exit(1);
+}
+
+/**************************************************************************************************
+ * @fn          osalInitTasks, nvIdxBenchTask, Hal_ProcessPoll
+ *
+ * @brief       The OSAL is linked for its services only, so it runs no tasks and polls no driver.
+ *
+ * @return      None; the events not processed.
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+}
+
+static uint16 nvIdxBenchTask(uint8 task_id, uint16 events)
+{
+  (void)task_id;
+  (void)events;
+  return 0;
+}
+
+void Hal_ProcessPoll(void)
+{
+}
+
+/**************************************************************************************************
+ * @fn          nvIdxBenchNow
+ *
+ * @brief       Read the host monotonic clock.
+ *
+ * @return      Nsecs.
+ */
+static unsigned long long nvIdxBenchNow(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**************************************************************************************************
+ * @fn          nvIdxBenchStart, nvIdxBenchStop
+ *
+ * @brief       Count the flash reads and the host time of one operation.
+ *
+ * @return      None.
+ */
+static void nvIdxBenchStart(halFlashHostCnt_t *pCnt, unsigned long long *pNs)
+{
+  *pCnt = halFlashHostCnt;
+  *pNs = nvIdxBenchNow();
+}
+
+static void nvIdxBenchStop(uint8 op, halFlashHostCnt_t *pCnt, unsigned long long *pNs)
+{
+  nvIdxBenchOps[op].ns += nvIdxBenchNow() - *pNs;
+  nvIdxBenchOps[op].reads += halFlashHostCnt.reads - pCnt->reads;
+  nvIdxBenchOps[op].cnt++;
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       Create the items, then rewrite, read back and look each up round after round.
+ *
+ * @return      0 on success; 1 on a broken check.
+ */
+int main(int argc, char **argv)
+{
+  uint8 buf[NV_IDX_BENCH_LEN_MAX];
+  halFlashHostCnt_t cnt;
+  unsigned long long ns;
+  unsigned items = 30, len = 16, rounds = 50, round, idx, op, bad = 0;
+  int opt, check = 0, seed = 1;
+
+  while ((opt = getopt(argc, argv, "ci:l:n:s:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'c':
+      check = 1;
+      rounds = 20;
+      break;
+
+    case 'i':
+      items = (unsigned)atoi(optarg);
+      break;
+
+    case 'l':
+      len = (unsigned)atoi(optarg);
+      break;
+
+    case 'n':
+      rounds = (unsigned)atoi(optarg);
+      break;
+
+    case 's':
+      seed = atoi(optarg);
+      break;
+
+    default:
+      (void)fprintf(stderr, "usage: %s [-c] [-i items] [-l len] [-n rounds] [-s seed]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if ((items == 0) || (items > NV_IDX_BENCH_ITEM_MAX) || (len == 0) ||
+      (len > NV_IDX_BENCH_LEN_MAX))
+  {
+    (void)fprintf(stderr, "nv_index_bench: 1 to %u items of 1 to %u bytes\n",
+                  NV_IDX_BENCH_ITEM_MAX, NV_IDX_BENCH_LEN_MAX);
+    return 1;
+  }
+
+  srand(seed);
+  if (HalFlashHostOpen(NULL) != 0)
+  {
+    perror("nv_index_bench: flash image");
+    return 1;
+  }
+  osal_init_system();
+  osal_nv_init(NULL);
+
+  for (idx = 0; idx < items; idx++)
+  {
+    (void)memset(nvIdxBenchModel[idx], (int)idx, len);
+    if (osal_nv_item_init(NV_IDX_BENCH_ID_BASE + idx, len, nvIdxBenchModel[idx]) != NV_ITEM_UNINIT)
+    {
+      (void)printf("FAIL: osal_nv_item_init 0x%04X\n", NV_IDX_BENCH_ID_BASE + idx);
+      bad++;
+    }
+  }
+
+  for (round = 0; round < rounds; round++)
+  {
+    if ((round % NV_IDX_BENCH_INIT_EVERY) == NV_IDX_BENCH_INIT_EVERY - 1)
+    {
+      nvIdxBenchStart(&cnt, &ns);
+      osal_nv_init(NULL);
+      nvIdxBenchStop(NV_IDX_BENCH_INIT, &cnt, &ns);
+    }
+
+    for (idx = 0; idx < items; idx++)
+    {
+      uint16 id = NV_IDX_BENCH_ID_BASE + idx;
+
+      for (op = 0; op < len; op++)
+      {
+        nvIdxBenchModel[idx][op] = (uint8)rand();
+      }
+
+      nvIdxBenchStart(&cnt, &ns);
+      if (osal_nv_write(id, 0, len, nvIdxBenchModel[idx]) != SUCCESS)
+      {
+        (void)printf("FAIL: osal_nv_write 0x%04X\n", id);
+        bad++;
+      }
+      nvIdxBenchStop(NV_IDX_BENCH_WRITE, &cnt, &ns);
+    }
+
+    for (idx = 0; idx < items; idx++)
+    {
+      uint16 id = NV_IDX_BENCH_ID_BASE + idx;
+      uint8 status;
+
+      nvIdxBenchStart(&cnt, &ns);
+      status = osal_nv_read(id, 0, len, buf);
+      nvIdxBenchStop(NV_IDX_BENCH_READ, &cnt, &ns);
+      if ((status != SUCCESS) || (memcmp(buf, nvIdxBenchModel[idx], len) != 0))
+      {
+        (void)printf("FAIL: osal_nv_read 0x%04X\n", id);
+        bad++;
+      }
+
+      nvIdxBenchStart(&cnt, &ns);
+      status = (osal_nv_item_len(id) == len);
+      nvIdxBenchStop(NV_IDX_BENCH_LEN, &cnt, &ns);
+      if (!status)
+      {
+        (void)printf("FAIL: osal_nv_item_len 0x%04X\n", id);
+        bad++;
+      }
+
+      nvIdxBenchStart(&cnt, &ns);
+      status = osal_nv_read(NV_IDX_BENCH_ID_MISSING + idx, 0, len, buf);
+      nvIdxBenchStop(NV_IDX_BENCH_MISSING, &cnt, &ns);
+      if (status != NV_OPER_FAILED)
+      {
+        (void)printf("FAIL: missing item 0x%04X found\n", NV_IDX_BENCH_ID_MISSING + idx);
+        bad++;
+      }
+    }
+  }
+
+  (void)printf("%u items x %u bytes on %u NV pages, %u rounds, %s\n", items, len, HAL_NV_PAGE_CNT,
+               rounds, OSAL_NV_INDEX ? "OSAL_NV_INDEX" : "page scans");
+  for (op = 0; op < NV_IDX_BENCH_OP_CNT; op++)
+  {
+    if (nvIdxBenchOps[op].cnt != 0)
+    {
+      (void)printf("  %-26s %8.1f flash reads  %8.2f us host\n", nvIdxBenchOps[op].pName,
+                   (double)nvIdxBenchOps[op].reads / nvIdxBenchOps[op].cnt,
+                   nvIdxBenchOps[op].ns / 1e3 / nvIdxBenchOps[op].cnt);
+    }
+  }
+
+  HalFlashHostClose();
+
+  if (check)
+  {
+    (void)printf("%s\n", (bad == 0) ? "PASS" : "FAIL");
+  }
+
+  return (bad == 0) ? 0 : 1;
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
@@ -0,0 +1,318 @@
+/**************************************************************************************************
+  Filename:       timer_bench.c
+
+  Description:    The cost of the 1 msec tick, osalTimerUpdate(), and of osal_next_timeout() with 4,
+                  16 and 64 reload timers active, as the LED, key repeat, ZID and motion timers of
+                  an adaptor are. Every timer must fire at each multiple of its period and at no
+                  other tick. It is built against OSAL_Timers.c and, to compare, against the
+                  OSAL_Timers.c of the unsorted list.
+
+  Usage:          timer_bench|timer_bench_base [-c] [-n ticks]
+                    -c  check mode: fewer ticks
+                    -n  the ticks at each timer count (default 20000)
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/* HAL includes */
+#include "hal_host.h"
+#include "hal_mcu.h"
+
+/* OSAL includes */
+#include "comdef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OSAL_Timers.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+// Each task has 16 event bits, so 4 tasks hold 64 timers.
+#define TIMER_BENCH_TASK_CNT           4
+#define TIMER_BENCH_MAX                64
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+static uint16 timerBenchTask(uint8 task_id, uint16 events);
+
+const pTaskEventHandlerFn tasksArr[TIMER_BENCH_TASK_CNT] = {
+  timerBenchTask,
+  timerBenchTask,
+  timerBenchTask,
+  timerBenchTask
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static unsigned long long timerBenchNow(void);
+static uint16 timerBenchPeriod(uint8 idx);
+static int timerBenchCmp(const void *pA, const void *pB);
+static double timerBenchSort(unsigned long long *pNs, unsigned cnt);
+
+/**************************************************************************************************
+ * @fn          halAssertHandler
+ *
+ * @brief       An assert resets the target, so it fails the benchmark at once.
+ *
+ * @return      Does not return.
+ */
+void halAssertHandler(void)
+{
+  (void)printf("FAIL: HAL assert\n");
+  exit(1);
+}
+
+/**************************************************************************************************
+ * @fn          osalInitTasks, timerBenchTask, Hal_ProcessPoll
+ *
+ * @brief       The benchmark checks and clears the timer events itself, so the tasks never run.
+ *
+ * @return      None; the events not processed.
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+}
+
+static uint16 timerBenchTask(uint8 task_id, uint16 events)
+{
+  (void)task_id;
+  return events;
+}
+
+void Hal_ProcessPoll(void)
+{
+}
+
+/**************************************************************************************************
+ * @fn          timerBenchNow
+ *
+ * @brief       Read the host monotonic clock.
+ *
+ * @return      Nsecs.
+ */
+static unsigned long long timerBenchNow(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**************************************************************************************************
+ * @fn          timerBenchPeriod
+ *
+ * @brief       The period of a timer: 5 to 200 msecs, spread so that few timers fire together.
+ *
+ * @param       idx - The timer.
+ *
+ * @return      Msecs.
+ */
+static uint16 timerBenchPeriod(uint8 idx)
+{
+  return 5 + (idx * 37) % 196;
+}
+
+/**************************************************************************************************
+ * @fn          timerBenchCmp, timerBenchSort
+ *
+ * @brief       Sort the times of a timer count, for its percentiles.
+ *
+ * @return      The order of two times; the average time.
+ */
+static int timerBenchCmp(const void *pA, const void *pB)
+{
+  unsigned long long a = *(const unsigned long long *)pA, b = *(const unsigned long long *)pB;
+
+  return (a > b) - (a < b);
+}
+
+static double timerBenchSort(unsigned long long *pNs, unsigned cnt)
+{
+  unsigned long long sum = 0;
+  unsigned idx;
+
+  for (idx = 0; idx < cnt; idx++)
+  {
+    sum += pNs[idx];
+  }
+  qsort(pNs, cnt, sizeof(*pNs), timerBenchCmp);
+
+  return (double)sum / cnt;
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       For each timer count, start the reload timers, then tick one msec at a time, timing
+ *              each tick and each osal_next_timeout() less the cost of reading the clock, and
+ *              checking the events that fire. The counts are run once unreported first.
+ *
+ * @return      0 on success; 1 on a broken check.
+ */
+int main(int argc, char **argv)
+{
+  static const uint8 counts[] = { 4, 4, 16, 64 };
+  unsigned long long start, ns, clk = ~0ULL, *pTick, *pNext;
+  unsigned ticks = 20000, tick, cnt, bad = 0;
+  int opt, check = 0;
+
+  while ((opt = getopt(argc, argv, "cn:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'c':
+      check = 1;
+      ticks = 2000;
+      break;
+
+    case 'n':
+      ticks = (unsigned)atoi(optarg);
+      break;
+
+    default:
+      (void)fprintf(stderr, "usage: %s [-c] [-n ticks]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if ((ticks == 0) || ((pTick = malloc(ticks * sizeof(*pTick))) == NULL) ||
+      ((pNext = malloc(ticks * sizeof(*pNext))) == NULL))
+  {
+    (void)fprintf(stderr, "%s: no room for %u ticks\n", argv[0], ticks);
+    return 1;
+  }
+
+  for (tick = 0; tick < 1000; tick++)
+  {
+    start = timerBenchNow();
+    if (clk > (ns = timerBenchNow() - start))
+    {
+      clk = ns;
+    }
+  }
+
+  HAL_ENABLE_INTERRUPTS();
+  osal_init_system();
+
+  (void)printf("%s: %u ticks at each timer count, nsecs on the host\n", argv[0], ticks);
+  (void)printf("  timers   tick avg    p50    p99   next avg    p50    p99\n");
+
+  // The first count warms the caches and the heap up, and is not reported.
+  for (cnt = 0; cnt < sizeof(counts); cnt++)
+  {
+    double tickAvg, nextAvg;
+    uint8 idx;
+
+    for (idx = 0; idx < counts[cnt]; idx++)
+    {
+      if (osal_start_reload_timer(idx / 16, BV(idx % 16), timerBenchPeriod(idx)) != SUCCESS)
+      {
+        (void)printf("FAIL: osal_start_reload_timer %u\n", idx);
+        return 1;
+      }
+    }
+
+    for (tick = 1; tick <= ticks; tick++)
+    {
+      uint16 next, nearest = 0xFFFF;
+
+      start = timerBenchNow();
+      osalTimerUpdate(1);
+      ns = timerBenchNow() - start;
+      pTick[tick - 1] = (ns > clk) ? ns - clk : 0;
+
+      start = timerBenchNow();
+      next = osal_next_timeout();
+      ns = timerBenchNow() - start;
+      pNext[tick - 1] = (ns > clk) ? ns - clk : 0;
+
+      for (idx = 0; idx < counts[cnt]; idx++)
+      {
+        uint16 *pEvents = &tasksEvents[idx / 16];
+        uint8 due = ((tick % timerBenchPeriod(idx)) == 0);
+
+        if (((*pEvents & BV(idx % 16)) != 0) != due)
+        {
+          bad++;
+        }
+        *pEvents &= ~BV(idx % 16);
+
+        if (nearest > timerBenchPeriod(idx) - tick % timerBenchPeriod(idx))
+        {
+          nearest = timerBenchPeriod(idx) - tick % timerBenchPeriod(idx);
+        }
+      }
+
+      // The next timeout is the time to the next multiple of the nearest period.
+      if (next != nearest)
+      {
+        bad++;
+      }
+    }
+
+    for (idx = 0; idx < counts[cnt]; idx++)
+    {
+      (void)osal_stop_timerEx(idx / 16, BV(idx % 16));
+    }
+
+    // The unsorted list frees the stopped timers at the next tick, and no event may fire.
+    osalTimerUpdate(1);
+    for (idx = 0; idx < TIMER_BENCH_TASK_CNT; idx++)
+    {
+      if (tasksEvents[idx] != 0)
+      {
+        bad++;
+      }
+    }
+
+    if (osal_timer_num_active() != 0)
+    {
+      bad++;
+    }
+
+    if (cnt != 0)
+    {
+      tickAvg = timerBenchSort(pTick, ticks);
+      nextAvg = timerBenchSort(pNext, ticks);
+      (void)printf("  %6u %10.1f %6llu %6llu %10.1f %6llu %6llu\n", counts[cnt],
+                   tickAvg, pTick[ticks / 2], pTick[ticks * 99 / 100],
+                   nextAvg, pNext[ticks / 2], pNext[ticks * 99 / 100]);
+    }
+  }
+
+  free(pTick);
+  free(pNext);
+
+  if (bad != 0)
+  {
+    (void)printf("FAIL: %u timer events or timeouts wrong\n", bad);
+  }
+  else if (check)
+  {
+    (void)printf("PASS\n");
+  }
+
+  return (bad == 0) ? 0 : 1;
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
@@ -0,0 +1,484 @@
+/**************************************************************************************************
+  Filename:       zid_cfg_node.c
+
+  Description:    One node of the ZID configuration simulation: the target OSAL, SNV on the
+                  emulated flash and the ZID co-layer of a Class Device (FEATURE_ZID_CLD) or of an
+                  Adapter (FEATURE_ZID_ADA), with the RTI and network layer below the co-layer
+                  simulated here as rti.c drives them:
+                  - the node is paired at pairing 0 with a ZID device, and has no other pairing;
+                  - RTI_SendDataReq() passes the frame through zidSendDataReq() to the air, and
+                    the confirm comes back through zidSendDataCnf();
+                  - a frame received goes to zidReceiveDataInd(); the application takes no part.
+
+                  The node is linked into one object with zidCfgNode as its only global symbol.
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* HAL includes */
+#include "hal_flash.h"
+#include "hal_host.h"
+#include "hal_mcu.h"
+
+/* OSAL includes */
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OSAL_Timers.h"
+#include "osal_snv.h"
+
+/* RTI includes */
+#include "rcn_nwk.h"
+#include "rti.h"
+
+/* Profile includes */
+#include "gdp_profile.h"
+#include "zid_common.h"
+#include "zid_profile.h"
+#if FEATURE_ZID_CLD
+#include "zid_class_device.h"
+#include "zid_cld_app_helper.h"
+#else
+#include "zid_adaptor.h"
+#endif
+
+#include "zid_cfg_sim.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+#if !defined ZID_ADA_CFG_NV_BATCH
+#define ZID_ADA_CFG_NV_BATCH           FALSE
+#endif
+
+// The pairing of the node, and the size of the non-standard descriptors that a Class Device pushes.
+#define ZID_CFG_NODE_PAIR_IDX          0
+#define ZID_CFG_NODE_DESC_LEN          aplcMaxNonStdDescCompSize
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static uint16 zidCfgNodeRtiTask(uint8 task_id, uint16 events);
+static uint32 zidCfgNodeInit(uint8 descCnt);
+static uint32 zidCfgNodeStart(void);
+static uint32 zidCfgNodeRun(void);
+static void zidCfgNodeTick(void);
+static uint32 zidCfgNodeRx(uint8 len, uint8 *pData);
+static uint32 zidCfgNodeCnf(uint8 status);
+static uint8 zidCfgNodeState(void);
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+const pTaskEventHandlerFn tasksArr[] = {
+  zidCfgNodeRtiTask,
+#if FEATURE_ZID_CLD
+  zidCld_ProcessEvent
+#else
+  zidAda_ProcessEvent
+#endif
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+uint8 RTI_TaskId;
+const uint8 gRCN_CAP_MAX_PAIRS = 1;
+
+const zidCfgNode_t zidCfgNode = {
+  FEATURE_ZID_ADA,
+  ZID_CFG_WINDOW,
+  ZID_ADA_CFG_NV_BATCH,
+  zidCfgNodeInit,
+  zidCfgNodeStart,
+  zidCfgNodeRun,
+  zidCfgNodeTick,
+  zidCfgNodeRx,
+  zidCfgNodeCnf,
+  zidCfgNodeState
+};
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static rcnNwkPairingEntry_t zidCfgNodeEntry;
+static uint8 zidCfgNodeTxBusy;
+static uint8 zidCfgNodeFailed;
+
+/**************************************************************************************************
+ * @fn          halAssertHandler
+ *
+ * @brief       An assert resets the target, so it fails the simulation at once.
+ *
+ * @return      Does not return.
+ */
+void halAssertHandler(void)
+{
+  (void)printf("FAIL: HAL assert\n");
+  exit(1);
+}
+
+/**************************************************************************************************
+ * @fn          osalInitTasks, Hal_ProcessPoll, MAC_RandomByte
+ *
+ * @brief       The tasks of the node: the simulated RTI, then the ZID co-layer.
+ *
+ * @return      None, or a random byte.
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  RTI_TaskId = 0;
+#if FEATURE_ZID_CLD
+  zidCld_Init( 1 );
+#else
+  zidAda_Init( 1 );
+#endif
+}
+
+void Hal_ProcessPoll(void)
+{
+}
+
+uint8 MAC_RandomByte(void)
+{
+  return (uint8)rand();
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgNodeRtiTask
+ *
+ * @brief       The simulated RTI task, which only takes the end of the configuration.
+ *
+ * @return      None; all events processed.
+ */
+static uint16 zidCfgNodeRtiTask(uint8 task_id, uint16 events)
+{
+  (void)task_id;
+
+  if (events & GDP_EVT_CONFIGURATION_FAILED)
+  {
+    zidCfgNodeFailed = TRUE;
+  }
+
+  // GDP_EVT_CONFIGURE_NEXT: ZID is the only profile to configure.
+  return 0;
+}
+
+/**************************************************************************************************
+ * @fn          RCN_NlmeGetPairingEntryReq, RCN_NlmeRxEnableReq
+ *
+ * @brief       The network layer: one pairing, with a ZID device, and a receiver always on.
+ *
+ * @return      RCN_SUCCESS, or RCN_ERROR_INVALID_INDEX for a pairing other than the one.
+ */
+uint8 RCN_NlmeGetPairingEntryReq( uint8 pairingRef, rcnNwkPairingEntry_t **entry )
+{
+  if (pairingRef != ZID_CFG_NODE_PAIR_IDX)
+  {
+    return RCN_ERROR_INVALID_INDEX;
+  }
+
+  *entry = &zidCfgNodeEntry;
+  return RCN_SUCCESS;
+}
+
+uint8 RCN_NlmeRxEnableReq( uint16 rxOnDurationInMs )
+{
+  (void)rxOnDurationInMs;
+  return RCN_SUCCESS;
+}
+
+/**************************************************************************************************
+ * @fn          RTI_ReadItemEx, RTI_WriteItemEx
+ *
+ * @brief       The RTI items that ZID reads: the TI vendor Id, the node type and no power saving.
+ *              ZID items are written to the co-layer, as rti.c does; others are ignored.
+ *
+ * @return      RTI_SUCCESS, or the status of zidWriteItem().
+ */
+rStatus_t RTI_ReadItemEx(uint8 profileId, uint8 itemId, uint8 len, uint8 *pValue)
+{
+  (void)profileId;
+  osal_memset(pValue, 0, len);
+
+  if (itemId == RTI_CP_ITEM_VENDOR_ID)
+  {
+    pValue[0] = LO_UINT16(RTI_VENDOR_TEXAS_INSTRUMENTS);
+    pValue[1] = HI_UINT16(RTI_VENDOR_TEXAS_INSTRUMENTS);
+  }
+  else if ((itemId == RTI_CP_ITEM_NODE_CAPABILITIES) && FEATURE_ZID_ADA)
+  {
+    pValue[0] = RTI_NODE_CAP_NODE_TYPE_BM;
+  }
+
+  return RTI_SUCCESS;
+}
+
+rStatus_t RTI_WriteItemEx(uint8 profileId, uint8 itemId, uint8 len, uint8 *pValue)
+{
+  if (profileId == RTI_PROFILE_ZID)
+  {
+    return zidWriteItem(itemId, len, pValue);
+  }
+
+  return RTI_SUCCESS;
+}
+
+/**************************************************************************************************
+ * @fn          RTI_SendDataReq
+ *
+ * @brief       Put the data in the air. As the RTI does without a Tx queue, a request made while
+ *              another is in the air fails, which the simulation takes as a failed configuration.
+ *
+ * @return      None.
+ */
+void RTI_SendDataReq( uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions, uint8 len, uint8 *pData )
+{
+  (void)vendorId;
+
+  if (zidCfgNodeTxBusy || (dstIndex != ZID_CFG_NODE_PAIR_IDX) || (profileId != RTI_PROFILE_ZID))
+  {
+    (void)printf("FAIL: %s data request while busy or not to the ZID pairing\n",
+                 FEATURE_ZID_ADA ? "Adapter" : "Class Device");
+    zidCfgNodeFailed = TRUE;
+    return;
+  }
+
+  (void)zidSendDataReq(dstIndex, txOptions, pData);
+  zidCfgNodeTxBusy = TRUE;
+  zidCfgSimTx(&zidCfgNode, len, pData);
+}
+
+/**************************************************************************************************
+ * @fn          RTI_UnpairReq, RTI_ReceiveDataInd
+ *
+ * @brief       An unpair ends the configuration as failed. The application takes no data.
+ *
+ * @return      None.
+ */
+void RTI_UnpairReq( uint8 dstIndex )
+{
+  (void)dstIndex;
+  zidCfgNodeFailed = TRUE;
+}
+
+void RTI_ReceiveDataInd( uint8 srcIndex, uint8 profileId, uint16 vendorId, uint8 rxLQI, uint8 rxFlags, uint8 len, uint8 *pData )
+{
+  (void)srcIndex;
+  (void)profileId;
+  (void)vendorId;
+  (void)rxLQI;
+  (void)rxFlags;
+  (void)len;
+  (void)pData;
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgNodeInit
+ *
+ * @brief       Start the OSAL and SNV on erased flash, and the ZID items, as at a first power up.
+ *              A Class Device stores descCnt non-standard descriptors of
+ *              aplcMaxNonStdDescCompSize bytes, as an application does with the helper.
+ *
+ * @param       descCnt - The number of descriptors, up to aplcMaxNonStdDescCompsPerHID.
+ *
+ * @return      The usecs of the flash operations.
+ */
+static uint32 zidCfgNodeInit(uint8 descCnt)
+{
+  uint32 us;
+
+  if (HalFlashHostOpen(NULL) != 0)
+  {
+    perror("zid_cfg_sim: flash");
+    exit(1);
+  }
+
+  HAL_ENABLE_INTERRUPTS();
+  osal_init_system();
+  osal_snv_init();
+  us = halFlashHostCnt.usecs;
+
+  SET_BIT(zidCfgNodeEntry.profileDiscs, RCN_PROFILE_DISC_ZID);
+  zidInitItems();
+  // A target node, as zidInitCnf() finds from the node capabilities.
+  if (FEATURE_ZID_ADA)
+  {
+    ZID_SET_TGT();
+  }
+
+#if FEATURE_ZID_CLD
+  {
+    uint8 buf[sizeof(zid_non_std_desc_comp_t) + ZID_CFG_NODE_DESC_LEN];
+    zid_non_std_desc_comp_t *pDesc = (zid_non_std_desc_comp_t *)buf;
+    uint16 idx;
+
+    pDesc->type = ZID_DESC_TYPE_REPORT;
+    pDesc->size_l = LO_UINT16(ZID_CFG_NODE_DESC_LEN);
+    pDesc->size_h = HI_UINT16(ZID_CFG_NODE_DESC_LEN);
+    for (idx = 0; idx < ZID_CFG_NODE_DESC_LEN; idx++)
+    {
+      pDesc->data[idx] = (uint8)idx;
+    }
+
+    for (idx = 0; idx < descCnt; idx++)
+    {
+      pDesc->reportId = ZID_STD_REPORT_TOTAL_NUM + 1 + idx;
+      if (zidCldAppHlp_WriteNonStdDescComp((uint8)idx, pDesc) != RTI_SUCCESS)
+      {
+        zidCfgNodeFailed = TRUE;
+      }
+    }
+
+    if (zidWriteItem(ZID_ITEM_HID_NUM_NON_STD_DESC_COMPS, 1, &descCnt) != RTI_SUCCESS)
+    {
+      zidCfgNodeFailed = TRUE;
+    }
+  }
+#else
+  (void)descCnt;
+#endif
+
+  return (halFlashHostCnt.usecs - us);
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgNodeStart
+ *
+ * @brief       Start the configuration of the pairing, as rti.c does on the pair confirm of a
+ *              Class Device or the allow pair confirm of an Adapter.
+ *
+ * @return      The usecs of the flash operations.
+ */
+static uint32 zidCfgNodeStart(void)
+{
+  uint32 us = halFlashHostCnt.usecs;
+
+#if FEATURE_ZID_CLD
+  zidCld_PairCnf(ZID_CFG_NODE_PAIR_IDX);
+#else
+  zidAda_AllowPairCnf(ZID_CFG_NODE_PAIR_IDX);
+#endif
+
+  return (halFlashHostCnt.usecs - us) + zidCfgNodeRun();
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgNodeRun
+ *
+ * @brief       Run the task events pending, highest priority first, as osal_start_system() does
+ *              but on the simulated clock, which zidCfgNodeTick() advances.
+ *
+ * @return      The usecs of the flash operations.
+ */
+static uint32 zidCfgNodeRun(void)
+{
+  uint32 us = halFlashHostCnt.usecs;
+  uint8 idx = 0;
+
+  while (idx < tasksCnt)
+  {
+    uint16 events = tasksEvents[idx];
+
+    if (events == 0)
+    {
+      idx++;
+      continue;
+    }
+
+    tasksEvents[idx] = 0;
+    events = (tasksArr[idx])( idx, events );
+    tasksEvents[idx] |= events;
+    idx = 0;
+  }
+
+  return (halFlashHostCnt.usecs - us);
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgNodeTick
+ *
+ * @brief       Advance the OSAL timers by 1 msec.
+ *
+ * @return      None.
+ */
+static void zidCfgNodeTick(void)
+{
+  osalTimerUpdate(1);
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgNodeRx
+ *
+ * @brief       Receive a secured ZID frame from the pairing, as rti.c passes it to the co-layer.
+ *
+ * @param       len   - The length of the frame.
+ * @param       pData - The frame.
+ *
+ * @return      The usecs of the flash operations.
+ */
+static uint32 zidCfgNodeRx(uint8 len, uint8 *pData)
+{
+  uint32 us = halFlashHostCnt.usecs;
+
+  if (!zidReceiveDataInd(ZID_CFG_NODE_PAIR_IDX, RTI_VENDOR_TEXAS_INSTRUMENTS, 0xFF,
+                         RTI_RX_FLAGS_SECURITY, len, pData))
+  {
+    RTI_ReceiveDataInd(ZID_CFG_NODE_PAIR_IDX, RTI_PROFILE_ZID, RTI_VENDOR_TEXAS_INSTRUMENTS,
+                       0xFF, RTI_RX_FLAGS_SECURITY, len, pData);
+  }
+
+  return (halFlashHostCnt.usecs - us) + zidCfgNodeRun();
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgNodeCnf
+ *
+ * @brief       Confirm the frame in the air, as rti.c does on the network data confirm.
+ *
+ * @param       status - The status of the data request.
+ *
+ * @return      The usecs of the flash operations.
+ */
+static uint32 zidCfgNodeCnf(uint8 status)
+{
+  uint32 us = halFlashHostCnt.usecs;
+
+  zidCfgNodeTxBusy = FALSE;
+  (void)zidSendDataCnf(status);
+
+  return (halFlashHostCnt.usecs - us) + zidCfgNodeRun();
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgNodeState
+ *
+ * @brief       Read the state of the configuration.
+ *
+ * @return      ZID_CFG_NODE_FAILED, ZID_CFG_NODE_DONE or ZID_CFG_NODE_BUSY.
+ */
+static uint8 zidCfgNodeState(void)
+{
+  if (zidCfgNodeFailed)
+  {
+    return ZID_CFG_NODE_FAILED;
+  }
+
+  return (GET_BIT(zidPairInfo.cfgCompleteDisc, ZID_CFG_NODE_PAIR_IDX) ?
+                                             ZID_CFG_NODE_DONE : ZID_CFG_NODE_BUSY);
+}
+
+/**************************************************************************************************
+ */
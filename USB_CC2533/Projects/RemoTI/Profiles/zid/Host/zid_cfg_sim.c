@@ -0,0 +1,500 @@
+/**************************************************************************************************
+  Filename:       zid_cfg_sim.c
+
+  Description:    The time of the ZID configuration phase of a Class Device and an Adapter that
+                  have just paired, with 1 to aplcMaxNonStdDescCompsPerHID non-standard
+                  descriptors of aplcMaxNonStdDescCompSize bytes to push. Both state machines are
+                  the target code (see zid_cfg_node.c), run on one simulated clock over a
+                  simulated link, for each of:
+                  - stop-and-wait, ZID_CFG_WINDOW of 1, with each push written to NV at once;
+                  - the same with ZID_ADA_CFG_NV_BATCH, the pushes written at the end;
+                  - a config push window, ZID_CFG_WINDOW of the build, both without and with
+                    ZID_ADA_CFG_NV_BATCH.
+
+                  The link carries one frame at a time, which takes the mean CSMA backoff, its
+                  bytes and the network and MAC overhead at 250 kbps, and the acknowledgement.
+                  A node is busy for the flash time of the NV writes and erases that it makes,
+                  as the flash emulator counts them, and handles any frame received meanwhile
+                  after. The CPU time of the stacks is not modelled.
+
+                  Each configuration runs in a child process, so that each starts at power up.
+
+  Usage:          zid_cfg_sim [-c]
+                    -c  check mode: fail unless every configuration completes on both sides,
+                        and the window takes no longer than stop-and-wait
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* HAL includes */
+#include "hal_types.h"
+
+#include "zid_cfg_sim.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+// Air time at 250 kbps: the PHY header, MAC header and FCS, RF4CE network header and MIC of a
+// secured frame; the mean initial CSMA backoff with its CCA; the turnaround and acknowledgement.
+#define ZID_CFG_SIM_BYTE_US            32
+#define ZID_CFG_SIM_HDR_LEN            (6 + 11 + 6 + 4)
+#define ZID_CFG_SIM_CSMA_US            (((1 << 3) - 1) * 320 / 2 + 128)
+#define ZID_CFG_SIM_ACK_US             (192 + 11 * ZID_CFG_SIM_BYTE_US)
+
+// The status of a frame acknowledged, RTI_SUCCESS.
+#define ZID_CFG_SIM_TX_SUCCESS         0
+
+#define ZID_CFG_SIM_FRAME_MAX          128
+#define ZID_CFG_SIM_RX_MAX             4
+#define ZID_CFG_SIM_LIMIT_US           (10 * 1000000UL)
+
+#define ZID_CFG_SIM_DESC_MAX           4
+#define ZID_CFG_SIM_VARIANT_CNT        4
+
+/**************************************************************************************************
+ *                                           Typedefs
+ **************************************************************************************************/
+
+// A frame in the air or waiting to be received.
+typedef struct
+{
+  uint8 len;
+  uint8 data[ZID_CFG_SIM_FRAME_MAX];
+} zidCfgSimFrame_t;
+
+// The simulation of one node.
+typedef struct
+{
+  const zidCfgNode_t *pNode;
+  uint32 busyUntil;      // Usecs at which its flash operations end.
+  uint8 txPending;       // The frame sent waits for the air from txReady.
+  uint32 txReady;
+  zidCfgSimFrame_t tx;
+  uint8 cnfPending;      // The frame sent is to be confirmed.
+  uint8 rxCnt;           // Frames received, waiting for the node.
+  zidCfgSimFrame_t rx[ZID_CFG_SIM_RX_MAX];
+  uint32 doneAt;         // Usecs at which it marked the pairing configured.
+  uint32 frames;
+  uint32 nvUs;
+} zidCfgSimSide_t;
+
+// The result of one configuration, sent by the child process.
+typedef struct
+{
+  uint8 ok;
+  uint32 usecs;          // Time to the end of the configuration at the Class Device.
+  uint32 frames;         // Frames sent by both sides.
+  uint32 adaNvUs;        // Flash time of the Adapter.
+} zidCfgSimResult_t;
+
+typedef struct
+{
+  const char *pName;
+  const zidCfgNode_t *pCld;
+  const zidCfgNode_t *pAda;
+} zidCfgSimVariant_t;
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+// The nodes, each built into its own object.
+extern const zidCfgNode_t zidCfgNode_cld_sw;
+extern const zidCfgNode_t zidCfgNode_cld_win;
+extern const zidCfgNode_t zidCfgNode_ada_sw;
+extern const zidCfgNode_t zidCfgNode_ada_sw_batch;
+extern const zidCfgNode_t zidCfgNode_ada_win;
+extern const zidCfgNode_t zidCfgNode_ada_win_batch;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static const zidCfgSimVariant_t zidCfgSimVariants[ZID_CFG_SIM_VARIANT_CNT] = {
+  { "stop-and-wait", &zidCfgNode_cld_sw,  &zidCfgNode_ada_sw },
+  { "+NV batch",     &zidCfgNode_cld_sw,  &zidCfgNode_ada_sw_batch },
+  { "window",        &zidCfgNode_cld_win, &zidCfgNode_ada_win },
+  { "+NV batch",     &zidCfgNode_cld_win, &zidCfgNode_ada_win_batch }
+};
+
+static zidCfgSimSide_t zidCfgSimSides[2];
+static uint32 zidCfgSimNow;
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static uint32 zidCfgSimAir(uint8 len);
+static void zidCfgSimHandle(zidCfgSimSide_t *pSide, uint32 us);
+static uint8 zidCfgSimRun(const zidCfgSimVariant_t *pVariant, uint8 descCnt,
+                          zidCfgSimResult_t *pResult);
+static uint8 zidCfgSimFork(const zidCfgSimVariant_t *pVariant, uint8 descCnt,
+                           zidCfgSimResult_t *pResult);
+
+/**************************************************************************************************
+ * @fn          zidCfgSimTx
+ *
+ * @brief       Put a ZID frame of a node in the air, once the node is done with the operation
+ *              that sends it.
+ *
+ * input parameters
+ *
+ * @param       pNode - The node sending.
+ * @param       len   - The length of the frame.
+ * @param       pData - The frame, copied before return.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void zidCfgSimTx(const zidCfgNode_t *pNode, uint8 len, uint8 *pData)
+{
+  zidCfgSimSide_t *pSide = &zidCfgSimSides[pNode->adapter ? 1 : 0];
+
+  if (pSide->txPending || (len > ZID_CFG_SIM_FRAME_MAX))
+  {
+    (void)printf("FAIL: %u bytes to send while a frame waits\n", len);
+    exit(1);
+  }
+
+  pSide->txPending = TRUE;
+  pSide->txReady = zidCfgSimNow;
+  pSide->tx.len = len;
+  memcpy(pSide->tx.data, pData, len);
+  pSide->frames++;
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgSimAir
+ *
+ * @brief       The time that a frame takes on the link, up to the end of its acknowledgement.
+ *
+ * @param       len - The length of the ZID frame.
+ *
+ * @return      Usecs.
+ */
+static uint32 zidCfgSimAir(uint8 len)
+{
+  return ZID_CFG_SIM_CSMA_US + (ZID_CFG_SIM_HDR_LEN + len) * ZID_CFG_SIM_BYTE_US +
+         ZID_CFG_SIM_ACK_US;
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgSimHandle
+ *
+ * @brief       Account for the flash time of an operation of a node: the node is busy for it,
+ *              and a frame that the operation sent waits for its end.
+ *
+ * @param       pSide - The node.
+ * @param       us    - The flash time of the operation.
+ *
+ * @return      None.
+ */
+static void zidCfgSimHandle(zidCfgSimSide_t *pSide, uint32 us)
+{
+  pSide->busyUntil = zidCfgSimNow + us;
+  pSide->nvUs += us;
+
+  if (pSide->txPending && (pSide->txReady < pSide->busyUntil))
+  {
+    pSide->txReady = pSide->busyUntil;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgSimRun
+ *
+ * @brief       Run one configuration to its end, in the process that runs it.
+ *
+ * @param       pVariant - The nodes to run.
+ * @param       descCnt  - The number of non-standard descriptors of the Class Device.
+ * @param       pResult  - The result.
+ *
+ * @return      TRUE if both sides completed the configuration.
+ */
+static uint8 zidCfgSimRun(const zidCfgSimVariant_t *pVariant, uint8 descCnt,
+                          zidCfgSimResult_t *pResult)
+{
+  zidCfgSimSide_t *pAir = NULL;  // The node whose frame is in the air.
+  uint32 airEnd = 0, nextMs = 1000;
+  uint8 idx;
+
+  memset(zidCfgSimSides, 0, sizeof(zidCfgSimSides));
+  zidCfgSimSides[0].pNode = pVariant->pCld;
+  zidCfgSimSides[1].pNode = pVariant->pAda;
+  zidCfgSimNow = 0;
+
+  for (idx = 0; idx < 2; idx++)
+  {
+    (void)zidCfgSimSides[idx].pNode->pInit(descCnt);
+  }
+
+  // The Adapter has allowed the pairing before the Class Device gets its confirm.
+  zidCfgSimHandle(&zidCfgSimSides[1], zidCfgSimSides[1].pNode->pStart());
+  zidCfgSimHandle(&zidCfgSimSides[0], zidCfgSimSides[0].pNode->pStart());
+
+  while (zidCfgSimNow < ZID_CFG_SIM_LIMIT_US)
+  {
+    uint32 next = nextMs;
+
+    if (zidCfgSimNow == nextMs)
+    {
+      for (idx = 0; idx < 2; idx++)
+      {
+        zidCfgSimSides[idx].pNode->pTick();
+      }
+      nextMs += 1000;
+    }
+
+    if ((pAir != NULL) && (zidCfgSimNow == airEnd))
+    {
+      zidCfgSimSide_t *pPeer = &zidCfgSimSides[(pAir == &zidCfgSimSides[0]) ? 1 : 0];
+
+      if (pPeer->rxCnt == ZID_CFG_SIM_RX_MAX)
+      {
+        (void)printf("FAIL: Rx overrun\n");
+        return FALSE;
+      }
+      pPeer->rx[pPeer->rxCnt++] = pAir->tx;
+      pAir->txPending = FALSE;
+      pAir->cnfPending = TRUE;
+      pAir = NULL;
+    }
+
+    // Each node free takes the confirm, then the frames received, then its task events.
+    for (idx = 0; idx < 2; idx++)
+    {
+      zidCfgSimSide_t *pSide = &zidCfgSimSides[idx];
+
+      while (zidCfgSimNow >= pSide->busyUntil)
+      {
+        if (pSide->cnfPending)
+        {
+          pSide->cnfPending = FALSE;
+          zidCfgSimHandle(pSide, pSide->pNode->pCnf(ZID_CFG_SIM_TX_SUCCESS));
+        }
+        else if (pSide->rxCnt != 0)
+        {
+          zidCfgSimFrame_t frame = pSide->rx[0];
+
+          pSide->rxCnt--;
+          memmove(pSide->rx, pSide->rx + 1, pSide->rxCnt * sizeof(zidCfgSimFrame_t));
+          zidCfgSimHandle(pSide, pSide->pNode->pRx(frame.len, frame.data));
+        }
+        else
+        {
+          uint32 us = pSide->pNode->pRun();
+
+          zidCfgSimHandle(pSide, us);
+          if (us == 0)
+          {
+            break;
+          }
+        }
+      }
+
+      if ((pSide->doneAt == 0) && (pSide->pNode->pState() == ZID_CFG_NODE_DONE))
+      {
+        pSide->doneAt = zidCfgSimNow;
+      }
+    }
+
+    if ((zidCfgSimSides[0].pNode->pState() == ZID_CFG_NODE_FAILED) ||
+        (zidCfgSimSides[1].pNode->pState() == ZID_CFG_NODE_FAILED))
+    {
+      break;
+    }
+
+    if ((zidCfgSimSides[0].doneAt != 0) && (zidCfgSimSides[1].doneAt != 0))
+    {
+      pResult->ok = TRUE;
+      break;
+    }
+
+    // The channel goes to the first frame ready, the Class Device's on a tie.
+    if (pAir == NULL)
+    {
+      for (idx = 0; idx < 2; idx++)
+      {
+        zidCfgSimSide_t *pSide = &zidCfgSimSides[idx];
+
+        if (pSide->txPending && (pSide->txReady <= zidCfgSimNow) &&
+            ((pAir == NULL) || (pSide->txReady < pAir->txReady)))
+        {
+          pAir = pSide;
+        }
+      }
+
+      if (pAir != NULL)
+      {
+        airEnd = zidCfgSimNow + zidCfgSimAir(pAir->tx.len);
+      }
+    }
+
+    if ((pAir != NULL) && (next > airEnd))
+    {
+      next = airEnd;
+    }
+
+    for (idx = 0; idx < 2; idx++)
+    {
+      zidCfgSimSide_t *pSide = &zidCfgSimSides[idx];
+
+      if ((pSide->busyUntil > zidCfgSimNow) && (next > pSide->busyUntil))
+      {
+        next = pSide->busyUntil;
+      }
+      if ((pAir == NULL) && pSide->txPending && (next > pSide->txReady))
+      {
+        next = pSide->txReady;
+      }
+    }
+
+    zidCfgSimNow = next;
+  }
+
+  pResult->usecs = zidCfgSimSides[0].doneAt;
+  pResult->frames = zidCfgSimSides[0].frames + zidCfgSimSides[1].frames;
+  pResult->adaNvUs = zidCfgSimSides[1].nvUs;
+
+  return pResult->ok;
+}
+
+/**************************************************************************************************
+ * @fn          zidCfgSimFork
+ *
+ * @brief       Run one configuration in a child process, which starts the nodes at power up.
+ *
+ * @param       pVariant - The nodes to run.
+ * @param       descCnt  - The number of non-standard descriptors of the Class Device.
+ * @param       pResult  - The result.
+ *
+ * @return      TRUE if both sides completed the configuration.
+ */
+static uint8 zidCfgSimFork(const zidCfgSimVariant_t *pVariant, uint8 descCnt,
+                           zidCfgSimResult_t *pResult)
+{
+  int fds[2], status;
+  pid_t pid;
+
+  memset(pResult, 0, sizeof(zidCfgSimResult_t));
+  (void)fflush(stdout);
+
+  if ((pipe(fds) != 0) || ((pid = fork()) < 0))
+  {
+    perror("zid_cfg_sim");
+    exit(1);
+  }
+
+  if (pid == 0)
+  {
+    (void)close(fds[0]);
+    (void)zidCfgSimRun(pVariant, descCnt, pResult);
+    (void)fflush(stdout);
+    _exit((write(fds[1], pResult, sizeof(zidCfgSimResult_t)) == sizeof(zidCfgSimResult_t)) ? 0 : 1);
+  }
+
+  (void)close(fds[1]);
+  if (read(fds[0], pResult, sizeof(zidCfgSimResult_t)) != sizeof(zidCfgSimResult_t))
+  {
+    memset(pResult, 0, sizeof(zidCfgSimResult_t));
+  }
+  (void)close(fds[0]);
+  (void)waitpid(pid, &status, 0);
+
+  return pResult->ok;
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       Run the configuration with each number of descriptors and each variant.
+ *
+ * @return      0 on success; 1 on a failed check.
+ */
+int main(int argc, char **argv)
+{
+  zidCfgSimResult_t results[ZID_CFG_SIM_DESC_MAX][ZID_CFG_SIM_VARIANT_CNT];
+  uint8 check = FALSE, desc, var;
+  unsigned bad = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "c")) != -1)
+  {
+    if (opt == 'c')
+    {
+      check = TRUE;
+    }
+    else
+    {
+      (void)fprintf(stderr, "usage: %s [-c]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  (void)printf("ZID configuration, descriptors of 256 bytes, window of %u pushes;\n"
+               "msecs to the end at the Class Device, frames sent, msecs of Adapter flash\n",
+               zidCfgNode_cld_win.window);
+  (void)printf("  descs");
+  for (var = 0; var < ZID_CFG_SIM_VARIANT_CNT; var++)
+  {
+    (void)printf("  %22s", zidCfgSimVariants[var].pName);
+  }
+  (void)printf("\n");
+
+  for (desc = 1; desc <= ZID_CFG_SIM_DESC_MAX; desc++)
+  {
+    (void)printf("  %5u", desc);
+
+    for (var = 0; var < ZID_CFG_SIM_VARIANT_CNT; var++)
+    {
+      zidCfgSimResult_t *pResult = &results[desc - 1][var];
+
+      if (zidCfgSimFork(&zidCfgSimVariants[var], desc, pResult))
+      {
+        (void)printf("  %8.1f %4u %8.1f", pResult->usecs / 1000.0, pResult->frames,
+                     pResult->adaNvUs / 1000.0);
+      }
+      else
+      {
+        (void)printf("  %22s", "FAILED");
+        bad++;
+      }
+    }
+    (void)printf("\n");
+
+    // The window is checked against stop-and-wait with the same NV writes.
+    for (var = 0; var < 2; var++)
+    {
+      if (results[desc - 1][var].ok && results[desc - 1][var + 2].ok &&
+          (results[desc - 1][var + 2].usecs > results[desc - 1][var].usecs))
+      {
+        (void)printf("FAIL: %u descriptors: the window takes longer than stop-and-wait\n", desc);
+        bad++;
+      }
+    }
+  }
+
+  if (check && (bad != 0))
+  {
+    (void)printf("FAIL: %u failed checks\n", bad);
+    return 1;
+  }
+
+  return 0;
+}
+
+/**************************************************************************************************
+ */
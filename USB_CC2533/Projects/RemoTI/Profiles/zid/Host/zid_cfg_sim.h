@@ -0,0 +1,85 @@
+/**************************************************************************************************
+  Filename:       zid_cfg_sim.h
+
+  Description:    Interface between the ZID configuration simulation and each of its nodes. A node
+                  is the target OSAL, SNV and ZID co-layer of one side of the pair, a Class Device
+                  or an Adapter, linked into one object whose only global symbol is its
+                  zidCfgNode_t, so that nodes built with different options share the simulation.
+**************************************************************************************************/
+#ifndef ZID_CFG_SIM_H
+#define ZID_CFG_SIM_H
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Constants
+ * ------------------------------------------------------------------------------------------------
+ */
+
+// The state of the configuration at a node.
+#define ZID_CFG_NODE_BUSY                  0
+#define ZID_CFG_NODE_DONE                  1  // The pairing is marked configured.
+#define ZID_CFG_NODE_FAILED                2  // The configuration failed, or the node misbehaved.
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Typedefs
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/* The entry points of a node. Each but pState returns the usecs that the flash writes and erases
+ * it made would take on target, during which the node does nothing else.
+ */
+typedef struct
+{
+  uint8 adapter;  // TRUE for an Adapter, FALSE for a Class Device.
+  uint8 window;   // ZID_CFG_WINDOW of the build.
+  uint8 nvBatch;  // ZID_ADA_CFG_NV_BATCH of the build.
+
+  // Start the OSAL and SNV on erased flash; a Class Device also stores descCnt descriptors.
+  uint32 (*pInit)(uint8 descCnt);
+  // Start the configuration of pairing 0, as the pairing confirm does.
+  uint32 (*pStart)(void);
+  // Run the OSAL task events pending.
+  uint32 (*pRun)(void);
+  // Advance the OSAL timers by 1 msec.
+  void (*pTick)(void);
+  // Receive a ZID frame from the peer, and run the task events that it sets.
+  uint32 (*pRx)(uint8 len, uint8 *pData);
+  // Confirm the frame sent, and run the task events that it sets.
+  uint32 (*pCnf)(uint8 status);
+  // Read the ZID_CFG_NODE_ state.
+  uint8 (*pState)(void);
+} zidCfgNode_t;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**************************************************************************************************
+ * @fn          zidCfgSimTx
+ *
+ * @brief       Put a ZID frame of a node in the air. A node has one frame in the air at most.
+ *
+ * input parameters
+ *
+ * @param       pNode - The node sending.
+ * @param       len   - The length of the frame.
+ * @param       pData - The frame, copied before return.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+extern void zidCfgSimTx(const zidCfgNode_t *pNode, uint8 len, uint8 *pData);
+
+#endif
+/**************************************************************************************************
+ */
@@ -44,6 +44,19 @@ extern "C" {
 #define FEATURE_ZID_ADA_TST  FALSE
 #endif
 
+// Setting to TRUE keeps each proxied device's entry, non-standard descriptor headers and NULL
+// reports in RAM so that report Id lookups, NULL reports and USB re-enumeration do not read NV.
+#if !defined ZID_ADA_DESC_CACHE
+#define ZID_ADA_DESC_CACHE  FALSE
+#endif
+
+// Setting to TRUE holds the non-standard descriptor fragments and NULL reports pushed in the
+// configuration phase in heap and writes them to NV with the proxy entry in one batch when the
+// configuration completes, instead of one NV write per push.
+#if !defined ZID_ADA_CFG_NV_BATCH
+#define ZID_ADA_CFG_NV_BATCH  FALSE
+#endif
+
 // ZID ADA task events
 #define ZID_ADA_EVT_IDLE_RATE_GUARD_TIME 0x0001
 
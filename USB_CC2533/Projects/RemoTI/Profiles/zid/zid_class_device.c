@@ -7,6 +7,9 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_ZID_CLD
+
 #include "comdef.h"
 #include "gdp_profile.h"
 #include "OSAL.h"
@@ -76,6 +79,13 @@ static uint8 procGetCldAttr(uint8 cnt, uint8 *pReq, uint8 *pBuf);
 static void unpairReq(uint8 dstIndex);
 static void pushNullReport( void );
 static uint8 getCldAttrTableIdx( uint8 attrId );
+#if (ZID_CFG_WINDOW > 1)
+static void rxGetAttrRsp(uint8 len, uint8 *pData);
+static uint8 cfgWindowCmd(uint8 cmd);
+#endif
+#if ZID_CLD_BATCH_TIME
+static void sendBatch(void);
+#endif
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Local Variables
@@ -92,7 +102,19 @@ static uint16 currentNonStdDescCompLen;
 static uint8 currentNullReportNum;
 static uint8 zidCldCurrentNonStdDescNum;
 static uint8 zidCldCurrentNonStdDescFragNum;
-static const zid_table_t zidCld_attributeTable[] =
+#if (ZID_CFG_WINDOW > 1)
+// Config push window agreed with the Adapter, and the number of pushes sent in the current window.
+static uint8 cldCfgWindow;
+static uint8 cldCfgWindowCnt;
+#endif
+#if ZID_CLD_BATCH_TIME
+// Report Data command frame being built from the records given to zidCld_SendReport().
+static uint8 cldBatchBuf[ZID_CLD_BATCH_LEN];
+static uint8 cldBatchLen;
+static uint8 cldBatchIdx;
+static uint8 cldBatchTxOptions;
+#endif
+static const zid_table_t zidCld_attributeTable[ZID_ATTR_TABLE_LEN] =
 {
   {
     aplZIDProfileVersion,
@@ -104,31 +126,16 @@ static const zid_table_t zidCld_attributeTable[] =
     ZID_DATATYPE_UINT16_LEN,
     offsetof(zid_cld_cfg_t, IntPipeUnsafeTxWindowTime)
   },
-  {
-    aplHIDParserVersion,
-    ZID_DATATYPE_UINT16_LEN,
-    offsetof(zid_cld_cfg_t, HIDParserVersion)
-  },
-  {
-    aplHIDDeviceReleaseNumber,
-    ZID_DATATYPE_UINT16_LEN,
-    offsetof(zid_cld_cfg_t, HIDDeviceReleaseNumber)
-  },
-  {
-    aplHIDVendorId,
-    ZID_DATATYPE_UINT16_LEN,
-    offsetof(zid_cld_cfg_t, HIDVendorId)
-  },
-  {
-    aplHIDProductId,
-    ZID_DATATYPE_UINT16_LEN,
-    offsetof(zid_cld_cfg_t, HIDProductId)
-  },
   {
     aplReportRepeatInterval,
     ZID_DATATYPE_UINT8_LEN,
     offsetof(zid_cld_cfg_t, ReportRepeatInterval)
   },
+  {
+    aplHIDParserVersion,
+    ZID_DATATYPE_UINT16_LEN,
+    offsetof(zid_cld_cfg_t, HIDParserVersion)
+  },
   {
     aplHIDDeviceSubclass,
     ZID_DATATYPE_UINT8_LEN,
@@ -144,6 +151,21 @@ static const zid_table_t zidCld_attributeTable[] =
     ZID_DATATYPE_UINT8_LEN,
     offsetof(zid_cld_cfg_t, HIDCountryCode)
   },
+  {
+    aplHIDDeviceReleaseNumber,
+    ZID_DATATYPE_UINT16_LEN,
+    offsetof(zid_cld_cfg_t, HIDDeviceReleaseNumber)
+  },
+  {
+    aplHIDVendorId,
+    ZID_DATATYPE_UINT16_LEN,
+    offsetof(zid_cld_cfg_t, HIDVendorId)
+  },
+  {
+    aplHIDProductId,
+    ZID_DATATYPE_UINT16_LEN,
+    offsetof(zid_cld_cfg_t, HIDProductId)
+  },
   {
     aplHIDNumEndpoints,
     ZID_DATATYPE_UINT8_LEN,
@@ -169,13 +191,16 @@ static const zid_table_t zidCld_attributeTable[] =
     ZID_DATATYPE_UINT8_LEN,
     offsetof(zid_cld_cfg_t, HIDNumNullReports)
   },
+  ZID_TABLE_ENTRY_UNUSED,  // 0xEC (reserved)
+  ZID_TABLE_ENTRY_UNUSED,  // 0xED (reserved)
+  ZID_TABLE_ENTRY_UNUSED,  // 0xEE (reserved)
+  ZID_TABLE_ENTRY_UNUSED,  // 0xEF (reserved)
   {
     aplHIDNumNonStdDescComps,
     ZID_DATATYPE_UINT8_LEN,
     offsetof(zid_cld_cfg_t, HIDNumNonStdDescComps)
   }
 };
-#define ZID_CLD_ATTRIBUTE_TABLE_LEN  (sizeof(zidCld_attributeTable) / sizeof(zidCld_attributeTable[0]))
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Global Variables
@@ -300,6 +325,21 @@ uint16 zidCld_ProcessEvent(uint8 taskId, uint16 events)
     rspWaitTimeout();
   }
 
+#if ZID_CLD_BATCH_TIME
+  if (events & ZID_CLD_EVT_BATCH)
+  {
+    sendBatch();
+  }
+#endif
+
+#if (ZID_CFG_WINDOW > 1)
+  if (events & ZID_CLD_EVT_CFG_WINDOW)
+  {
+    // A windowed config push went out, so push the next one without awaiting a response.
+    pushConfig();
+  }
+#endif
+
   return 0;  // All events processed in one pass; discard unexpected events.
 }
 
@@ -326,9 +366,17 @@ uint8 zidCld_SendDataReq(uint8 dstIndex, uint8 txOptions, uint8 *cmd)
 
   switch (*cmd & GDP_HEADER_CMD_CODE_MASK)
   {
-  case GDP_CMD_GET_ATTR:
   case GDP_CMD_PUSH_ATTR:
   case ZID_CMD_SET_REPORT:
+#if (ZID_CFG_WINDOW > 1)
+    if (*cmd & GDP_HEADER_DATA_PENDING)  // A windowed config push has no response of its own.
+    {
+      ZID_SET_WINDOW();  // Set status bit for action on send data confirm.
+      break;
+    }
+#endif
+    // no break
+  case GDP_CMD_GET_ATTR:
   case GDP_CMD_CFG_COMPLETE:
     ZID_SET_RSPING();  // Set status bit for action on send data confirm.
     zidRspIdx = dstIndex;
@@ -368,6 +416,122 @@ uint8 zidCld_SendDataReq(uint8 dstIndex, uint8 txOptions, uint8 *cmd)
   return txOptions;
 }
 
+/**************************************************************************************************
+ * @fn          zidCld_SendReport
+ *
+ * @brief       This API is used to send a report record in a ZID Report Data command frame.
+ *              The record is held for up to ZID_CLD_BATCH_TIME so that the records given
+ *              meanwhile share the frame, which is then sent by RTI_SendDataReq(); one
+ *              RTI_SendDataCnf() follows for the whole frame.
+ *
+ * input parameters
+ *
+ * @param       dstIndex  - Pairing table index of target.
+ * @param       txOptions - Bit mask according to the ZID_TX_OPTION_... definitions.
+ * @param       *pRecord  - A pointer to the report record.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if the record was taken; FALSE if it could not join the pending frame, which
+ *              is then sent at once, and has to be given again after its RTI_SendDataCnf().
+ */
+uint8 zidCld_SendReport(uint8 dstIndex, uint8 txOptions, zid_report_record_t *pRecord)
+{
+  uint8 len = pRecord->len + 1;  // The record length field does not count itself.
+
+#if ZID_CLD_BATCH_TIME
+  if (cldBatchLen != 0)
+  {
+    uint8 idx;
+
+    // A record joins the pending frame only if the frame has room and holds no record of the
+    // same report, whose earlier state the target would otherwise never see.
+    for (idx = 1; idx < cldBatchLen; idx += cldBatchBuf[idx] + 1)
+    {
+      if (((zid_report_record_t *)(cldBatchBuf + idx))->id == pRecord->id)
+      {
+        break;
+      }
+    }
+
+    if ((dstIndex != cldBatchIdx) || (idx < cldBatchLen) ||
+        ((uint16)cldBatchLen + len > ZID_CLD_BATCH_LEN))
+    {
+      (void)osal_stop_timerEx(zidCld_TaskId, ZID_CLD_EVT_BATCH);
+      sendBatch();
+      return FALSE;
+    }
+
+    // The Control Pipe of any one record takes the whole frame.
+    if (!(txOptions & RTI_TX_OPTION_SINGLE_CHANNEL))
+    {
+      cldBatchTxOptions = txOptions;
+    }
+  }
+  else
+  {
+    if (len >= ZID_CLD_BATCH_LEN)
+    {
+      return FALSE;
+    }
+
+    if (osal_start_timerEx(zidCld_TaskId, ZID_CLD_EVT_BATCH, ZID_CLD_BATCH_TIME) != SUCCESS)
+    {
+      (void)osal_set_event(zidCld_TaskId, ZID_CLD_EVT_BATCH);
+    }
+
+    cldBatchBuf[0] = ZID_CMD_REPORT_DATA;
+    cldBatchLen = 1;
+    cldBatchIdx = dstIndex;
+    cldBatchTxOptions = txOptions;
+  }
+
+  (void)osal_memcpy(cldBatchBuf + cldBatchLen, pRecord, len);
+  cldBatchLen += len;
+#else
+  uint8 buf[ZID_CLD_BATCH_LEN];
+  uint16 vendorId = RTI_VENDOR_TEXAS_INSTRUMENTS;
+
+  if (len >= ZID_CLD_BATCH_LEN)
+  {
+    return FALSE;
+  }
+
+  buf[0] = ZID_CMD_REPORT_DATA;
+  (void)osal_memcpy(buf + 1, pRecord, len);
+  (void)RTI_ReadItemEx(RTI_PROFILE_RTI, RTI_CP_ITEM_VENDOR_ID, sizeof(uint16), (uint8 *)&vendorId);
+  RTI_SendDataReq(dstIndex, RTI_PROFILE_ZID, vendorId, txOptions, len + 1, buf);
+#endif
+
+  return TRUE;
+}
+
+/**************************************************************************************************
+ * @fn          zidCld_ReportPending
+ *
+ * @brief       This API is used to check whether report records are being held for a frame.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if zidCld_SendReport() can add a record to a frame not yet sent.
+ */
+uint8 zidCld_ReportPending(void)
+{
+#if ZID_CLD_BATCH_TIME
+  return (cldBatchLen != 0);
+#else
+  return FALSE;
+#endif
+}
+
 /**************************************************************************************************
  * @fn      zidCld_ReceiveDataInd
  *
@@ -407,6 +571,9 @@ uint8 zidCld_ReceiveDataInd(uint8 srcIndex, uint8 rxFlags, uint8 len, uint8 *pDa
   case GDP_CMD_GET_ATTR_RSP:
     if ((srcIndex == zidCfgIdx) && (cldState == eCldCfgGet))
     {
+#if (ZID_CFG_WINDOW > 1)
+      rxGetAttrRsp(len, pData);
+#endif
       pushConfig();
     }
     else
@@ -467,6 +634,10 @@ void zidCld_PairCnf(uint8 dstIndex)
   {
     zidCfgIdx = dstIndex;
     cldState = eCldCfgGet;
+#if (ZID_CFG_WINDOW > 1)
+    cldCfgWindow = 1;
+    cldCfgWindowCnt = 0;
+#endif
     CLR_BIT(zidPairInfo.adapterDisc, dstIndex);
     CLR_BIT(zidPairInfo.cfgCompleteDisc, dstIndex);
     (void)osal_snv_write(ZID_COMMON_NVID_PAIR_INFO, sizeof(zid_pair_t), (uint8 *)&zidPairInfo);
@@ -690,6 +861,7 @@ static void rspWaitTimeout(void)
     case eCldCfgGet:  // Attempting to get the Adapter capabilities.
     case eCldCfgPxy:  // Attempting to push the proxy table entry configuration.
     case eCldCfgExt:  // Attempting to push the non-standard descriptors (optional).
+    case eCldCfgXmitNonStdDescCompFrags: // pushing non-std descriptor fragments (optional).
     case eCldCfgNullReports: // sending set report command frames for any NULL reports (optional).
     case eCldCfgComplete:  // Attempting to signal end of config phase.
     case eCldCfgRdy:  // Attempting to end the configuration state with GDP_CMD_CFG_COMPLETE.
@@ -948,6 +1120,38 @@ static void sendCldDataReq(uint8 dstIndex, uint8 len, uint8 *pData)
   RTI_SendDataReq(dstIndex, RTI_PROFILE_ZID, vendorId, txOptions, len, pData);
 }
 
+#if ZID_CLD_BATCH_TIME
+/**************************************************************************************************
+ * @fn          sendBatch
+ *
+ * @brief       Send the Report Data command frame built from the records held so far.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void sendBatch(void)
+{
+  uint8 len = cldBatchLen;
+
+  if (len != 0)
+  {
+    uint16 vendorId = RTI_VENDOR_TEXAS_INSTRUMENTS;
+
+    (void)RTI_ReadItemEx(RTI_PROFILE_RTI, RTI_CP_ITEM_VENDOR_ID, sizeof(uint16), (uint8 *)&vendorId);
+    // Clear first, as the confirm may come back before RTI_SendDataReq() returns.
+    cldBatchLen = 0;
+    RTI_SendDataReq(cldBatchIdx, RTI_PROFILE_ZID, vendorId, cldBatchTxOptions, len, cldBatchBuf);
+  }
+}
+#endif
+
 /**************************************************************************************************
  * @fn          pullProxy
  *
@@ -965,12 +1169,100 @@ static void sendCldDataReq(uint8 dstIndex, uint8 len, uint8 *pData)
  */
 static void pullProxy(void)
 {
+#if (ZID_CFG_WINDOW > 1)
+  // Offer a config push window; an Adapter without one answers the attribute as unsupported.
+  uint8 buf[8] = { GDP_CMD_GET_ATTR,
+                   aplZIDProfileVersion, aplHIDParserVersion, aplHIDCountryCode,
+                   aplHIDDeviceReleaseNumber, aplHIDVendorId, aplHIDProductId,
+                   ZID_ATTR_CFG_WINDOW };
+  sendCldDataReq(zidCfgIdx, 8, buf);
+#else
   uint8 buf[7] = { GDP_CMD_GET_ATTR,
                    aplZIDProfileVersion, aplHIDParserVersion, aplHIDCountryCode,
                    aplHIDDeviceReleaseNumber, aplHIDVendorId, aplHIDProductId };
   sendCldDataReq(zidCfgIdx, 7, buf);
+#endif
 }
 
+#if (ZID_CFG_WINDOW > 1)
+/**************************************************************************************************
+ * @fn          rxGetAttrRsp
+ *
+ * @brief       Take the config push window offered in the Get Attributes Response to pullProxy().
+ *
+ * input parameters
+ *
+ * @param       len    - Number of data bytes.
+ * @param       *pData - Pointer to the Get Attributes Response command frame.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void rxGetAttrRsp(uint8 len, uint8 *pData)
+{
+  gdp_attr_rsp_t *pRsp;
+
+  len--;
+  pData++;
+
+  while (len >= 2)
+  {
+    pRsp = (gdp_attr_rsp_t *)pData;
+
+    if (pRsp->status != GDP_ATTR_RSP_SUCCESS)  // A failed record has no length or value.
+    {
+      len -= 2;
+      pData += 2;
+    }
+    else if (len < GDP_ATTR_RSP_SIZE_HDR + pRsp->len)
+    {
+      break;
+    }
+    else
+    {
+      if ((pRsp->id == ZID_ATTR_CFG_WINDOW) && (pRsp->len == 1) && (pRsp->data[0] > 1))
+      {
+        cldCfgWindow = MIN(pRsp->data[0], ZID_CFG_WINDOW);
+      }
+      len -= GDP_ATTR_RSP_SIZE_HDR + pRsp->len;
+      pData += GDP_ATTR_RSP_SIZE_HDR + pRsp->len;
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          cfgWindowCmd
+ *
+ * @brief       Mark a config push with the GDP data pending bit unless it ends a window.
+ *
+ * input parameters
+ *
+ * @param       cmd - The command code of the config push.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The command frame control byte to send.
+ */
+static uint8 cfgWindowCmd(uint8 cmd)
+{
+  if (++cldCfgWindowCnt < cldCfgWindow)
+  {
+    cmd |= GDP_HEADER_DATA_PENDING;
+  }
+  else
+  {
+    cldCfgWindowCnt = 0;
+  }
+
+  return cmd;
+}
+#endif
+
 /**************************************************************************************************
  * @fn          pushConfig
  *
@@ -1094,6 +1386,9 @@ static void pushConfig(void)
       {
         uint8 cfgComplete[2] = { GDP_CMD_CFG_COMPLETE, GDP_GENERIC_RSP_SUCCESS };
         cldState = eCldCfgRdy;
+#if (ZID_CFG_WINDOW > 1)
+        cldCfgWindowCnt = 0;  // The response to the config complete acknowledges any open window.
+#endif
         sendCldDataReq(zidCfgIdx, 2, cfgComplete);
         // invoke next configuration
         osal_start_timerEx( RTI_TaskId, GDP_EVT_CONFIGURE_NEXT, aplcConfigBlackoutTime );
@@ -1191,7 +1486,11 @@ static void pushNonStdDescComp( void )
   {
     attrId = currentNonStdDescCompNum + aplHIDNonStdDescCompSpec1;
 
+#if (ZID_CFG_WINDOW > 1)
+    *pBuf = cfgWindowCmd(GDP_CMD_PUSH_ATTR);
+#else
     *pBuf = GDP_CMD_PUSH_ATTR;
+#endif
     len = procGetCldAttr(1, &attrId, pBuf);
 
     sendCldDataReq(zidCfgIdx, len, pBuf);
@@ -1237,7 +1536,11 @@ static void pushNullReport( void )
                          (uint8 *)pReportHdr );
 
     /* Now build set report command */
+#if (ZID_CFG_WINDOW > 1)
+    pBuf->cmd = cfgWindowCmd(ZID_CMD_SET_REPORT);
+#else
     pBuf->cmd = ZID_CMD_SET_REPORT;
+#endif
     pBuf->type = ZID_REPORT_TYPE_IN;
     pBuf->id = pReportHdr->reportId;
     osal_memcpy(pBuf->data, pReportHdr->data, len);
@@ -1421,17 +1724,7 @@ static void unpairReq(uint8 dstIndex)
  */
 static uint8 getCldAttrTableIdx( uint8 attrId )
 {
-  uint8 idx;
-
-  for (idx = 0; idx < ZID_CLD_ATTRIBUTE_TABLE_LEN; idx++)
-  {
-    if (zidCld_attributeTable[idx].attrId == attrId)
-    {
-      return idx;
-    }
-  }
-
-  return ZID_TABLE_IDX_INVALID;
+  return zidCommon_GetAttrTableIdx( zidCld_attributeTable, attrId );
 }
 
 /**************************************************************************************************
@@ -7,6 +7,9 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+/* Heap trace caller id, ahead of the OSAL headers */
+#define OSALMEM_TRACE_FILE_ID  OSALMEM_TRACE_FILE_NP_MAIN
+
 // HAL includes
 #include "hal_types.h"
 #include "hal_board.h"
@@ -115,6 +118,11 @@ void osalInitTasks( void )
   RCN_Init( taskID++ );
   RTI_Init( taskID++ );
   NPI_Init( taskID++ );
+#if defined OSAL_DRAIN_BUDGET && OSAL_DRAIN_BUDGET
+  // Let the MAC and NPI tasks work through bursts before the lower priority tasks run
+  (void)osal_drain_enable( 0 );
+  (void)osal_drain_enable( taskID - 1 );
+#endif
 #if defined FEATURE_ZID_ADA && FEATURE_ZID_ADA == TRUE
   zidAda_Init( taskID++ );
 #endif
@@ -0,0 +1,59 @@
+/**************************************************************************************************
+  Filename:       npi.c
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+#include "comdef.h"
+
+/* Hal Driver includes */
+#include "hal_board.h"
+#include "hal_types.h"
+#include "hal_drivers.h"
+#include "hal_uart.h"
+
+/* OS includes */
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OSAL_PwrMgr.h"
+
+/* NPI */
+#include "npi.h"
+
+/**************************************************************************************************
+ *                                        Type definitions
+ **************************************************************************************************/
+
+typedef struct
+{
+  osal_event_hdr_t  hdr;
+  uint8             *msg;
+} npiSysEvtMsg_t;
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+uint8 NPI_TaskId;
+osal_msg_q_t npiTxQueue;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ *                                     Functions
+ **************************************************************************************************/
+
+#if ((defined HAL_UART) && (HAL_UART == TRUE))
+#include "./npi_uart.c"
+#elif ((defined HAL_SPI) && (HAL_SPI == TRUE))
+#include "./npi_spi.c"
+#elif ((defined HAL_I2C) && (HAL_I2C == TRUE))
+#include "./npi_i2c.c"
+#endif
+
+/**************************************************************************************************
+ **************************************************************************************************/
@@ -0,0 +1,480 @@
+/**************************************************************************************************
+  Filename:       npi_bench.c
+
+  Description:    Throughput of the NPI UART frame parser, npiProcessData(), on the traffic that
+                  a host sent to the RNP, as rnp_sim -r records it. The trace is let into the UART
+                  a few bytes per poll, as the DMA would have received them between two runs of
+                  the NPI task, and the parser is run until it has taken them all. The frames that
+                  it hands to the NPI task are dispatched, untimed, and each must be the next good
+                  frame of the trace, as a reference parser finds it. The SREQs to the NPI itself,
+                  on RPC_SYS_SYS, are not checked, and the trace is replayed at one baud rate.
+
+                  npi.c is included here, so that its parser can be called and timed on its own,
+                  with a UART that serves the trace from memory. It is built against the current
+                  npi_uart.c and, to compare, against the npi_uart.c that read one byte per
+                  HalUARTRead() and checked the FCS in a second pass.
+
+  Usage:          npi_bench|npi_bench_base [-c] [-n passes] trace
+                    -c  check mode: fewer passes
+                    -n  the passes over the trace at each poll size, of which the median is
+                        reported (default 101)
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined __x86_64__ || defined __i386__
+#include <x86intrin.h>
+#endif
+
+/* HAL includes */
+#include "hal_host.h"
+#include "hal_mcu.h"
+#include "hal_rpc.h"
+
+/* The NPI, with its UART transport */
+#include "npi.c"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+// The most frames of a trace.
+#define NPI_BENCH_FRAME_MAX            65536
+
+// The NPI events not to run when dispatching: the parser, which is timed on its own, and a baud
+// rate change, which would re-open the UART and drop the frame being parsed.
+#if defined NPI_UART_BAUD_EVT
+#define NPI_BENCH_EVT_SKIP             (NPI_UART_RX_READY_EVT | NPI_UART_BAUD_EVT)
+#else
+#define NPI_BENCH_EVT_SKIP             NPI_UART_RX_READY_EVT
+#endif
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+const pTaskEventHandlerFn tasksArr[] = {
+  NPI_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static uint8 *npiBenchTrace;
+static unsigned npiBenchLen;
+
+// The offsets in the trace of the good frames, and the next one to be dispatched.
+static unsigned *npiBenchFrame;
+static unsigned npiBenchFrameCnt, npiBenchNext;
+
+// The bytes of the trace received so far, and those of them read.
+static unsigned npiBenchRxEnd, npiBenchRxPos;
+
+static unsigned long long npiBenchReads;
+static unsigned npiBenchBad;
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static unsigned long long npiBenchNow(void);
+static unsigned long long npiBenchTsc(void);
+static void npiBenchCheck(npiMsgData_t *pMsg);
+static void npiBenchRef(void);
+static int npiBenchCmp(const void *pA, const void *pB);
+
+/**************************************************************************************************
+ * @fn          halAssertHandler
+ *
+ * @brief       An assert resets the target, so it fails the benchmark at once.
+ *
+ * @return      Does not return.
+ */
+void halAssertHandler(void)
+{
+  (void)printf("FAIL: HAL assert\n");
+  exit(1);
+}
+
+/**************************************************************************************************
+ * @fn          osalInitTasks, Hal_ProcessPoll
+ *
+ * @brief       The one task is the NPI, and the UART is served from the trace without a poll.
+ *
+ * @return      None.
+ */
+void osalInitTasks( void )
+{
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  NPI_Init( 0 );
+}
+
+void Hal_ProcessPoll(void)
+{
+}
+
+/**************************************************************************************************
+ * @fn          HalUARTOpen, HalUARTRead, HalUARTWrite, HalUARTBusy, HalUARTSuspend
+ *
+ * @brief       The UART of the NPI: it reads the bytes of the trace received so far and takes all
+ *              that is written, as a host that reads as fast as the RNP sends would.
+ *
+ * @return      As the HAL UART.
+ */
+uint8 HalUARTOpen(uint8 port, halUARTCfg_t *config)
+{
+  (void)port;
+  (void)config;
+  return HAL_UART_SUCCESS;
+}
+
+uint16 HalUARTRead(uint8 port, uint8 *buf, uint16 len)
+{
+  (void)port;
+
+  npiBenchReads++;
+  if (len > npiBenchRxEnd - npiBenchRxPos)
+  {
+    len = npiBenchRxEnd - npiBenchRxPos;
+  }
+
+  (void)memcpy(buf, &npiBenchTrace[npiBenchRxPos], len);
+  npiBenchRxPos += len;
+
+  return len;
+}
+
+uint16 HalUARTWrite(uint8 port, uint8 *buf, uint16 len)
+{
+  (void)port;
+  (void)buf;
+  return len;
+}
+
+uint8 HalUARTBusy(void)
+{
+  return FALSE;
+}
+
+void HalUARTSuspend(void)
+{
+}
+
+/**************************************************************************************************
+ * @fn          NPI_AsynchMsgCback, NPI_SynchMsgCback
+ *
+ * @brief       Check each frame dispatched, and reply to an SREQ with a status byte.
+ *
+ * @param       pMsg - The frame, with the command type taken off CMD0.
+ *
+ * @return      None.
+ */
+void NPI_AsynchMsgCback( npiMsgData_t *pMsg )
+{
+  npiBenchCheck(pMsg);
+}
+
+void NPI_SynchMsgCback( npiMsgData_t *pMsg )
+{
+  // The NPI that predates its own SREQs passes them on.
+  if (pMsg->subSys != RPC_SYS_SYS)
+  {
+    npiBenchCheck(pMsg);
+  }
+  pMsg->len = 1;
+  pMsg->pData[0] = SUCCESS;
+}
+
+/**************************************************************************************************
+ * @fn          npiBenchCheck
+ *
+ * @brief       Check that a frame dispatched is the next good frame of the trace.
+ *
+ * @param       pMsg - The frame, with the command type taken off CMD0.
+ *
+ * @return      None.
+ */
+static void npiBenchCheck(npiMsgData_t *pMsg)
+{
+  uint8 *pRef;
+
+  if (npiBenchNext == npiBenchFrameCnt)
+  {
+    npiBenchBad++;
+    return;
+  }
+
+  pRef = &npiBenchTrace[npiBenchFrame[npiBenchNext++] + 1];
+  if ((pMsg->len != pRef[RPC_POS_LEN]) ||
+      (pMsg->subSys != (pRef[RPC_POS_CMD0] & RPC_SUBSYSTEM_MASK)) ||
+      (pMsg->cmdId != pRef[RPC_POS_CMD1]) ||
+      (memcmp(pMsg->pData, &pRef[RPC_FRAME_HDR_SZ], pMsg->len) != 0))
+  {
+    npiBenchBad++;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          npiBenchRef
+ *
+ * @brief       Find the good frames of the trace, a byte at a time as the NPI state machine did,
+ *              less the SREQs to the NPI itself.
+ *
+ * @return      None.
+ */
+static void npiBenchRef(void)
+{
+  unsigned pos = 0;
+
+  while (pos < npiBenchLen)
+  {
+    unsigned sof = pos, idx;
+    uint8 fcs = 0;
+
+    if (npiBenchTrace[pos++] != RPC_UART_SOF)
+    {
+      continue;
+    }
+
+    // A repeated SOF means the prior SOF was perhaps a garbled wakeup character.
+    while ((pos < npiBenchLen) && (npiBenchTrace[pos] == RPC_UART_SOF))
+    {
+      sof = pos++;
+    }
+
+    if (pos + RPC_FRAME_HDR_SZ + 1 > npiBenchLen)
+    {
+      break;
+    }
+
+    if (pos + RPC_FRAME_HDR_SZ + npiBenchTrace[pos] + 1 > npiBenchLen)
+    {
+      break;
+    }
+
+    for (idx = 0; idx < RPC_FRAME_HDR_SZ + npiBenchTrace[sof + 1] + 1; idx++)
+    {
+      fcs ^= npiBenchTrace[pos++];
+    }
+
+    if ((fcs == 0) && (npiBenchFrameCnt < NPI_BENCH_FRAME_MAX) &&
+        (npiBenchTrace[sof + 1 + RPC_POS_CMD0] != (RPC_CMD_SREQ | RPC_SYS_SYS)))
+    {
+      npiBenchFrame[npiBenchFrameCnt++] = sof;
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          npiBenchCmp
+ *
+ * @brief       Order the times of two passes, for their median.
+ *
+ * @return      The order of the two times.
+ */
+static int npiBenchCmp(const void *pA, const void *pB)
+{
+  unsigned long long a = *(const unsigned long long *)pA, b = *(const unsigned long long *)pB;
+
+  return (a > b) - (a < b);
+}
+
+/**************************************************************************************************
+ * @fn          npiBenchNow, npiBenchTsc
+ *
+ * @brief       Read the host monotonic clock, or the time stamp counter of an x86 host.
+ *
+ * @return      Nsecs; cycles of the time stamp counter, or 0 on another host.
+ */
+static unsigned long long npiBenchNow(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned long long npiBenchTsc(void)
+{
+#if defined __x86_64__ || defined __i386__
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       At each poll size, let the trace in that many bytes at a time, timing the parser
+ *              on each poll less the cost of reading the clock, and dispatch the frames that it
+ *              finds. The median pass is reported, and the first poll size is run once
+ *              unreported first.
+ *
+ * @return      0 on success; 1 on a broken check.
+ */
+int main(int argc, char **argv)
+{
+  static const unsigned polls[] = { 12, 1, 12, 48, 128 };
+  unsigned long long start, tsc, ns, clk = ~0ULL, *pPass;
+  unsigned passes = 101, pass, poll, idx;
+  double ghz;
+  FILE *pFile;
+  int opt, check = 0;
+
+  while ((opt = getopt(argc, argv, "cn:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'c':
+      check = 1;
+      passes = 3;
+      break;
+
+    case 'n':
+      passes = (unsigned)atoi(optarg);
+      break;
+
+    default:
+      passes = 0;
+      break;
+    }
+  }
+
+  if ((passes == 0) || (optind != argc - 1))
+  {
+    (void)fprintf(stderr, "usage: %s [-c] [-n passes] trace\n", argv[0]);
+    return 1;
+  }
+
+  if (((pFile = fopen(argv[optind], "rb")) == NULL) ||
+      ((npiBenchTrace = malloc(1 << 24)) == NULL) ||
+      ((npiBenchFrame = malloc(NPI_BENCH_FRAME_MAX * sizeof(*npiBenchFrame))) == NULL) ||
+      ((pPass = malloc(passes * sizeof(*pPass))) == NULL))
+  {
+    perror(argv[optind]);
+    return 1;
+  }
+  npiBenchLen = (unsigned)fread(npiBenchTrace, 1, 1 << 24, pFile);
+  (void)fclose(pFile);
+
+  npiBenchRef();
+  if (npiBenchFrameCnt == 0)
+  {
+    (void)printf("FAIL: no frames in %s\n", argv[optind]);
+    return 1;
+  }
+
+  for (idx = 0; idx < 1000; idx++)
+  {
+    start = npiBenchNow();
+    if (clk > (ns = npiBenchNow() - start))
+    {
+      clk = ns;
+    }
+  }
+
+  // The rate of the time stamp counter, to turn nsecs into its cycles.
+  start = npiBenchNow();
+  tsc = npiBenchTsc();
+  (void)usleep(50000);
+  ghz = (double)(npiBenchTsc() - tsc) / (npiBenchNow() - start);
+
+  HAL_ENABLE_INTERRUPTS();
+  osal_init_system();
+
+  (void)printf("%s: %u bytes, %u frames, median of %u passes at each poll size, on the host\n",
+               argv[0], npiBenchLen, npiBenchFrameCnt, passes);
+  (void)printf("  bytes/poll     frames/s    ns/byte  cycles/byte  reads/frame\n");
+
+  // The first poll size warms the caches and the heap up, and is not reported.
+  for (poll = 0; poll < sizeof(polls) / sizeof(polls[0]); poll++)
+  {
+    unsigned long long total;
+
+    npiBenchReads = 0;
+
+    for (pass = 0; pass < passes; pass++)
+    {
+      npiBenchRxEnd = npiBenchRxPos = npiBenchNext = 0;
+      pPass[pass] = 0;
+
+      while (npiBenchRxPos < npiBenchLen)
+      {
+        npiBenchRxEnd = MIN(npiBenchRxEnd + polls[poll], npiBenchLen);
+
+        // Each frame found ends a run of the parser, as it does a run of the NPI task.
+        start = npiBenchNow();
+        while (npiBenchRxPos < npiBenchRxEnd)
+        {
+          unsigned pos = npiBenchRxPos;
+
+          npiProcessData(FALSE);
+
+          if (npiBenchRxPos == pos)
+          {
+            break;
+          }
+        }
+        ns = npiBenchNow() - start;
+        pPass[pass] += (ns > clk) ? ns - clk : 0;
+
+        // Dispatch the frames found, and send the replies to the SREQs.
+        tasksEvents[0] &= ~NPI_BENCH_EVT_SKIP;
+        while (tasksEvents[0] != 0)
+        {
+          osal_start_system();
+          tasksEvents[0] &= ~NPI_BENCH_EVT_SKIP;
+        }
+      }
+
+      if (npiBenchNext != npiBenchFrameCnt)
+      {
+        npiBenchBad++;
+      }
+    }
+
+    qsort(pPass, passes, sizeof(*pPass), npiBenchCmp);
+    total = pPass[passes / 2];
+
+    if (poll != 0)
+    {
+      (void)printf("  %10u %12.0f %10.2f %12.2f %12.2f\n", polls[poll],
+                   (double)npiBenchFrameCnt * 1e9 / total, (double)total / npiBenchLen,
+                   ghz * total / npiBenchLen, (double)npiBenchReads / npiBenchFrameCnt / passes);
+    }
+  }
+
+  free(npiBenchTrace);
+  free(npiBenchFrame);
+  free(pPass);
+
+  if (npiBenchBad != 0)
+  {
+    (void)printf("FAIL: %u frames wrong or missing\n", npiBenchBad);
+  }
+  else if (check)
+  {
+    (void)printf("PASS\n");
+  }
+
+  return (npiBenchBad == 0) ? 0 : 1;
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
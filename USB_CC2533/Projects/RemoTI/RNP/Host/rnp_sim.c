@@ -0,0 +1,525 @@
+/**************************************************************************************************
+  Filename:       rnp_sim.c
+
+  Description:    Simulated RemoTI network processor (RNP) for a POSIX host. The OSAL, the NPI
+                  UART transport and the RTI surrogate (rtis_np.c) are the target code, built for
+                  the HOST target, whose UART is a PTY; only the RTI and the radio below it are
+                  simulated here:
+                  - configuration items are kept in RAM, and any item may be written and read;
+                  - RTI_SendDataReq() is confirmed with success after the air time given by -a;
+                  - with -e, the data is then received back from the destination, with the
+                    first 8 bytes replaced by the CLOCK_MONOTONIC nsecs at which the indication
+                    is made, for the host to measure the indication latency.
+
+                  The path of the PTY slave, to be given to RTI_InitRNP(), is written to stdout.
+
+  Usage:          rnp_sim [-a msecs] [-e] [-r trace] [-u]
+                    -a  air time of each RTI_SendDataReq() (default 0)
+                    -e  echo each sent data back as an RTI_ReceiveDataInd()
+                    -r  record every byte received from the host to a file
+                    -u  do not pace the UART at its baud rate
+**************************************************************************************************/
+
+// posix_openpt() and cfmakeraw() are not C99.
+#define _GNU_SOURCE
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* HAL includes */
+#include "hal_board.h"
+#include "hal_drivers.h"
+#include "hal_host.h"
+#include "hal_uart.h"
+
+/* OSAL includes */
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+
+/* RTI includes */
+#include "rti.h"
+#include "rtis.h"
+#include "rcns.h"
+
+/* NPI includes */
+#include "npi.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+#define RNP_SIM_CNF_EVT                0x0001
+
+// The configuration items kept, and the longest of them.
+#define RNP_SIM_ITEM_CNT               64
+#define RNP_SIM_ITEM_MAX               (NP_MAX_BUF_LEN - 3)
+
+/**************************************************************************************************
+ *                                           Typedefs
+ **************************************************************************************************/
+
+typedef struct
+{
+  uint8 profileId;
+  uint8 itemId;
+  uint8 len;
+  uint8 value[RNP_SIM_ITEM_MAX];
+} rnpSimItem_t;
+
+/**************************************************************************************************
+ *                                        Global Variables
+ **************************************************************************************************/
+
+const pTaskEventHandlerFn tasksArr[] = {
+  NPI_ProcessEvent,
+  RTI_ProcessEvent,
+  Hal_ProcessEvent
+};
+
+const uint8 tasksCnt = sizeof( tasksArr ) / sizeof( tasksArr[0] );
+uint16 *tasksEvents;
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static uint8 rnpSimTaskId;
+static uint16 rnpSimAirTime;
+static uint8 rnpSimEcho;
+
+static rnpSimItem_t rnpSimItems[RNP_SIM_ITEM_CNT];
+static uint8 rnpSimItemCnt;
+
+// The data request in the air.
+static uint8 rnpSimTxBusy;
+static uint8 rnpSimTxDst;
+static uint8 rnpSimTxProfile;
+static uint16 rnpSimTxVendor;
+static uint8 rnpSimTxLen;
+static uint8 rnpSimTxData[NP_MAX_BUF_LEN];
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static rnpSimItem_t *rnpSimFindItem(uint8 profileId, uint8 itemId);
+static int rnpSimOpenPty(void);
+static uint8 rnpSimIdle(void);
+
+/**************************************************************************************************
+ * @fn          osalInitTasks
+ *
+ * @brief       This function initializes the tasks of the simulated RNP, as np_main.c does.
+ *
+ * @param       None.
+ *
+ * @return      None.
+ */
+void osalInitTasks( void )
+{
+  uint8 taskID = 0;
+
+  tasksEvents = (uint16 *)osal_mem_alloc( sizeof( uint16 ) * tasksCnt);
+  osal_memset( tasksEvents, 0, (sizeof( uint16 ) * tasksCnt));
+
+  NPI_Init( taskID++ );
+  RTI_Init( taskID++ );
+  Hal_Init( taskID );
+}
+
+/**************************************************************************************************
+ * @fn          RTI_Init, RTI_ProcessEvent
+ *
+ * @brief       The simulated RTI task, which confirms each data request after its air time.
+ *
+ * @return      None; the events not processed.
+ */
+void RTI_Init( uint8 task_id )
+{
+  rnpSimTaskId = task_id;
+}
+
+uint16 RTI_ProcessEvent( uint8 task_id, uint16 events )
+{
+  (void)task_id;
+
+  if (events & RNP_SIM_CNF_EVT)
+  {
+    rnpSimTxBusy = FALSE;
+    RTI_SendDataCnf(RTI_SUCCESS);
+
+    if (rnpSimEcho)
+    {
+      if (rnpSimTxLen >= 8)
+      {
+        struct timespec ts;
+        unsigned long long ns;
+        uint8 idx;
+
+        (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+        ns = (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+        for (idx = 0; idx < 8; idx++)
+        {
+          rnpSimTxData[idx] = (uint8)(ns >> (8 * idx));
+        }
+      }
+
+      RTI_ReceiveDataInd(rnpSimTxDst, rnpSimTxProfile, rnpSimTxVendor, 0xFF, 0,
+                         rnpSimTxLen, rnpSimTxData);
+    }
+
+    return (events ^ RNP_SIM_CNF_EVT);
+  }
+
+  return 0;
+}
+
+/**************************************************************************************************
+ * @fn          RTI_ReadItemEx, RTI_WriteItemEx
+ *
+ * @brief       Read or write a configuration item in RAM. An item never written reads as zeros.
+ *
+ * @return      RTI_SUCCESS, or RTI_ERROR_INVALID_PARAMETER if the item does not fit.
+ */
+rStatus_t RTI_ReadItemEx(uint8 profileId, uint8 itemId, uint8 len, uint8 *pValue)
+{
+  rnpSimItem_t *pItem = rnpSimFindItem(profileId, itemId);
+
+  if (len > RNP_SIM_ITEM_MAX)
+  {
+    return RTI_ERROR_INVALID_PARAMETER;
+  }
+
+  if (pItem == NULL)
+  {
+    osal_memset(pValue, 0, len);
+  }
+  else
+  {
+    osal_memcpy(pValue, pItem->value, len);
+  }
+
+  return RTI_SUCCESS;
+}
+
+rStatus_t RTI_WriteItemEx(uint8 profileId, uint8 itemId, uint8 len, uint8 *pValue)
+{
+  rnpSimItem_t *pItem = rnpSimFindItem(profileId, itemId);
+
+  if (len > RNP_SIM_ITEM_MAX)
+  {
+    return RTI_ERROR_INVALID_PARAMETER;
+  }
+
+  if (pItem == NULL)
+  {
+    if (rnpSimItemCnt == RNP_SIM_ITEM_CNT)
+    {
+      return RTI_ERROR_INVALID_PARAMETER;
+    }
+
+    pItem = &rnpSimItems[rnpSimItemCnt++];
+    pItem->profileId = profileId;
+    pItem->itemId = itemId;
+    osal_memset(pItem->value, 0, RNP_SIM_ITEM_MAX);
+  }
+
+  pItem->len = len;
+  osal_memcpy(pItem->value, pValue, len);
+
+  return RTI_SUCCESS;
+}
+
+/**************************************************************************************************
+ * @fn          RTI_SendDataReq
+ *
+ * @brief       Put the data in the air, to be confirmed after the air time. As the RTI does
+ *              without a Tx queue, a request made while another is in the air fails at once.
+ *
+ * @return      None.
+ */
+void RTI_SendDataReq( uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions, uint8 len, uint8 *pData )
+{
+  (void)txOptions;
+
+  if (rnpSimTxBusy)
+  {
+    RTI_SendDataCnf(RTI_ERROR_MAC_TRANSACTION_OVERFLOW);
+    return;
+  }
+
+  rnpSimTxBusy = TRUE;
+  rnpSimTxDst = dstIndex;
+  rnpSimTxProfile = profileId;
+  rnpSimTxVendor = vendorId;
+  rnpSimTxLen = len;
+  osal_memcpy(rnpSimTxData, pData, len);
+
+  if (rnpSimAirTime == 0)
+  {
+    (void)osal_set_event(rnpSimTaskId, RNP_SIM_CNF_EVT);
+  }
+  else
+  {
+    (void)osal_start_timerEx(rnpSimTaskId, RNP_SIM_CNF_EVT, rnpSimAirTime);
+  }
+}
+
+/**************************************************************************************************
+ * @fn          RTI_InitReq, RTI_PairReq, RTI_PairAbortReq, RTI_AllowPairReq,
+ *              RTI_AllowPairAbortReq, RTI_UnpairReq, RTI_StandbyReq, RTI_RxEnableReq,
+ *              RTI_EnableSleepReq, RTI_DisableSleepReq, RTI_SetBridgeMode
+ *
+ * @brief       The other RTI requests succeed at once; the simulated RNP is paired with one
+ *              device, at index 0.
+ *
+ * @return      None.
+ */
+void RTI_InitReq( void )
+{
+  RTI_InitCnf(RTI_SUCCESS);
+}
+
+void RTI_PairReq( void )
+{
+  RTI_PairCnf(RTI_SUCCESS, 0, 0);
+}
+
+void RTI_PairAbortReq( void )
+{
+  RTI_PairAbortCnf(RTI_SUCCESS);
+}
+
+void RTI_AllowPairReq( void )
+{
+  RTI_AllowPairCnf(RTI_SUCCESS, 0, 0);
+}
+
+void RTI_AllowPairAbortReq( void )
+{
+}
+
+void RTI_UnpairReq( uint8 dstIndex )
+{
+  RTI_UnpairCnf(RTI_SUCCESS, dstIndex);
+}
+
+void RTI_StandbyReq( uint8 mode )
+{
+  (void)mode;
+  RTI_StandbyCnf(RTI_SUCCESS);
+}
+
+void RTI_RxEnableReq( uint16 duration )
+{
+  (void)duration;
+  RTI_RxEnableCnf(RTI_SUCCESS);
+}
+
+void RTI_EnableSleepReq( void )
+{
+  RTI_EnableSleepCnf(RTI_SUCCESS);
+}
+
+void RTI_DisableSleepReq( void )
+{
+  RTI_DisableSleepCnf(RTI_SUCCESS);
+}
+
+void RTI_SetBridgeMode(rtiRcnCbackFn_t pCback)
+{
+  (void)pCback;
+}
+
+/**************************************************************************************************
+ * @fn          RCNS_HandleSyncMsg, RCNS_HandleAsyncMsg, RCNS_SerializeCback
+ *
+ * @brief       The simulated RNP has no network layer to bridge to.
+ *
+ * @return      FALSE, to stay out of the bridge mode; otherwise none.
+ */
+uint8 RCNS_HandleSyncMsg( uint8 *pData )
+{
+  ((npiMsgData_t *)pData)->len = 0;
+  return FALSE;
+}
+
+void RCNS_HandleAsyncMsg( uint8 *pData )
+{
+  (void)pData;
+}
+
+void RCNS_SerializeCback(rcnCbackEvent_t *pData)
+{
+  (void)pData;
+}
+
+/**************************************************************************************************
+ * @fn          rnpSimFindItem
+ *
+ * @brief       Find a configuration item in RAM.
+ *
+ * @param       profileId - The profile of the item.
+ * @param       itemId    - The item identifier.
+ *
+ * @return      The item, or NULL if it was never written.
+ */
+static rnpSimItem_t *rnpSimFindItem(uint8 profileId, uint8 itemId)
+{
+  uint8 idx;
+
+  for (idx = 0; idx < rnpSimItemCnt; idx++)
+  {
+    if ((rnpSimItems[idx].profileId == profileId) && (rnpSimItems[idx].itemId == itemId))
+    {
+      return &rnpSimItems[idx];
+    }
+  }
+
+  return NULL;
+}
+
+/**************************************************************************************************
+ * @fn          rnpSimOpenPty
+ *
+ * @brief       Open a PTY, make its slave side a raw line and write its path to stdout. The slave
+ *              is kept open, so that the master stays usable while no host has it open.
+ *
+ * @param       None.
+ *
+ * @return      The file descriptor of the master; -1 on failure.
+ */
+static int rnpSimOpenPty(void)
+{
+  struct termios tio;
+  int fd, slave;
+
+  if (((fd = posix_openpt(O_RDWR | O_NOCTTY)) < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0))
+  {
+    return -1;
+  }
+
+  if ((slave = open(ptsname(fd), O_RDWR | O_NOCTTY)) < 0)
+  {
+    return -1;
+  }
+
+  (void)tcgetattr(slave, &tio);
+  cfmakeraw(&tio);
+  (void)tcsetattr(slave, TCSANOW, &tio);
+
+  (void)printf("%s\n", ptsname(fd));
+  (void)fflush(stdout);
+
+  return fd;
+}
+
+/**************************************************************************************************
+ * @fn          rnpSimIdle
+ *
+ * @brief       Check whether the simulated RNP has nothing to do until the PTY has more for it
+ *              or a timer expires.
+ *
+ * @param       None.
+ *
+ * @return      TRUE if no task has an event and the UART has nothing to send; FALSE otherwise.
+ */
+static uint8 rnpSimIdle(void)
+{
+  uint8 idx;
+
+  for (idx = 0; idx < tasksCnt; idx++)
+  {
+    if (tasksEvents[idx] != 0)
+    {
+      return FALSE;
+    }
+  }
+
+  return (Hal_UART_TxBufLen(HAL_UART_PORT_0) == 0);
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       Start the simulated RNP as np_main.c starts the RNP, and run the OSAL one pass at a
+ *              time, sleeping on the PTY while idle.
+ *
+ * @return      Does not return, unless the PTY cannot be opened.
+ */
+int main(int argc, char **argv)
+{
+  struct pollfd fds;
+  int opt, rec;
+
+  while ((opt = getopt(argc, argv, "a:er:u")) != -1)
+  {
+    switch (opt)
+    {
+    case 'a':
+      rnpSimAirTime = (uint16)atoi(optarg);
+      break;
+
+    case 'e':
+      rnpSimEcho = TRUE;
+      break;
+
+    case 'r':
+      if ((rec = open(optarg, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+      {
+        perror(optarg);
+        return 1;
+      }
+      HalUARTHostRecord(rec);
+      break;
+
+    case 'u':
+      halHostUartPaced = FALSE;
+      break;
+
+    default:
+      (void)fprintf(stderr, "usage: %s [-a msecs] [-e] [-r trace] [-u]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if ((fds.fd = rnpSimOpenPty()) < 0)
+  {
+    perror("rnp_sim: PTY");
+    return 1;
+  }
+  fds.events = POLLIN;
+  HalUARTHostAttach(fds.fd);
+
+  osal_int_disable( INTS_ALL );
+  HAL_BOARD_INIT();
+  HalDriverInit();
+  RTIS_Init();
+  osal_init_system();
+  osal_int_enable( INTS_ALL );
+  RTI_ResetInd();
+
+  while (TRUE)
+  {
+    osal_start_system();
+
+    if (rnpSimIdle())
+    {
+      (void)poll(&fds, 1, 1);
+    }
+  }
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
@@ -0,0 +1,642 @@
+/**************************************************************************************************
+  Filename:       rtis_bench.c
+
+  Description:    Benchmark of the POSIX RTI surrogate (rtis_lnx.c) against the simulated RNP
+                  (rnp_sim), which it starts on a PTY. It measures:
+                  - the round trip of RTI_ReadItemEx(), and the per-item cost of a pipelined
+                    RTIS_ReadItemsEx() batch;
+                  - the sustained rate of RTI_SendDataReq() each waiting for its RTI_SendDataCnf();
+                  - the latency of RTI_ReceiveDataInd(), from the RNP making it to its callback;
+                  - both rates again at each UART baud rate from 115200 up, which RTIS_SetBaudRate()
+                    negotiates with the RNP, as rnp_sim paces its UART at the rate it is set to.
+                  It also checks that an SREQ made from an RTI callback fails at once with
+                  RTI_ERROR_NOT_PERMITTED, rather than waiting on the reader thread for an SRSP
+                  that only the reader thread itself could take.
+
+  Usage:          rtis_bench [-c] [-n count] [-l len] [-r trace] [-s path]
+                    -c  check mode: fewer rounds, and fail on a broken check
+                    -n  the round trips and data requests to time (default 2000)
+                    -l  the data length of each RTI_SendDataReq(), 8 to 100 (default 16)
+                    -r  have rnp_sim record the bytes that it receives to a file, for npi_bench
+                    -s  the path of rnp_sim (default ./rnp_sim)
+**************************************************************************************************/
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* RTI includes */
+#include "rti.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+// An SREQ from a callback must fail well inside this many nsecs; a wait for the SRSP would take
+// the whole RTIS_SREQ_TIMEOUT.
+#define BENCH_FAIL_FAST_NS             100000000ULL
+
+// Nsecs to wait for each confirmation before giving up.
+#define BENCH_CNF_TIMEOUT_NS           1000000000ULL
+
+// The items of the pipelined batch.
+#define BENCH_BATCH_CNT                32
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+// The rates to run at, each with its HAL_UART_BR_ value for RTIS_SetBaudRate().
+static const struct
+{
+  uint8    baudRate;
+  unsigned bps;
+} benchRates[] =
+{
+  { 0x04, 115200 },
+  { 0x05, 230400 },
+  { 0x06, 460800 },
+  { 0x07, 921600 }
+};
+
+static pthread_mutex_t benchLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t benchCond = PTHREAD_COND_INITIALIZER;
+
+// The confirmations counted by the callbacks, and the status of the last of each.
+static unsigned benchInitCnfCnt;
+static rStatus_t benchInitCnfStatus;
+static unsigned benchSendCnfCnt;
+static unsigned benchSendCnfFail;
+
+// The SREQ made from RTI_InitCnf(): its status and duration.
+static rStatus_t benchCbackStatus;
+static unsigned long long benchCbackNs;
+
+// The indication latencies, in nsecs.
+static unsigned long long *benchIndNs;
+static unsigned benchIndCnt, benchIndMax;
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static unsigned long long benchNow(void);
+static int benchWait(unsigned *pCnt, unsigned target);
+static int benchCmp(const void *pA, const void *pB);
+static void benchReport(const char *pName, unsigned long long *pNs, unsigned cnt);
+static unsigned benchSend(unsigned cnt, unsigned len, uint8 *pData, unsigned long long *pNs);
+static unsigned benchBatch(unsigned cnt, rtisItem_t *pItems, unsigned long long *pNs);
+static pid_t benchStartSim(const char *pSim, const char *pRec, char *pPath, size_t size);
+
+/**************************************************************************************************
+ * @fn          RTI_InitCnf
+ *
+ * @brief       Count the confirmation and, on the first, make an SREQ from the reader thread.
+ *
+ * @return      None.
+ */
+void RTI_InitCnf( rStatus_t status )
+{
+  unsigned long long start;
+  uint8 value[2];
+
+  if (benchInitCnfCnt == 0)
+  {
+    start = benchNow();
+    benchCbackStatus = RTI_ReadItemEx(RTI_PROFILE_RTI, RTI_CP_ITEM_VENDOR_ID, sizeof(value), value);
+    benchCbackNs = benchNow() - start;
+  }
+
+  (void)pthread_mutex_lock(&benchLock);
+  benchInitCnfStatus = status;
+  benchInitCnfCnt++;
+  (void)pthread_cond_signal(&benchCond);
+  (void)pthread_mutex_unlock(&benchLock);
+}
+
+/**************************************************************************************************
+ * @fn          RTI_SendDataCnf
+ *
+ * @brief       Count the confirmation, and any failure.
+ *
+ * @return      None.
+ */
+void RTI_SendDataCnf( rStatus_t status )
+{
+  (void)pthread_mutex_lock(&benchLock);
+  if (status != RTI_SUCCESS)
+  {
+    benchSendCnfFail++;
+  }
+  benchSendCnfCnt++;
+  (void)pthread_cond_signal(&benchCond);
+  (void)pthread_mutex_unlock(&benchLock);
+}
+
+/**************************************************************************************************
+ * @fn          RTI_ReceiveDataInd
+ *
+ * @brief       Record the latency of an indication, from the CLOCK_MONOTONIC nsecs that the
+ *              simulated RNP stamps its first 8 bytes with.
+ *
+ * @return      None.
+ */
+void RTI_ReceiveDataInd( uint8 srcIndex, uint8 profileId, uint16 vendorId, uint8 rxLQI, uint8 rxFlags, uint8 len, uint8 *pData )
+{
+  unsigned long long now = benchNow(), stamp = 0;
+  int idx;
+
+  (void)srcIndex; (void)profileId; (void)vendorId; (void)rxLQI; (void)rxFlags;
+
+  if ((len < 8) || (benchIndCnt == benchIndMax))
+  {
+    return;
+  }
+
+  for (idx = 7; idx >= 0; idx--)
+  {
+    stamp = (stamp << 8) | pData[idx];
+  }
+
+  benchIndNs[benchIndCnt++] = now - stamp;
+}
+
+/**************************************************************************************************
+ * @fn          RTI_*Cnf, RTI_*Ind
+ *
+ * @brief       The other callbacks are not timed.
+ *
+ * @return      None.
+ */
+void RTI_PairCnf( rStatus_t status, uint8 dstIndex, uint8 devType )
+{
+  (void)status; (void)dstIndex; (void)devType;
+}
+
+void RTI_PairAbortCnf( rStatus_t status )
+{
+  (void)status;
+}
+
+void RTI_AllowPairCnf( rStatus_t status, uint8 dstIndex, uint8 devType )
+{
+  (void)status; (void)dstIndex; (void)devType;
+}
+
+void RTI_UnpairCnf( rStatus_t status, uint8 dstIndex )
+{
+  (void)status; (void)dstIndex;
+}
+
+void RTI_UnpairInd( uint8 dstIndex )
+{
+  (void)dstIndex;
+}
+
+void RTI_StandbyCnf( rStatus_t status )
+{
+  (void)status;
+}
+
+void RTI_RxEnableCnf( rStatus_t status )
+{
+  (void)status;
+}
+
+void RTI_EnableSleepCnf( rStatus_t status )
+{
+  (void)status;
+}
+
+void RTI_DisableSleepCnf( rStatus_t status )
+{
+  (void)status;
+}
+
+void RTI_ResetInd( void )
+{
+}
+
+/**************************************************************************************************
+ * @fn          benchNow
+ *
+ * @brief       Read the monotonic clock, which the simulated RNP also stamps indications with.
+ *
+ * @return      Nsecs.
+ */
+static unsigned long long benchNow(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**************************************************************************************************
+ * @fn          benchWait
+ *
+ * @brief       Wait for a callback count to reach a target.
+ *
+ * @param       pCnt   - The count, kept under benchLock.
+ * @param       target - The count to wait for.
+ *
+ * @return      0 once reached; -1 on BENCH_CNF_TIMEOUT_NS without progress.
+ */
+static int benchWait(unsigned *pCnt, unsigned target)
+{
+  struct timespec ts;
+  unsigned long long end;
+  int rtn = 0;
+
+  (void)pthread_mutex_lock(&benchLock);
+  while (*pCnt < target)
+  {
+    (void)clock_gettime(CLOCK_REALTIME, &ts);
+    end = (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec + BENCH_CNF_TIMEOUT_NS;
+    ts.tv_sec = end / 1000000000ULL;
+    ts.tv_nsec = end % 1000000000ULL;
+
+    if (pthread_cond_timedwait(&benchCond, &benchLock, &ts) == ETIMEDOUT)
+    {
+      rtn = (*pCnt < target) ? -1 : 0;
+      break;
+    }
+  }
+  (void)pthread_mutex_unlock(&benchLock);
+
+  return rtn;
+}
+
+/**************************************************************************************************
+ * @fn          benchCmp, benchReport
+ *
+ * @brief       Sort a set of durations and print its min, average, median, 99th percentile and max
+ *              in usecs.
+ *
+ * @return      None.
+ */
+static int benchCmp(const void *pA, const void *pB)
+{
+  unsigned long long a = *(const unsigned long long *)pA, b = *(const unsigned long long *)pB;
+
+  return (a > b) - (a < b);
+}
+
+static void benchReport(const char *pName, unsigned long long *pNs, unsigned cnt)
+{
+  unsigned long long sum = 0;
+  unsigned idx;
+
+  if (cnt == 0)
+  {
+    (void)printf("%-28s none\n", pName);
+    return;
+  }
+
+  qsort(pNs, cnt, sizeof(pNs[0]), benchCmp);
+  for (idx = 0; idx < cnt; idx++)
+  {
+    sum += pNs[idx];
+  }
+
+  (void)printf("%-28s n=%-6u min %7.1f  avg %7.1f  p50 %7.1f  p99 %7.1f  max %7.1f us\n", pName, cnt,
+               pNs[0] / 1e3, sum / 1e3 / cnt, pNs[cnt / 2] / 1e3, pNs[cnt * 99 / 100] / 1e3,
+               pNs[cnt - 1] / 1e3);
+}
+
+/**************************************************************************************************
+ * @fn          benchSend
+ *
+ * @brief       Send data requests back to back, each waiting for its confirmation.
+ *
+ * @param       cnt   - The requests to send.
+ * @param       len   - The data length of each.
+ * @param       pData - The data.
+ * @param       pNs   - The nsecs that they took.
+ *
+ * @return      The requests confirmed, cnt unless one was not.
+ */
+static unsigned benchSend(unsigned cnt, unsigned len, uint8 *pData, unsigned long long *pNs)
+{
+  unsigned long long start = benchNow();
+  unsigned base, idx;
+
+  (void)pthread_mutex_lock(&benchLock);
+  base = benchSendCnfCnt;
+  (void)pthread_mutex_unlock(&benchLock);
+
+  for (idx = 0; idx < cnt; idx++)
+  {
+    RTI_SendDataReq(0, RTI_PROFILE_RTI, 0, 0, (uint8)len, pData);
+    if (benchWait(&benchSendCnfCnt, base + idx + 1) != 0)
+    {
+      (void)printf("FAIL: no RTI_SendDataCnf %u\n", idx);
+      break;
+    }
+  }
+  *pNs = benchNow() - start;
+
+  return idx;
+}
+
+/**************************************************************************************************
+ * @fn          benchBatch
+ *
+ * @brief       Read BENCH_BATCH_CNT items in pipelined batches, timing each batch per item.
+ *
+ * @param       cnt    - The batches to read.
+ * @param       pItems - The items of a batch.
+ * @param       pNs    - The nsecs per item of each batch.
+ *
+ * @return      The batches read, cnt unless one failed.
+ */
+static unsigned benchBatch(unsigned cnt, rtisItem_t *pItems, unsigned long long *pNs)
+{
+  unsigned long long start;
+  unsigned idx;
+
+  for (idx = 0; idx < cnt; idx++)
+  {
+    start = benchNow();
+    if (RTIS_ReadItemsEx(pItems, BENCH_BATCH_CNT) != RTI_SUCCESS)
+    {
+      (void)printf("FAIL: RTIS_ReadItemsEx batch %u\n", idx);
+      break;
+    }
+    pNs[idx] = (benchNow() - start) / BENCH_BATCH_CNT;
+  }
+
+  return idx;
+}
+
+/**************************************************************************************************
+ * @fn          benchStartSim
+ *
+ * @brief       Start the simulated RNP, echoing each data request, and read the path of its PTY.
+ *
+ * @param       pSim  - The path of rnp_sim.
+ * @param       pRec  - The file for rnp_sim to record the bytes it receives to; NULL for none.
+ * @param       pPath - Buffer for the path of the PTY.
+ * @param       size  - The size of the buffer.
+ *
+ * @return      The pid of the simulated RNP; -1 on failure.
+ */
+static pid_t benchStartSim(const char *pSim, const char *pRec, char *pPath, size_t size)
+{
+  FILE *pOut;
+  int fds[2];
+  pid_t pid;
+
+  if (pipe(fds) != 0)
+  {
+    return -1;
+  }
+
+  if ((pid = fork()) == 0)
+  {
+    (void)dup2(fds[1], STDOUT_FILENO);
+    (void)close(fds[0]);
+    (void)close(fds[1]);
+    if (pRec != NULL)
+    {
+      (void)execl(pSim, pSim, "-e", "-r", pRec, (char *)NULL);
+    }
+    else
+    {
+      (void)execl(pSim, pSim, "-e", (char *)NULL);
+    }
+    _exit(127);
+  }
+  (void)close(fds[1]);
+
+  if ((pid < 0) || ((pOut = fdopen(fds[0], "r")) == NULL))
+  {
+    return -1;
+  }
+
+  if (fgets(pPath, (int)size, pOut) == NULL)
+  {
+    (void)fclose(pOut);
+    (void)kill(pid, SIGTERM);
+    (void)waitpid(pid, NULL, 0);
+    return -1;
+  }
+  pPath[strcspn(pPath, "\n")] = '\0';
+
+  // The simulated RNP writes nothing more; keep the pipe open so that it never sees SIGPIPE.
+  return pid;
+}
+
+/**************************************************************************************************
+ * @fn          main
+ *
+ * @brief       Run the checks and the benchmarks against a simulated RNP.
+ *
+ * @return      0 on success; 1 on a broken check.
+ */
+int main(int argc, char **argv)
+{
+  static uint8 data[100], name[7] = "bench!", back[7];
+  rtisItem_t items[BENCH_BATCH_CNT];
+  uint8 values[BENCH_BATCH_CNT];
+  unsigned long long *pNs, start, ns;
+  const char *pSim = "./rnp_sim", *pRec = NULL;
+  unsigned cnt = 2000, len = 16, idx, batches, sent, rate, fail = 0;
+  char path[64];
+  pid_t pid;
+  int opt, check = 0;
+
+  while ((opt = getopt(argc, argv, "cn:l:r:s:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'c':
+      check = 1;
+      cnt = 200;
+      break;
+
+    case 'n':
+      cnt = (unsigned)atoi(optarg);
+      break;
+
+    case 'l':
+      len = (unsigned)atoi(optarg);
+      break;
+
+    case 'r':
+      pRec = optarg;
+      break;
+
+    case 's':
+      pSim = optarg;
+      break;
+
+    default:
+      (void)fprintf(stderr, "usage: %s [-c] [-n count] [-l len] [-r trace] [-s path]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if ((cnt == 0) || (len < 8) || (len > sizeof(data)))
+  {
+    (void)fprintf(stderr, "rtis_bench: count must be positive and len 8 to %u\n", (unsigned)sizeof(data));
+    return 1;
+  }
+
+  pNs = malloc(cnt * sizeof(pNs[0]));
+  benchIndNs = malloc(cnt * sizeof(benchIndNs[0]));
+  benchIndMax = cnt;
+
+  if ((pNs == NULL) || (benchIndNs == NULL) ||
+      ((pid = benchStartSim(pSim, pRec, path, sizeof(path))) < 0))
+  {
+    perror("rtis_bench: rnp_sim");
+    return 1;
+  }
+
+  if (RTI_InitRNP(path) != 0)
+  {
+    perror("rtis_bench: RTIS_Init");
+    (void)kill(pid, SIGTERM);
+    (void)waitpid(pid, NULL, 0);
+    return 1;
+  }
+
+  // An SREQ from a callback fails at once.
+  RTI_InitReq();
+  if ((benchWait(&benchInitCnfCnt, 1) != 0) || (benchInitCnfStatus != RTI_SUCCESS))
+  {
+    (void)printf("FAIL: no RTI_InitCnf\n");
+    fail++;
+  }
+  else if ((benchCbackStatus != RTI_ERROR_NOT_PERMITTED) || (benchCbackNs >= BENCH_FAIL_FAST_NS))
+  {
+    (void)printf("FAIL: SREQ from a callback: status 0x%02X after %.1f ms\n", benchCbackStatus,
+                 benchCbackNs / 1e6);
+    fail++;
+  }
+  else
+  {
+    (void)printf("SREQ from a callback         RTI_ERROR_NOT_PERMITTED after %.1f us\n",
+                 benchCbackNs / 1e3);
+  }
+
+  // An item reads back as written.
+  if ((RTI_WriteItemEx(RTI_PROFILE_RTI, RTI_CP_ITEM_VENDOR_NAME, sizeof(name), name) != RTI_SUCCESS) ||
+      (RTI_ReadItemEx(RTI_PROFILE_RTI, RTI_CP_ITEM_VENDOR_NAME, sizeof(back), back) != RTI_SUCCESS) ||
+      (memcmp(name, back, sizeof(name)) != 0))
+  {
+    (void)printf("FAIL: item write and read back\n");
+    fail++;
+  }
+
+  // SREQ round trips, one at a time.
+  for (idx = 0; idx < cnt; idx++)
+  {
+    start = benchNow();
+    if (RTI_ReadItemEx(RTI_PROFILE_RTI, RTI_CP_ITEM_VENDOR_NAME, sizeof(back), back) != RTI_SUCCESS)
+    {
+      (void)printf("FAIL: RTI_ReadItemEx round trip %u\n", idx);
+      fail++;
+      break;
+    }
+    pNs[idx] = benchNow() - start;
+  }
+  benchReport("RTI_ReadItemEx round trip", pNs, idx);
+
+  // The same SREQs pipelined in batches, per item.
+  for (idx = 0; idx < BENCH_BATCH_CNT; idx++)
+  {
+    items[idx].profileId = RTI_PROFILE_RTI;
+    items[idx].itemId = RTI_CP_ITEM_VENDOR_NAME;
+    items[idx].len = 1;
+    items[idx].pValue = &values[idx];
+  }
+  batches = cnt / BENCH_BATCH_CNT + 1;
+  if ((idx = benchBatch(batches, items, pNs)) != batches)
+  {
+    fail++;
+  }
+  benchReport("RTIS_ReadItemsEx per item", pNs, idx);
+
+  // Data requests back to back, each waiting for its confirmation; each is also echoed back.
+  if ((sent = benchSend(cnt, len, data, &ns)) != cnt)
+  {
+    fail++;
+  }
+  (void)printf("RTI_SendDataReq sustained    %u x %u bytes in %.3f s: %.0f /s\n", sent, len,
+               ns / 1e9, sent * 1e9 / ns);
+
+  // The same at each baud rate; the echoes are past benchIndMax, and not timed.
+  for (rate = 0; rate < sizeof(benchRates) / sizeof(benchRates[0]); rate++)
+  {
+    unsigned long long batchNs;
+    rStatus_t status;
+
+    if ((status = RTIS_SetBaudRate(benchRates[rate].baudRate)) != RTI_SUCCESS)
+    {
+      (void)printf("FAIL: RTIS_SetBaudRate %u: status 0x%02X\n", benchRates[rate].bps, status);
+      fail++;
+      break;
+    }
+
+    if ((benchSend(cnt, len, data, &ns) != cnt) || (benchBatch(batches, items, pNs) != batches))
+    {
+      fail++;
+      break;
+    }
+
+    for (idx = 0, batchNs = 0; idx < batches; idx++)
+    {
+      batchNs += pNs[idx];
+    }
+    (void)printf("UART %6u baud             RTI_SendDataReq %5.0f /s  RTIS_ReadItemsEx %6.0f /s\n",
+                 benchRates[rate].bps, cnt * 1e9 / ns, batches * 1e9 / batchNs);
+  }
+
+  (void)pthread_mutex_lock(&benchLock);
+  if (benchSendCnfFail != 0)
+  {
+    (void)printf("FAIL: %u RTI_SendDataCnf failed\n", benchSendCnfFail);
+    fail++;
+  }
+  (void)pthread_mutex_unlock(&benchLock);
+
+  // Let the last echo in before closing.
+  (void)usleep(20000);
+  RTIS_Close();
+
+  if (benchIndCnt < sent)
+  {
+    (void)printf("FAIL: %u of %u echoes indicated\n", benchIndCnt, sent);
+    fail++;
+  }
+  benchReport("RTI_ReceiveDataInd latency", benchIndNs, benchIndCnt);
+
+  (void)kill(pid, SIGTERM);
+  (void)waitpid(pid, NULL, 0);
+  free(pNs);
+  free(benchIndNs);
+
+  if (check)
+  {
+    (void)printf("%s\n", (fail == 0) ? "PASS" : "FAIL");
+  }
+
+  return (fail == 0) ? 0 : 1;
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
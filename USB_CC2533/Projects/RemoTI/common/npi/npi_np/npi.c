@@ -26,12 +26,6 @@
  *                                        Type definitions
  **************************************************************************************************/
 
-typedef struct
-{
-  osal_event_hdr_t  hdr;
-  uint8             *msg;
-} npiSysEvtMsg_t;
-
 /**************************************************************************************************
  *                                        Global Variables
  **************************************************************************************************/
@@ -43,10 +37,171 @@ osal_msg_q_t npiTxQueue;
  *                                        Local Variables
  **************************************************************************************************/
 
+#if NPI_POLL_PACK
+// An OSAL queue of the AREQs held to be packed into one POLL response.
+static osal_msg_q_t npiPackQueue;
+#endif
+
+#if NPI_TX_BURST_STATS
+static npiTxBurst_t npiTxBurst;
+#define NPI_TX_BURST_COUNT(FRAMES)  npiTxBurstCount(FRAMES)
+#else
+#define NPI_TX_BURST_COUNT(FRAMES)
+#endif
+
 /**************************************************************************************************
  *                                     Functions
  **************************************************************************************************/
 
+#if NPI_TX_BURST_STATS
+/**************************************************************************************************
+ * @fn          npiTxBurstCount
+ *
+ * @brief       This function counts a Tx burst.
+ *
+ * input parameters
+ *
+ * @param frames - The number of frames sent in the burst.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void npiTxBurstCount( uint8 frames )
+{
+  npiTxBurst.bursts++;
+  npiTxBurst.frames += frames;
+
+  if (npiTxBurst.maxFrames < frames)
+  {
+    npiTxBurst.maxFrames = frames;
+  }
+}
+
+/**************************************************************************************************
+ * @fn          NPI_TxBurstGet
+ *
+ * @brief       This function reads the Tx burst counters.
+ *
+ * input parameters
+ *
+ * @param clear - TRUE to clear the counters after reading them.
+ *
+ * output parameters
+ *
+ * @param *pBurst - The Tx burst counters.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void NPI_TxBurstGet( npiTxBurst_t *pBurst, uint8 clear )
+{
+  *pBurst = npiTxBurst;
+
+  if (clear)
+  {
+    (void)osal_memset(&npiTxBurst, 0, sizeof(npiTxBurst_t));
+  }
+}
+#endif
+
+#if NPI_POLL_PACK
+/**************************************************************************************************
+ * @fn          npiPackHold
+ *
+ * @brief       This function holds an AREQ to be packed with any others queued within
+ *              NPI_POLL_PACK_HOLD msecs, when the given event is set for the transport to send them.
+ *
+ * input parameters
+ *
+ * @param *pMsg - Pointer to the AREQ allocated by NPI_AllocAsynchData().
+ * @param event - The transport event on which to call npiPackAReqs().
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void npiPackHold( npiMsgData_t *pMsg, uint16 event )
+{
+  osal_msg_enqueue(&npiPackQueue, pMsg);
+
+#if NPI_POLL_PACK_HOLD
+  if (osal_get_timeoutEx(NPI_TaskId, event) == 0)
+  {
+    (void)osal_start_timerEx(NPI_TaskId, event, NPI_POLL_PACK_HOLD);
+  }
+#else
+  (void)osal_set_event(NPI_TaskId, event);
+#endif
+}
+
+/**************************************************************************************************
+ * @fn          npiPackAReqs
+ *
+ * @brief       This function takes the next AREQ(s) held by npiPackHold(): a lone AREQ is returned
+ *              as is, otherwise as many as fit are packed as whole RPC frames into the payload of
+ *              one NPI_SYS_CMD_ID_PACKED_AREQ.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * @param *pFrames - The number of AREQs in the message returned.
+ *
+ * @return      The AREQ to send, as allocated by NPI_AllocAsynchData(); NULL when none are held.
+ **************************************************************************************************
+ */
+static npiMsgData_t *npiPackAReqs( uint8 *pFrames )
+{
+  npiMsgData_t *pMsg = OSAL_MSG_Q_HEAD(&npiPackQueue);
+  npiMsgData_t *pPack;
+  uint8 len = 0;
+  uint8 cnt = 0;
+
+  // Count the AREQs at the head of the queue that fit whole into one packed AREQ.
+  while ((pMsg != NULL) && (((uint16)len + RPC_FRAME_HDR_SZ + pMsg->len) <= NPI_POLL_PACK_MAX))
+  {
+    len += RPC_FRAME_HDR_SZ + pMsg->len;
+    cnt++;
+    pMsg = OSAL_MSG_NEXT(pMsg);
+  }
+
+  *pFrames = 1;
+
+  // A lone AREQ, or one too big to be packed, is sent as is - as it is on an allocation failure.
+  if ((cnt < 2) || ((pPack = NPI_AllocAsynchData(len)) == NULL))
+  {
+    return (npiMsgData_t *)osal_msg_dequeue(&npiPackQueue);
+  }
+
+  *pFrames = cnt;
+  pPack->len = 0;
+  pPack->subSys = RPC_SYS_SYS;
+  pPack->cmdId = NPI_SYS_CMD_ID_PACKED_AREQ;
+
+  while (cnt--)
+  {
+    pMsg = (npiMsgData_t *)osal_msg_dequeue(&npiPackQueue);
+    len = RPC_FRAME_HDR_SZ + pMsg->len;
+    pMsg->subSys = (pMsg->subSys & RPC_SUBSYSTEM_MASK) | RPC_CMD_AREQ;
+
+    (void)osal_memcpy(&pPack->pData[pPack->len], pMsg, len);
+    pPack->len += len;
+    (void)osal_msg_deallocate((uint8 *)pMsg);
+  }
+
+  return pPack;
+}
+#endif
+
 #if ((defined HAL_UART) && (HAL_UART == TRUE))
 #include "./npi_uart.c"
 #elif ((defined HAL_SPI) && (HAL_SPI == TRUE))
@@ -24,6 +24,38 @@ extern "C"
 // Buffer size - it has to be big enough for the largest NPI RPC packet and NPI overhead
 #define NP_MAX_BUF_LEN                 128
 
+// Hold AREQs for up to NPI_POLL_PACK_HOLD msecs and pack those queued together into one POLL
+// response, as an NPI_SYS_CMD_ID_PACKED_AREQ (SPI and I2C only; the host must unpack them).
+#if !defined NPI_POLL_PACK
+#define NPI_POLL_PACK                  FALSE
+#endif
+#if !defined NPI_POLL_PACK_HOLD
+#define NPI_POLL_PACK_HOLD             0
+#endif
+// The largest payload of a packed AREQ, so that its frame and the SPI dummy byte fit NP_MAX_BUF_LEN.
+#define NPI_POLL_PACK_MAX             (NP_MAX_BUF_LEN - RPC_FRAME_HDR_SZ - 1)
+
+// Count the frames sent per Tx burst: per UART DMA write pass, or per SPI/I2C POLL response.
+#if !defined NPI_TX_BURST_STATS
+#define NPI_TX_BURST_STATS             FALSE
+#endif
+
+// NPI system commands - on the RPC_SYS_SYS subsystem, handled by the NPI transport itself and not
+// passed to the client.
+
+// Change the UART baud rate: the one byte payload is the HAL_UART_BR_ value, the one byte SRSP
+// payload is the RPC_ status. On success, the SRSP is sent at the old rate and then the NP changes
+// to the new rate, where the host must send a frame within NPI_UART_BAUD_TIMEOUT msecs to keep it;
+// otherwise the NP falls back to the old rate.
+#define NPI_SYS_CMD_ID_UART_BAUD_REQ   0x01
+
+// AREQ from the NP whose payload is whole RPC frames (LEN, CMD0, CMD1, data) - see NPI_POLL_PACK.
+#define NPI_SYS_CMD_ID_PACKED_AREQ     0x02
+
+// Read the Tx burst counters (UART only): the SRSP payload is the npiTxBurst_t, little-endian,
+// and reading the counters clears them.
+#define NPI_SYS_CMD_ID_TX_BURST_REQ    0x03
+
 /**************************************************************************************************
  * TYPEDEFS
  **************************************************************************************************/
@@ -38,6 +70,14 @@ typedef struct
   uint8 pData[NP_MAX_BUF_LEN];
 } npiMsgData_t;
 
+// Tx burst counters - see NPI_TX_BURST_STATS.
+typedef struct
+{
+  uint16 bursts;     // Number of bursts sent.
+  uint16 frames;     // Number of frames sent in those bursts.
+  uint8  maxFrames;  // Most frames sent in one burst.
+} npiTxBurst_t;
+
 /**************************************************************************************************
  * GLOBALS
  **************************************************************************************************/
@@ -88,6 +128,65 @@ extern void NPI_SleepRx( void );
  */
 extern void NPI_SendAsynchData( npiMsgData_t *pMsg );
 
+/**************************************************************************************************
+ * @fn          NPI_AllocAsynchData
+ *
+ * @brief       This function is called by the client to allocate an AREQ buffer, already framed
+ *              for the transport, in which to build an asynchronous message without a copy.
+ *
+ * input parameters
+ *
+ * @param len   - The payload length required.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      A pointer to the message to fill in and pass to NPI_SendAsynchBuf(), which then
+ *              owns it; NULL if the allocation failed.
+ **************************************************************************************************
+ */
+extern npiMsgData_t *NPI_AllocAsynchData( uint8 len );
+
+/**************************************************************************************************
+ * @fn          NPI_SendAsynchBuf
+ *
+ * @brief       This function is called by the client to send, in place, an asynchronous message
+ *              that was allocated by NPI_AllocAsynchData().
+ *
+ * input parameters
+ *
+ * @param *pMsg  - Pointer to the message to be sent; len must not exceed the allocated length.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+extern void NPI_SendAsynchBuf( npiMsgData_t *pMsg );
+
+#if NPI_TX_BURST_STATS
+/**************************************************************************************************
+ * @fn          NPI_TxBurstGet
+ *
+ * @brief       This function reads the Tx burst counters.
+ *
+ * input parameters
+ *
+ * @param clear - TRUE to clear the counters after reading them.
+ *
+ * output parameters
+ *
+ * @param *pBurst - The Tx burst counters.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+extern void NPI_TxBurstGet( npiTxBurst_t *pBurst, uint8 clear );
+#endif
+
 
 /**************************************************************************************************
  * @fn          NPI_AsynchMsgCback
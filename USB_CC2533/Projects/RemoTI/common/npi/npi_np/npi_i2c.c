@@ -97,6 +97,7 @@
 #define NPI_EVENT_I2C_EXIT_PM          0x0800
 #define NPI_EVENT_I2C_ENTER_PM         0x0400
 #endif
+#define NPI_EVENT_I2C_PACK             0x0200
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Local Variables
@@ -116,6 +117,7 @@ static npiMsgData_t npiMsgSREQ;
 static uint8 npiI2CCB(uint8 cnt);
 static void npiGpioInit(void);
 static void npiRecvAsynchData(npiMsgData_t *pMsg);
+static void npiSendAReq(npiMsgData_t *pMsg);
 void npiProcessSREQCmd(void);
 void npiProcessPOLLCmd(void);
 void npiProcessAREQCmd(void);
@@ -182,6 +184,21 @@ uint16 NPI_ProcessEvent(uint8 taskId, uint16 events)
     npiProcessAREQCmd();
   }
 
+#if NPI_POLL_PACK
+  if (events & NPI_EVENT_I2C_PACK)
+  {
+    npiMsgData_t *pMsg;
+    uint8 frames;
+
+    // Send the held AREQs, packed into as few POLL responses as possible.
+    while ((pMsg = npiPackAReqs(&frames)) != NULL)
+    {
+      npiSendAReq(pMsg);
+      NPI_TX_BURST_COUNT(frames);
+    }
+  }
+#endif
+
 #if defined POWER_SAVING
   if (events & NPI_EVENT_I2C_EXIT_PM)
   {
@@ -228,22 +245,93 @@ uint16 NPI_ProcessEvent(uint8 taskId, uint16 events)
  */
 void NPI_SendAsynchData( npiMsgData_t *pMsg )
 {
-  uint8* p;
+  npiMsgData_t *p;
 
-  if ((p = osal_msg_allocate(pMsg->len + RPC_FRAME_HDR_SZ)) != NULL)
+  if ((p = NPI_AllocAsynchData(pMsg->len)) != NULL)
   {
     // Prepare message
-    p[RPC_POS_LEN]  = pMsg->len;
-    p[RPC_POS_CMD0] = (pMsg->subSys & RPC_SUBSYSTEM_MASK) | RPC_CMD_AREQ;
-    p[RPC_POS_CMD1] = pMsg->cmdId;
+    p->len    = pMsg->len;
+    p->subSys = pMsg->subSys;
+    p->cmdId  = pMsg->cmdId;
 
-    osal_memcpy( &p[RPC_POS_DAT0], pMsg->pData, pMsg->len );  // copy the client's payload
-    osal_msg_enqueue(&npiTxQueue, p);  // Enqueue the AREQ.
-    SRDY = NPI_I2C_SRDY;  // Assert SRDY to notify master we have data.
+    osal_memcpy( p->pData, pMsg->pData, pMsg->len );  // copy the client's payload
+    NPI_SendAsynchBuf(p);
+  }
+}
+
+/**************************************************************************************************
+ * @fn          NPI_AllocAsynchData API
+ *
+ * @brief       This function is called by the client to allocate an AREQ buffer, already framed
+ *              for the I2C, in which to build an asynchronous message without a copy.
+ *
+ * input parameters
+ *
+ * @param len   - The payload length required.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      A pointer to the message to fill in and pass to NPI_SendAsynchBuf(); NULL if the
+ *              allocation failed.
+ */
+npiMsgData_t *NPI_AllocAsynchData( uint8 len )
+{
+  return (npiMsgData_t *)osal_msg_allocate(len + RPC_FRAME_HDR_SZ);
+}
+
+/**************************************************************************************************
+ * @fn          NPI_SendAsynchBuf API
+ *
+ * @brief       This function is called by the client to send, in place, an asynchronous message
+ *              that was allocated by NPI_AllocAsynchData().
+ *
+ * input parameters
+ *
+ * @param *pMsg  - Pointer to the message to be sent.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void NPI_SendAsynchBuf( npiMsgData_t *pMsg )
+{
+#if NPI_POLL_PACK
+  npiPackHold(pMsg, NPI_EVENT_I2C_PACK);
+#else
+  npiSendAReq(pMsg);
+  NPI_TX_BURST_COUNT(1);
+#endif
+}
+
+/**************************************************************************************************
+ * @fn          npiSendAReq
+ *
+ * @brief       This function frames an AREQ allocated by NPI_AllocAsynchData() and queues it for
+ *              the next POLL from the master.
+ *
+ * input parameters
+ *
+ * @param *pMsg  - Pointer to the message to be sent.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void npiSendAReq(npiMsgData_t *pMsg)
+{
+  pMsg->subSys = (pMsg->subSys & RPC_SUBSYSTEM_MASK) | RPC_CMD_AREQ;
+
+  osal_msg_enqueue(&npiTxQueue, pMsg);  // Enqueue the AREQ.
+  SRDY = NPI_I2C_SRDY;  // Assert SRDY to notify master we have data.
 #if defined POWER_SAVING
-    (void)osal_set_event(NPI_TaskId, NPI_EVENT_I2C_EXIT_PM);
+  (void)osal_set_event(NPI_TaskId, NPI_EVENT_I2C_EXIT_PM);
 #endif
-  }
 }
 
 /**************************************************************************************************
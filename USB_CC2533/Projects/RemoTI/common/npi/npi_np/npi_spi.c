@@ -49,6 +49,7 @@
 #define NPI_SPI_RX_AREQ_EVENT          0x4000
 #define NPI_SPI_RX_SREQ_EVENT          0x2000
 #define NPI_SPI_TX_COMPLETE_EVENT      0x1000
+#define NPI_SPI_PACK_EVENT             0x0800
 
 /**************************************************************************************************
  *                                        Type definitions
@@ -73,6 +74,7 @@ bool   npSpiReadyCallback (void );
 
 // Internal Functions
 static void npiSpiSend( uint8 *pBuf );
+static void npiSpiSendAReq( npiMsgData_t *pMsg );
 
 /**************************************************************************************************
  *                                     Functions
@@ -182,6 +184,21 @@ uint16 NPI_ProcessEvent( uint8 taskId, uint16 events )
     }
   }
   
+#if NPI_POLL_PACK
+  if (events & NPI_SPI_PACK_EVENT)
+  {
+    npiMsgData_t *pMsg;
+    uint8 frames;
+
+    // send the held AREQs, packed into as few POLL responses as possible
+    while ((pMsg = npiPackAReqs(&frames)) != NULL)
+    {
+      npiSpiSendAReq( pMsg );
+      NPI_TX_BURST_COUNT(frames);
+    }
+  }
+#endif
+
   if (events & NPI_SPI_TX_COMPLETE_EVENT)
   {
     npSpiMonitor();
@@ -214,31 +231,107 @@ uint16 NPI_ProcessEvent( uint8 taskId, uint16 events )
  */
 void NPI_SendAsynchData( npiMsgData_t *pMsg )
 {
-  uint8 *pAReq;
+  npiMsgData_t *pAReq;
+
+  if ( (pAReq = NPI_AllocAsynchData( pMsg->len )) != NULL )
+  {
+    // setup the message
+    pAReq->len    = pMsg->len;
+    pAReq->subSys = pMsg->subSys;
+    pAReq->cmdId  = pMsg->cmdId;
+
+    // copy the client's payload
+    osal_memcpy( pAReq->pData, pMsg->pData, pMsg->len );
 
-  // allocate a buffer
-  // NOTE: After the following AREQ is TX'ed to the master, the DMA complete ISR
+    NPI_SendAsynchBuf( pAReq );
+  }
+}
+
+
+/**************************************************************************************************
+ * @fn          NPI_AllocAsynchData API
+ *
+ * @brief       This function is called by the client to allocate an AREQ buffer, already framed
+ *              for the SPI, in which to build an asynchronous message without a copy.
+ *
+ * input parameters
+ *
+ * @param len   - The payload length required.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      A pointer to the message to fill in and pass to NPI_SendAsynchBuf(); NULL if the
+ *              allocation failed.
+ **************************************************************************************************
+ */
+npiMsgData_t *NPI_AllocAsynchData( uint8 len )
+{
+  // NOTE: After the AREQ is TX'ed to the master, the DMA complete ISR
   //       will deallocate this buffer.
   // NOTE: This call already allocates space for the header.
+  // NOTE: One extra byte is allocated for the dummy byte added by NPI_SendAsynchBuf.
+  return (npiMsgData_t *)npSpiAReqAlloc( len+1 );
+}
+
+
+/**************************************************************************************************
+ * @fn          NPI_SendAsynchBuf API
+ *
+ * @brief       This function is called by the client to send, in place, an asynchronous message
+ *              that was allocated by NPI_AllocAsynchData().
+ *
+ * input parameters
+ *
+ * @param *pMsg  - Pointer to the message to be sent.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void NPI_SendAsynchBuf( npiMsgData_t *pMsg )
+{
+#if NPI_POLL_PACK
+  npiPackHold( pMsg, NPI_SPI_PACK_EVENT );
+#else
+  npiSpiSendAReq( pMsg );
+  NPI_TX_BURST_COUNT(1);
+#endif
+}
+
+
+/**************************************************************************************************
+ * @fn          npiSpiSendAReq
+ *
+ * @brief       This function frames an AREQ allocated by NPI_AllocAsynchData() and sets up the send.
+ *
+ * input parameters
+ *
+ * @param *pMsg  - Pointer to the message to be sent.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void npiSpiSendAReq( npiMsgData_t *pMsg )
+{
   // NOTE: For some reason, the DMA sends n-1 bytes to the master (the master
   //       always gets zero on the last payload byte). Until this is figured out,
   //       one extra byte is added to the payload length, and sent.
-  if ( (pAReq = npSpiAReqAlloc( pMsg->len+RPC_FRAME_HDR_SZ+1 )) != NULL )
-  {
-    // setup the message
-    pAReq[RPC_POS_LEN]  = pMsg->len+1;                                        // payload length
-    pAReq[RPC_POS_CMD0] = (pMsg->subSys & RPC_SUBSYSTEM_MASK) | RPC_CMD_AREQ; // type and subsystem
-    pAReq[RPC_POS_CMD1] = pMsg->cmdId;                                        // ID
+  // add one extra dummy byte; use value so it's obvious in memory
+  pMsg->pData[pMsg->len++] = 0xFF;
 
-    // copy the client's payload
-    osal_memcpy( &pAReq[RPC_POS_DAT0], (uint8 *)pMsg->pData, pMsg->len+1 );
-    
-    // add one extra dummy byte; use value so it's obvious in memory
-    pAReq[RPC_FRAME_HDR_SZ+pMsg->len] = 0xFF;
-    
-    // enqueue data on NPI task queue
-    npiSpiSend( pAReq );
-  }
+  pMsg->subSys = (pMsg->subSys & RPC_SUBSYSTEM_MASK) | RPC_CMD_AREQ;  // type and subsystem
+
+  // enqueue data on NPI task queue
+  npiSpiSend( (uint8 *)pMsg );
 }
 
 
@@ -14,6 +14,8 @@
 #define NPI_UART_RX_READY_EVT         0x2000
 #define NPI_UART_EXIT_PM_EVT          0x1000  // Exit PM should be higher priority then enter PM.
 #define NPI_UART_ENTER_PM_EVT         0x0800
+#define NPI_UART_BAUD_EVT             0x0400
+#define NPI_UART_RX_MSG_EVT           0x0200
 
 // UART port selection
 #if HAL_UART_DMA == 1
@@ -27,27 +29,61 @@
 #endif
 
 // UART configuration parameters
+#if !defined NPI_UART_BAUD_RATE
 #define NPI_UART_BAUD_RATE             HAL_UART_BR_115200
+#endif
+// The highest rate that the host may change to with NPI_SYS_CMD_ID_UART_BAUD_REQ.
+#if !defined NPI_UART_BAUD_MAX
+#define NPI_UART_BAUD_MAX              HAL_UART_BR_921600
+#endif
+// Msecs for the host to send a frame at a new baud rate before falling back to the old one.
+#if !defined NPI_UART_BAUD_TIMEOUT
+#define NPI_UART_BAUD_TIMEOUT          1000
+#endif
+
+// Msecs that an AREQ may be held to go out in one Tx burst with those that follow it; 0 to not hold.
+#if !defined NPI_UART_TX_HOLD
+#define NPI_UART_TX_HOLD               0
+#endif
+
+#if NPI_POLL_PACK
+#error NPI_POLL_PACK is for the SPI and I2C transports; the UART coalesces its Tx by itself.
+#endif
 
 #define NPI_UART_FLOW_THRESHOLD        48
 #define NPI_UART_IDLE_TIMEOUT          6
 #define NPI_UART_TX_MAX                NP_MAX_BUF_LEN
 #define NPI_UART_RX_MAX                NP_MAX_BUF_LEN
 
-// Message command IDs
-#define CMD_SERIAL_MSG                 0x01
-
-// State values for UART reception - npiUartCbackProcessData
+// State values for UART reception - npiProcessData
 #define SOF_STATE                      0x00
-#define CMD_STATE1                     0x01
-#define CMD_STATE2                     0x02
-#define LEN_STATE                      0x03
-#define DATA_STATE                     0x04
-#define FCS_STATE                      0x05
+#define LEN_STATE                      0x01
+#define CMD0_STATE                     0x02
+#define BODY_STATE                     0x03  // CMD1, the data and the FCS, read as one block.
 
 // Special NULL message (used for responding to wake up event) first and only byte content
 #define NPI_UART_NULL_MSG              0x00
 
+// State values for a baud rate change - npiUartBaudState
+#define NPI_UART_BAUD_IDLE             0x00
+#define NPI_UART_BAUD_PENDING          0x01  // Waiting for the SRSP to be sent at the old rate.
+#define NPI_UART_BAUD_TRIAL            0x02  // Waiting for a good frame at the new rate.
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static uint8 npiUartBaud = NPI_UART_BAUD_RATE;  // The baud rate in use.
+static uint8 npiUartBaudOld;                    // The baud rate to fall back to.
+static uint8 npiUartBaudState = NPI_UART_BAUD_IDLE;
+
+// An OSAL queue of the frames received, each allocated by npiUartAlloc().
+static osal_msg_q_t npiRxQueue;
+
+// Reception state of npiProcessData() and the frame being received, dropped on a UART re-open.
+static uint8 npiRxState = SOF_STATE;
+static uint8 *npiRxBuf;
+
 /**************************************************************************************************
  *                                     Local Function Prototypes
  **************************************************************************************************/
@@ -56,6 +92,8 @@
 static void npUartReqCback( uint8 port, uint8 event );
 
 // Internal Functions
+static void   npiUartOpen( uint8 baudRate );
+static void   npiUartSysMsg( npiMsgData_t *pMsg );
 static uint8 *npiUartAlloc( uint8 len );
 static void   npiUartSend( uint8 *pBuf );
 static bool npiUartTxReady(void);
@@ -75,8 +113,6 @@ static uint8  npiUartCalcFCS( uint8 *msg_ptr, uint8 len );
  **************************************************************************************************/
 void NPI_Init( uint8 taskId )
 {
-  halUARTCfg_t uartConfig;
-
   NPI_TaskId = taskId;
 
 #if defined( POWER_SAVING )
@@ -84,8 +120,38 @@ void NPI_Init( uint8 taskId )
   osal_pwrmgr_task_state( NPI_TaskId, PWRMGR_HOLD );
 #endif
 
+  npiUartOpen(npiUartBaud);
+}
+
+/**************************************************************************************************
+ * @fn          npiUartOpen
+ *
+ * @brief       This function opens, or re-opens, the NPI UART port at the given baud rate.
+ *
+ * input parameters
+ *
+ * @param baudRate - The HAL_UART_BR_ value of the baud rate to use.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void npiUartOpen( uint8 baudRate )
+{
+  halUARTCfg_t uartConfig;
+
+  // A frame partly received at the old rate would take the first bytes sent at the new one.
+  if (npiRxState == BODY_STATE)
+  {
+    osal_msg_deallocate(npiRxBuf - 1);
+  }
+  npiRxState = SOF_STATE;
+
   uartConfig.configured           = TRUE;
-  uartConfig.baudRate             = NPI_UART_BAUD_RATE;
+  uartConfig.baudRate             = baudRate;
   uartConfig.flowControl          = FALSE;
   uartConfig.flowControlThreshold = NPI_UART_FLOW_THRESHOLD;
   uartConfig.rx.maxBufSize        = NPI_UART_RX_MAX;
@@ -129,55 +195,6 @@ uint16 NPI_ProcessEvent( uint8 taskId, uint16 events )
     {
       switch (pMsg->event)
       {
-      // message from serial interface
-      case CMD_SERIAL_MSG:
-        {
-          // view system event message as a NPI RPC message
-          uint8 *pBuf = ((npiSysEvtMsg_t *) pMsg)->msg;
-
-          // check the type of message
-          if ( (pBuf[RPC_POS_CMD0] & RPC_CMD_TYPE_MASK) == RPC_CMD_AREQ )
-          {
-            // remove RPC Command Field Type, leaving only Subsystem for client
-            pBuf[RPC_POS_CMD0] &= RPC_SUBSYSTEM_MASK;
-
-            // call the NPI callback implemented by client to process data
-            NPI_AsynchMsgCback( (npiMsgData_t *)pBuf );
-          }
-          else if ( (pBuf[RPC_POS_CMD0] & RPC_CMD_TYPE_MASK) == RPC_CMD_SREQ )
-          {
-            // reply will be required for a synchronous request
-            uint8 *pRspMsg;
-
-            // remove RPC Command Field Type, leaving only Subsystem for client
-            pBuf[RPC_POS_CMD0] &= RPC_SUBSYSTEM_MASK;
-
-            // always allocate the max size (for now)
-            // NOTE: deallocated in npiUartTxReady
-            if ((pRspMsg = npiUartAlloc( NP_MAX_BUF_LEN )) != NULL)
-            {
-              // copy the client's data (max size for now)
-              // NOTE: allocated space includes room for SOF and FCS bytes, but
-              //       note that the return pointer is one byte past SOF
-              osal_memcpy( &pRspMsg[RPC_POS_LEN], &pBuf[RPC_POS_LEN], NP_MAX_BUF_LEN );
-
-              // call the NPI callback implemented by client to process data
-              // NOTE: It is assumed that a SRSP will take place in a reasonable
-              //       amount of time. If the SREQ processing is expected to take
-              //       a long time before the SRSP is returned, then it should be
-              //       sent as a AREQ instead.
-              NPI_SynchMsgCback( (npiMsgData_t *)pRspMsg );
-
-              // clients data in buffer; add in Command Field Type
-              pRspMsg[RPC_POS_CMD0] = (pRspMsg[RPC_POS_CMD0] & RPC_SUBSYSTEM_MASK) | RPC_CMD_SRSP;
-
-              // send it back
-              npiUartSend( pRspMsg );
-            }
-          }
-        }
-        break;
-
       default:
         break;
       }
@@ -188,6 +205,60 @@ uint16 NPI_ProcessEvent( uint8 taskId, uint16 events )
     return (events ^ SYS_EVENT_MSG);
   }
 
+  if (events & NPI_UART_RX_MSG_EVT)
+  {
+    uint8 *pBuf;
+
+    // process all frames received from the serial interface
+    while ((pBuf = osal_msg_dequeue(&npiRxQueue)) != NULL)
+    {
+      // view the frame as a NPI RPC message, which starts one byte past the SOF
+      pBuf++;
+
+      // check the type of message
+      if ( (pBuf[RPC_POS_CMD0] & RPC_CMD_TYPE_MASK) == RPC_CMD_AREQ )
+      {
+        // remove RPC Command Field Type, leaving only Subsystem for client
+        pBuf[RPC_POS_CMD0] &= RPC_SUBSYSTEM_MASK;
+
+        // call the NPI callback implemented by client to process data
+        NPI_AsynchMsgCback( (npiMsgData_t *)pBuf );
+      }
+      else if ( (pBuf[RPC_POS_CMD0] & RPC_CMD_TYPE_MASK) == RPC_CMD_SREQ )
+      {
+        // remove RPC Command Field Type, leaving only Subsystem for client
+        pBuf[RPC_POS_CMD0] &= RPC_SUBSYSTEM_MASK;
+
+        // call the NPI callback implemented by client to process data
+        // NOTE: npiProcessData allocated an SREQ with room for the largest reply, so the client
+        //       replies in place and the same buffer is sent back (deallocated in npiUartTxReady).
+        // NOTE: It is assumed that a SRSP will take place in a reasonable
+        //       amount of time. If the SREQ processing is expected to take
+        //       a long time before the SRSP is returned, then it should be
+        //       sent as a AREQ instead.
+        if (pBuf[RPC_POS_CMD0] == RPC_SYS_SYS)
+        {
+          npiUartSysMsg( (npiMsgData_t *)pBuf );
+        }
+        else
+        {
+          NPI_SynchMsgCback( (npiMsgData_t *)pBuf );
+        }
+
+        // clients data in buffer; add in Command Field Type
+        pBuf[RPC_POS_CMD0] = (pBuf[RPC_POS_CMD0] & RPC_SUBSYSTEM_MASK) | RPC_CMD_SRSP;
+
+        // send it back
+        npiUartSend( pBuf );
+        continue;
+      }
+
+      osal_msg_deallocate(pBuf - 1);
+    }
+
+    return (events ^ NPI_UART_RX_MSG_EVT);
+  }
+
   if (events & NPI_UART_TX_READY_EVT)
   {
     return (npiUartTxReady()) ? events : (events ^ NPI_UART_TX_READY_EVT);
@@ -199,6 +270,37 @@ uint16 NPI_ProcessEvent( uint8 taskId, uint16 events )
     return (events ^ NPI_UART_RX_READY_EVT);
   }
 
+  if (events & NPI_UART_BAUD_EVT)
+  {
+    if (npiUartBaudState == NPI_UART_BAUD_PENDING)
+    {
+      // The SRSP is still being sent, or the host sent more at the old rate, so check again.
+      if (HalUARTBusy())
+      {
+        return events;
+      }
+
+      npiUartOpen(npiUartBaud);
+      npiUartBaudState = NPI_UART_BAUD_TRIAL;
+      (void)osal_start_timerEx(NPI_TaskId, NPI_UART_BAUD_EVT, NPI_UART_BAUD_TIMEOUT);
+    }
+    else if (npiUartBaudState == NPI_UART_BAUD_TRIAL)
+    {
+      // Do not cut off a frame still going out or coming in at the new rate, so check again.
+      if (HalUARTBusy())
+      {
+        return events;
+      }
+
+      // No good frame was received at the new rate in time, so fall back to the old rate.
+      npiUartBaud = npiUartBaudOld;
+      npiUartOpen(npiUartBaud);
+      npiUartBaudState = NPI_UART_BAUD_IDLE;
+    }
+
+    return (events ^ NPI_UART_BAUD_EVT);
+  }
+
   // Exiting PM should have priority over entering PM since it clears the flag to enter and thereby
   // resolves any possible race condition in favor of not entering PM.
   if (events & NPI_UART_EXIT_PM_EVT)
@@ -260,27 +362,134 @@ uint16 NPI_ProcessEvent( uint8 taskId, uint16 events )
  */
 void NPI_SendAsynchData( npiMsgData_t *pMsg )
 {
-  uint8 *pAReq;
+  npiMsgData_t *pAReq;
 
-  // allocate a buffer
-  // NOTE: allocated space includes room for SOF and FCS bytes
-  // NOTE: deallocated in npiUartTxReady
-  if ( (pAReq = npiUartAlloc( pMsg->len )) != NULL )
+  if ( (pAReq = NPI_AllocAsynchData( pMsg->len )) != NULL )
   {
-    // NOTE: allocate returns pointer to first RPC message byte (i.e. to length field)
-    pAReq[RPC_POS_LEN]  = pMsg->len;
-    pAReq[RPC_POS_CMD0] = (pMsg->subSys & RPC_SUBSYSTEM_MASK) | RPC_CMD_AREQ;
-    pAReq[RPC_POS_CMD1] = pMsg->cmdId;
+    pAReq->len    = pMsg->len;
+    pAReq->subSys = pMsg->subSys;
+    pAReq->cmdId  = pMsg->cmdId;
 
     // copy the client's payload
-    osal_memcpy( &pAReq[RPC_POS_DAT0], pMsg->pData, pMsg->len );
+    osal_memcpy( pAReq->pData, pMsg->pData, pMsg->len );
 
-    // send it back
-    npiUartSend( pAReq );
+    NPI_SendAsynchBuf( pAReq );
   }
 }
 
 
+/**************************************************************************************************
+ * @fn          NPI_AllocAsynchData API
+ *
+ * @brief       This function is called by the client to allocate an AREQ buffer, already framed
+ *              for the UART, in which to build an asynchronous message without a copy.
+ *
+ * input parameters
+ *
+ * @param len   - The payload length required.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      A pointer to the message to fill in and pass to NPI_SendAsynchBuf(); NULL if the
+ *              allocation failed.
+ **************************************************************************************************
+ */
+npiMsgData_t *NPI_AllocAsynchData( uint8 len )
+{
+  // NOTE: allocated space includes room for SOF and FCS bytes
+  // NOTE: deallocated in npiUartTxReady
+  return (npiMsgData_t *)npiUartAlloc( len );
+}
+
+
+/**************************************************************************************************
+ * @fn          NPI_SendAsynchBuf API
+ *
+ * @brief       This function is called by the client to send, in place, an asynchronous message
+ *              that was allocated by NPI_AllocAsynchData().
+ *
+ * input parameters
+ *
+ * @param *pMsg  - Pointer to the message to be sent.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void NPI_SendAsynchBuf( npiMsgData_t *pMsg )
+{
+  pMsg->subSys = (pMsg->subSys & RPC_SUBSYSTEM_MASK) | RPC_CMD_AREQ;
+
+  npiUartSend( (uint8 *)pMsg );
+}
+
+
+/**************************************************************************************************
+ * @fn          npiUartSysMsg
+ *
+ * @brief       This function processes an NPI system SREQ and replies in the same buffer.
+ *
+ * input parameters
+ *
+ * @param       *pMsg - A pointer to the synchronously received message.
+ *
+ * output parameters
+ *
+ * @param       *pMsg - A pointer to the synchronous reply message.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void npiUartSysMsg( npiMsgData_t *pMsg )
+{
+  uint8 status = RPC_ERR_COMMAND_ID;
+
+  if (pMsg->cmdId == NPI_SYS_CMD_ID_UART_BAUD_REQ)
+  {
+    if ((pMsg->len != 1) || (pMsg->pData[0] > NPI_UART_BAUD_MAX) ||
+        (npiUartBaudState != NPI_UART_BAUD_IDLE))
+    {
+      status = RPC_ERR_PARAMETER;
+    }
+    else
+    {
+      if (pMsg->pData[0] != npiUartBaud)
+      {
+        // Change only after the SRSP has been sent at the old rate - see NPI_UART_BAUD_EVT.
+        npiUartBaudOld = npiUartBaud;
+        npiUartBaud = pMsg->pData[0];
+        npiUartBaudState = NPI_UART_BAUD_PENDING;
+        (void)osal_set_event(NPI_TaskId, NPI_UART_BAUD_EVT);
+      }
+
+      status = RPC_SUCCESS;
+    }
+  }
+#if NPI_TX_BURST_STATS
+  else if (pMsg->cmdId == NPI_SYS_CMD_ID_TX_BURST_REQ)
+  {
+    npiTxBurst_t burst;
+
+    NPI_TxBurstGet(&burst, TRUE);
+    pMsg->len = 5;
+    pMsg->pData[0] = LO_UINT16(burst.bursts);
+    pMsg->pData[1] = HI_UINT16(burst.bursts);
+    pMsg->pData[2] = LO_UINT16(burst.frames);
+    pMsg->pData[3] = HI_UINT16(burst.frames);
+    pMsg->pData[4] = burst.maxFrames;
+    return;
+  }
+#endif
+
+  pMsg->len = 1;
+  pMsg->pData[0] = status;
+}
+
 /**************************************************************************************************
  * @fn          npUartReqCback
  *
@@ -349,6 +558,20 @@ static void npiUartSend(uint8 *pBuf)
 
   // queue message, and wait for
   osal_msg_enqueue(&npiTxQueue, pBuf);
+
+#if NPI_UART_TX_HOLD
+  // Hold an AREQ to go out in one burst with any that follow it within NPI_UART_TX_HOLD msecs;
+  // anything else (i.e. an SRSP) is sent right away, along with the AREQs held before it.
+  if ((pBuf[1 + RPC_POS_CMD0] & RPC_CMD_TYPE_MASK) == RPC_CMD_AREQ)
+  {
+    if (osal_get_timeoutEx(NPI_TaskId, NPI_UART_TX_READY_EVT) == 0)
+    {
+      (void)osal_start_timerEx(NPI_TaskId, NPI_UART_TX_READY_EVT, NPI_UART_TX_HOLD);
+    }
+    return;
+  }
+#endif
+
   osal_set_event(NPI_TaskId, NPI_UART_TX_READY_EVT);
 }
 
@@ -356,7 +579,8 @@ static void npiUartSend(uint8 *pBuf)
 /**************************************************************************************************
  * @fn          npiUartTxReady
  *
- * @brief       This function gets and writes the next chunk of data to the UART.
+ * @brief       This function writes as many of the queued frames to the UART as its Tx buffers
+ *              take, so that frames queued together go out in as few DMA bursts as possible.
  *
  * input parameters
  *
@@ -374,11 +598,19 @@ static bool npiUartTxReady(void)
   static uint16 npUartTxCnt = 0;
   static uint8 *npUartTxMsg = NULL;
   static uint8 *pMsg = NULL;
+  uint8 frames = 0;
 
-  if ( !npUartTxMsg )
+  while (1)
   {
-    if ( (pMsg = npUartTxMsg = osal_msg_dequeue(&npiTxQueue)) )
+    uint16 len;
+
+    if ( !npUartTxMsg )
     {
+      if ( (pMsg = npUartTxMsg = osal_msg_dequeue(&npiTxQueue)) == NULL )
+      {
+        break;
+      }
+
       if (pMsg[0] == NPI_UART_NULL_MSG)
       {
         // Special NULL message to respond to wake up
@@ -392,13 +624,15 @@ static bool npiUartTxReady(void)
         npUartTxCnt = pMsg[1] + RPC_UART_FRAME_OVHD + RPC_FRAME_HDR_SZ;
       }
     }
-  }
 
-  if ( npUartTxMsg )
-  {
-    uint16 len = MIN(NPI_UART_TX_MAX, npUartTxCnt);
+    len = MIN(NPI_UART_TX_MAX, npUartTxCnt);
+
+    // The write is all or none, so stop when the Tx buffers are full and try again on the next pass.
+    if ( (len = HalUARTWrite(NPI_UART_PORT, pMsg, len)) == 0 )
+    {
+      break;
+    }
 
-    len = HalUARTWrite(NPI_UART_PORT, pMsg, len);
     npUartTxCnt -= len;
     //NP_RDYOut = 0;  // Signal to Master that Tx is pending - sleep not ok.
 
@@ -406,6 +640,7 @@ static bool npiUartTxReady(void)
     {
       osal_msg_deallocate(npUartTxMsg);
       npUartTxMsg = NULL;
+      frames++;
     }
     else
     {
@@ -413,6 +648,11 @@ static bool npiUartTxReady(void)
     }
   }
 
+  if (frames)
+  {
+    NPI_TX_BURST_COUNT(frames);
+  }
+
   return ((npUartTxMsg != NULL) || (npiTxQueue != NULL));
 }
 
@@ -454,6 +694,10 @@ static uint8* npiUartAlloc( uint8 len )
  *          Parses the data and determine either is SPI or just simply serial data
  *          then send the data to NPI task
  *
+ *          Once the length and CMD0 are known, the frame is allocated as for Tx (with room for a
+ *          reply in place to an SREQ), the rest of it is read from the UART in as few blocks as it
+ *          arrives in, and the FCS is accumulated over each block as it is read.
+ *
  * @param   flag - Flag to indicate that sleep is pending.
  *
  *
@@ -461,21 +705,25 @@ static uint8* npiUartAlloc( uint8 len )
  ***************************************************************************************************/
 static void npiProcessData ( uint8 flag )
 {
-  static uint8 state = SOF_STATE;
-  static uint8 LEN_Token;
-  static uint8 FSC_Token;
-  static uint8 dataLen;
-  static npiSysEvtMsg_t *pMsg;
+  static uint8 len;
+  static uint16 bodyLen;  // Number of bytes from CMD1 to FCS inclusive.
+  static uint16 bodyCnt;  // Number of those bytes already read.
+  static uint8 fcs;
   uint8 ch;
 
-  while (HalUARTRead (NPI_UART_PORT, &ch, 1))
+  while (1)
   {
-    switch (state)
+    switch (npiRxState)
     {
     case SOF_STATE:
+      if (!HalUARTRead (NPI_UART_PORT, &ch, 1))
+      {
+        return;
+      }
+
       if (ch == RPC_UART_SOF)
       {
-        state = LEN_STATE;
+        npiRxState = LEN_STATE;
       }
       else if (flag && (ch == NPI_UART_NULL_MSG))
       {
@@ -484,82 +732,97 @@ static void npiProcessData ( uint8 flag )
       break;
 
     case LEN_STATE:
+      if (!HalUARTRead (NPI_UART_PORT, &ch, 1))
+      {
+        return;
+      }
+
       if (ch == RPC_UART_SOF)
       {
         // Repeated SOF means the prior SOF was perhaps garbled wakeup character
         break;
       }
-      LEN_Token = ch;
 
-      dataLen = 0;
+      len = ch;
+      npiRxState = CMD0_STATE;
+      break;
 
-      /* Allocate memory for the data */
-      pMsg = (npiSysEvtMsg_t *)osal_msg_allocate(sizeof(npiSysEvtMsg_t)+RPC_FRAME_HDR_SZ+LEN_Token);
+    case CMD0_STATE:
+      if (!HalUARTRead (NPI_UART_PORT, &ch, 1))
+      {
+        return;
+      }
 
-      if (pMsg)
+      /* Allocate the frame as for Tx, with room for the SOF and the FCS, so that an SREQ can be
+       * replied to in place - for which it needs room for the largest reply.
+       */
+      if ((ch & RPC_CMD_TYPE_MASK) == RPC_CMD_SREQ)
       {
-        pMsg->hdr.event = CMD_SERIAL_MSG;
-        pMsg->msg = (uint8*)(pMsg+1);
-        pMsg->msg[RPC_POS_LEN] = LEN_Token;
-        state = CMD_STATE1;
+        npiRxBuf = npiUartAlloc(MAX(len, NP_MAX_BUF_LEN));
       }
       else
       {
-        state = SOF_STATE;
-        return;
+        npiRxBuf = npiUartAlloc(len);
       }
-      break;
-
-    case CMD_STATE1:
-      pMsg->msg[RPC_POS_CMD0] = ch;
-      state = CMD_STATE2;
-      break;
 
-    case CMD_STATE2:
-      pMsg->msg[RPC_POS_CMD1] = ch;
-      /* If there is no data, skip to FCS state */
-      if (LEN_Token)
+      if (npiRxBuf)
       {
-        state = DATA_STATE;
+        npiRxBuf[RPC_POS_LEN] = len;
+        npiRxBuf[RPC_POS_CMD0] = ch;
+        bodyLen = RPC_FRAME_HDR_SZ - RPC_POS_CMD1 + len + 1;
+        bodyCnt = 0;
+        fcs = len ^ ch;
+        npiRxState = BODY_STATE;
       }
       else
       {
-        state = FCS_STATE;
+        npiRxState = SOF_STATE;
+        return;
       }
       break;
 
-    case DATA_STATE:
-      /* Fill in the buffer the first byte of the data */
-      pMsg->msg[RPC_FRAME_HDR_SZ + dataLen++] = ch;
+    case BODY_STATE:
+    {
+      uint8 *pBody = &npiRxBuf[RPC_POS_CMD1 + bodyCnt];
+      uint16 cnt = HalUARTRead (NPI_UART_PORT, pBody, bodyLen - bodyCnt);
 
-      /* Check number of bytes left in the Rx buffer */
-      if (dataLen < LEN_Token)
+      if (cnt == 0)
       {
-        dataLen +=  HalUARTRead (NPI_UART_PORT, &pMsg->msg[RPC_FRAME_HDR_SZ + dataLen], LEN_Token-dataLen);
+        return;
       }
 
-      /* If number of bytes read is equal to data length, time to move on to FCS */
-      if ( dataLen == LEN_Token )
+      bodyCnt += cnt;
+      while (cnt--)
       {
-        state = FCS_STATE;
+        fcs ^= *pBody++;
       }
-      break;
-
-    case FCS_STATE:
-      state = SOF_STATE;
-      FSC_Token = ch;
 
-      if ((npiUartCalcFCS ((uint8*)&pMsg->msg[0], RPC_FRAME_HDR_SZ + LEN_Token) == FSC_Token))
+      if (bodyCnt == bodyLen)
       {
-        osal_msg_send( NPI_TaskId, (uint8 *)pMsg );
-        osal_set_event(NPI_TaskId, NPI_UART_RX_READY_EVT);
-        return;
-      }
-      else
-      {
-        osal_msg_deallocate ( (uint8 *)pMsg );
+        npiRxState = SOF_STATE;
+
+        // The FCS byte XOR'ed into the FCS of the rest of the frame leaves zero.
+        if (fcs == 0)
+        {
+          if (npiUartBaudState == NPI_UART_BAUD_TRIAL)
+          {
+            // The host is talking at the new baud rate, so keep it.
+            (void)osal_stop_timerEx(NPI_TaskId, NPI_UART_BAUD_EVT);
+            npiUartBaudState = NPI_UART_BAUD_IDLE;
+          }
+
+          osal_msg_enqueue(&npiRxQueue, npiRxBuf - 1);
+          osal_set_event(NPI_TaskId, NPI_UART_RX_MSG_EVT);
+          osal_set_event(NPI_TaskId, NPI_UART_RX_READY_EVT);
+          return;
+        }
+        else
+        {
+          osal_msg_deallocate(npiRxBuf - 1);
+        }
       }
       break;
+    }
 
     default:
      break;
@@ -13,8 +13,10 @@ extern "C"
  * INCLUDES
  **************************************************************************************************/
 
-/* NPI includes */
+/* NPI includes - the host surrogate (rtis_lnx.c) frames the NPI itself */
+#if !defined __unix__
 #include "npi.h"
+#endif
 
 /* RTI includes */
 #include "rti.h"
@@ -45,9 +47,11 @@ extern "C"
 #define RTIS_CMD_ID_RTI_TEST_MODE_REQ          0x11
 #define RTIS_CMD_ID_RTI_RX_COUNTER_GET_REQ     0x12
 #define RTIS_CMD_ID_RTI_SW_RESET_REQ           0x13
+#define RTIS_CMD_ID_HEAP_TRACE_READ_REQ        0x14
 //
 #define RTIS_CMD_ID_RTI_READ_ITEM_EX           0x21
 #define RTIS_CMD_ID_RTI_WRITE_ITEM_EX          0x22
+#define RTIS_CMD_ID_RTI_SEND_DATA_REQ_EX       0x23
 
 // RTIS Confirm Ids
 #define RTIS_CMD_ID_RTI_INIT_CNF               0x01
@@ -63,6 +67,7 @@ extern "C"
 #define RTIS_CMD_ID_RTI_UNPAIR_IND             0x0B
 #define RTIS_CMD_ID_RTI_PAIR_ABORT_CNF         0x0C
 #define RTIS_CMD_ID_RTI_RESET_IND              0x0D
+#define RTIS_CMD_ID_RTI_SEND_DATA_CNF_EX       0x0E
 
 // RTI States
 enum
@@ -0,0 +1,1270 @@
+/**************************************************************************************************
+  Filename:       rtis_lnx.c
+
+  Description:    RTI surrogate for a POSIX host: the RTI API of rti.h, serialized as in
+                  rtis_np.c, over the NPI UART framing to a RemoTI network processor (RNP) on a
+                  serial port or a PTY.
+
+                  The RTI_*Req() AREQs return as soon as they are written, so any number of them
+                  may be in flight; their RTI_*Cnf() and RTI_*Ind() callbacks are made on a
+                  dedicated reader thread. The SREQ APIs, RTI_ReadItemEx(), RTI_WriteItemEx(),
+                  their batched forms RTIS_ReadItemsEx() and RTIS_WriteItemsEx(), and
+                  RTI_TestRxCounterGetReq(), block for their SRSPs and are serialized among
+                  themselves; a batch keeps up to RTIS_SREQ_WINDOW SREQs in flight, which the RNP
+                  processes and replies to in order. The reader thread takes the SRSPs, so these
+                  fail at once, with RTI_ERROR_NOT_PERMITTED, when called from a callback.
+
+                  RTIS_SetBaudRate() has the RNP change the baud rate of its UART, and follows it.
+**************************************************************************************************/
+
+// cfmakeraw() and CRTSCTS are not POSIX.
+#define _DEFAULT_SOURCE
+
+/**************************************************************************************************
+ *                                           Includes
+ **************************************************************************************************/
+
+/* POSIX includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* HAL includes */
+#include "hal_defs.h"
+#include "hal_rpc.h"
+
+/* RTIS includes */
+#include "rti.h"
+#include "rtis.h"
+
+/**************************************************************************************************
+ *                                           Constants
+ **************************************************************************************************/
+
+// The baud rate of the RNP UART - see NPI_UART_BAUD_RATE in npi_uart.c.
+#if !defined RTIS_BAUD_RATE
+#define RTIS_BAUD_RATE                 B115200
+#endif
+
+// The number of SREQs that a batch keeps in flight: the RNP queues each complete SREQ and replies
+// to them in order, and its UART DMA Rx ring holds three maximum-length frames.
+#if !defined RTIS_SREQ_WINDOW
+#define RTIS_SREQ_WINDOW               3
+#endif
+
+// Msecs to wait for each SRSP before failing the rest of the batch with RTI_ERROR_NO_RESPONSE.
+#if !defined RTIS_SREQ_TIMEOUT
+#define RTIS_SREQ_TIMEOUT              1000
+#endif
+
+// The largest NPI payload - NP_MAX_BUF_LEN in npi.h.
+#define RTIS_MAX_BUF_LEN               128
+
+// An SREQ on RPC_SYS_SYS that changes the baud rate of the RNP - NPI_SYS_CMD_ID_UART_BAUD_REQ.
+#define RTIS_NPI_UART_BAUD_REQ         0x01
+
+// An AREQ on RPC_SYS_SYS whose payload is whole RPC frames - NPI_SYS_CMD_ID_PACKED_AREQ in npi.h.
+#define RTIS_NPI_PACKED_AREQ           0x02
+
+// Msecs for the RNP to re-open its UART at a new baud rate after its SRSP, which drops whatever it
+// receives meanwhile; well inside the NPI_UART_BAUD_TIMEOUT that it then waits for a frame.
+#if !defined RTIS_BAUD_SETTLE
+#define RTIS_BAUD_SETTLE               20
+#endif
+
+// The largest RPC frame held for parsing: the LEN field is one byte.
+#define RTIS_RX_FRAME_MAX             (RPC_FRAME_HDR_SZ + 255)
+
+// UART frame parsing states, as in npi_uart.c
+#define SOF_STATE                      0x00
+#define LEN_STATE                      0x01
+#define CMD0_STATE                     0x02
+#define CMD1_STATE                     0x03
+#define DATA_STATE                     0x04
+#define FCS_STATE                      0x05
+
+/**************************************************************************************************
+ *                                        Local Variables
+ **************************************************************************************************/
+
+static int rtisFd = -1;             // The port to the RNP.
+static int rtisStopFd[2];           // Pipe that wakes the reader thread to stop it.
+static pthread_t rtisReadThread;
+
+static pthread_mutex_t rtisTxMutex = PTHREAD_MUTEX_INITIALIZER;    // One frame written at a time.
+static pthread_mutex_t rtisSreqMutex = PTHREAD_MUTEX_INITIALIZER;  // One SREQ batch at a time.
+
+// The SRSPs of the SREQs in flight, in order, each as LEN, CMD0, CMD1, data; guarded by rtisRspMutex.
+static pthread_mutex_t rtisRspMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t rtisRspCond = PTHREAD_COND_INITIALIZER;
+static uint8 rtisRsp[RTIS_SREQ_WINDOW][RPC_FRAME_HDR_SZ + RTIS_MAX_BUF_LEN];
+static uint8 rtisRspHead;
+static uint8 rtisRspCnt;
+static uint8 rtisSreqCnt;           // SREQs in flight, whose SRSPs have not been taken.
+static uint8 rtisSreqLate;          // SRSPs still due for abandoned SREQs, to be dropped.
+
+/**************************************************************************************************
+ *                                        Local Functions
+ **************************************************************************************************/
+
+static uint8 rtisSend(uint8 cmd0, uint8 cmd1, uint8 len, uint8 *pData);
+static uint8 rtisSreqSend(uint8 subSys, uint8 cmdId, uint8 len, uint8 *pData);
+static uint8 rtisSreqWait(uint8 cmdId, uint8 *pRsp);
+static void rtisSreqAbandon(void);
+static uint8 rtisOnReadThread(void);
+static rStatus_t rtisItemsEx(uint8 cmdId, rtisItem_t *pItems, uint8 cnt);
+static void *rtisReadTask(void *pArg);
+static void rtisRxFrame(uint8 *pFrame);
+static void rtisAsynchMsg(uint8 *pFrame);
+
+/**************************************************************************************************
+ *
+ * @fn          RTIS_Init
+ *
+ * @brief       This function opens the port to the RNP as a raw 8N1 line at RTIS_BAUD_RATE and
+ *              starts the reader thread that makes the RTI callbacks.
+ *
+ * input parameters
+ *
+ * @param       pPortName - The path of the serial port or PTY, e.g. "/dev/ttyUSB0".
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      0 on success; otherwise -1, with errno set.
+ */
+int RTIS_Init(const char *pPortName)
+{
+  struct termios tio;
+  int fd, err;
+
+  if (rtisFd >= 0)
+  {
+    errno = EBUSY;
+    return -1;
+  }
+
+  if ((fd = open(pPortName, O_RDWR | O_NOCTTY)) < 0)
+  {
+    return -1;
+  }
+
+  if (tcgetattr(fd, &tio) != 0)
+  {
+    err = errno;
+    (void)close(fd);
+    errno = err;
+    return -1;
+  }
+
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+  tio.c_cc[VMIN] = 1;
+  tio.c_cc[VTIME] = 0;
+  (void)cfsetispeed(&tio, RTIS_BAUD_RATE);
+  (void)cfsetospeed(&tio, RTIS_BAUD_RATE);
+
+  if ((tcsetattr(fd, TCSANOW, &tio) != 0) || (pipe(rtisStopFd) != 0))
+  {
+    err = errno;
+    (void)close(fd);
+    errno = err;
+    return -1;
+  }
+  (void)tcflush(fd, TCIOFLUSH);
+
+  rtisFd = fd;
+  rtisRspHead = rtisRspCnt = rtisSreqCnt = rtisSreqLate = 0;
+
+  if ((err = pthread_create(&rtisReadThread, NULL, rtisReadTask, NULL)) != 0)
+  {
+    (void)close(rtisStopFd[0]);
+    (void)close(rtisStopFd[1]);
+    (void)close(fd);
+    rtisFd = -1;
+    errno = err;
+    return -1;
+  }
+
+  return 0;
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTIS_Close
+ *
+ * @brief       This function stops the reader thread and closes the port to the RNP. The reader
+ *              thread cannot stop itself, so this does nothing when called from an RTI callback.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void RTIS_Close(void)
+{
+  uint8 stop = 0;
+
+  if ((rtisFd < 0) || rtisOnReadThread())
+  {
+    return;
+  }
+
+  (void)write(rtisStopFd[1], &stop, 1);
+  (void)pthread_join(rtisReadThread, NULL);
+
+  (void)close(rtisStopFd[0]);
+  (void)close(rtisStopFd[1]);
+  (void)close(rtisFd);
+  rtisFd = -1;
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTIS_ReadItemsEx
+ *
+ * @brief       This function reads a batch of configuration items, pipelining the SREQs.
+ *
+ * input parameters
+ *
+ * @param       pItems - The items, each with its profileId, itemId, len and pValue.
+ * @param       cnt    - The number of items.
+ *
+ * output parameters
+ *
+ * @param       pItems - The status of each item and, on success, the value read into pValue.
+ *
+ * @return      RTI_SUCCESS if every item was read; otherwise the first failing status. Nothing is
+ *              read if any item is too long for one NPI frame, or if called from an RTI callback.
+ */
+rStatus_t RTIS_ReadItemsEx(rtisItem_t *pItems, uint8 cnt)
+{
+  return rtisItemsEx(RTIS_CMD_ID_RTI_READ_ITEM_EX, pItems, cnt);
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTIS_WriteItemsEx
+ *
+ * @brief       This function writes a batch of configuration items, pipelining the SREQs. The
+ *              items are written in order, and all are attempted even if one fails.
+ *
+ * input parameters
+ *
+ * @param       pItems - The items, each with its profileId, itemId, len and pValue.
+ * @param       cnt    - The number of items.
+ *
+ * output parameters
+ *
+ * @param       pItems - The status of each item.
+ *
+ * @return      RTI_SUCCESS if every item was written; otherwise the first failing status. Nothing
+ *              is written if any item is too long for one NPI frame, or if called from an RTI
+ *              callback.
+ */
+rStatus_t RTIS_WriteItemsEx(rtisItem_t *pItems, uint8 cnt)
+{
+  return rtisItemsEx(RTIS_CMD_ID_RTI_WRITE_ITEM_EX, pItems, cnt);
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTIS_SetBaudRate
+ *
+ * @brief       This function has the RNP change its UART to another baud rate, changes the port to
+ *              match, and keeps the new rate on the RNP with a read of an item at it. If that read
+ *              gets no reply, the port goes back to the old rate, as the RNP does by itself after
+ *              NPI_UART_BAUD_TIMEOUT.
+ *
+ * input parameters
+ *
+ * @param       baudRate - The HAL_UART_BR_ value of the new rate, at most NPI_UART_BAUD_MAX.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      RTI_SUCCESS; RTI_ERROR_INVALID_PARAMETER if the RNP does not take the rate;
+ *              RTI_ERROR_NO_RESPONSE; or RTI_ERROR_NOT_PERMITTED from an RTI callback.
+ */
+rStatus_t RTIS_SetBaudRate(uint8 baudRate)
+{
+  static const speed_t rtisSpeed[] =
+  {
+    B9600, B19200, B38400, B57600, B115200, B230400, B460800, B921600
+  };
+  uint8 buf[RPC_FRAME_HDR_SZ + RTIS_MAX_BUF_LEN];
+  rStatus_t rtn = RTI_ERROR_NO_RESPONSE;
+  struct termios tio;
+  speed_t old;
+
+  if (rtisOnReadThread())
+  {
+    return RTI_ERROR_NOT_PERMITTED;
+  }
+
+  if ((baudRate >= sizeof(rtisSpeed) / sizeof(rtisSpeed[0])) || (tcgetattr(rtisFd, &tio) != 0))
+  {
+    return RTI_ERROR_INVALID_PARAMETER;
+  }
+  old = cfgetospeed(&tio);
+
+  (void)pthread_mutex_lock(&rtisSreqMutex);
+
+  // The RNP replies at the old rate, and changes after its SRSP is out.
+  if (rtisSreqSend(RPC_SYS_SYS, RTIS_NPI_UART_BAUD_REQ, 1, &baudRate) &&
+      rtisSreqWait(RTIS_NPI_UART_BAUD_REQ, buf) && (buf[RPC_POS_LEN] != 0))
+  {
+    if (buf[RPC_POS_DAT0] != RPC_SUCCESS)
+    {
+      rtn = RTI_ERROR_INVALID_PARAMETER;
+    }
+    else if (rtisSpeed[baudRate] == old)
+    {
+      rtn = RTI_SUCCESS;
+    }
+    else
+    {
+      (void)tcdrain(rtisFd);
+      (void)usleep(RTIS_BAUD_SETTLE * 1000);
+      (void)cfsetispeed(&tio, rtisSpeed[baudRate]);
+      (void)cfsetospeed(&tio, rtisSpeed[baudRate]);
+      (void)tcsetattr(rtisFd, TCSANOW, &tio);
+
+      // Any good frame keeps the new rate on the RNP; a reply to one shows that it got there.
+      buf[0] = RTI_PROFILE_RTI;
+      buf[1] = RTI_CP_ITEM_VENDOR_ID;
+      buf[2] = 2;
+      if (rtisSreqSend(RPC_SYS_RCAF, RTIS_CMD_ID_RTI_READ_ITEM_EX, 3, buf) &&
+          rtisSreqWait(RTIS_CMD_ID_RTI_READ_ITEM_EX, buf))
+      {
+        rtn = RTI_SUCCESS;
+      }
+      else
+      {
+        (void)cfsetispeed(&tio, old);
+        (void)cfsetospeed(&tio, old);
+        (void)tcsetattr(rtisFd, TCSANOW, &tio);
+      }
+    }
+  }
+
+  (void)pthread_mutex_unlock(&rtisSreqMutex);
+
+  return rtn;
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTI_ReadItemEx
+ *
+ * @brief       This API is used to read an item from the RNP's Configuration Parameters, State
+ *              Attributes, or Constants.
+ *
+ * input parameters
+ *
+ * @param       profileId - The profile of the item.
+ * @param       itemId    - The item identifier.
+ * @param       len       - The length of the item.
+ *
+ * output parameters
+ *
+ * @param       pValue    - The value read.
+ *
+ * @return      The status returned by the RNP, RTI_ERROR_NO_RESPONSE, or RTI_ERROR_NOT_PERMITTED
+ *              from an RTI callback.
+ */
+rStatus_t RTI_ReadItemEx(uint8 profileId, uint8 itemId, uint8 len, uint8 *pValue)
+{
+  rtisItem_t item;
+
+  item.profileId = profileId;
+  item.itemId = itemId;
+  item.len = len;
+  item.pValue = pValue;
+
+  return rtisItemsEx(RTIS_CMD_ID_RTI_READ_ITEM_EX, &item, 1);
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTI_WriteItemEx
+ *
+ * @brief       This API is used to write an item to the RNP's Configuration Parameters or State
+ *              Attributes.
+ *
+ * input parameters
+ *
+ * @param       profileId - The profile of the item.
+ * @param       itemId    - The item identifier.
+ * @param       len       - The length of the item.
+ * @param       pValue    - The value to write.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      The status returned by the RNP, RTI_ERROR_NO_RESPONSE, or RTI_ERROR_NOT_PERMITTED
+ *              from an RTI callback.
+ */
+rStatus_t RTI_WriteItemEx(uint8 profileId, uint8 itemId, uint8 len, uint8 *pValue)
+{
+  rtisItem_t item;
+
+  item.profileId = profileId;
+  item.itemId = itemId;
+  item.len = len;
+  item.pValue = pValue;
+
+  return rtisItemsEx(RTIS_CMD_ID_RTI_WRITE_ITEM_EX, &item, 1);
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTI_ReadItem
+ *
+ * @brief       Deprecated for RTI_ReadItemEx() - reads an item of the RTI profile.
+ *
+ * @param       itemId - The item identifier.
+ * @param       len    - The length of the item.
+ * @param       pValue - The value read.
+ *
+ * @return      The status returned by the RNP, or RTI_ERROR_NO_RESPONSE.
+ */
+rStatus_t RTI_ReadItem(uint8 itemId, uint8 len, uint8 *pValue)
+{
+  return RTI_ReadItemEx(RTI_PROFILE_RTI, itemId, len, pValue);
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTI_WriteItem
+ *
+ * @brief       Deprecated for RTI_WriteItemEx() - writes an item of the RTI profile.
+ *
+ * @param       itemId - The item identifier.
+ * @param       len    - The length of the item.
+ * @param       pValue - The value to write.
+ *
+ * @return      The status returned by the RNP, or RTI_ERROR_NO_RESPONSE.
+ */
+rStatus_t RTI_WriteItem(uint8 itemId, uint8 len, uint8 *pValue)
+{
+  return RTI_WriteItemEx(RTI_PROFILE_RTI, itemId, len, pValue);
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTI_InitReq, RTI_PairReq, RTI_PairAbortReq, RTI_AllowPairReq,
+ *              RTI_AllowPairAbortReq, RTI_UnpairReq, RTI_StandbyReq, RTI_RxEnableReq,
+ *              RTI_EnableSleepReq, RTI_DisableSleepReq, RTI_SwResetReq, RTI_TestModeReq
+ *
+ * @brief       These APIs send their request to the RNP as an AREQ and return; the confirm, if
+ *              any, is made on the reader thread.
+ *
+ * @return      None.
+ */
+void RTI_InitReq( void )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_INIT_REQ, 0, NULL);
+}
+
+void RTI_PairReq( void )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_PAIR_REQ, 0, NULL);
+}
+
+void RTI_PairAbortReq( void )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_PAIR_ABORT_REQ, 0, NULL);
+}
+
+void RTI_AllowPairReq( void )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_ALLOW_PAIR_REQ, 0, NULL);
+}
+
+void RTI_AllowPairAbortReq( void )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_ALLOW_PAIR_ABORT_REQ, 0, NULL);
+}
+
+void RTI_UnpairReq( uint8 dstIndex )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_UNPAIR_REQ, 1, &dstIndex);
+}
+
+void RTI_StandbyReq( uint8 mode )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_STANDBY_REQ, 1, &mode);
+}
+
+void RTI_RxEnableReq( uint16 duration )
+{
+  uint8 buf[2];
+
+  buf[0] = LO_UINT16(duration);
+  buf[1] = HI_UINT16(duration);
+
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_RX_ENABLE_REQ, 2, buf);
+}
+
+void RTI_EnableSleepReq( void )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_ENABLE_SLEEP_REQ, 0, NULL);
+}
+
+void RTI_DisableSleepReq( void )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_DISABLE_SLEEP_REQ, 0, NULL);
+}
+
+void RTI_SwResetReq( void )
+{
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_SW_RESET_REQ, 0, NULL);
+}
+
+void RTI_TestModeReq( uint8 mode, int8 txPower, uint8 channel )
+{
+  uint8 buf[3];
+
+  buf[0] = mode;
+  buf[1] = (uint8)txPower;
+  buf[2] = channel;
+
+  (void)rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_TEST_MODE_REQ, 3, buf);
+}
+
+/**************************************************************************************************
+ *
+ * @fn          RTI_SendDataReq
+ *
+ * @brief       This API sends data to a paired device as an AREQ and returns; RTI_SendDataCnf()
+ *              is made on the reader thread, or at once if the request could not be sent.
+ *
+ * @param       dstIndex  - The pairing table index of the destination.
+ * @param       profileId - The profile of the data.
+ * @param       vendorId  - The vendor of the data.
+ * @param       txOptions - The transmission options.
+ * @param       len       - The length of the data.
+ * @param       pData     - The data.
+ *
+ * @return      None.
+ */
+void RTI_SendDataReq( uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions, uint8 len, uint8 *pData )
+{
+  uint8 buf[RTIS_MAX_BUF_LEN];
+
+  if (len > RTIS_MAX_BUF_LEN - 6)
+  {
+    RTI_SendDataCnf(RTI_ERROR_INVALID_PARAMETER);
+    return;
+  }
+
+  buf[0] = dstIndex;
+  buf[1] = profileId;
+  buf[2] = LO_UINT16(vendorId);
+  buf[3] = HI_UINT16(vendorId);
+  buf[4] = txOptions;
+  buf[5] = len;
+  (void)memcpy(buf + 6, pData, len);
+
+  if (!rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_SEND_DATA_REQ, 6 + len, buf))
+  {
+    RTI_SendDataCnf(RTI_ERROR_NO_RESPONSE);
+  }
+}
+
+#if RTI_TX_QUEUE_DEPTH
+/**************************************************************************************************
+ *
+ * @fn          RTI_SendDataReqEx
+ *
+ * @brief       This API sends data to a paired device as an AREQ and returns; RTI_SendDataCnfEx()
+ *              with the same handle is made on the reader thread, or at once if the request could
+ *              not be sent. The RNP holds up to RTI_TX_QUEUE_DEPTH of them.
+ *
+ * @param       handle    - The handle of the confirm.
+ * @param       dstIndex  - The pairing table index of the destination.
+ * @param       profileId - The profile of the data.
+ * @param       vendorId  - The vendor of the data.
+ * @param       txOptions - The transmission options.
+ * @param       len       - The length of the data.
+ * @param       pData     - The data.
+ *
+ * @return      None.
+ */
+void RTI_SendDataReqEx( uint8 handle, uint8 dstIndex, uint8 profileId, uint16 vendorId, uint8 txOptions, uint8 len, uint8 *pData )
+{
+  uint8 buf[RTIS_MAX_BUF_LEN];
+
+  if (len > RTIS_MAX_BUF_LEN - 7)
+  {
+    RTI_SendDataCnfEx(handle, RTI_ERROR_INVALID_PARAMETER);
+    return;
+  }
+
+  buf[0] = handle;
+  buf[1] = dstIndex;
+  buf[2] = profileId;
+  buf[3] = LO_UINT16(vendorId);
+  buf[4] = HI_UINT16(vendorId);
+  buf[5] = txOptions;
+  buf[6] = len;
+  (void)memcpy(buf + 7, pData, len);
+
+  if (!rtisSend(RPC_CMD_AREQ | RPC_SYS_RCAF, RTIS_CMD_ID_RTI_SEND_DATA_REQ_EX, 7 + len, buf))
+  {
+    RTI_SendDataCnfEx(handle, RTI_ERROR_NO_RESPONSE);
+  }
+}
+#endif
+
+/**************************************************************************************************
+ *
+ * @fn          RTI_TestRxCounterGetReq
+ *
+ * @brief       This API reads the RNP's test mode receive counter.
+ *
+ * @param       resetFlag - TRUE to reset the counter after reading it.
+ *
+ * @return      The counter, or zero if the RNP did not respond or if called from an RTI callback.
+ */
+uint16 RTI_TestRxCounterGetReq(uint8 resetFlag)
+{
+  uint8 rsp[RPC_FRAME_HDR_SZ + RTIS_MAX_BUF_LEN];
+  uint16 cnt = 0;
+
+  if (rtisOnReadThread())
+  {
+    return 0;
+  }
+
+  (void)pthread_mutex_lock(&rtisSreqMutex);
+
+  if (rtisSreqSend(RPC_SYS_RCAF, RTIS_CMD_ID_RTI_RX_COUNTER_GET_REQ, 1, &resetFlag) &&
+      rtisSreqWait(RTIS_CMD_ID_RTI_RX_COUNTER_GET_REQ, rsp) && (rsp[RPC_POS_LEN] >= 2))
+  {
+    cnt = BUILD_UINT16(rsp[RPC_POS_DAT0], rsp[RPC_POS_DAT0 + 1]);
+  }
+
+  (void)pthread_mutex_unlock(&rtisSreqMutex);
+
+  return cnt;
+}
+
+/**************************************************************************************************
+ * @fn          rtisSend
+ *
+ * @brief       This function frames a message for the NPI UART and writes it to the RNP.
+ *
+ * input parameters
+ *
+ * @param       cmd0  - The command type and subsystem.
+ * @param       cmd1  - The command Id.
+ * @param       len   - The length of the payload; at most RTIS_MAX_BUF_LEN.
+ * @param       pData - The payload.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if the whole frame was written; FALSE otherwise.
+ */
+static uint8 rtisSend(uint8 cmd0, uint8 cmd1, uint8 len, uint8 *pData)
+{
+  uint8 buf[RPC_UART_FRAME_OVHD + RPC_FRAME_HDR_SZ + RTIS_MAX_BUF_LEN];
+  uint8 fcs, idx, *pBuf = buf;
+  size_t cnt = RPC_UART_FRAME_OVHD + RPC_FRAME_HDR_SZ + len;
+  ssize_t rtn;
+
+  buf[0] = RPC_UART_SOF;
+  buf[1 + RPC_POS_LEN] = len;
+  buf[1 + RPC_POS_CMD0] = cmd0;
+  buf[1 + RPC_POS_CMD1] = cmd1;
+  if (len != 0)
+  {
+    (void)memcpy(buf + 1 + RPC_POS_DAT0, pData, len);
+  }
+
+  fcs = 0;
+  for (idx = 1; idx < cnt - 1; idx++)
+  {
+    fcs ^= buf[idx];
+  }
+  buf[cnt - 1] = fcs;
+
+  (void)pthread_mutex_lock(&rtisTxMutex);
+  while (cnt != 0)
+  {
+    rtn = write(rtisFd, pBuf, cnt);
+
+    if (rtn < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+
+    pBuf += rtn;
+    cnt -= rtn;
+  }
+  (void)pthread_mutex_unlock(&rtisTxMutex);
+
+  return (cnt == 0);
+}
+
+/**************************************************************************************************
+ * @fn          rtisSreqSend
+ *
+ * @brief       This function sends an SREQ, its SRSP to be taken by rtisSreqWait(). The caller
+ *              holds rtisSreqMutex.
+ *
+ * input parameters
+ *
+ * @param       subSys - The subsystem, RPC_SYS_RCAF or RPC_SYS_SYS.
+ * @param       cmdId  - The command Id.
+ * @param       len    - The length of the payload.
+ * @param       pData  - The payload.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if the SREQ was sent; FALSE otherwise.
+ */
+static uint8 rtisSreqSend(uint8 subSys, uint8 cmdId, uint8 len, uint8 *pData)
+{
+  // Count the SREQ in flight first, so that the reader thread keeps its SRSP.
+  (void)pthread_mutex_lock(&rtisRspMutex);
+  rtisSreqCnt++;
+  (void)pthread_mutex_unlock(&rtisRspMutex);
+
+  if (rtisSend(RPC_CMD_SREQ | subSys, cmdId, len, pData))
+  {
+    return TRUE;
+  }
+
+  (void)pthread_mutex_lock(&rtisRspMutex);
+  rtisSreqCnt--;
+  (void)pthread_mutex_unlock(&rtisRspMutex);
+
+  return FALSE;
+}
+
+/**************************************************************************************************
+ * @fn          rtisSreqWait
+ *
+ * @brief       This function takes the SRSP of the oldest SREQ in flight. On a timeout, all of
+ *              the SREQs in flight are abandoned. The caller holds rtisSreqMutex.
+ *
+ * input parameters
+ *
+ * @param       cmdId - The command Id of the oldest SREQ in flight.
+ *
+ * output parameters
+ *
+ * @param       pRsp  - The SRSP, as LEN, CMD0, CMD1, data.
+ *
+ * @return      TRUE if the SRSP was taken; FALSE on a timeout.
+ */
+static uint8 rtisSreqWait(uint8 cmdId, uint8 *pRsp)
+{
+  struct timespec ts;
+  uint8 *pFrame;
+  uint8 rtn = FALSE;
+
+  (void)clock_gettime(CLOCK_REALTIME, &ts);
+  ts.tv_sec += RTIS_SREQ_TIMEOUT / 1000;
+  ts.tv_nsec += (RTIS_SREQ_TIMEOUT % 1000) * 1000000L;
+  if (ts.tv_nsec >= 1000000000L)
+  {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000L;
+  }
+
+  (void)pthread_mutex_lock(&rtisRspMutex);
+  while (TRUE)
+  {
+    if (rtisRspCnt == 0)
+    {
+      if (pthread_cond_timedwait(&rtisRspCond, &rtisRspMutex, &ts) == ETIMEDOUT)
+      {
+        rtisSreqLate += rtisSreqCnt;
+        rtisSreqCnt = 0;
+        break;
+      }
+      continue;
+    }
+
+    pFrame = rtisRsp[rtisRspHead];
+    rtisRspHead = (rtisRspHead + 1) % RTIS_SREQ_WINDOW;
+    rtisRspCnt--;
+
+    rtisSreqCnt--;
+
+    // The RNP replies to its SREQs in order, so anything else is a stray to be dropped.
+    if (pFrame[RPC_POS_CMD1] == cmdId)
+    {
+      (void)memcpy(pRsp, pFrame, RPC_FRAME_HDR_SZ + pFrame[RPC_POS_LEN]);
+      rtn = TRUE;
+      break;
+    }
+  }
+  (void)pthread_mutex_unlock(&rtisRspMutex);
+
+  return rtn;
+}
+
+/**************************************************************************************************
+ * @fn          rtisSreqAbandon
+ *
+ * @brief       This function abandons the SREQs in flight: the SRSPs already received are dropped,
+ *              and so are those still due, as they arrive.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void rtisSreqAbandon(void)
+{
+  (void)pthread_mutex_lock(&rtisRspMutex);
+  rtisSreqLate += rtisSreqCnt - rtisRspCnt;
+  rtisSreqCnt = rtisRspCnt = 0;
+  (void)pthread_mutex_unlock(&rtisRspMutex);
+}
+
+/**************************************************************************************************
+ * @fn          rtisOnReadThread
+ *
+ * @brief       This function checks whether it is called on the reader thread, i.e. from an RTI
+ *              callback.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if called on the reader thread; FALSE otherwise.
+ */
+static uint8 rtisOnReadThread(void)
+{
+  return ((rtisFd >= 0) && pthread_equal(pthread_self(), rtisReadThread));
+}
+
+/**************************************************************************************************
+ * @fn          rtisItemsEx
+ *
+ * @brief       This function reads or writes a batch of configuration items, keeping up to
+ *              RTIS_SREQ_WINDOW of the SREQs in flight.
+ *
+ * input parameters
+ *
+ * @param       cmdId  - RTIS_CMD_ID_RTI_READ_ITEM_EX or RTIS_CMD_ID_RTI_WRITE_ITEM_EX.
+ * @param       pItems - The items.
+ * @param       cnt    - The number of items.
+ *
+ * output parameters
+ *
+ * @param       pItems - The status of each item and, for a read, the values.
+ *
+ * @return      RTI_SUCCESS if every item succeeded; otherwise the first failing status. Nothing is
+ *              sent, and RTI_ERROR_NOT_PERMITTED returned, when called on the reader thread.
+ */
+static rStatus_t rtisItemsEx(uint8 cmdId, rtisItem_t *pItems, uint8 cnt)
+{
+  uint8 buf[RPC_FRAME_HDR_SZ + RTIS_MAX_BUF_LEN];
+  rStatus_t rtn = RTI_SUCCESS;
+  uint8 sent, done;
+
+  // The SREQ or the SRSP carries the value after 3 or 1 bytes.
+  for (done = 0; done < cnt; done++)
+  {
+    if (pItems[done].len > RTIS_MAX_BUF_LEN - ((cmdId == RTIS_CMD_ID_RTI_WRITE_ITEM_EX) ? 3 : 1))
+    {
+      pItems[done].status = RTI_ERROR_INVALID_PARAMETER;
+      return RTI_ERROR_INVALID_PARAMETER;
+    }
+  }
+
+  // The SRSPs are taken by the reader thread, which would wait here for them in vain.
+  if (rtisOnReadThread())
+  {
+    for (done = 0; done < cnt; done++)
+    {
+      pItems[done].status = RTI_ERROR_NOT_PERMITTED;
+    }
+    return RTI_ERROR_NOT_PERMITTED;
+  }
+
+  (void)pthread_mutex_lock(&rtisSreqMutex);
+
+  for (sent = done = 0; done < cnt; done++)
+  {
+    rtisItem_t *pItem;
+
+    // Keep the window full.
+    for (; (sent < cnt) && (sent - done < RTIS_SREQ_WINDOW); sent++)
+    {
+      uint8 len = 3;
+
+      pItem = pItems + sent;
+      buf[0] = pItem->profileId;
+      buf[1] = pItem->itemId;
+      buf[2] = pItem->len;
+      if (cmdId == RTIS_CMD_ID_RTI_WRITE_ITEM_EX)
+      {
+        (void)memcpy(buf + 3, pItem->pValue, pItem->len);
+        len += pItem->len;
+      }
+
+      if (!rtisSreqSend(RPC_SYS_RCAF, cmdId, len, buf))
+      {
+        break;
+      }
+    }
+
+    pItem = pItems + done;
+    if ((done == sent) || !rtisSreqWait(cmdId, buf) || (buf[RPC_POS_LEN] == 0))
+    {
+      // Fail this and the rest of the batch.
+      for (; done < cnt; done++)
+      {
+        pItems[done].status = RTI_ERROR_NO_RESPONSE;
+      }
+      rtisSreqAbandon();
+      if (rtn == RTI_SUCCESS)
+      {
+        rtn = RTI_ERROR_NO_RESPONSE;
+      }
+      break;
+    }
+
+    pItem->status = buf[RPC_POS_DAT0];
+    if ((cmdId == RTIS_CMD_ID_RTI_READ_ITEM_EX) && (pItem->status == RTI_SUCCESS))
+    {
+      if (buf[RPC_POS_LEN] >= pItem->len + 1)
+      {
+        (void)memcpy(pItem->pValue, buf + RPC_POS_DAT0 + 1, pItem->len);
+      }
+      else
+      {
+        pItem->status = RTI_ERROR_UNKNOWN_STATUS_RETURNED;
+      }
+    }
+
+    if ((rtn == RTI_SUCCESS) && (pItem->status != RTI_SUCCESS))
+    {
+      rtn = pItem->status;
+    }
+  }
+
+  (void)pthread_mutex_unlock(&rtisSreqMutex);
+
+  return rtn;
+}
+
+/**************************************************************************************************
+ * @fn          rtisReadTask
+ *
+ * @brief       This function is the reader thread: it parses the NPI UART frames from the RNP,
+ *              drops those with a bad FCS, and passes the rest to rtisRxFrame().
+ *
+ * input parameters
+ *
+ * @param       pArg - Unused.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      NULL.
+ */
+static void *rtisReadTask(void *pArg)
+{
+  uint8 frame[RTIS_RX_FRAME_MAX];
+  uint8 buf[64];
+  uint8 state = SOF_STATE;
+  uint8 fcs = 0;
+  uint16 idx = 0;
+  struct pollfd fds[2];
+  ssize_t cnt, i;
+
+  (void)pArg;
+
+  fds[0].fd = rtisFd;
+  fds[0].events = POLLIN;
+  fds[1].fd = rtisStopFd[0];
+  fds[1].events = POLLIN;
+
+  while (TRUE)
+  {
+    if (poll(fds, 2, -1) < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+
+    if (fds[1].revents != 0)
+    {
+      break;
+    }
+
+    if ((cnt = read(rtisFd, buf, sizeof(buf))) <= 0)
+    {
+      if ((cnt < 0) && ((errno == EINTR) || (errno == EAGAIN)))
+      {
+        continue;
+      }
+      break;
+    }
+
+    for (i = 0; i < cnt; i++)
+    {
+      uint8 ch = buf[i];
+
+      switch (state)
+      {
+      case SOF_STATE:
+        if (ch == RPC_UART_SOF)
+        {
+          state = LEN_STATE;
+        }
+        break;
+
+      case LEN_STATE:
+        frame[RPC_POS_LEN] = ch;
+        fcs = ch;
+        state = CMD0_STATE;
+        break;
+
+      case CMD0_STATE:
+        frame[RPC_POS_CMD0] = ch;
+        fcs ^= ch;
+        state = CMD1_STATE;
+        break;
+
+      case CMD1_STATE:
+        frame[RPC_POS_CMD1] = ch;
+        fcs ^= ch;
+        idx = RPC_POS_DAT0;
+        state = (frame[RPC_POS_LEN] == 0) ? FCS_STATE : DATA_STATE;
+        break;
+
+      case DATA_STATE:
+        frame[idx++] = ch;
+        fcs ^= ch;
+        if (idx == RPC_FRAME_HDR_SZ + frame[RPC_POS_LEN])
+        {
+          state = FCS_STATE;
+        }
+        break;
+
+      case FCS_STATE:
+        if (ch == fcs)
+        {
+          rtisRxFrame(frame);
+        }
+        state = SOF_STATE;
+        break;
+
+      default:
+        state = SOF_STATE;
+        break;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**************************************************************************************************
+ * @fn          rtisRxFrame
+ *
+ * @brief       This function queues an SRSP for rtisSreqWait(), or makes the callbacks of an AREQ,
+ *              unpacking an NPI packed AREQ into the frames it carries.
+ *
+ * input parameters
+ *
+ * @param       pFrame - The frame, as LEN, CMD0, CMD1, data.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void rtisRxFrame(uint8 *pFrame)
+{
+  uint8 type = pFrame[RPC_POS_CMD0] & RPC_CMD_TYPE_MASK;
+  uint8 len = pFrame[RPC_POS_LEN];
+
+  if (type == RPC_CMD_SRSP)
+  {
+    (void)pthread_mutex_lock(&rtisRspMutex);
+    // Drop the late SRSP of an abandoned SREQ, or one that no SREQ in flight waits for.
+    if (rtisSreqLate != 0)
+    {
+      rtisSreqLate--;
+    }
+    else if ((rtisRspCnt < rtisSreqCnt) && (len <= RTIS_MAX_BUF_LEN))
+    {
+      (void)memcpy(rtisRsp[(rtisRspHead + rtisRspCnt) % RTIS_SREQ_WINDOW], pFrame,
+                   RPC_FRAME_HDR_SZ + len);
+      rtisRspCnt++;
+      (void)pthread_cond_signal(&rtisRspCond);
+    }
+    (void)pthread_mutex_unlock(&rtisRspMutex);
+  }
+  else if (type == RPC_CMD_AREQ)
+  {
+    if (((pFrame[RPC_POS_CMD0] & RPC_SUBSYSTEM_MASK) == RPC_SYS_SYS) &&
+         (pFrame[RPC_POS_CMD1] == RTIS_NPI_PACKED_AREQ))
+    {
+      uint16 idx = RPC_POS_DAT0;
+      uint16 end = RPC_POS_DAT0 + len;
+
+      while ((idx + RPC_FRAME_HDR_SZ <= end) &&
+             (idx + RPC_FRAME_HDR_SZ + pFrame[idx + RPC_POS_LEN] <= end))
+      {
+        rtisAsynchMsg(pFrame + idx);
+        idx += RPC_FRAME_HDR_SZ + pFrame[idx + RPC_POS_LEN];
+      }
+    }
+    else
+    {
+      rtisAsynchMsg(pFrame);
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          rtisAsynchMsg
+ *
+ * @brief       This function makes the RTI callback of an RCAF AREQ from the RNP.
+ *
+ * input parameters
+ *
+ * @param       pFrame - The frame, as LEN, CMD0, CMD1, data.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void rtisAsynchMsg(uint8 *pFrame)
+{
+  uint8 *pData = pFrame + RPC_POS_DAT0;
+
+  if ((pFrame[RPC_POS_CMD0] & RPC_SUBSYSTEM_MASK) != RPC_SYS_RCAF)
+  {
+    return;
+  }
+
+  switch (pFrame[RPC_POS_CMD1])
+  {
+  case RTIS_CMD_ID_RTI_INIT_CNF:
+    RTI_InitCnf(pData[0]);
+    break;
+
+  case RTIS_CMD_ID_RTI_PAIR_CNF:
+    RTI_PairCnf(pData[0], pData[1], pData[2]);
+    break;
+
+  case RTIS_CMD_ID_RTI_PAIR_ABORT_CNF:
+    RTI_PairAbortCnf(pData[0]);
+    break;
+
+  case RTIS_CMD_ID_RTI_ALLOW_PAIR_CNF:
+    RTI_AllowPairCnf(pData[0], pData[1], pData[2]);
+    break;
+
+  case RTIS_CMD_ID_RTI_SEND_DATA_CNF:
+    RTI_SendDataCnf(pData[0]);
+    break;
+
+#if RTI_TX_QUEUE_DEPTH
+  case RTIS_CMD_ID_RTI_SEND_DATA_CNF_EX:
+    RTI_SendDataCnfEx(pData[0], pData[1]);
+    break;
+#endif
+
+  case RTIS_CMD_ID_RTI_REC_DATA_IND:
+    if ((pFrame[RPC_POS_LEN] >= 7) && (pData[6] <= pFrame[RPC_POS_LEN] - 7))
+    {
+      RTI_ReceiveDataInd(pData[0],                            // srcIndex
+                         pData[1],                            // profileId
+                         BUILD_UINT16(pData[2], pData[3]),    // vendorId
+                         pData[4],                            // rxLQI
+                         pData[5],                            // rxFlags
+                         pData[6],                            // len
+                         pData + 7);                          // *pData
+    }
+    break;
+
+  case RTIS_CMD_ID_RTI_STANDBY_CNF:
+    RTI_StandbyCnf(pData[0]);
+    break;
+
+  case RTIS_CMD_ID_RTI_RX_ENABLE_CNF:
+    RTI_RxEnableCnf(pData[0]);
+    break;
+
+  case RTIS_CMD_ID_RTI_ENABLE_SLEEP_CNF:
+    RTI_EnableSleepCnf(pData[0]);
+    break;
+
+  case RTIS_CMD_ID_RTI_DISABLE_SLEEP_CNF:
+    RTI_DisableSleepCnf(pData[0]);
+    break;
+
+  case RTIS_CMD_ID_RTI_UNPAIR_CNF:
+    RTI_UnpairCnf(pData[0], pData[1]);
+    break;
+
+  case RTIS_CMD_ID_RTI_UNPAIR_IND:
+    RTI_UnpairInd(pData[0]);
+    break;
+
+  case RTIS_CMD_ID_RTI_RESET_IND:
+    // The reset RNP will not reply to any abandoned SREQs.
+    (void)pthread_mutex_lock(&rtisRspMutex);
+    rtisSreqLate = 0;
+    (void)pthread_mutex_unlock(&rtisRspMutex);
+    RTI_ResetInd();
+    break;
+
+  default:
+    break;
+  }
+}
+
+/**************************************************************************************************
+ **************************************************************************************************/
@@ -116,6 +116,13 @@ void NPI_SynchMsgCback( npiMsgData_t *pMsg )
       break;
 #endif // FEATURE_TEST_MODE
 
+#if ( OSALMEM_TRACE ) && !defined ( DPRINTF_OSALHEAPTRACE )
+    case RTIS_CMD_ID_HEAP_TRACE_READ_REQ:
+      // reply with the count of records lost followed by as many whole heap trace records as fit
+      pMsg->len = 1 + osal_mem_trace_read(&pMsg->pData[1], NP_MAX_BUF_LEN - 1, &pMsg->pData[0]);
+      break;
+#endif
+
     case RTIS_CMD_ID_RTI_READ_ITEM_EX:
       pMsg->len = pMsg->pData[2] + 1;
       pMsg->pData[0] = RTI_ReadItemEx(pMsg->pData[0], pMsg->pData[1],
@@ -225,6 +232,22 @@ void NPI_AsynchMsgCback( npiMsgData_t *pMsg )
       }
       break;
 
+#if RTI_TX_QUEUE_DEPTH
+    // send data request with a handle for the confirm
+    case RTIS_CMD_ID_RTI_SEND_DATA_REQ_EX:
+      if ( rtisState == RTIS_STATE_READY )
+      {
+        RTI_SendDataReqEx( pMsg->pData[0],        // handle
+                           pMsg->pData[1],        // dstIndex
+                           pMsg->pData[2],        // profileId
+                           (uint16)pMsg->pData[3] | ((uint16)pMsg->pData[4] << 8), // vendorId
+                           pMsg->pData[5],        // txOptions
+                           pMsg->pData[6],        // len
+                          &pMsg->pData[7] );      // *pData
+      }
+      break;
+#endif
+
     // allow pair request
     case RTIS_CMD_ID_RTI_ALLOW_PAIR_REQ:
       if ( rtisState == RTIS_STATE_READY )
@@ -520,6 +543,33 @@ void RTI_SendDataCnf( rStatus_t status )
   NPI_SendAsynchData( &pMsg );
 }
 
+#if RTI_TX_QUEUE_DEPTH
+/**************************************************************************************************
+ *
+ * @fn      RTI_SendDataCnfEx
+ *
+ * @brief   RTI confirmation callback initiated by client's RTI_SendDataReqEx API
+ *          call. The client is expected to complete this function.
+ *
+ * @param   handle - Handle given with the RTI_SendDataReqEx API call.
+ * @param   status - Result of RTI_SendDataReqEx API call.
+ *
+ * @return  void
+ */
+void RTI_SendDataCnfEx( uint8 handle, rStatus_t status )
+{
+  npiMsgData_t pMsg;
+
+  pMsg.subSys   = RPC_SYS_RCAF;
+  pMsg.cmdId    = RTIS_CMD_ID_RTI_SEND_DATA_CNF_EX;
+  pMsg.len      = 2;
+  pMsg.pData[0] = handle;
+  pMsg.pData[1] = status;
+
+  NPI_SendAsynchData( &pMsg );
+}
+#endif
+
 
 /**************************************************************************************************
  *
@@ -546,25 +596,31 @@ void RTI_SendDataCnf( rStatus_t status )
  */
 void RTI_ReceiveDataInd( uint8 srcIndex, uint8 profileId, uint16 vendorId, uint8 rxLQI, uint8 rxFlags, uint8 len, uint8 *pData )
 {
-  npiMsgData_t pMsg;
+  npiMsgData_t *pMsg;
 
-  // RTI has received data from network, so prep an asynchronous message...
-  pMsg.subSys   = RPC_SYS_RCAF;
-  pMsg.cmdId    = RTIS_CMD_ID_RTI_REC_DATA_IND;
-  pMsg.len      = 7+len;
-  pMsg.pData[0] = srcIndex;
-  pMsg.pData[1] = profileId;
-  pMsg.pData[2] = (vendorId >> 0) & 0xFF;
-  pMsg.pData[3] = (vendorId >> 8) & 0xFF;
-  pMsg.pData[4] = rxLQI;
-  pMsg.pData[5] = rxFlags;
-  pMsg.pData[6] = len;
+  // RTI has received data from network, so prep an asynchronous message in place in an AREQ
+  // buffer (instead of in a full npiMsgData_t on the stack that NPI would then copy)...
+  if ((pMsg = NPI_AllocAsynchData( 7+len )) == NULL)
+  {
+    return;
+  }
+
+  pMsg->subSys   = RPC_SYS_RCAF;
+  pMsg->cmdId    = RTIS_CMD_ID_RTI_REC_DATA_IND;
+  pMsg->len      = 7+len;
+  pMsg->pData[0] = srcIndex;
+  pMsg->pData[1] = profileId;
+  pMsg->pData[2] = (vendorId >> 0) & 0xFF;
+  pMsg->pData[3] = (vendorId >> 8) & 0xFF;
+  pMsg->pData[4] = rxLQI;
+  pMsg->pData[5] = rxFlags;
+  pMsg->pData[6] = len;
 
   // ...copy the received data to be sent...
-  osal_memcpy( &pMsg.pData[7], pData, len );
+  osal_memcpy( &pMsg->pData[7], pData, len );
 
   // ...and send the Receive Data Indication
-  NPI_SendAsynchData( &pMsg );
+  NPI_SendAsynchBuf( pMsg );
 }
 
 